@@ -32,6 +32,8 @@ PRIVATE_HEADERS += \
     qgstreamervideooverlay_p.h \
     qgsttools_global_p.h \
     qgstreamerplayersession_p.h \
+    qgstreamerplaybackclock_p.h \
+    qgstreamerframecache_p.h \
     qgstreamerplayercontrol_p.h
 
 SOURCES += \
@@ -46,6 +48,7 @@ SOURCES += \
     qgstreamervideoinputdevicecontrol.cpp \
     qgstcodecsinfo.cpp \
     qgstreamervideoprobecontrol.cpp \
+    qgstreamerframecache.cpp \
     qgstreameraudioprobecontrol.cpp \
     qgstreamervideowindow.cpp \
     qgstreamervideooverlay.cpp \
@@ -84,10 +87,21 @@ qtConfig(gstreamer_0_10) {
 
 qtConfig(gstreamer_gl): QMAKE_USE += gstreamer_gl
 
+qtConfig(gstreamer_dmabuf) {
+    QMAKE_USE += gstreamer_allocators egl
+    PRIVATE_HEADERS += qgstdmabufvideobuffer_p.h
+    SOURCES += qgstdmabufvideobuffer.cpp
+}
+
 qtConfig(gstreamer_app) {
     QMAKE_USE += gstreamer_app
     PRIVATE_HEADERS += qgstappsrc_p.h
     SOURCES += qgstappsrc.cpp
+
+    !qtConfig(gstreamer_0_10) {
+        PRIVATE_HEADERS += qgstreamerframeextractor_p.h
+        SOURCES += qgstreamerframeextractor.cpp
+    }
 }
 
 android {
@@ -0,0 +1,246 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgstdmabufvideobuffer_p.h"
+
+#include <QtCore/qvarlengtharray.h>
+#include <QtGui/qguiapplication.h>
+#include <qpa/qplatformnativeinterface.h>
+
+#include <gst/allocators/gstdmabuf.h>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#ifndef EGL_LINUX_DMA_BUF_EXT
+#define EGL_LINUX_DMA_BUF_EXT 0x3270
+#define EGL_LINUX_DRM_FOURCC_EXT 0x3271
+#define EGL_DMA_BUF_PLANE0_FD_EXT 0x3272
+#define EGL_DMA_BUF_PLANE0_OFFSET_EXT 0x3273
+#define EGL_DMA_BUF_PLANE0_PITCH_EXT 0x3274
+#define EGL_DMA_BUF_PLANE1_FD_EXT 0x3275
+#define EGL_DMA_BUF_PLANE1_OFFSET_EXT 0x3276
+#define EGL_DMA_BUF_PLANE1_PITCH_EXT 0x3277
+#define EGL_DMA_BUF_PLANE2_FD_EXT 0x3278
+#define EGL_DMA_BUF_PLANE2_OFFSET_EXT 0x3279
+#define EGL_DMA_BUF_PLANE2_PITCH_EXT 0x327A
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+struct EglDmaBufImport
+{
+    EglDmaBufImport()
+    {
+        QPlatformNativeInterface *nativeInterface = qGuiApp ? qGuiApp->platformNativeInterface() : nullptr;
+        if (!nativeInterface)
+            return;
+
+        display = static_cast<EGLDisplay>(nativeInterface->nativeResourceForIntegration("egldisplay"));
+        if (!display)
+            return;
+
+        const QByteArray extensions = eglQueryString(display, EGL_EXTENSIONS);
+        if (!extensions.contains("EGL_EXT_image_dma_buf_import"))
+            return;
+
+        createImage = reinterpret_cast<PFNEGLCREATEIMAGEKHRPROC>(eglGetProcAddress("eglCreateImageKHR"));
+        destroyImage = reinterpret_cast<PFNEGLDESTROYIMAGEKHRPROC>(eglGetProcAddress("eglDestroyImageKHR"));
+    }
+
+    bool isValid() const { return createImage && destroyImage; }
+
+    EGLDisplay display = nullptr;
+    PFNEGLCREATEIMAGEKHRPROC createImage = nullptr;
+    PFNEGLDESTROYIMAGEKHRPROC destroyImage = nullptr;
+};
+
+const EglDmaBufImport &eglDmaBufImport()
+{
+    static const EglDmaBufImport import;
+    return import;
+}
+
+constexpr EGLint drmFourcc(char a, char b, char c, char d)
+{
+    return EGLint(quint32(a) | (quint32(b) << 8) | (quint32(c) << 16) | (quint32(d) << 24));
+}
+
+// The DRM formats are named from the most significant bit of a little
+// endian word, GStreamer names the bytes in memory order.
+EGLint drmFourcc(GstVideoFormat format)
+{
+    switch (format) {
+    case GST_VIDEO_FORMAT_NV12:
+        return drmFourcc('N', 'V', '1', '2');
+    case GST_VIDEO_FORMAT_NV21:
+        return drmFourcc('N', 'V', '2', '1');
+    case GST_VIDEO_FORMAT_I420:
+        return drmFourcc('Y', 'U', '1', '2');
+    case GST_VIDEO_FORMAT_YV12:
+        return drmFourcc('Y', 'V', '1', '2');
+    case GST_VIDEO_FORMAT_YUY2:
+        return drmFourcc('Y', 'U', 'Y', 'V');
+    case GST_VIDEO_FORMAT_UYVY:
+        return drmFourcc('U', 'Y', 'V', 'Y');
+    case GST_VIDEO_FORMAT_BGRx:
+        return drmFourcc('X', 'R', '2', '4');
+    case GST_VIDEO_FORMAT_BGRA:
+        return drmFourcc('A', 'R', '2', '4');
+    case GST_VIDEO_FORMAT_RGBx:
+        return drmFourcc('X', 'B', '2', '4');
+    case GST_VIDEO_FORMAT_RGBA:
+        return drmFourcc('A', 'B', '2', '4');
+    case GST_VIDEO_FORMAT_RGB16:
+        return drmFourcc('R', 'G', '1', '6');
+    default:
+        return 0;
+    }
+}
+
+}
+
+QGstDmaBufVideoBuffer::QGstDmaBufVideoBuffer(GstBuffer *buffer, const GstVideoInfo &info)
+    : QGstVideoBuffer(buffer, info, EGLImageHandle, QVariant())
+    , m_dmaBufInfo(info)
+{
+}
+
+QGstDmaBufVideoBuffer::~QGstDmaBufVideoBuffer()
+{
+    if (m_image) {
+        const EglDmaBufImport &egl = eglDmaBufImport();
+        egl.destroyImage(egl.display, static_cast<EGLImageKHR>(m_image));
+    }
+}
+
+QVariant QGstDmaBufVideoBuffer::handle() const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_imported) {
+        m_imported = true;
+        m_image = createImage();
+    }
+
+    return QVariant::fromValue<void *>(m_image);
+}
+
+bool QGstDmaBufVideoBuffer::isSupported()
+{
+    return eglDmaBufImport().isValid();
+}
+
+bool QGstDmaBufVideoBuffer::isDmaBuf(GstBuffer *buffer)
+{
+    return gst_buffer_n_memory(buffer) > 0 && gst_is_dmabuf_memory(gst_buffer_peek_memory(buffer, 0));
+}
+
+void QGstDmaBufVideoBuffer::removeUnsupportedFormats(GstCaps *caps)
+{
+    for (guint i = gst_caps_get_size(caps); i > 0; --i) {
+        const GstStructure *structure = gst_caps_get_structure(caps, i - 1);
+        const gchar *format = gst_structure_get_string(structure, "format");
+        if (!format || !drmFourcc(gst_video_format_from_string(format)))
+            gst_caps_remove_structure(caps, i - 1);
+    }
+}
+
+void *QGstDmaBufVideoBuffer::createImage() const
+{
+    const EglDmaBufImport &egl = eglDmaBufImport();
+    const EGLint fourcc = drmFourcc(GST_VIDEO_INFO_FORMAT(&m_dmaBufInfo));
+    if (!egl.isValid() || !fourcc)
+        return nullptr;
+
+    static const EGLint planeAttributes[3][3] = {
+        { EGL_DMA_BUF_PLANE0_FD_EXT, EGL_DMA_BUF_PLANE0_OFFSET_EXT, EGL_DMA_BUF_PLANE0_PITCH_EXT },
+        { EGL_DMA_BUF_PLANE1_FD_EXT, EGL_DMA_BUF_PLANE1_OFFSET_EXT, EGL_DMA_BUF_PLANE1_PITCH_EXT },
+        { EGL_DMA_BUF_PLANE2_FD_EXT, EGL_DMA_BUF_PLANE2_OFFSET_EXT, EGL_DMA_BUF_PLANE2_PITCH_EXT }
+    };
+
+    QVarLengthArray<EGLint, 32> attributes;
+    attributes.append(EGL_WIDTH);
+    attributes.append(GST_VIDEO_INFO_WIDTH(&m_dmaBufInfo));
+    attributes.append(EGL_HEIGHT);
+    attributes.append(GST_VIDEO_INFO_HEIGHT(&m_dmaBufInfo));
+    attributes.append(EGL_LINUX_DRM_FOURCC_EXT);
+    attributes.append(fourcc);
+
+    // Decoders describe padded planes with a video meta
+    GstBuffer *gstBuffer = buffer();
+    const GstVideoMeta *meta = gst_buffer_get_video_meta(gstBuffer);
+    const guint planes = qMin<guint>(GST_VIDEO_INFO_N_PLANES(&m_dmaBufInfo), 3);
+
+    for (guint i = 0; i < planes; ++i) {
+        const gsize offset = meta ? meta->offset[i] : GST_VIDEO_INFO_PLANE_OFFSET(&m_dmaBufInfo, i);
+        const gint stride = meta ? meta->stride[i] : GST_VIDEO_INFO_PLANE_STRIDE(&m_dmaBufInfo, i);
+
+        // Planes may be in separate dmabufs
+        guint index = 0;
+        guint length = 0;
+        gsize skip = 0;
+        if (!gst_buffer_find_memory(gstBuffer, offset, 1, &index, &length, &skip))
+            return nullptr;
+
+        GstMemory *memory = gst_buffer_peek_memory(gstBuffer, index);
+        if (!gst_is_dmabuf_memory(memory))
+            return nullptr;
+
+        attributes.append(planeAttributes[i][0]);
+        attributes.append(gst_dmabuf_memory_get_fd(memory));
+        attributes.append(planeAttributes[i][1]);
+        attributes.append(EGLint(memory->offset + skip));
+        attributes.append(planeAttributes[i][2]);
+        attributes.append(stride);
+    }
+    attributes.append(EGL_NONE);
+
+    EGLImageKHR image = egl.createImage(egl.display, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT,
+                                        nullptr, attributes.constData());
+    if (image == EGL_NO_IMAGE_KHR) {
+        qWarning("Failed to import dmabuf video frame: EGL error 0x%x", eglGetError());
+        return nullptr;
+    }
+
+    return image;
+}
+
+QT_END_NAMESPACE
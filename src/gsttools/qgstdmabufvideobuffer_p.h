@@ -0,0 +1,90 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGSTDMABUFVIDEOBUFFER_P_H
+#define QGSTDMABUFVIDEOBUFFER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qgstvideobuffer_p.h>
+#include <QtCore/qmutex.h>
+
+QT_BEGIN_NAMESPACE
+
+// A video buffer backed by dmabuf memory, e.g. from VA-API or V4L2
+// decoders. Its handle is an EGLImage imported with
+// EGL_EXT_image_dma_buf_import, so frames reach the scene graph without
+// being copied. The image is created on first use and lives as long as the
+// buffer; the frame can still be mapped for CPU access.
+class Q_GSTTOOLS_EXPORT QGstDmaBufVideoBuffer : public QGstVideoBuffer
+{
+public:
+    QGstDmaBufVideoBuffer(GstBuffer *buffer, const GstVideoInfo &info);
+    ~QGstDmaBufVideoBuffer();
+
+    QVariant handle() const override;
+
+    // True if the EGL display of the application can import dmabufs.
+    static bool isSupported();
+    static bool isDmaBuf(GstBuffer *buffer);
+    // Removes the structures of the writable caps whose format has no DRM
+    // equivalent, as such buffers can't be imported.
+    static void removeUnsupportedFormats(GstCaps *caps);
+
+private:
+    void *createImage() const;
+
+    GstVideoInfo m_dmaBufInfo;
+    mutable QMutex m_mutex;
+    mutable void *m_image = nullptr;
+    mutable bool m_imported = false;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,220 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgstreamerframecache_p.h"
+
+#include "qgstutils_p.h"
+#include <private/qgstvideobuffer_p.h>
+
+QT_BEGIN_NAMESPACE
+
+QGstreamerFrameCache::QGstreamerFrameCache()
+{
+#if GST_CHECK_VERSION(1,0,0)
+    gst_video_info_init(&m_videoInfo);
+#endif
+}
+
+QGstreamerFrameCache::~QGstreamerFrameCache()
+{
+}
+
+int QGstreamerFrameCache::capacity() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_capacity;
+}
+
+void QGstreamerFrameCache::setCapacity(int frames)
+{
+    QMutexLocker locker(&m_mutex);
+    m_capacity = qMax(frames, 0);
+    trim();
+}
+
+void QGstreamerFrameCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_frames.clear();
+}
+
+qint64 QGstreamerFrameCache::frameDuration() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_frameDuration;
+}
+
+QVideoFrame QGstreamerFrameCache::frameAt(qint64 time) const
+{
+    QMutexLocker locker(&m_mutex);
+    const const_iterator it = find(time);
+    return it != m_frames.constEnd() ? it.value() : QVideoFrame();
+}
+
+QVideoFrame QGstreamerFrameCache::step(qint64 time, int frames) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    const_iterator it = find(time);
+    if (it == m_frames.constEnd())
+        return QVideoFrame();
+
+    // Only step across frames that follow each other directly; a gap means
+    // the frames in between were never cached.
+    const qint64 tolerance = qMax<qint64>(m_frameDuration / 2, 1000);
+    for (; frames > 0; --frames) {
+        const qint64 end = endTime(it.value());
+        if (++it == m_frames.constEnd() || qAbs(it.key() - end) > tolerance)
+            return QVideoFrame();
+    }
+    for (; frames < 0; ++frames) {
+        if (it == m_frames.constBegin())
+            return QVideoFrame();
+        const qint64 start = it.key();
+        --it;
+        if (qAbs(start - endTime(it.value())) > tolerance)
+            return QVideoFrame();
+    }
+
+    m_playhead = it.key();
+    return it.value();
+}
+
+void QGstreamerFrameCache::probeCaps(GstCaps *caps)
+{
+#if GST_CHECK_VERSION(1,0,0)
+    GstVideoInfo videoInfo;
+    const QVideoSurfaceFormat format = QGstUtils::formatForCaps(caps, &videoInfo);
+#else
+    int bytesPerLine = 0;
+    const QVideoSurfaceFormat format = QGstUtils::formatForCaps(caps, &bytesPerLine);
+#endif
+
+    bool cacheable = format.isValid();
+#if GST_CHECK_VERSION(1,2,0)
+    // Frames in GL or other device memory can't be copied cheaply.
+    if (GstCapsFeatures *features = gst_caps_get_features(caps, 0))
+        cacheable = cacheable && gst_caps_features_contains(features, GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY);
+#endif
+
+    QMutexLocker locker(&m_mutex);
+
+    if (format.frameSize() != m_format.frameSize() || format.pixelFormat() != m_format.pixelFormat())
+        m_frames.clear();
+
+    m_format = format;
+#if GST_CHECK_VERSION(1,0,0)
+    m_videoInfo = videoInfo;
+#else
+    m_bytesPerLine = bytesPerLine;
+#endif
+    m_frameDuration = format.frameRate() > 0 ? qint64(1000000 / format.frameRate()) : 0;
+    m_cacheable = cacheable;
+}
+
+bool QGstreamerFrameCache::probeBuffer(GstBuffer *buffer)
+{
+    if (!m_recording.loadAcquire() || !GST_BUFFER_TIMESTAMP_IS_VALID(buffer))
+        return true;
+
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_cacheable || m_capacity == 0)
+        return true;
+
+    // Copy the data so that cached frames don't hold on to buffers of the
+    // decoder's pool.
+#if GST_CHECK_VERSION(1,6,0)
+    GstBuffer *copy = gst_buffer_copy_deep(buffer);
+#else
+    GstBuffer *copy = gst_buffer_copy(buffer);
+#endif
+
+    QVideoFrame frame(
+#if GST_CHECK_VERSION(1,0,0)
+                new QGstVideoBuffer(copy, m_videoInfo),
+#else
+                new QGstVideoBuffer(copy, m_bytesPerLine),
+#endif
+                m_format.frameSize(),
+                m_format.pixelFormat());
+    gst_buffer_unref(copy);
+
+    QGstUtils::setFrameTimeStamps(&frame, buffer);
+
+    // Variable frame rate streams have no nominal rate in the caps.
+    if (m_format.frameRate() <= 0 && GST_BUFFER_DURATION_IS_VALID(buffer))
+        m_frameDuration = GST_BUFFER_DURATION(buffer) / 1000;
+
+    m_frames.insert(frame.startTime(), frame);
+    m_playhead = frame.startTime();
+    trim();
+
+    return true;
+}
+
+// Returns the cached frame displayed at time. m_mutex must be held.
+QGstreamerFrameCache::const_iterator QGstreamerFrameCache::find(qint64 time) const
+{
+    const_iterator it = m_frames.upperBound(time);
+    if (it == m_frames.constBegin())
+        return m_frames.constEnd();
+
+    --it;
+    return time == it.key() || time < endTime(it.value()) ? it : m_frames.constEnd();
+}
+
+qint64 QGstreamerFrameCache::endTime(const QVideoFrame &frame) const
+{
+    return frame.endTime() > frame.startTime()
+            ? frame.endTime()
+            : frame.startTime() + m_frameDuration;
+}
+
+void QGstreamerFrameCache::trim()
+{
+    while (m_frames.size() > m_capacity) {
+        if (m_playhead - m_frames.firstKey() > m_frames.lastKey() - m_playhead)
+            m_frames.erase(m_frames.begin());
+        else
+            m_frames.erase(--m_frames.end());
+    }
+}
+
+QT_END_NAMESPACE
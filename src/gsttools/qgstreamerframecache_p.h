@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGSTREAMERFRAMECACHE_P_H
+#define QGSTREAMERFRAMECACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qgsttools_global_p.h>
+#include <private/qgstreamerbufferprobe_p.h>
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qmutex.h>
+#include <qvideoframe.h>
+#include <qvideosurfaceformat.h>
+
+QT_BEGIN_NAMESPACE
+
+// Keeps copies of the most recent decoded frames that passed a video sink pad,
+// keyed by start time (in microseconds), so a paused player can step between
+// them without decoding again. When over capacity the frame furthest from the
+// playhead is dropped.
+class Q_GSTTOOLS_EXPORT QGstreamerFrameCache : public QGstreamerBufferProbe
+{
+public:
+    QGstreamerFrameCache();
+    ~QGstreamerFrameCache();
+
+    int capacity() const;
+    void setCapacity(int frames);
+
+    bool isRecording() const { return m_recording.loadAcquire(); }
+    void setRecording(bool recording) { m_recording.storeRelease(recording ? 1 : 0); }
+
+    void clear();
+
+    qint64 frameDuration() const;
+
+    QVideoFrame frameAt(qint64 time) const;
+    QVideoFrame step(qint64 time, int frames) const;
+
+protected:
+    void probeCaps(GstCaps *caps) override;
+    bool probeBuffer(GstBuffer *buffer) override;
+
+private:
+    typedef QMap<qint64, QVideoFrame>::const_iterator const_iterator;
+
+    const_iterator find(qint64 time) const;
+    qint64 endTime(const QVideoFrame &frame) const;
+    void trim();
+
+    mutable QMutex m_mutex;
+    QMap<qint64, QVideoFrame> m_frames;
+    QVideoSurfaceFormat m_format;
+#if GST_CHECK_VERSION(1,0,0)
+    GstVideoInfo m_videoInfo;
+#else
+    int m_bytesPerLine = 0;
+#endif
+    qint64 m_frameDuration = 0;
+    mutable qint64 m_playhead = 0;
+    int m_capacity = 0;
+    bool m_cacheable = false;
+    QAtomicInt m_recording;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGSTREAMERFRAMECACHE_P_H
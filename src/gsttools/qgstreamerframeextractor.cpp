@@ -0,0 +1,376 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgstreamerframeextractor_p.h"
+
+#include <private/qgstutils_p.h>
+#include <private/qgstvideobuffer_p.h>
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qrunnable.h>
+#include <qvideosurfaceformat.h>
+
+#include <gst/app/gstappsink.h>
+
+#include <algorithm>
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+enum { PlayFlagVideo = 0x00000001 };
+
+typedef std::function<void(qint64 position, const QVideoFrame &frame)> FrameCallback;
+
+// Waits for the pipeline to preroll after a state change or a flushing seek.
+bool waitForPreroll(GstElement *pipeline, int timeout, const QAtomicInt *cancelled,
+                    QString *errorString)
+{
+    GstBus *bus = gst_element_get_bus(pipeline);
+    QElapsedTimer timer;
+    timer.start();
+
+    bool prerolled = false;
+    bool failed = false;
+    while (!prerolled && !failed && !cancelled->loadAcquire()) {
+        // Wake up regularly to honour cancellation.
+        qint64 wait = 100;
+        if (timeout >= 0) {
+            wait = qMin(wait, timeout - timer.elapsed());
+            if (wait <= 0) {
+                *errorString = QGstreamerFrameExtractor::tr("Timed out while decoding");
+                break;
+            }
+        }
+
+        GstMessage *message = gst_bus_timed_pop_filtered(
+                bus, wait * GST_MSECOND, GstMessageType(GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR));
+        if (!message)
+            continue;
+
+        if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_ERROR) {
+            GError *error = nullptr;
+            gchar *debug = nullptr;
+            gst_message_parse_error(message, &error, &debug);
+            *errorString = QString::fromUtf8(error->message);
+            g_error_free(error);
+            g_free(debug);
+            failed = true;
+        } else {
+            prerolled = true;
+        }
+        gst_message_unref(message);
+    }
+
+    gst_object_unref(bus);
+    return prerolled;
+}
+
+QVideoFrame frameForSample(GstSample *sample)
+{
+    GstCaps *caps = gst_sample_get_caps(sample);
+    GstBuffer *buffer = gst_sample_get_buffer(sample);
+    if (!caps || !buffer)
+        return QVideoFrame();
+
+    GstVideoInfo info;
+    const QVideoSurfaceFormat format = QGstUtils::formatForCaps(caps, &info);
+    if (!format.isValid())
+        return QVideoFrame();
+
+    QVideoFrame frame(new QGstVideoBuffer(buffer, info), format.frameSize(), format.pixelFormat());
+    QGstUtils::setFrameTimeStamps(&frame, buffer);
+    return frame;
+}
+
+bool decodeFrames(const QUrl &url, const QList<qint64> &positions, const QSize &maximumSize,
+                  bool keyFramesOnly, int timeout, const QAtomicInt *cancelled,
+                  const FrameCallback &callback, QString *errorString)
+{
+    QGstUtils::initializeGst();
+
+    GstElement *pipeline = gst_element_factory_make(QT_GSTREAMER_PLAYBIN_ELEMENT_NAME, nullptr);
+    GstElement *scale = gst_element_factory_make("videoscale", nullptr);
+    GstElement *filter = gst_element_factory_make("capsfilter", nullptr);
+    GstElement *convert = gst_element_factory_make("videoconvert", nullptr);
+    GstElement *sink = gst_element_factory_make("appsink", nullptr);
+    if (!pipeline || !scale || !filter || !convert || !sink) {
+        for (GstElement *element : { pipeline, scale, filter, convert, sink }) {
+            if (element)
+                gst_object_unref(GST_OBJECT(element));
+        }
+        *errorString = QGstreamerFrameExtractor::tr("Could not create the decoding pipeline");
+        return false;
+    }
+
+    // The video sink is "videoscale ! capsfilter ! videoconvert ! appsink":
+    // frames are scaled to the requested size in the decoder's format, and
+    // only then converted to RGB, so large frames are never converted at
+    // full size. playbin's own converter passes them through unchanged.
+    GstCaps *caps = gst_caps_new_simple("video/x-raw",
+            "pixel-aspect-ratio", GST_TYPE_FRACTION, 1, 1,
+            nullptr);
+    if (maximumSize.isValid()) {
+        gst_caps_set_simple(caps,
+                "width", GST_TYPE_INT_RANGE, 1, qMax(1, maximumSize.width()),
+                "height", GST_TYPE_INT_RANGE, 1, qMax(1, maximumSize.height()),
+                nullptr);
+    }
+    g_object_set(G_OBJECT(filter), "caps", caps, nullptr);
+    gst_caps_unref(caps);
+
+    caps = gst_caps_new_simple("video/x-raw",
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+            "format", G_TYPE_STRING, "BGRx",
+#else
+            "format", G_TYPE_STRING, "xRGB",
+#endif
+            nullptr);
+    g_object_set(G_OBJECT(sink),
+            "caps", caps,
+            "sync", FALSE,
+            "max-buffers", 1,
+            "drop", TRUE,
+            "enable-last-sample", FALSE,
+            nullptr);
+    gst_caps_unref(caps);
+
+    GstElement *videoSink = gst_bin_new(nullptr);
+    gst_bin_add_many(GST_BIN(videoSink), scale, filter, convert, sink, nullptr);
+    gst_element_link_many(scale, filter, convert, sink, nullptr);
+    GstPad *pad = gst_element_get_static_pad(scale, "sink");
+    gst_element_add_pad(videoSink, gst_ghost_pad_new("sink", pad));
+    gst_object_unref(GST_OBJECT(pad));
+
+    // Audio and subtitles are not decoded at all.
+    g_object_set(G_OBJECT(pipeline),
+            "uri", url.toEncoded().constData(),
+            "video-sink", videoSink,
+            "flags", PlayFlagVideo,
+            nullptr);
+
+    gst_element_set_state(pipeline, GST_STATE_PAUSED);
+    bool ok = waitForPreroll(pipeline, timeout, cancelled, errorString);
+
+    if (ok) {
+        gint videoStreams = 0;
+        g_object_get(G_OBJECT(pipeline), "n-video", &videoStreams, nullptr);
+        if (videoStreams == 0) {
+            *errorString = QGstreamerFrameExtractor::tr("The media has no video stream");
+            ok = false;
+        }
+    }
+
+    // Seek forwards only; the caller gets the frames in ascending order.
+    QList<qint64> sorted = positions;
+    std::sort(sorted.begin(), sorted.end());
+
+    const GstSeekFlags seekFlags = GstSeekFlags(GST_SEEK_FLAG_FLUSH | (keyFramesOnly
+            ? GST_SEEK_FLAG_KEY_UNIT | GST_SEEK_FLAG_SNAP_NEAREST
+            : GST_SEEK_FLAG_ACCURATE));
+
+    QVideoFrame frame;
+    qint64 framePosition = -1;
+    for (int i = 0; ok && i < sorted.size(); ++i) {
+        const qint64 position = qMax<qint64>(0, sorted.at(i));
+        if (position != framePosition) {
+            frame = QVideoFrame();
+            framePosition = position;
+
+            if (gst_element_seek_simple(pipeline, GST_FORMAT_TIME, seekFlags, position * GST_MSECOND)) {
+                ok = waitForPreroll(pipeline, timeout, cancelled, errorString);
+                if (!ok)
+                    break;
+
+                if (GstSample *sample = gst_app_sink_pull_preroll(GST_APP_SINK(sink))) {
+                    frame = frameForSample(sample);
+                    gst_sample_unref(sample);
+                }
+            }
+        }
+
+        callback(sorted.at(i), frame);
+    }
+
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(GST_OBJECT(pipeline));
+
+    return ok;
+}
+
+}
+
+class QGstreamerFrameExtractorJob : public QRunnable
+{
+public:
+    QGstreamerFrameExtractorJob(QGstreamerFrameExtractor *extractor, int id, const QUrl &url,
+                                const QList<qint64> &positions,
+                                const QSharedPointer<QAtomicInt> &cancelled)
+        : m_extractor(extractor)
+        , m_url(url)
+        , m_positions(positions)
+        , m_maximumSize(extractor->maximumSize())
+        , m_cancelled(cancelled)
+        , m_id(id)
+        , m_timeout(extractor->timeout())
+        , m_keyFramesOnly(extractor->keyFramesOnly())
+    {
+    }
+
+    void run() override
+    {
+        QString errorString;
+        if (!m_cancelled->loadAcquire()) {
+            decodeFrames(m_url, m_positions, m_maximumSize, m_keyFramesOnly, m_timeout, m_cancelled.data(),
+                    [this](qint64 position, const QVideoFrame &frame) {
+                        emit m_extractor->frameExtracted(m_id, position, frame);
+                    },
+                    &errorString);
+        }
+
+        if (!errorString.isEmpty() && !m_cancelled->loadAcquire())
+            emit m_extractor->error(m_id, errorString);
+
+        m_extractor->jobDone(m_id);
+        emit m_extractor->finished(m_id);
+    }
+
+private:
+    QGstreamerFrameExtractor *m_extractor;
+    QUrl m_url;
+    QList<qint64> m_positions;
+    QSize m_maximumSize;
+    QSharedPointer<QAtomicInt> m_cancelled;
+    int m_id;
+    int m_timeout;
+    bool m_keyFramesOnly;
+};
+
+QGstreamerFrameExtractor::QGstreamerFrameExtractor(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<QVideoFrame>();
+    QGstUtils::initializeGst();
+}
+
+QGstreamerFrameExtractor::~QGstreamerFrameExtractor()
+{
+    cancelAll();
+    m_pool.waitForDone();
+}
+
+int QGstreamerFrameExtractor::maximumJobCount() const
+{
+    return m_pool.maxThreadCount();
+}
+
+void QGstreamerFrameExtractor::setMaximumJobCount(int count)
+{
+    m_pool.setMaxThreadCount(count);
+}
+
+// Queues extraction of the frames at the given positions (in milliseconds)
+// and returns the job id. frameExtracted() is emitted once per position, in
+// ascending order, with an invalid frame for positions that could not be
+// decoded; finished() is emitted last, also for failed and cancelled jobs.
+int QGstreamerFrameExtractor::extract(const QUrl &url, const QList<qint64> &positions)
+{
+    QSharedPointer<QAtomicInt> cancelled(new QAtomicInt(0));
+
+    int id;
+    {
+        QMutexLocker locker(&m_mutex);
+        id = m_nextJob++;
+        m_cancelFlags.insert(id, cancelled);
+    }
+
+    m_pool.start(new QGstreamerFrameExtractorJob(this, id, url, positions, cancelled));
+    return id;
+}
+
+void QGstreamerFrameExtractor::cancel(int job)
+{
+    QMutexLocker locker(&m_mutex);
+    if (QSharedPointer<QAtomicInt> cancelled = m_cancelFlags.value(job))
+        cancelled->storeRelease(1);
+}
+
+void QGstreamerFrameExtractor::cancelAll()
+{
+    QMutexLocker locker(&m_mutex);
+    for (const QSharedPointer<QAtomicInt> &cancelled : qAsConst(m_cancelFlags))
+        cancelled->storeRelease(1);
+}
+
+bool QGstreamerFrameExtractor::waitForDone(int msecs)
+{
+    return m_pool.waitForDone(msecs);
+}
+
+void QGstreamerFrameExtractor::jobDone(int job)
+{
+    QMutexLocker locker(&m_mutex);
+    m_cancelFlags.remove(job);
+}
+
+QList<QVideoFrame> QGstreamerFrameExtractor::extractFrames(const QUrl &url,
+                                                           const QList<qint64> &positions,
+                                                           const QSize &maximumSize,
+                                                           bool keyFramesOnly, int timeout,
+                                                           QString *errorString)
+{
+    QHash<qint64, QVideoFrame> frames;
+    const QAtomicInt cancelled(0);
+    QString error;
+    decodeFrames(url, positions, maximumSize, keyFramesOnly, timeout, &cancelled,
+            [&frames](qint64 position, const QVideoFrame &frame) { frames.insert(position, frame); },
+            &error);
+
+    if (errorString)
+        *errorString = error;
+
+    QList<QVideoFrame> result;
+    result.reserve(positions.size());
+    for (qint64 position : positions)
+        result.append(frames.value(position));
+    return result;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,128 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGSTREAMERFRAMEEXTRACTOR_P_H
+#define QGSTREAMERFRAMEEXTRACTOR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qgsttools_global_p.h>
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qsize.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qurl.h>
+#include <qvideoframe.h>
+
+QT_BEGIN_NAMESPACE
+
+// Decodes still frames (poster frames, scrubbing strips) from media files
+// without a playback pipeline: each file gets a video-only playbin with an
+// unsynchronized appsink, frames are scaled down before conversion and
+// pulled as preroll buffers after each seek. Files are processed
+// concurrently on the extractor's own thread pool; results are reported in
+// Format_RGB32 memory frames, so QVideoFrame::image() does not convert.
+class Q_GSTTOOLS_EXPORT QGstreamerFrameExtractor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QGstreamerFrameExtractor(QObject *parent = nullptr);
+    ~QGstreamerFrameExtractor();
+
+    int maximumJobCount() const;
+    void setMaximumJobCount(int count);
+
+    // Settings for jobs queued afterwards.
+    QSize maximumSize() const { return m_maximumSize; }
+    void setMaximumSize(const QSize &size) { m_maximumSize = size; }
+
+    bool keyFramesOnly() const { return m_keyFramesOnly; }
+    void setKeyFramesOnly(bool keyFramesOnly) { m_keyFramesOnly = keyFramesOnly; }
+
+    int timeout() const { return m_timeout; }
+    void setTimeout(int msecs) { m_timeout = msecs; }
+
+    int extract(const QUrl &url, const QList<qint64> &positions);
+    void cancel(int job);
+    void cancelAll();
+    bool waitForDone(int msecs = -1);
+
+    // Blocking variant, usable from any thread. Positions are in
+    // milliseconds; frames that could not be decoded are invalid.
+    static QList<QVideoFrame> extractFrames(const QUrl &url, const QList<qint64> &positions,
+                                            const QSize &maximumSize = QSize(),
+                                            bool keyFramesOnly = true, int timeout = 10000,
+                                            QString *errorString = nullptr);
+
+Q_SIGNALS:
+    void frameExtracted(int job, qint64 position, const QVideoFrame &frame);
+    void finished(int job);
+    void error(int job, const QString &errorString);
+
+private:
+    friend class QGstreamerFrameExtractorJob;
+
+    void jobDone(int job);
+
+    QThreadPool m_pool;
+    QMutex m_mutex;
+    QHash<int, QSharedPointer<QAtomicInt>> m_cancelFlags;
+    QSize m_maximumSize;
+    int m_timeout = 10000;
+    int m_nextJob = 1;
+    bool m_keyFramesOnly = true;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGSTREAMERFRAMEEXTRACTOR_P_H
@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGSTREAMERPLAYBACKCLOCK_P_H
+#define QGSTREAMERPLAYBACKCLOCK_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qglobal.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+// Interpolated playback position.
+//
+// The session anchors the clock to a position it queried from the pipeline,
+// together with the running state and rate. Readers extrapolate from the
+// anchor with a monotonic timer, so position() costs a few atomic loads and
+// can be called from any thread, e.g. once per rendered frame. Small
+// corrections when re-anchoring never move the reported position backwards;
+// it holds still until the pipeline catches up instead.
+//
+// There is a single writer (the session's thread); the anchor is published
+// with a sequence lock.
+class QGstreamerPlaybackClock
+{
+public:
+    // Corrections larger than this are treated as a jump, not as drift.
+    static const qint64 MaximumSlewNs = Q_INT64_C(100000000);
+
+    QGstreamerPlaybackClock()
+    {
+        m_timer.start();
+        reset(0);
+    }
+
+    // Sets the position outright, for seeks, stops and new media.
+    void reset(qint64 positionNs, bool running = false, qreal rate = 1.0)
+    {
+        publish(positionNs, positionNs, running, rate);
+    }
+
+    // Re-anchors to a freshly queried position. While running, the reported
+    // position is kept monotonic; a stopped clock reports the queried
+    // position as is.
+    void update(qint64 positionNs, bool running, qreal rate)
+    {
+        const qint64 current = position();
+        const bool slew = running && qAbs(positionNs - current) < MaximumSlewNs;
+        const qint64 floor = slew ? current : positionNs;
+        publish(positionNs, floor, running, rate);
+    }
+
+    qint64 position() const
+    {
+        qint64 anchor, time, floor, rateBits;
+        int running;
+        quint32 sequence;
+        do {
+            sequence = m_sequence.loadAcquire();
+            anchor = m_anchorPosition.loadAcquire();
+            time = m_anchorTime.loadAcquire();
+            floor = m_floor.loadAcquire();
+            rateBits = m_rateBits.loadAcquire();
+            running = m_running.loadAcquire();
+        } while ((sequence & 1) || sequence != m_sequence.loadAcquire());
+
+        if (!running)
+            return qMax<qint64>(0, floor);
+
+        double rate;
+        memcpy(&rate, &rateBits, sizeof(rate));
+        const qint64 position = anchor + qint64((m_timer.nsecsElapsed() - time) * rate);
+        return qMax<qint64>(0, rate >= 0 ? qMax(position, floor) : qMin(position, floor));
+    }
+
+    bool isRunning() const { return m_running.loadAcquire(); }
+
+    // Time since the clock was last anchored.
+    qint64 anchorAge() const { return m_timer.nsecsElapsed() - m_anchorTime.loadAcquire(); }
+
+private:
+    void publish(qint64 positionNs, qint64 floorNs, bool running, qreal rate)
+    {
+        double value = rate;
+        qint64 rateBits;
+        memcpy(&rateBits, &value, sizeof(rateBits));
+
+        m_sequence.fetchAndAddOrdered(1);
+        m_anchorPosition.storeRelease(positionNs);
+        m_anchorTime.storeRelease(m_timer.nsecsElapsed());
+        m_floor.storeRelease(floorNs);
+        m_rateBits.storeRelease(rateBits);
+        m_running.storeRelease(running ? 1 : 0);
+        m_sequence.fetchAndAddOrdered(1);
+    }
+
+    QElapsedTimer m_timer;
+    QAtomicInteger<quint32> m_sequence;
+    QAtomicInteger<qint64> m_anchorPosition;
+    QAtomicInteger<qint64> m_anchorTime;
+    QAtomicInteger<qint64> m_floor;
+    QAtomicInteger<qint64> m_rateBits;
+    QAtomicInt m_running;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGSTREAMERPLAYBACKCLOCK_P_H
@@ -43,6 +43,7 @@
 #include <private/qgstreameraudioprobecontrol_p.h>
 #include <private/qgstreamervideoprobecontrol_p.h>
 #include <private/qgstreamervideorendererinterface_p.h>
+#include <private/qgstreamervideorenderer_p.h>
 #if !GST_CHECK_VERSION(1,0,0)
 #include <private/gstvideoconnector_p.h>
 #endif
@@ -61,12 +62,16 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qstandardpaths.h>
 #include <qvideorenderercontrol.h>
+#include <qabstractvideosurface.h>
 #include <QUrlQuery>
 
 //#define DEBUG_PLAYBIN
 
 QT_BEGIN_NAMESPACE
 
+// How long the interpolated position runs before it is checked against the pipeline.
+static const qint64 clockResyncIntervalNs = Q_INT64_C(250000000);
+
 static bool usePlaybinVolume()
 {
     static enum { Yes, No, Unknown } status = Unknown;
@@ -237,6 +242,7 @@ QGstreamerPlayerSession::~QGstreamerPlayerSession()
         stop();
 
         removeVideoBufferProbe();
+        removeFrameCacheProbe();
         removeAudioBufferProbe();
 
         delete m_busHelper;
@@ -305,6 +311,10 @@ void QGstreamerPlayerSession::loadFromStream(const QNetworkRequest &request, QIO
     m_request = request;
     m_duration = 0;
     m_lastPosition = 0;
+    m_clock.reset(0);
+    m_frameCache.clear();
+    m_pendingStep = 0;
+    m_cachedFramePosition = -1;
 
     if (!m_appSrc)
         m_appSrc = new QGstAppSrc(this);
@@ -334,6 +344,10 @@ void QGstreamerPlayerSession::loadFromUri(const QNetworkRequest &request)
     m_request = request;
     m_duration = 0;
     m_lastPosition = 0;
+    m_clock.reset(0);
+    m_frameCache.clear();
+    m_pendingStep = 0;
+    m_cachedFramePosition = -1;
 
 #if QT_CONFIG(gstreamer_app)
     if (m_appSrc) {
@@ -474,13 +488,28 @@ qint64 QGstreamerPlayerSession::duration() const
 
 qint64 QGstreamerPlayerSession::position() const
 {
-    gint64      position = 0;
+    // The position is interpolated from the last anchor; the pipeline is only
+    // queried now and then while playing to correct drift.
+    if (m_pipeline && m_clock.isRunning() && m_clock.anchorAge() > clockResyncIntervalNs)
+        resyncClock();
+
+    qint64 position = m_clock.position() / 1000000;
+    if (m_duration > 0)
+        position = qMin(position, m_duration);
 
-    if (m_pipeline && qt_gst_element_query_position(m_pipeline, GST_FORMAT_TIME, &position))
-        m_lastPosition = position / 1000000;
+    m_lastPosition = position;
     return m_lastPosition;
 }
 
+void QGstreamerPlayerSession::resyncClock() const
+{
+    gint64 position = 0;
+    if (!m_pipeline || !qt_gst_element_query_position(m_pipeline, GST_FORMAT_TIME, &position))
+        position = m_clock.position();
+
+    m_clock.update(position, m_state == QMediaPlayer::PlayingState, m_playbackRate);
+}
+
 qreal QGstreamerPlayerSession::playbackRate() const
 {
     return m_playbackRate;
@@ -493,6 +522,7 @@ void QGstreamerPlayerSession::setPlaybackRate(qreal rate)
 #endif
     if (!qFuzzyCompare(m_playbackRate, rate)) {
         m_playbackRate = rate;
+        m_clock.update(m_clock.position(), m_state == QMediaPlayer::PlayingState, rate);
         if (m_pipeline && m_seekable) {
             gst_element_seek(m_pipeline, rate, GST_FORMAT_TIME,
                              GstSeekFlags(GST_SEEK_FLAG_FLUSH),
@@ -719,6 +749,7 @@ void QGstreamerPlayerSession::setVideoRenderer(QObject *videoOutput)
 #endif
 
         removeVideoBufferProbe();
+        removeFrameCacheProbe();
 
         gst_bin_remove(GST_BIN(m_videoOutputBin), m_videoSink);
 
@@ -748,6 +779,7 @@ void QGstreamerPlayerSession::setVideoRenderer(QObject *videoOutput)
         }
 
         addVideoBufferProbe();
+        addFrameCacheProbe();
 
         switch (m_pendingState) {
         case QMediaPlayer::PausedState:
@@ -852,6 +884,7 @@ void QGstreamerPlayerSession::finishVideoOutputChange()
     }
 
     removeVideoBufferProbe();
+    removeFrameCacheProbe();
 
     gst_bin_remove(GST_BIN(m_videoOutputBin), m_videoSink);
 
@@ -861,6 +894,7 @@ void QGstreamerPlayerSession::finishVideoOutputChange()
     gst_bin_add(GST_BIN(m_videoOutputBin), m_videoSink);
 
     addVideoBufferProbe();
+    addFrameCacheProbe();
 
     bool linked = gst_element_link(m_videoIdentity, m_videoSink);
 #if !GST_CHECK_VERSION(1,0,0)
@@ -1007,6 +1041,8 @@ bool QGstreamerPlayerSession::play()
     m_everPlayed = false;
     if (m_pipeline) {
         m_pendingState = QMediaPlayer::PlayingState;
+        m_pendingStep = 0;
+        seekToCachedFrame();
         if (gst_element_set_state(m_pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
             qWarning() << "GStreamer; Unable to play -" << m_request.url().toString();
             m_pendingState = m_state = QMediaPlayer::StoppedState;
@@ -1058,6 +1094,10 @@ void QGstreamerPlayerSession::stop()
         gst_element_set_state(m_pipeline, GST_STATE_NULL);
 
         m_lastPosition = 0;
+        m_clock.reset(0);
+        m_frameCache.clear();
+        m_pendingStep = 0;
+        m_cachedFramePosition = -1;
         QMediaPlayer::State oldState = m_state;
         m_pendingState = m_state = QMediaPlayer::StoppedState;
 
@@ -1078,15 +1118,7 @@ bool QGstreamerPlayerSession::seek(qint64 ms)
     //seek locks when the video output sink is changing and pad is blocked
     if (m_pipeline && !m_pendingVideoSink && m_state != QMediaPlayer::StoppedState && m_seekable) {
         ms = qMax(ms,qint64(0));
-        gint64  position = ms * 1000000;
-        bool isSeeking = gst_element_seek(m_pipeline,
-                                          m_playbackRate,
-                                          GST_FORMAT_TIME,
-                                          GstSeekFlags(GST_SEEK_FLAG_FLUSH),
-                                          GST_SEEK_TYPE_SET,
-                                          position,
-                                          GST_SEEK_TYPE_NONE,
-                                          0);
+        bool isSeeking = seekTo(ms * 1000000, m_accurateSeek);
         if (isSeeking)
             m_lastPosition = ms;
 
@@ -1096,6 +1128,109 @@ bool QGstreamerPlayerSession::seek(qint64 ms)
     return false;
 }
 
+bool QGstreamerPlayerSession::seekTo(qint64 positionNs, bool accurate)
+{
+    // An accurate seek decodes from the preceding key frame up to the exact
+    // position instead of presenting the key frame.
+    const GstSeekFlags flags = accurate
+            ? GstSeekFlags(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE)
+            : GstSeekFlags(GST_SEEK_FLAG_FLUSH);
+
+    if (!gst_element_seek(m_pipeline, m_playbackRate, GST_FORMAT_TIME, flags,
+                          GST_SEEK_TYPE_SET, positionNs, GST_SEEK_TYPE_NONE, 0)) {
+        return false;
+    }
+
+    m_cachedFramePosition = -1;
+    m_clock.reset(positionNs, m_state == QMediaPlayer::PlayingState, m_playbackRate);
+    return true;
+}
+
+bool QGstreamerPlayerSession::step(int frames)
+{
+#ifdef DEBUG_PLAYBIN
+    qDebug() << Q_FUNC_INFO << frames;
+#endif
+    if (!m_pipeline || !m_videoAvailable || frames == 0)
+        return false;
+
+    // Steps are only exact on a paused pipeline; while a pause is in
+    // progress they are accumulated and applied once it completes.
+    if (m_state != QMediaPlayer::PausedState || m_pendingStep != 0) {
+        if (m_state == QMediaPlayer::StoppedState || m_pendingState != QMediaPlayer::PausedState)
+            return false;
+        m_pendingStep += frames;
+        return true;
+    }
+
+    return stepPaused(frames);
+}
+
+bool QGstreamerPlayerSession::stepPaused(int frames)
+{
+    const qint64 current = m_cachedFramePosition >= 0
+            ? m_cachedFramePosition
+            : m_clock.position() / 1000;
+
+    // Within the cached frames the pipeline is left where it is; it only
+    // catches up when playback resumes or the cache runs out.
+    const QVideoFrame cached = m_frameCache.step(current, frames);
+    if (cached.isValid() && presentCachedFrame(cached)) {
+        m_cachedFramePosition = cached.startTime();
+        m_clock.reset(cached.startTime() * 1000);
+        emit positionChanged(cached.startTime() / 1000);
+        return true;
+    }
+
+#if GST_CHECK_VERSION(0,10,24)
+    // Stepping forwards from the pipeline's own position only decodes the
+    // next frames. The event goes to the video sink alone, so audio doesn't
+    // advance by a number of audio buffers.
+    if (frames > 0 && m_cachedFramePosition < 0 && m_videoSink) {
+        GstEvent *event = gst_event_new_step(GST_FORMAT_BUFFERS, frames, 1.0, TRUE, FALSE);
+        if (gst_element_send_event(m_videoSink, event))
+            return true;
+    }
+#endif
+
+    const qint64 frameDuration = m_frameCache.frameDuration();
+    if (!m_seekable || m_pendingVideoSink || frameDuration <= 0)
+        return false;
+
+    // Aim at the middle of the frame, so that rounding of the time stamps
+    // can't land on its predecessor.
+    const qint64 target = qMax<qint64>(0, current + frames * frameDuration) + frameDuration / 2;
+    return seekTo(target * 1000, true);
+}
+
+bool QGstreamerPlayerSession::presentCachedFrame(const QVideoFrame &frame)
+{
+    // Cached frames can only be shown on a surface, and only if the surface
+    // still expects frames of the same format.
+    QGstreamerVideoRenderer *renderer = qobject_cast<QGstreamerVideoRenderer *>(m_videoOutput);
+    QAbstractVideoSurface *surface = renderer ? renderer->surface() : nullptr;
+    if (!surface || !surface->isActive())
+        return false;
+
+    const QVideoSurfaceFormat format = surface->surfaceFormat();
+    if (format.pixelFormat() != frame.pixelFormat() || format.frameSize() != frame.size())
+        return false;
+
+    return surface->present(frame);
+}
+
+// Moves the pipeline to the cached frame being shown, if any.
+bool QGstreamerPlayerSession::seekToCachedFrame()
+{
+    if (m_cachedFramePosition < 0)
+        return false;
+
+    const qint64 position = m_cachedFramePosition + m_frameCache.frameDuration() / 2;
+    m_cachedFramePosition = -1;
+
+    return m_seekable && seekTo(position * 1000, true);
+}
+
 void QGstreamerPlayerSession::setVolume(int volume)
 {
 #ifdef DEBUG_PLAYBIN
@@ -1241,15 +1376,26 @@ bool QGstreamerPlayerSession::processBusMessage(const QGstreamerMessage &message
                             }
                         }
 
+                        resyncClock();
+                        m_frameCache.setRecording(true);
                         if (m_state != prevState)
                             emit stateChanged(m_state);
 
+                        if (m_pendingStep != 0 && m_pendingState == QMediaPlayer::PausedState) {
+                            const int frames = m_pendingStep;
+                            m_pendingStep = 0;
+                            stepPaused(frames);
+                        }
+
                         break;
                     }
                     case GST_STATE_PLAYING:
                         m_everPlayed = true;
+                        m_frameCache.setRecording(false);
                         if (m_state != QMediaPlayer::PlayingState) {
-                            emit stateChanged(m_state = QMediaPlayer::PlayingState);
+                            m_state = QMediaPlayer::PlayingState;
+                            resyncClock();
+                            emit stateChanged(m_state);
 
                             // For rtsp streams duration information might not be available
                             // until playback starts.
@@ -1265,6 +1411,7 @@ bool QGstreamerPlayerSession::processBusMessage(const QGstreamerMessage &message
                 break;
 
             case GST_MESSAGE_EOS:
+                m_clock.update(m_clock.position(), false, m_playbackRate);
                 emit playbackFinished();
                 break;
 
@@ -1321,6 +1468,7 @@ bool QGstreamerPlayerSession::processBusMessage(const QGstreamerMessage &message
                 {
                     const GstStructure *structure = gst_message_get_structure(gm);
                     qint64 position = g_value_get_int64(gst_structure_get_value(structure, "position"));
+                    m_clock.reset(position, m_state == QMediaPlayer::PlayingState, m_playbackRate);
                     position /= 1000000;
                     m_lastPosition = position;
                     emit positionChanged(position);
@@ -1336,6 +1484,7 @@ bool QGstreamerPlayerSession::processBusMessage(const QGstreamerMessage &message
             {
                 gint64      position = 0;
                 if (qt_gst_element_query_position(m_pipeline, GST_FORMAT_TIME, &position)) {
+                    m_clock.reset(position, m_state == QMediaPlayer::PlayingState, m_playbackRate);
                     position /= 1000000;
                     m_lastPosition = position;
                     emit positionChanged(position);
@@ -1351,6 +1500,15 @@ bool QGstreamerPlayerSession::processBusMessage(const QGstreamerMessage &message
             default:
                 break;
             }
+        } else if (GST_MESSAGE_TYPE(gm) == GST_MESSAGE_STEP_DONE) {
+            // Posted by the video sink once a frame step has completed.
+            gint64 position = 0;
+            if (qt_gst_element_query_position(m_pipeline, GST_FORMAT_TIME, &position)) {
+                m_clock.reset(position, m_state == QMediaPlayer::PlayingState, m_playbackRate);
+                position /= 1000000;
+                m_lastPosition = position;
+                emit positionChanged(position);
+            }
         } else if (GST_MESSAGE_TYPE(gm) == GST_MESSAGE_ERROR) {
             GError *err;
             gchar *debug;
@@ -1938,6 +2096,7 @@ void QGstreamerPlayerSession::endOfMediaReset()
 
     QMediaPlayer::State oldState = m_state;
     m_pendingState = m_state = QMediaPlayer::StoppedState;
+    m_clock.update(m_clock.position(), false, m_playbackRate);
 
     finishVideoOutputChange();
 
@@ -1969,6 +2128,24 @@ void QGstreamerPlayerSession::addVideoBufferProbe()
     }
 }
 
+void QGstreamerPlayerSession::removeFrameCacheProbe()
+{
+    GstPad *pad = gst_element_get_static_pad(m_videoSink, "sink");
+    if (pad) {
+        m_frameCache.removeProbeFromPad(pad);
+        gst_object_unref(GST_OBJECT(pad));
+    }
+}
+
+void QGstreamerPlayerSession::addFrameCacheProbe()
+{
+    GstPad *pad = gst_element_get_static_pad(m_videoSink, "sink");
+    if (pad) {
+        m_frameCache.addProbeToPad(pad);
+        gst_object_unref(GST_OBJECT(pad));
+    }
+}
+
 void QGstreamerPlayerSession::removeAudioBufferProbe()
 {
     if (!m_audioProbe)
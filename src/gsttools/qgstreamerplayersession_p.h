@@ -57,6 +57,8 @@
 #include <QtNetwork/qnetworkrequest.h>
 #include <private/qgstreamerplayercontrol_p.h>
 #include <private/qgstreamerbushelper_p.h>
+#include <private/qgstreamerplaybackclock_p.h>
+#include <private/qgstreamerframecache_p.h>
 #include <qmediaplayer.h>
 #include <qmediastreamscontrol.h>
 #include <qaudioformat.h>
@@ -104,6 +106,7 @@ public:
 
     qint64 duration() const;
     qint64 position() const;
+    const QGstreamerPlaybackClock *playbackClock() const { return &m_clock; }
 
     int volume() const;
     bool isMuted() const;
@@ -119,6 +122,12 @@ public:
     qreal playbackRate() const;
     void setPlaybackRate(qreal rate);
 
+    bool isAccurateSeekEnabled() const { return m_accurateSeek; }
+    void setAccurateSeekEnabled(bool enabled) { m_accurateSeek = enabled; }
+
+    int frameCacheSize() const { return m_frameCache.capacity(); }
+    void setFrameCacheSize(int frames) { m_frameCache.setCapacity(frames); }
+
     QMediaTimeRange availablePlaybackRanges() const;
 
     QMap<QByteArray ,QVariant> tags() const { return m_tags; }
@@ -154,6 +163,7 @@ public slots:
     void stop();
 
     bool seek(qint64 pos);
+    bool step(int frames);
 
     void setVolume(int volume);
     void setMuted(bool muted);
@@ -201,9 +211,16 @@ private:
     static GstAutoplugSelectResult handleAutoplugSelect(GstBin *bin, GstPad *pad, GstCaps *caps, GstElementFactory *factory, QGstreamerPlayerSession *session);
 
     void processInvalidMedia(QMediaPlayer::Error errorCode, const QString& errorString);
+    void resyncClock() const;
+    bool seekTo(qint64 positionNs, bool accurate);
+    bool stepPaused(int frames);
+    bool presentCachedFrame(const QVideoFrame &frame);
+    bool seekToCachedFrame();
 
     void removeVideoBufferProbe();
     void addVideoBufferProbe();
+    void removeFrameCacheProbe();
+    void addFrameCacheProbe();
     void removeAudioBufferProbe();
     void addAudioBufferProbe();
     void flushVideoProbes();
@@ -259,6 +276,14 @@ private:
     bool m_seekable = false;
 
     mutable qint64 m_lastPosition = 0;
+    mutable QGstreamerPlaybackClock m_clock;
+
+    QGstreamerFrameCache m_frameCache;
+    bool m_accurateSeek = false;
+    int m_pendingStep = 0;
+    // Start time in microseconds of a cached frame presented while the
+    // pipeline is still at its previous position, or -1.
+    qint64 m_cachedFramePosition = -1;
     qint64 m_duration = 0;
     int m_durationQueries = 0;
 
@@ -41,6 +41,8 @@
 
 QT_BEGIN_NAMESPACE
 
+QT_MULTIMEDIA_DEFINE_POOLED_ALLOCATOR(QGstVideoBuffer, gstVideoBufferPool)
+
 #if GST_CHECK_VERSION(1,0,0)
 QGstVideoBuffer::QGstVideoBuffer(GstBuffer *buffer, const GstVideoInfo &info)
     : QAbstractPlanarVideoBuffer(NoHandle)
@@ -52,6 +52,7 @@
 //
 
 #include <private/qgsttools_global_p.h>
+#include <private/qmultimediaobjectpool_p.h>
 #include <qabstractvideobuffer.h>
 #include <QtCore/qvariant.h>
 
@@ -90,6 +91,10 @@ public:
     void unmap() override;
 
     QVariant handle() const override { return m_handle; }
+
+    // One buffer is created for every frame rendered or probed
+    QT_MULTIMEDIA_DECLARE_POOLED_ALLOCATOR
+
 private:
 #if GST_CHECK_VERSION(1,0,0)
     GstVideoInfo m_videoInfo;
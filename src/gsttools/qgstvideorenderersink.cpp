@@ -54,6 +54,10 @@
 
 #include "qgstutils_p.h"
 
+#if QT_CONFIG(gstreamer_dmabuf)
+#include "qgstdmabufvideobuffer_p.h"
+#endif
+
 #if QT_CONFIG(gstreamer_gl)
 #include <QOpenGLContext>
 #include <QGuiApplication>
@@ -106,6 +110,25 @@ GstCaps *QGstDefaultVideoRenderer::getCaps(QAbstractVideoSurface *surface)
 
         return caps;
     }
+#endif
+#if QT_CONFIG(gstreamer_dmabuf)
+    // Prefer importing dmabufs from hardware decoders over copying them,
+    // and fall back to system memory for other upstream elements.
+    if (QGstDmaBufVideoBuffer::isSupported()) {
+        GstCaps *caps = QGstUtils::capsForFormats(
+                    surface->supportedPixelFormats(QAbstractVideoBuffer::EGLImageHandle));
+        QGstDmaBufVideoBuffer::removeUnsupportedFormats(caps);
+        if (gst_caps_is_empty(caps)) {
+            gst_caps_unref(caps);
+        } else {
+            for (guint i = 0; i < gst_caps_get_size(caps); ++i)
+                gst_caps_set_features(caps, i, gst_caps_features_from_string("memory:DMABuf"));
+
+            gst_caps_append(caps, QGstUtils::capsForFormats(
+                    surface->supportedPixelFormats(QAbstractVideoBuffer::NoHandle)));
+            return caps;
+        }
+    }
 #endif
     return QGstUtils::capsForFormats(surface->supportedPixelFormats(QAbstractVideoBuffer::NoHandle));
 }
@@ -113,6 +136,13 @@ GstCaps *QGstDefaultVideoRenderer::getCaps(QAbstractVideoSurface *surface)
 bool QGstDefaultVideoRenderer::start(QAbstractVideoSurface *surface, GstCaps *caps)
 {
     m_flushed = true;
+#if QT_CONFIG(gstreamer_dmabuf)
+    GstCapsFeatures *features = gst_caps_get_size(caps) > 0 ? gst_caps_get_features(caps, 0) : nullptr;
+    if (features && gst_caps_features_contains(features, "memory:DMABuf"))
+        m_handleType = QAbstractVideoBuffer::EGLImageHandle;
+    else if (m_handleType == QAbstractVideoBuffer::EGLImageHandle)
+        m_handleType = QAbstractVideoBuffer::NoHandle;
+#endif
     m_format = QGstUtils::formatForCaps(caps, &m_videoInfo, m_handleType);
 
     return m_format.isValid() && surface->start(m_format);
@@ -137,6 +167,12 @@ bool QGstDefaultVideoRenderer::present(QAbstractVideoSurface *surface, GstBuffer
         videoBuffer = new QGstVideoBuffer(buffer, m_videoInfo, m_format.handleType(), textureId);
     }
 #endif
+#if QT_CONFIG(gstreamer_dmabuf)
+    if (m_format.handleType() == QAbstractVideoBuffer::EGLImageHandle
+            && QGstDmaBufVideoBuffer::isDmaBuf(buffer)) {
+        videoBuffer = new QGstDmaBufVideoBuffer(buffer, m_videoInfo);
+    }
+#endif
 
     if (!videoBuffer)
         videoBuffer = new QGstVideoBuffer(buffer, m_videoInfo);
@@ -178,8 +214,9 @@ bool QGstDefaultVideoRenderer::proposeAllocation(GstQuery *)
 Q_GLOBAL_STATIC_WITH_ARGS(QMediaPluginLoader, rendererLoader,
         (QGstVideoRendererInterface_iid, QLatin1String("video/gstvideorenderer"), Qt::CaseInsensitive))
 
-QVideoSurfaceGstDelegate::QVideoSurfaceGstDelegate(QAbstractVideoSurface *surface)
+QVideoSurfaceGstDelegate::QVideoSurfaceGstDelegate(QAbstractVideoSurface *surface, GstElement *sink)
     : m_surface(surface)
+    , m_sink(sink)
 {
     const auto instances = rendererLoader()->instances(QGstVideoRendererPluginKey);
     for (QObject *instance : instances) {
@@ -207,12 +244,82 @@ QVideoSurfaceGstDelegate::~QVideoSurfaceGstDelegate()
 #endif
 }
 
+bool QVideoSurfaceGstDelegate::eventFilter(QObject *object, QEvent *event)
+{
+    if (object == m_surface && event->type() == QEvent::DynamicPropertyChange
+            && static_cast<QDynamicPropertyChangeEvent *>(event)->propertyName() == "_q_preferredSize") {
+        updateSupportedFormats();
+
+        // Let upstream pick a new frame size for the changed caps.
+        if (m_sink)
+            gst_pad_push_event(GST_BASE_SINK_PAD(m_sink), gst_event_new_reconfigure());
+    }
+
+    return QObject::eventFilter(object, event);
+}
+
+// Prefers frames no larger than the size the surface displays them at, so
+// that an upstream scaler can shrink them before they are rendered. The
+// unrestricted caps are kept as a fallback for sources that cannot scale.
+static GstCaps *capsForPreferredSize(GstCaps *caps, const QSize &size)
+{
+    if (!size.isValid() || size.width() < 2 || size.height() < 2)
+        return caps;
+
+    GstCaps *preferred = gst_caps_copy(caps);
+    for (guint i = 0; i < gst_caps_get_size(preferred); ++i) {
+        gst_structure_set(gst_caps_get_structure(preferred, i),
+                "width", GST_TYPE_INT_RANGE, 1, size.width(),
+                "height", GST_TYPE_INT_RANGE, 1, size.height(),
+                nullptr);
+    }
+    gst_caps_append(preferred, caps);
+
+    return preferred;
+}
+
+// playsink scales video to the caps of its sink. Other pipelines, such as
+// camera viewfinders, have no scaler, so there a size restriction would
+// change what the source produces instead.
+static bool isInPlaySink(GstElement *element)
+{
+    GstObject *parent = gst_object_get_parent(GST_OBJECT(element));
+    while (parent) {
+        bool found = false;
+        if (GST_IS_ELEMENT(parent)) {
+            GstElementFactory *factory = gst_element_get_factory(GST_ELEMENT(parent));
+            found = factory && qstrcmp(GST_OBJECT_NAME(factory), "playsink") == 0;
+        }
+
+        GstObject *next = found ? nullptr : gst_object_get_parent(parent);
+        gst_object_unref(parent);
+        if (found)
+            return true;
+        parent = next;
+    }
+
+    return false;
+}
+
+// Looked up once per state change rather than on every caps query, as that
+// walks the parents of the sink.
+void QVideoSurfaceGstDelegate::updateInPlaySink()
+{
+    const bool inPlaySink = m_sink && isInPlaySink(m_sink);
+
+    QMutexLocker locker(&m_mutex);
+    m_inPlaySink = inPlaySink;
+}
+
 GstCaps *QVideoSurfaceGstDelegate::caps()
 {
     QMutexLocker locker(&m_mutex);
 
     gst_caps_ref(m_surfaceCaps);
 
+    if (m_surfaceCaps && m_inPlaySink)
+        return capsForPreferredSize(m_surfaceCaps, m_preferredSize);
+
     return m_surfaceCaps;
 }
 
@@ -541,10 +648,8 @@ bool QVideoSurfaceGstDelegate::waitForAsyncEvent(
 
 void QVideoSurfaceGstDelegate::updateSupportedFormats()
 {
-    if (m_surfaceCaps) {
-        gst_caps_unref(m_surfaceCaps);
-        m_surfaceCaps = 0;
-    }
+    GstCaps *surfaceCaps = nullptr;
+    QGstVideoRenderer *renderer = nullptr;
 
     for (QGstVideoRenderer *pool : qAsConst(m_renderers)) {
         if (GstCaps *caps = pool->getCaps(m_surface)) {
@@ -553,16 +658,23 @@ void QVideoSurfaceGstDelegate::updateSupportedFormats()
                 continue;
             }
 
-            if (m_surfaceCaps)
-                gst_caps_unref(m_surfaceCaps);
-
-            m_renderer = pool;
-            m_surfaceCaps = caps;
+            renderer = pool;
+            surfaceCaps = caps;
             break;
-        } else {
-            gst_caps_unref(caps);
         }
     }
+
+    const QSize preferredSize = m_surface ? m_surface->property("_q_preferredSize").toSize() : QSize();
+
+    // caps() is called from the streaming thread.
+    QMutexLocker locker(&m_mutex);
+
+    m_preferredSize = preferredSize;
+    if (m_surfaceCaps)
+        gst_caps_unref(m_surfaceCaps);
+
+    m_renderer = renderer;
+    m_surfaceCaps = surfaceCaps;
 }
 
 static GstVideoSinkClass *sink_parent_class;
@@ -685,8 +797,9 @@ void QGstVideoRendererSink::instance_init(GTypeInstance *instance, gpointer g_cl
         current_surface = &nullSurface;
     }
 
-    sink->delegate = new QVideoSurfaceGstDelegate(current_surface);
+    sink->delegate = new QVideoSurfaceGstDelegate(current_surface, GST_ELEMENT(sink));
     sink->delegate->moveToThread(current_surface->thread());
+    current_surface->installEventFilter(sink->delegate);
     current_surface = nullptr;
 }
 
@@ -735,6 +848,10 @@ GstStateChangeReturn QGstVideoRendererSink::change_state(
     if (transition == GST_STATE_CHANGE_PLAYING_TO_PAUSED && !showPrerollFrame)
         sink->delegate->flush();
 
+    // By the time it starts, the sink is in its final bin.
+    if (transition == GST_STATE_CHANGE_NULL_TO_READY)
+        sink->delegate->updateInPlaySink();
+
     return GST_ELEMENT_CLASS(sink_parent_class)->change_state(element, transition);
 }
 
@@ -59,6 +59,7 @@
 #include <QtCore/qmutex.h>
 #include <QtCore/qqueue.h>
 #include <QtCore/qpointer.h>
+#include <QtCore/qsize.h>
 #include <QtCore/qwaitcondition.h>
 #include <qvideosurfaceformat.h>
 #include <qvideoframe.h>
@@ -104,10 +105,11 @@ class QVideoSurfaceGstDelegate : public QObject
 {
     Q_OBJECT
 public:
-    QVideoSurfaceGstDelegate(QAbstractVideoSurface *surface);
+    QVideoSurfaceGstDelegate(QAbstractVideoSurface *surface, GstElement *sink = nullptr);
     ~QVideoSurfaceGstDelegate();
 
     GstCaps *caps();
+    void updateInPlaySink();
 
     bool start(GstCaps *caps);
     void stop();
@@ -119,6 +121,7 @@ public:
     GstFlowReturn render(GstBuffer *buffer);
 
     bool event(QEvent *event) override;
+    bool eventFilter(QObject *object, QEvent *event) override;
     bool query(GstQuery *query);
 
 private slots:
@@ -130,6 +133,7 @@ private:
     bool waitForAsyncEvent(QMutexLocker *locker, QWaitCondition *condition, unsigned long time);
 
     QPointer<QAbstractVideoSurface> m_surface;
+    GstElement *m_sink = nullptr;
 
     QMutex m_mutex;
     QWaitCondition m_setupCondition;
@@ -140,6 +144,9 @@ private:
     QGstVideoRenderer *m_activeRenderer = nullptr;
 
     GstCaps *m_surfaceCaps = nullptr;
+    // Only applied to the caps of sinks inside playbin
+    QSize m_preferredSize;
+    bool m_inPlaySink = false;
     GstCaps *m_startCaps = nullptr;
     GstBuffer *m_renderBuffer = nullptr;
 #if QT_CONFIG(gstreamer_gl)
@@ -20,6 +20,7 @@ HEADERS += \
         qdeclarative_audiosample_p.h \
         qdeclarative_sound_p.h \
         qsoundinstance_p.h \
+        qsoundemittertable_p.h \
         qaudioengine_p.h \
         qsoundsource_p.h \
         qsoundbuffer_p.h \
@@ -36,6 +37,7 @@ SOURCES += \
         qdeclarative_audiosample_p.cpp \
         qdeclarative_sound_p.cpp \
         qsoundinstance_p.cpp \
+        qsoundemittertable_p.cpp \
         qaudioengine_p.cpp \
         qsoundsource_openal_p.cpp  \
         qaudioengine_openal_p.cpp
@@ -41,6 +41,9 @@
 
 #include <QtCore/QMutex>
 #include <QtCore/QThread>
+#include <QtCore/QFile>
+#include <QtQml/qqmlfile.h>
+#include <QtMultimedia/qaudiodecoder.h>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkAccessManager>
@@ -49,6 +52,9 @@
 
 #include "qdebug.h"
 
+#include <algorithm>
+#include <cmath>
+
 #define DEBUG_AUDIOENGINE
 
 QT_USE_NAMESPACE
@@ -64,6 +70,7 @@ StaticSoundBufferAL::StaticSoundBufferAL(QObject *parent, const QUrl &url, QSamp
       m_ref(1),
       m_url(url),
       m_alBuffer(0),
+      m_duration(0),
       m_state(Creating),
       m_sample(0),
       m_sampleLoader(sampleLoader)
@@ -124,6 +131,11 @@ void StaticSoundBufferAL::unbindFromSource(ALuint alSource)
     alSourcei(alSource, AL_BUFFER, 0);
 }
 
+qreal StaticSoundBufferAL::duration() const
+{
+    return m_duration;
+}
+
 void StaticSoundBufferAL::sampleReady()
 {
 #ifdef DEBUG_AUDIOENGINE
@@ -169,6 +181,8 @@ void StaticSoundBufferAL::sampleReady()
         return;
     }
 
+    m_duration = m_sample->format().durationForBytes(m_sample->data().size()) / qreal(1000000);
+
     m_sample->release();
     m_sample = 0;
 
@@ -193,9 +207,476 @@ void StaticSoundBufferAL::decoderError()
 }
 
 
+void QSoundBufferPrivateAL::playSource(ALuint alSource)
+{
+    alSourcePlay(alSource);
+}
+
+void QSoundBufferPrivateAL::stopSource(ALuint alSource)
+{
+    alSourceStop(alSource);
+}
+
+void QSoundBufferPrivateAL::setSourceLooping(ALuint alSource, bool looping)
+{
+    alSourcei(alSource, AL_LOOPING, looping ? AL_TRUE : AL_FALSE);
+}
+
+void QSoundBufferPrivateAL::setSourceOffset(ALuint alSource, qreal offset)
+{
+    alSourcef(alSource, AL_SEC_OFFSET, offset);
+}
+
+qreal QSoundBufferPrivateAL::sourceOffset(ALuint alSource) const
+{
+    ALfloat offset = 0;
+    alGetSourcef(alSource, AL_SEC_OFFSET, &offset);
+    return offset;
+}
+
+ALint QSoundBufferPrivateAL::sourceState(ALuint alSource) const
+{
+    ALint state = AL_STOPPED;
+    alGetSourcei(alSource, AL_SOURCE_STATE, &state);
+    return state;
+}
+
+
+/////////////////////////////////////////////////////////////////
+QSoundStreamAL::QSoundStreamAL(StreamingSoundBufferAL *buffer, ALuint alSource)
+    : QObject(buffer)
+    , m_buffer(buffer)
+    , m_alSource(alSource)
+    , m_decoder(0)
+    , m_alFormat(0)
+    , m_processedBytes(0)
+    , m_skipBytes(0)
+    , m_startOffset(0)
+    , m_playbackOffset(0)
+    , m_looping(false)
+    , m_active(false)
+    , m_decoderDone(false)
+    , m_endOfStream(false)
+{
+#ifdef DEBUG_AUDIOENGINE
+    qDebug() << "creating new QSoundStreamAL for" << buffer->url();
+#endif
+    alGenBuffers(BufferCount, m_alBuffers);
+    QAudioEnginePrivate::checkNoError("create stream buffers");
+    m_freeBuffers.reserve(BufferCount);
+    for (int i = 0; i < BufferCount; ++i)
+        m_freeBuffers.append(m_alBuffers[i]);
+
+    m_decoder = new QAudioDecoder(this);
+    const QString path = QQmlFile::urlToLocalFileOrQrc(buffer->url());
+    if (path.startsWith(QLatin1Char(':'))) {
+        QFile *file = new QFile(path, m_decoder);
+        file->open(QIODevice::ReadOnly);
+        m_decoder->setSourceDevice(file);
+    } else {
+        m_decoder->setSourceFilename(path);
+    }
+    if (buffer->decodeFormat().isValid())
+        setFormat(buffer->decodeFormat());
+
+    connect(m_decoder, SIGNAL(bufferReady()), this, SLOT(pump()));
+    connect(m_decoder, SIGNAL(finished()), this, SLOT(decoderFinished()));
+    connect(m_decoder, SIGNAL(error(QAudioDecoder::Error)), this, SLOT(decoderError()));
+    connect(m_decoder, SIGNAL(durationChanged(qint64)), this, SLOT(durationChanged(qint64)));
+
+    m_pumpTimer.setInterval(50);
+    connect(&m_pumpTimer, SIGNAL(timeout()), this, SLOT(pump()));
+
+    //an openal looping flag would loop the queue, not the sound
+    alSourcei(m_alSource, AL_LOOPING, AL_FALSE);
+}
+
+QSoundStreamAL::~QSoundStreamAL()
+{
+    stop();
+    alDeleteBuffers(BufferCount, m_alBuffers);
+    QAudioEnginePrivate::checkNoError("delete stream buffers");
+}
+
+ALuint QSoundStreamAL::alSource() const
+{
+    return m_alSource;
+}
+
+void QSoundStreamAL::play()
+{
+    if (m_active && state() == AL_PAUSED) {
+        alSourcePlay(m_alSource);
+        return;
+    }
+    restart();
+}
+
+void QSoundStreamAL::stop()
+{
+    m_active = false;
+    m_pumpTimer.stop();
+    m_decoder->stop();
+    reset();
+}
+
+void QSoundStreamAL::setLooping(bool looping)
+{
+    m_looping = looping;
+}
+
+void QSoundStreamAL::setStartOffset(qreal offset)
+{
+    m_startOffset = qMax(qreal(0), offset);
+}
+
+qreal QSoundStreamAL::offset() const
+{
+    if (!m_active || !m_format.isValid())
+        return 0;
+    ALint byteOffset = 0;
+    alGetSourcei(m_alSource, AL_BYTE_OFFSET, &byteOffset);
+    qreal offset = m_playbackOffset
+            + m_format.durationForBytes(m_processedBytes + byteOffset) / qreal(1000000);
+    const qreal duration = m_buffer->duration();
+    if (m_looping && duration > 0)
+        offset = std::fmod(offset, duration);
+    return offset;
+}
+
+ALint QSoundStreamAL::state() const
+{
+    ALint state = AL_STOPPED;
+    alGetSourcei(m_alSource, AL_SOURCE_STATE, &state);
+    if (state == AL_PAUSED)
+        return state;
+    //an underrun stops the openal source, that is not the end of the sound
+    return m_active ? AL_PLAYING : AL_STOPPED;
+}
+
+void QSoundStreamAL::restart()
+{
+    m_decoder->stop();
+    reset();
+
+    m_active = true;
+    //skipped once the decoder output format is known
+    m_playbackOffset = m_startOffset;
+    m_skipBytes = -1;
+    m_startOffset = 0;
+
+    if (m_format.isValid())
+        m_decoder->setAudioFormat(m_format);
+    m_decoder->start();
+    m_pumpTimer.start();
+}
+
+void QSoundStreamAL::reset()
+{
+    alSourceStop(m_alSource);
+    //detaches all queued buffers, processed or not
+    alSourcei(m_alSource, AL_BUFFER, 0);
+    m_freeBuffers.clear();
+    for (int i = 0; i < BufferCount; ++i)
+        m_freeBuffers.append(m_alBuffers[i]);
+    m_queuedSizes.clear();
+    m_pending.clear();
+    m_processedBytes = 0;
+    m_decoderDone = false;
+    m_endOfStream = false;
+}
+
+void QSoundStreamAL::pump()
+{
+    if (!m_active)
+        return;
+
+    unqueueProcessed();
+
+    //only pull from the decoder what fits into the ring, the rest stays
+    //queued in the decoder which throttles decoding to the playback rate
+    while (m_decoder->bufferAvailable()
+           && (m_pending.size() < chunkSize() || !m_freeBuffers.isEmpty())) {
+        if (!readDecoder())
+            break;
+        while (queueChunk()) { }
+    }
+    while (queueChunk()) { }
+
+    if (m_decoderDone && !m_decoder->bufferAvailable()) {
+        if (m_looping) {
+            //the partial chunk carries over, so the loop point is seamless
+            m_decoderDone = false;
+            m_decoder->stop();
+            m_decoder->start();
+        } else {
+            m_endOfStream = true;
+            while (queueChunk()) { }
+        }
+    }
+
+    if (m_queuedSizes.isEmpty()) {
+        if (m_endOfStream && m_pending.isEmpty()) {
+            m_active = false;
+            m_pumpTimer.stop();
+        }
+        return;
+    }
+
+    ALint state = AL_STOPPED;
+    alGetSourcei(m_alSource, AL_SOURCE_STATE, &state);
+    if (state == AL_INITIAL || state == AL_STOPPED)
+        alSourcePlay(m_alSource);
+}
+
+void QSoundStreamAL::decoderFinished()
+{
+    m_decoderDone = true;
+    pump();
+}
+
+void QSoundStreamAL::decoderError()
+{
+    qWarning() << "streaming [" << m_buffer->url() << "] failed:" << m_decoder->errorString();
+    m_decoderDone = true;
+    m_looping = false;
+    pump();
+}
+
+void QSoundStreamAL::durationChanged(qint64 duration)
+{
+    if (duration > 0)
+        m_buffer->setDuration(duration / qreal(1000));
+}
+
+void QSoundStreamAL::unqueueProcessed()
+{
+    ALint processed = 0;
+    alGetSourcei(m_alSource, AL_BUFFERS_PROCESSED, &processed);
+    while (processed-- > 0 && !m_queuedSizes.isEmpty()) {
+        ALuint alBuffer = 0;
+        alSourceUnqueueBuffers(m_alSource, 1, &alBuffer);
+        m_freeBuffers.append(alBuffer);
+        m_processedBytes += m_queuedSizes.dequeue();
+    }
+}
+
+bool QSoundStreamAL::readDecoder()
+{
+    const QAudioBuffer buffer = m_decoder->read();
+    if (!buffer.isValid())
+        return false;
+
+    if (!m_format.isValid() && !setFormat(buffer.format())) {
+        //let the decoder convert into something openal takes and start over
+        QAudioFormat format = buffer.format();
+        format.setSampleSize(16);
+        format.setSampleType(QAudioFormat::SignedInt);
+        format.setByteOrder(QAudioFormat::Endian(QSysInfo::ByteOrder));
+        format.setChannelCount(qMin(format.channelCount(), 2));
+        setFormat(format);
+        m_buffer->setDecodeFormat(format);
+        m_startOffset = m_playbackOffset;
+        restart();
+        return false;
+    }
+
+    if (!m_buffer->decodeFormat().isValid())
+        m_buffer->setDecodeFormat(m_format);
+    if (m_skipBytes < 0)
+        m_skipBytes = m_format.bytesForDuration(qint64(m_playbackOffset * 1000000));
+
+    const char *data = buffer.constData<char>();
+    int size = buffer.byteCount();
+    if (m_skipBytes > 0) {
+        const int skip = int(qMin<qint64>(m_skipBytes, size));
+        data += skip;
+        size -= skip;
+        m_skipBytes -= skip;
+    }
+    m_pending.append(data, size);
+    return true;
+}
+
+bool QSoundStreamAL::queueChunk()
+{
+    if (m_pending.isEmpty() || m_freeBuffers.isEmpty())
+        return false;
+    const int chunk = chunkSize();
+    if (m_pending.size() < chunk && !m_endOfStream)
+        return false;
+
+    const int size = qMin(chunk, m_pending.size());
+    const ALuint alBuffer = m_freeBuffers.takeLast();
+    alGetError(); // clear error
+    alBufferData(alBuffer, m_alFormat, m_pending.constData(), size, m_format.sampleRate());
+    alSourceQueueBuffers(m_alSource, 1, &alBuffer);
+    if (!QAudioEnginePrivate::checkNoError("queue stream buffer")) {
+        m_freeBuffers.append(alBuffer);
+        return false;
+    }
+    m_queuedSizes.enqueue(size);
+    m_pending.remove(0, size);
+    return true;
+}
+
+int QSoundStreamAL::chunkSize() const
+{
+    //a quarter of a second per buffer, one second queued in total
+    return m_format.isValid() ? m_format.bytesForDuration(250000) : 0;
+}
+
+bool QSoundStreamAL::setFormat(const QAudioFormat &format)
+{
+    if (format.channelCount() < 1 || format.channelCount() > 2)
+        return false;
+    if (format.sampleSize() == 8 && format.sampleType() == QAudioFormat::UnSignedInt) {
+        m_alFormat = format.channelCount() == 1 ? AL_FORMAT_MONO8 : AL_FORMAT_STEREO8;
+    } else if (format.sampleSize() == 16 && format.sampleType() == QAudioFormat::SignedInt
+               && format.byteOrder() == QAudioFormat::Endian(QSysInfo::ByteOrder)) {
+        m_alFormat = format.channelCount() == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+    } else {
+        return false;
+    }
+    m_format = format;
+    return true;
+}
+
+
+/////////////////////////////////////////////////////////////////
+StreamingSoundBufferAL::StreamingSoundBufferAL(QObject *parent, const QUrl &url)
+    : QSoundBufferPrivateAL(parent),
+      m_url(url),
+      m_state(Creating),
+      m_duration(0)
+{
+#ifdef DEBUG_AUDIOENGINE
+    qDebug() << "creating new StreamingSoundBufferAL";
+#endif
+}
+
+StreamingSoundBufferAL::~StreamingSoundBufferAL()
+{
+    qDeleteAll(m_streams);
+}
+
+QSoundBuffer::State StreamingSoundBufferAL::state() const
+{
+    return m_state;
+}
+
+void StreamingSoundBufferAL::load()
+{
+    if (m_state == Loading || m_state == Ready)
+        return;
+
+    //nothing is decoded up front, every source decodes its own playback
+    const QString path = QQmlFile::urlToLocalFileOrQrc(m_url);
+    if (path.isEmpty() || !QFile::exists(path)) {
+        qWarning() << "streaming [" << m_url << "] failed: only local files and resources can be streamed";
+        m_state = Error;
+        emit stateChanged(m_state);
+        emit error();
+        return;
+    }
+
+    m_state = Ready;
+    emit stateChanged(m_state);
+    emit ready();
+}
+
+QUrl StreamingSoundBufferAL::url() const
+{
+    return m_url;
+}
+
+qreal StreamingSoundBufferAL::duration() const
+{
+    return m_duration;
+}
+
+void StreamingSoundBufferAL::setDuration(qreal duration)
+{
+    m_duration = duration;
+}
+
+QAudioFormat StreamingSoundBufferAL::decodeFormat() const
+{
+    return m_decodeFormat;
+}
+
+void StreamingSoundBufferAL::setDecodeFormat(const QAudioFormat &format)
+{
+    m_decodeFormat = format;
+}
+
+QSoundStreamAL *StreamingSoundBufferAL::stream(ALuint alSource) const
+{
+    for (QSoundStreamAL *s : m_streams) {
+        if (s->alSource() == alSource)
+            return s;
+    }
+    return 0;
+}
+
+void StreamingSoundBufferAL::bindToSource(ALuint alSource)
+{
+    Q_ASSERT(m_state == Ready);
+    if (!stream(alSource))
+        m_streams.append(new QSoundStreamAL(this, alSource));
+}
+
+void StreamingSoundBufferAL::unbindFromSource(ALuint alSource)
+{
+    if (QSoundStreamAL *s = stream(alSource)) {
+        m_streams.removeOne(s);
+        delete s;
+    }
+}
+
+void StreamingSoundBufferAL::playSource(ALuint alSource)
+{
+    if (QSoundStreamAL *s = stream(alSource))
+        s->play();
+}
+
+void StreamingSoundBufferAL::stopSource(ALuint alSource)
+{
+    if (QSoundStreamAL *s = stream(alSource))
+        s->stop();
+}
+
+void StreamingSoundBufferAL::setSourceLooping(ALuint alSource, bool looping)
+{
+    if (QSoundStreamAL *s = stream(alSource))
+        s->setLooping(looping);
+}
+
+void StreamingSoundBufferAL::setSourceOffset(ALuint alSource, qreal offset)
+{
+    if (QSoundStreamAL *s = stream(alSource))
+        s->setStartOffset(offset);
+}
+
+qreal StreamingSoundBufferAL::sourceOffset(ALuint alSource) const
+{
+    if (QSoundStreamAL *s = stream(alSource))
+        return s->offset();
+    return 0;
+}
+
+ALint StreamingSoundBufferAL::sourceState(ALuint alSource) const
+{
+    if (QSoundStreamAL *s = stream(alSource))
+        return s->state();
+    return AL_STOPPED;
+}
+
 /////////////////////////////////////////////////////////////////
 QAudioEnginePrivate::QAudioEnginePrivate(QObject *parent)
     : QObject(parent)
+    , m_maxVoices(32)
+    , m_allocatedVoices(0)
 {
     m_updateTimer.setInterval(200);
     connect(&m_updateTimer, SIGNAL(timeout()), this, SLOT(updateSoundSources()));
@@ -234,6 +715,15 @@ QAudioEnginePrivate::QAudioEnginePrivate(QObject *parent)
     alcMakeContextCurrent(context);
     alDistanceModel(AL_NONE);
     alDopplerFactor(0);
+
+    //sound sources beyond this limit play as virtual voices
+    ALCint monoSources = 0;
+    alcGetIntegerv(device, ALC_MONO_SOURCES, 1, &monoSources);
+    if (monoSources > 0)
+        m_maxVoices = monoSources;
+#ifdef DEBUG_AUDIOENGINE
+    qDebug() << "openal voices =" << m_maxVoices;
+#endif
 }
 
 QAudioEnginePrivate::~QAudioEnginePrivate()
@@ -249,6 +739,15 @@ QAudioEnginePrivate::~QAudioEnginePrivate()
         s->release();
     }
 
+    if (!m_freeVoices.isEmpty()) {
+        alDeleteSources(m_freeVoices.count(), m_freeVoices.constData());
+        checkNoError("delete sources");
+        m_freeVoices.clear();
+    }
+
+    qDeleteAll(m_streamingBuffers);
+    m_streamingBuffers.clear();
+
     for (QSoundBufferPrivateAL *buffer : qAsConst(m_staticBufferPool)) {
         delete buffer;
     }
@@ -282,7 +781,7 @@ QSoundSource* QAudioEnginePrivate::createSoundSource()
         instance = m_instancePool.front();
         m_instancePool.pop_front();
     }
-    connect(instance, SIGNAL(activate(QObject*)), this, SLOT(soundSourceActivate(QObject*)));
+    connect(instance, SIGNAL(activate(QObject*)), this, SLOT(soundSourceActivate(QObject*)), Qt::UniqueConnection);
     return instance;
 }
 
@@ -293,6 +792,8 @@ void QAudioEnginePrivate::releaseSoundSource(QSoundSource *soundInstance)
     qDebug() << "recycle soundInstance" << privInstance;
 #endif
     privInstance->unbindBuffer();
+    if (privInstance->hasVoice())
+        releaseVoice(privInstance->detachVoice());
     m_instancePool.push_front(privInstance);
     m_activeInstances.removeOne(privInstance);
 }
@@ -311,6 +812,14 @@ QSoundBuffer* QAudioEnginePrivate::getStaticSoundBuffer(const QUrl& url)
     return staticBuffer;
 }
 
+QSoundBuffer* QAudioEnginePrivate::getStreamingSoundBuffer(const QUrl& url)
+{
+    //not shared, streams are decoded per playing source anyway
+    StreamingSoundBufferAL *streamingBuffer = new StreamingSoundBufferAL(this, url);
+    m_streamingBuffers.append(streamingBuffer);
+    return streamingBuffer;
+}
+
 void QAudioEnginePrivate::releaseSoundBuffer(QSoundBuffer *buffer)
 {
 #ifdef DEBUG_AUDIOENGINE
@@ -320,6 +829,8 @@ void QAudioEnginePrivate::releaseSoundBuffer(QSoundBuffer *buffer)
         //decrement the reference count, still kept in memory for reuse
         staticBuffer->release();
         //TODO implement some resource recycle strategy
+    } else if (qobject_cast<StreamingSoundBufferAL *>(buffer)) {
+        //owned by its AudioSample for the lifetime of the engine
     } else {
         //TODO
         Q_ASSERT(0);
@@ -406,8 +917,7 @@ void QAudioEnginePrivate::soundSourceActivate(QObject *soundSource)
 {
     QSoundSourcePrivate *ss = qobject_cast<QSoundSourcePrivate*>(soundSource);
     ss->checkState();
-    if (ss->isLooping())
-        return;
+    //looping sources are tracked as well, they take part in voice allocation
     if (!m_activeInstances.contains(ss))
         m_activeInstances.push_back(ss);
     if (!m_updateTimer.isActive())
@@ -421,6 +931,8 @@ void QAudioEnginePrivate::updateSoundSources()
         QSoundSourcePrivate *instance = *it;
         instance->checkState();
         if (instance->state() == QSoundSource::StoppedState) {
+            if (instance->hasVoice())
+                releaseVoice(instance->detachVoice());
             it = m_activeInstances.erase(it);
         } else {
             ++it;
@@ -429,5 +941,77 @@ void QAudioEnginePrivate::updateSoundSources()
 
     if (m_activeInstances.count() == 0) {
         m_updateTimer.stop();
+        return;
+    }
+
+    updateVoices();
+}
+
+int QAudioEnginePrivate::maximumVoiceCount() const
+{
+    return m_maxVoices;
+}
+
+ALuint QAudioEnginePrivate::acquireVoice()
+{
+    if (!m_freeVoices.isEmpty())
+        return m_freeVoices.takeLast();
+    if (m_allocatedVoices >= m_maxVoices)
+        return 0;
+
+    ALuint alSource = 0;
+    alGetError(); // clear error
+    alGenSources(1, &alSource);
+    if (!checkNoError("create source")) {
+        //the device ran out of sources earlier than advertised
+        m_maxVoices = m_allocatedVoices;
+        return 0;
+    }
+    ++m_allocatedVoices;
+    return alSource;
+}
+
+void QAudioEnginePrivate::releaseVoice(ALuint alSource)
+{
+    if (alSource)
+        m_freeVoices.append(alSource);
+}
+
+void QAudioEnginePrivate::updateVoices()
+{
+    bool hasVirtualVoices = false;
+    for (QSoundSourcePrivate *instance : qAsConst(m_activeInstances)) {
+        if (!instance->hasVoice()) {
+            hasVirtualVoices = true;
+            break;
+        }
+    }
+    if (!hasVirtualVoices)
+        return;
+
+    //the most audible sources get the real voices, a source that already
+    //has one keeps it unless another one is clearly louder
+    m_voiceOrder = m_activeInstances.toVector();
+    std::stable_sort(m_voiceOrder.begin(), m_voiceOrder.end(),
+                     [](QSoundSourcePrivate *a, QSoundSourcePrivate *b) {
+        return a->audibility() * (a->hasVoice() ? 1.25 : 1.0)
+                > b->audibility() * (b->hasVoice() ? 1.25 : 1.0);
+    });
+
+    const int realCount = qMin(m_voiceOrder.count(), m_maxVoices);
+    for (int i = realCount; i < m_voiceOrder.count(); ++i) {
+        QSoundSourcePrivate *instance = m_voiceOrder.at(i);
+        if (instance->hasVoice())
+            releaseVoice(instance->detachVoice());
+    }
+    for (int i = 0; i < realCount; ++i) {
+        QSoundSourcePrivate *instance = m_voiceOrder.at(i);
+        if (instance->hasVoice() || instance->audibility() <= 0)
+            continue;
+        const ALuint alSource = acquireVoice();
+        if (!alSource)
+            break;
+        instance->attachVoice(alSource);
     }
+    m_voiceOrder.clear();
 }
@@ -56,6 +56,11 @@
 #include <QMap>
 #include <QTimer>
 #include <QUrl>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QVector3D>
+#include <QQueue>
+#include <QtMultimedia/qaudioformat.h>
 
 #if defined(HEADER_OPENAL_PREFIX)
 #include <OpenAL/al.h>
@@ -72,6 +77,8 @@ QT_BEGIN_NAMESPACE
 
 class QSample;
 class QSampleCache;
+class QAudioEnginePrivate;
+class QAudioDecoder;
 
 class QSoundBufferPrivateAL : public QSoundBuffer
 {
@@ -80,6 +87,17 @@ public:
     QSoundBufferPrivateAL(QObject* parent);
     virtual void bindToSource(ALuint alSource) = 0;
     virtual void unbindFromSource(ALuint alSource) = 0;
+    //in seconds
+    virtual qreal duration() const = 0;
+
+    //playback control of a source bound to this buffer, streaming buffers
+    //feed the source themselves and can't map these to plain openal calls
+    virtual void playSource(ALuint alSource);
+    virtual void stopSource(ALuint alSource);
+    virtual void setSourceLooping(ALuint alSource, bool looping);
+    virtual void setSourceOffset(ALuint alSource, qreal offset);
+    virtual qreal sourceOffset(ALuint alSource) const;
+    virtual ALint sourceState(ALuint alSource) const;
 };
 
 
@@ -97,6 +115,7 @@ public:
 
     void bindToSource(ALuint alSource) override;
     void unbindFromSource(ALuint alSource) override;
+    qreal duration() const override;
 
     inline long addRef() { return ++m_ref; }
     inline long release() { return --m_ref; }
@@ -110,17 +129,119 @@ private:
     long m_ref;
     QUrl m_url;
     ALuint m_alBuffer;
+    qreal m_duration;
     State m_state;
     QSample *m_sample;
     QSampleCache *m_sampleLoader;
 };
 
 
+class StreamingSoundBufferAL;
+
+//decodes one playback of a streaming buffer into a small ring of openal
+//buffers queued on the source
+class QSoundStreamAL : public QObject
+{
+    Q_OBJECT
+public:
+    QSoundStreamAL(StreamingSoundBufferAL *buffer, ALuint alSource);
+    ~QSoundStreamAL();
+
+    ALuint alSource() const;
+
+    void play();
+    void stop();
+    void setLooping(bool looping);
+    void setStartOffset(qreal offset);
+    qreal offset() const;
+    ALint state() const;
+
+private Q_SLOTS:
+    void pump();
+    void decoderFinished();
+    void decoderError();
+    void durationChanged(qint64 duration);
+
+private:
+    enum { BufferCount = 4 };
+
+    void restart();
+    void reset();
+    void unqueueProcessed();
+    bool readDecoder();
+    bool queueChunk();
+    int chunkSize() const;
+    bool setFormat(const QAudioFormat &format);
+
+    StreamingSoundBufferAL *m_buffer;
+    ALuint m_alSource;
+    ALuint m_alBuffers[BufferCount];
+    QVector<ALuint> m_freeBuffers;
+    QQueue<int> m_queuedSizes;
+
+    QAudioDecoder *m_decoder;
+    QTimer m_pumpTimer;
+    QAudioFormat m_format;
+    ALenum m_alFormat;
+    QByteArray m_pending;
+
+    qint64 m_processedBytes;
+    qint64 m_skipBytes;
+    qreal m_startOffset;
+    qreal m_playbackOffset;
+    bool m_looping;
+    bool m_active;
+    bool m_decoderDone;
+    bool m_endOfStream;
+};
+
+
+class StreamingSoundBufferAL : public QSoundBufferPrivateAL
+{
+    Q_OBJECT
+
+public:
+    StreamingSoundBufferAL(QObject *parent, const QUrl &url);
+    ~StreamingSoundBufferAL();
+
+    State state() const override;
+
+    void load() override;
+
+    void bindToSource(ALuint alSource) override;
+    void unbindFromSource(ALuint alSource) override;
+    qreal duration() const override;
+
+    void playSource(ALuint alSource) override;
+    void stopSource(ALuint alSource) override;
+    void setSourceLooping(ALuint alSource, bool looping) override;
+    void setSourceOffset(ALuint alSource, qreal offset) override;
+    qreal sourceOffset(ALuint alSource) const override;
+    ALint sourceState(ALuint alSource) const override;
+
+    QUrl url() const;
+
+    //output format of the decoder once known, shared by all streams
+    QAudioFormat decodeFormat() const;
+    void setDecodeFormat(const QAudioFormat &format);
+    void setDuration(qreal duration);
+
+private:
+    QSoundStreamAL *stream(ALuint alSource) const;
+
+    QUrl m_url;
+    State m_state;
+    qreal m_duration;
+    QAudioFormat m_decodeFormat;
+    QList<QSoundStreamAL*> m_streams;
+};
+
+
 class QSoundSourcePrivate : public QSoundSource
 {
     Q_OBJECT
 public:
-    QSoundSourcePrivate(QObject *parent);
+    QSoundSourcePrivate(QAudioEnginePrivate *engine);
     ~QSoundSourcePrivate();
 
     void play() override;
@@ -150,22 +271,39 @@ public:
 
     void release();
 
+    //a source without an openal source attached is a virtual voice, it keeps
+    //its playback clock running and gets a real source once it is audible enough
+    bool hasVoice() const;
+    void attachVoice(ALuint alSource);
+    ALuint detachVoice();
+    qreal audibility() const;
+
 Q_SIGNALS:
     void activate(QObject*);
 
 private:
-    void sourcePlay();
-    void sourcePause();
+    void applyParameters();
+    void applyCone(qreal innerAngle, qreal outerAngle);
+    qreal virtualOffset() const;
 
+    QAudioEnginePrivate *m_engine;
     ALuint  m_alSource;
     QSoundBufferPrivateAL *m_bindBuffer;
     bool                 m_isReady; //true if the sound source is already bound to some sound buffer
     QSoundSource::State  m_state;
+    QSoundSource::State  m_virtualState;
     qreal   m_gain;
     qreal   m_pitch;
     qreal   m_coneInnerAngle;
     qreal   m_coneOuterAngle;
     qreal   m_coneOuterGain;
+    bool    m_looping;
+    QVector3D m_position;
+    QVector3D m_direction;
+    QVector3D m_velocity;
+
+    qreal   m_offset; //playback position in seconds while virtual
+    QElapsedTimer m_virtualClock;
 };
 
 
@@ -181,6 +319,7 @@ public:
     QSoundSource* createSoundSource();
     void releaseSoundSource(QSoundSource *soundInstance);
     QSoundBuffer* getStaticSoundBuffer(const QUrl& url);
+    QSoundBuffer* getStreamingSoundBuffer(const QUrl& url);
     void releaseSoundBuffer(QSoundBuffer *buffer);
 
     QVector3D listenerPosition() const;
@@ -193,6 +332,11 @@ public:
     void setDopplerFactor(qreal dopplerFactor);
     void setSpeedOfSound(qreal speedOfSound);
 
+    int maximumVoiceCount() const;
+    ALuint acquireVoice();
+    void releaseVoice(ALuint alSource);
+    void updateVoices();
+
     static bool checkNoError(const char *msg);
 
 Q_SIGNALS:
@@ -206,9 +350,15 @@ private:
     QList<QSoundSourcePrivate*> m_activeInstances;
     QList<QSoundSourcePrivate*> m_instancePool;
     QMap<QUrl, QSoundBufferPrivateAL*> m_staticBufferPool;
+    QList<StreamingSoundBufferAL*> m_streamingBuffers;
 
     QSampleCache *m_sampleLoader;
     QTimer m_updateTimer;
+
+    int m_maxVoices;
+    int m_allocatedVoices;
+    QVector<ALuint> m_freeVoices;
+    QVector<QSoundSourcePrivate*> m_voiceOrder;
 };
 
 QT_END_NAMESPACE
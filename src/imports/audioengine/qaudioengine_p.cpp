@@ -86,6 +86,11 @@ QSoundBuffer* QAudioEngine::getStaticSoundBuffer(const QUrl& url)
     return d->getStaticSoundBuffer(url);
 }
 
+QSoundBuffer* QAudioEngine::getStreamingSoundBuffer(const QUrl& url)
+{
+    return d->getStreamingSoundBuffer(url);
+}
+
 void QAudioEngine::releaseSoundBuffer(QSoundBuffer *buffer)
 {
     d->releaseSoundBuffer(buffer);
@@ -194,3 +199,13 @@ void QAudioEngine::setSpeedOfSound(qreal speedOfSound)
     m_speedOfSound = speedOfSound;
     d->setSpeedOfSound(speedOfSound);
 }
+
+int QAudioEngine::maximumVoiceCount() const
+{
+    return d->maximumVoiceCount();
+}
+
+void QAudioEngine::updateVoices()
+{
+    d->updateVoices();
+}
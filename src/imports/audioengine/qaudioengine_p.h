@@ -72,6 +72,7 @@ public:
     virtual void releaseSoundSource(QSoundSource *soundInstance);
 
     virtual QSoundBuffer* getStaticSoundBuffer(const QUrl& url);
+    virtual QSoundBuffer* getStreamingSoundBuffer(const QUrl& url);
     virtual void releaseSoundBuffer(QSoundBuffer *buffer);
 
     virtual bool isLoading() const;
@@ -93,6 +94,9 @@ public:
     virtual qreal speedOfSound() const;
     virtual void setSpeedOfSound(qreal speedOfSound);
 
+    virtual int maximumVoiceCount() const;
+    virtual void updateVoices();
+
     static QAudioEngine* create(QObject *parent);
 
 Q_SIGNALS:
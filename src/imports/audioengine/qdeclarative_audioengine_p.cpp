@@ -109,6 +109,10 @@ QT_BEGIN_NAMESPACE
     It is mostly used as a container to access other types such as AudioCategory, AudioSample and
     Sound.
 
+    The number of sounds that can be heard at the same time is limited by the audio device. When
+    more sounds are playing, only the most audible ones are rendered; the others keep their
+    playback position and become audible again once they are among the loudest.
+
     \sa AudioCategory, AudioSample, Sound, SoundInstance, AttenuationModelLinear, AttenuationModelInverse
 */
 
@@ -118,11 +122,13 @@ QDeclarativeAudioEngine::QDeclarativeAudioEngine(QObject *parent)
     , m_defaultCategory(0)
     , m_defaultAttenuationModel(0)
     , m_audioEngine(0)
+    , m_attenuationPending(false)
 {
     m_audioEngine = QAudioEngine::create(this);
     connect(m_audioEngine, SIGNAL(isLoadingChanged()), this, SIGNAL(isLoadingChanged()));
     connect(m_audioEngine, SIGNAL(isLoadingChanged()), this, SLOT(handleLoadingChanged()));
     m_listener = new QDeclarativeAudioListener(this);
+    connect(m_listener, SIGNAL(positionChanged()), this, SLOT(handleListenerMoved()));
     m_updateTimer.setInterval(100);
     connect(&m_updateTimer, SIGNAL(timeout()), this, SLOT(updateSoundInstances()));
 }
@@ -223,6 +229,11 @@ void QDeclarativeAudioEngine::releaseSoundInstance(QSoundInstance* instance)
     emit liveInstanceCountChanged();
 }
 
+QSoundEmitterTable* QDeclarativeAudioEngine::emitterTable()
+{
+    return &m_emitters;
+}
+
 void QDeclarativeAudioEngine::initAudioSample(QDeclarativeAudioSample *sample)
 {
     sample->init();
@@ -508,18 +519,33 @@ void QDeclarativeAudioEngine::updateSoundInstances()
         }
     }
 
-    QVector3D listenerPosition = this->listener()->position();
-    for (QSoundInstance *instance : qAsConst(m_activeSoundInstances)) {
-        if (instance->state() == QSoundInstance::PlayingState
-            &&  instance->attenuationEnabled()) {
-            instance->update3DVolume(listenerPosition);
-        }
-    }
+    updateAttenuation();
 
     if (m_activeSoundInstances.count() == 0)
         m_updateTimer.stop();
 }
 
+void QDeclarativeAudioEngine::updateAttenuation()
+{
+    m_attenuationPending = false;
+    //nothing moved since the last pass, all gains are still valid
+    if (!m_emitters.isDirty())
+        return;
+    if (m_emitters.update())
+        m_audioEngine->updateVoices();
+}
+
+void QDeclarativeAudioEngine::handleListenerMoved()
+{
+    m_emitters.setListenerPosition(m_listener->position());
+    //follow the listener without waiting for the next timer tick, but
+    //coalesce bursts of movement into one pass per event loop iteration
+    if (m_attenuationPending || m_emitters.count() == 0)
+        return;
+    m_attenuationPending = true;
+    QMetaObject::invokeMethod(this, "updateAttenuation", Qt::QueuedConnection);
+}
+
 void QDeclarativeAudioEngine::appendFunction(QQmlListProperty<QObject> *property, QObject *value)
 {
     QDeclarativeAudioEngine* engine = static_cast<QDeclarativeAudioEngine*>(property->object);
@@ -58,6 +58,7 @@
 #include <QtCore/QList>
 #include <QTimer>
 #include "qaudioengine_p.h"
+#include "qsoundemittertable_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -128,6 +129,9 @@ public:
     QSoundInstance* newSoundInstance(const QString &name);
     void releaseSoundInstance(QSoundInstance* instance);
 
+    //3d state of all attenuated sound instances, updated in one batch
+    QSoundEmitterTable* emitterTable();
+
     Q_REVISION(1) Q_INVOKABLE void addAudioSample(QDeclarativeAudioSample *);
     Q_REVISION(1) Q_INVOKABLE void addSound(QDeclarativeSound *);
     Q_REVISION(1) Q_INVOKABLE void addAudioCategory(QDeclarativeAudioCategory *);
@@ -141,7 +145,9 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void updateSoundInstances();
+    void updateAttenuation();
     void handleLoadingChanged();
+    void handleListenerMoved();
 
 private:
     Q_DISABLE_COPY(QDeclarativeAudioEngine);
@@ -168,6 +174,8 @@ private:
     QList<QSoundInstance*> m_activeSoundInstances;
 
     QTimer m_updateTimer;
+    QSoundEmitterTable m_emitters;
+    bool m_attenuationPending;
     QList<QDeclarativeSoundInstance*> m_managedDeclSoundInstances;
     QList<QDeclarativeSoundInstance*> m_managedDeclSndInstancePool;
     void releaseManagedDeclarativeSoundInstance(QDeclarativeSoundInstance* declSndInstance);
@@ -112,6 +112,17 @@ void QDeclarativeAudioSample::setSource(const QUrl& url)
     m_url = url;
 }
 
+/*!
+    \qmlproperty bool QtAudioEngine::AudioSample::streaming
+
+    This property indicates whether the sample is decoded while it plays instead
+    of being loaded into memory as a whole. Streaming starts playback almost
+    immediately and keeps memory usage constant, which suits long sounds such as
+    music or ambience. Every playing instance decodes the file on its own, so
+    short sounds that are played often should not be streamed.
+
+    Only local files and resources can be streamed. The default value is \c false.
+*/
 bool QDeclarativeAudioSample::isStreaming() const
 {
     return m_streaming;
@@ -215,8 +226,10 @@ void QDeclarativeAudioSample::init()
     Q_ASSERT(m_engine != 0);
 
     if (m_streaming) {
-        //TODO
-
+        m_soundBuffer = m_engine->engine()->getStreamingSoundBuffer(m_url);
+        connect(m_soundBuffer, SIGNAL(ready()), this, SIGNAL(loadedChanged()));
+        //only validates the source, decoding starts when a sound plays
+        m_soundBuffer->load();
     } else {
         m_soundBuffer = m_engine->engine()->getStaticSoundBuffer(m_url);
         if (m_soundBuffer->state() == QSoundBuffer::Ready) {
@@ -0,0 +1,239 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsoundemittertable_p.h"
+#include "qsoundinstance_p.h"
+#include "qdeclarative_attenuationmodel_p.h"
+
+#include <algorithm>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+QSoundEmitterTable::QSoundEmitterTable()
+    : m_dirty(false)
+    , m_customModelCount(0)
+{
+}
+
+int QSoundEmitterTable::add(QSoundInstance *instance, QDeclarativeAttenuationModel *model,
+                            const QVector3D &position)
+{
+    Q_ASSERT(instance && model);
+
+    float lower = 0;
+    float upper = 0;
+    float linearScale = 0;
+    float reference = 1;
+    float rolloff = 0;
+    bool custom = false;
+
+    if (QDeclarativeAttenuationModelLinear *linear = qobject_cast<QDeclarativeAttenuationModelLinear *>(model)) {
+        lower = linear->startDistance();
+        upper = linear->endDistance();
+        if (upper > lower)
+            linearScale = 1 / (upper - lower);
+        else
+            upper = lower;
+    } else if (QDeclarativeAttenuationModelInverse *inverse = qobject_cast<QDeclarativeAttenuationModelInverse *>(model)) {
+        lower = inverse->referenceDistance();
+        upper = inverse->maxDistance();
+        reference = inverse->referenceDistance();
+        rolloff = inverse->rolloffFactor();
+    } else {
+        // Unknown curve, evaluated separately through calculateGain()
+        custom = true;
+        ++m_customModelCount;
+    }
+
+    const int index = m_instances.count();
+    m_instances.append(instance);
+    m_models.append(model);
+    m_custom.append(custom);
+    m_x.append(position.x());
+    m_y.append(position.y());
+    m_z.append(position.z());
+    m_lower.append(lower);
+    m_upper.append(upper);
+    m_linearScale.append(linearScale);
+    m_reference.append(reference);
+    m_rolloff.append(rolloff);
+    m_gain.append(1);
+    m_appliedGain.append(-1);
+
+    instance->setEmitterIndex(index);
+    m_dirty = true;
+    return index;
+}
+
+void QSoundEmitterTable::remove(int index)
+{
+    Q_ASSERT(index >= 0 && index < m_instances.count());
+
+    if (m_custom.at(index))
+        --m_customModelCount;
+
+    m_instances.at(index)->setEmitterIndex(-1);
+
+    // Move the last row into the hole to keep the arrays dense
+    const int last = m_instances.count() - 1;
+    if (index != last) {
+        m_instances[index] = m_instances.at(last);
+        m_models[index] = m_models.at(last);
+        m_custom[index] = m_custom.at(last);
+        m_x[index] = m_x.at(last);
+        m_y[index] = m_y.at(last);
+        m_z[index] = m_z.at(last);
+        m_lower[index] = m_lower.at(last);
+        m_upper[index] = m_upper.at(last);
+        m_linearScale[index] = m_linearScale.at(last);
+        m_reference[index] = m_reference.at(last);
+        m_rolloff[index] = m_rolloff.at(last);
+        m_gain[index] = m_gain.at(last);
+        m_appliedGain[index] = m_appliedGain.at(last);
+        m_instances.at(index)->setEmitterIndex(index);
+    }
+
+    m_instances.removeLast();
+    m_models.removeLast();
+    m_custom.removeLast();
+    m_x.removeLast();
+    m_y.removeLast();
+    m_z.removeLast();
+    m_lower.removeLast();
+    m_upper.removeLast();
+    m_linearScale.removeLast();
+    m_reference.removeLast();
+    m_rolloff.removeLast();
+    m_gain.removeLast();
+    m_appliedGain.removeLast();
+}
+
+void QSoundEmitterTable::clear()
+{
+    for (QSoundInstance *instance : qAsConst(m_instances))
+        instance->setEmitterIndex(-1);
+
+    m_instances.clear();
+    m_models.clear();
+    m_custom.clear();
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_lower.clear();
+    m_upper.clear();
+    m_linearScale.clear();
+    m_reference.clear();
+    m_rolloff.clear();
+    m_gain.clear();
+    m_appliedGain.clear();
+    m_customModelCount = 0;
+    m_dirty = false;
+}
+
+void QSoundEmitterTable::setPosition(int index, const QVector3D &position)
+{
+    Q_ASSERT(index >= 0 && index < m_instances.count());
+    m_x[index] = position.x();
+    m_y[index] = position.y();
+    m_z[index] = position.z();
+    m_dirty = true;
+}
+
+void QSoundEmitterTable::setListenerPosition(const QVector3D &position)
+{
+    if (m_listenerPosition == position)
+        return;
+    m_listenerPosition = position;
+    m_dirty = true;
+}
+
+bool QSoundEmitterTable::update()
+{
+    m_dirty = false;
+
+    const int n = m_instances.count();
+    if (n == 0)
+        return false;
+
+    const float lx = m_listenerPosition.x();
+    const float ly = m_listenerPosition.y();
+    const float lz = m_listenerPosition.z();
+
+    const float *x = m_x.constData();
+    const float *y = m_y.constData();
+    const float *z = m_z.constData();
+    const float *lower = m_lower.constData();
+    const float *upper = m_upper.constData();
+    const float *linearScale = m_linearScale.constData();
+    const float *reference = m_reference.constData();
+    const float *rolloff = m_rolloff.constData();
+    float *gain = m_gain.data();
+
+    // Branch free on purpose so the compiler can vectorize the loop
+    for (int i = 0; i < n; ++i) {
+        const float dx = x[i] - lx;
+        const float dy = y[i] - ly;
+        const float dz = z[i] - lz;
+        const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+        const float d = std::max(lower[i], std::min(distance, upper[i])) - lower[i];
+        gain[i] = (1 - d * linearScale[i]) * (reference[i] / (reference[i] + d * rolloff[i]));
+    }
+
+    if (m_customModelCount > 0) {
+        for (int i = 0; i < n; ++i) {
+            if (m_custom.at(i))
+                gain[i] = m_models.at(i)->calculateGain(m_listenerPosition, QVector3D(x[i], y[i], z[i]));
+        }
+    }
+
+    // Only instances whose gain actually moved get touched
+    bool changed = false;
+    float *appliedGain = m_appliedGain.data();
+    for (int i = 0; i < n; ++i) {
+        if (qAbs(gain[i] - appliedGain[i]) < 1e-4f)
+            continue;
+        appliedGain[i] = gain[i];
+        m_instances.at(i)->setAttenuationGain(gain[i]);
+        changed = true;
+    }
+    return changed;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,115 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSOUNDEMITTERTABLE_P_H
+#define QSOUNDEMITTERTABLE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/QVector>
+#include <QVector3D>
+
+QT_BEGIN_NAMESPACE
+
+class QSoundInstance;
+class QDeclarativeAttenuationModel;
+
+// Keeps the 3D state of every attenuated sound instance in flat arrays so
+// the engine can recalculate all attenuation gains in a single pass instead
+// of walking the instances one by one.
+class QSoundEmitterTable
+{
+public:
+    QSoundEmitterTable();
+
+    int count() const { return m_instances.count(); }
+    float gain(int index) const { return m_gain.at(index); }
+    bool isDirty() const { return m_dirty; }
+
+    int add(QSoundInstance *instance, QDeclarativeAttenuationModel *model,
+            const QVector3D &position);
+    void remove(int index);
+    void clear();
+
+    void setPosition(int index, const QVector3D &position);
+    void setListenerPosition(const QVector3D &position);
+
+    // Recalculates the gains and pushes the ones that changed to their
+    // instances. Returns true if any gain changed.
+    bool update();
+
+private:
+    QVector3D m_listenerPosition;
+    bool m_dirty;
+    int m_customModelCount;
+
+    QVector<QSoundInstance *> m_instances;
+    QVector<QDeclarativeAttenuationModel *> m_models;
+    QVector<bool> m_custom;
+
+    QVector<float> m_x;
+    QVector<float> m_y;
+    QVector<float> m_z;
+
+    // Both built-in curves reduce to clamping the distance to [lower, upper]
+    // and evaluating
+    //     (1 - d * linearScale) * (reference / (reference + d * rolloff))
+    // with d = clamped distance - lower. Each model leaves the other term at 1.
+    QVector<float> m_lower;
+    QVector<float> m_upper;
+    QVector<float> m_linearScale;
+    QVector<float> m_reference;
+    QVector<float> m_rolloff;
+
+    QVector<float> m_gain;
+    QVector<float> m_appliedGain;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSOUNDEMITTERTABLE_P_H
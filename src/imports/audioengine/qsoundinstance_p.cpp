@@ -47,6 +47,7 @@
 #include "qdeclarative_playvariation_p.h"
 #include "qdeclarative_audioengine_p.h"
 #include "qdeclarative_audiolistener_p.h"
+#include "qsoundemittertable_p.h"
 
 #include "qdebug.h"
 
@@ -68,6 +69,7 @@ QSoundInstance::QSoundInstance(QObject *parent)
     , m_varPitch(1)
     , m_state(QSoundInstance::StoppedState)
     , m_coneOuterGain(0)
+    , m_emitterIndex(-1)
     , m_engine(0)
 {
 #ifdef DEBUG_AUDIOENGINE
@@ -120,6 +122,17 @@ void QSoundInstance::bindSoundDescription(QDeclarativeSound *sound)
     } else {
         m_variationIndex = -1;
     }
+
+    updateEmitter();
+}
+
+void QSoundInstance::updateEmitter()
+{
+    QSoundEmitterTable *emitters = m_engine->emitterTable();
+    if (m_emitterIndex >= 0)
+        emitters->remove(m_emitterIndex);
+    if (m_sound && m_soundSource && m_sound->attenuationModelObject())
+        emitters->add(this, m_sound->attenuationModelObject(), m_position);
 }
 
 QSoundInstance::~QSoundInstance()
@@ -127,6 +140,8 @@ QSoundInstance::~QSoundInstance()
 #ifdef DEBUG_AUDIOENGINE
     qDebug() << "QSoundInstance::dtor()";
 #endif
+    if (m_emitterIndex >= 0)
+        m_engine->emitterTable()->remove(m_emitterIndex);
     if (m_soundSource) {
         detach();
         m_engine->engine()->releaseSoundSource(m_soundSource);
@@ -300,7 +315,10 @@ void QSoundInstance::setPosition(const QVector3D& position)
 {
     if (!m_soundSource)
         return;
+    m_position = position;
     m_soundSource->setPosition(position);
+    if (m_emitterIndex >= 0)
+        m_engine->emitterTable()->setPosition(m_emitterIndex, position);
 }
 
 void QSoundInstance::setDirection(const QVector3D& direction)
@@ -354,10 +372,27 @@ void QSoundInstance::update3DVolume(const QVector3D& listenerPosition)
     QDeclarativeAttenuationModel *attenModel = m_sound->attenuationModelObject();
     if (!attenModel)
         return;
-    m_attenuationGain = attenModel->calculateGain(listenerPosition, m_soundSource->position());
+    setAttenuationGain(attenModel->calculateGain(listenerPosition, m_position));
+}
+
+void QSoundInstance::setAttenuationGain(qreal gain)
+{
+    if (!m_soundSource || m_attenuationGain == gain)
+        return;
+    m_attenuationGain = gain;
     updateGain();
 }
 
+int QSoundInstance::emitterIndex() const
+{
+    return m_emitterIndex;
+}
+
+void QSoundInstance::setEmitterIndex(int index)
+{
+    m_emitterIndex = index;
+}
+
 void QSoundInstance::updateVariationParameters(qreal varPitch, qreal varGain, bool looping)
 {
     if (!m_soundSource)
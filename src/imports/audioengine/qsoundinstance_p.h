@@ -92,9 +92,14 @@ public:
     void bindSoundDescription(QDeclarativeSound *sound);
 
     void update3DVolume(const QVector3D& listenerPosition);
+    void setAttenuationGain(qreal gain);
 
     bool attenuationEnabled() const;
 
+    //row of this instance in the engine's emitter table, -1 if not attenuated
+    int emitterIndex() const;
+    void setEmitterIndex(int index);
+
 Q_SIGNALS:
     void stateChanged(QSoundInstance::State state);
 
@@ -112,6 +117,7 @@ private:
     void setState(State state);
     void prepareNewVariation();
     void detach();
+    void updateEmitter();
     qreal categoryVolume() const;
     void updatePitch();
     void updateGain();
@@ -135,6 +141,8 @@ private:
     qreal                m_varPitch;
     State                m_state;
     qreal                m_coneOuterGain;
+    QVector3D            m_position;
+    int                  m_emitterIndex;
 
     QDeclarativeAudioEngine *m_engine;
 };
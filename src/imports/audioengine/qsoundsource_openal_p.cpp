@@ -40,30 +40,31 @@
 #include "qaudioengine_openal_p.h"
 #include "qdebug.h"
 
+#include <cmath>
+
 #define DEBUG_AUDIOENGINE
 
 QT_USE_NAMESPACE
 
-QSoundSourcePrivate::QSoundSourcePrivate(QObject *parent)
-    : QSoundSource(parent)
+QSoundSourcePrivate::QSoundSourcePrivate(QAudioEnginePrivate *engine)
+    : QSoundSource(engine)
+    , m_engine(engine)
     , m_alSource(0)
     , m_bindBuffer(0)
     , m_isReady(false)
     , m_state(QSoundSource::StoppedState)
-    , m_gain(0)
-    , m_pitch(0)
-    , m_coneInnerAngle(0)
-    , m_coneOuterAngle(0)
-    , m_coneOuterGain(1)
+    , m_virtualState(QSoundSource::StoppedState)
+    , m_gain(1)
+    , m_pitch(1)
+    , m_coneInnerAngle(360)
+    , m_coneOuterAngle(360)
+    , m_coneOuterGain(0)
+    , m_looping(false)
+    , m_offset(0)
 {
 #ifdef DEBUG_AUDIOENGINE
     qDebug() << "creating new QSoundSourcePrivate";
 #endif
-    alGenSources(1, &m_alSource);
-    QAudioEnginePrivate::checkNoError("create source");
-    setGain(1);
-    setPitch(1);
-    setCone(360, 360, 0);
 }
 
 QSoundSourcePrivate::~QSoundSourcePrivate()
@@ -82,28 +83,129 @@ void QSoundSourcePrivate::release()
 #endif
         stop();
         unbindBuffer();
-        alDeleteSources(1, &m_alSource);
-        QAudioEnginePrivate::checkNoError("delete source");
-        m_alSource = 0;
+        m_engine->releaseVoice(detachVoice());
     }
 }
 
+bool QSoundSourcePrivate::hasVoice() const
+{
+    return m_alSource != 0;
+}
+
+qreal QSoundSourcePrivate::audibility() const
+{
+    return m_state == QSoundSource::PlayingState ? m_gain : 0;
+}
+
+void QSoundSourcePrivate::attachVoice(ALuint alSource)
+{
+    Q_ASSERT(!m_alSource && alSource);
+    m_alSource = alSource;
+    applyParameters();
+
+    if (!m_isReady)
+        return;
+    m_bindBuffer->bindToSource(m_alSource);
+    m_bindBuffer->setSourceLooping(m_alSource, m_looping);
+    if (m_virtualState == QSoundSource::StoppedState)
+        return;
+
+    //pick up where the virtual voice is at the moment
+    m_bindBuffer->setSourceOffset(m_alSource, virtualOffset());
+    m_bindBuffer->playSource(m_alSource);
+    if (m_virtualState == QSoundSource::PausedState)
+        alSourcePause(m_alSource);
+#ifdef DEBUG_AUDIOENGINE
+    QAudioEnginePrivate::checkNoError("attach voice");
+#endif
+}
+
+ALuint QSoundSourcePrivate::detachVoice()
+{
+    const ALuint alSource = m_alSource;
+    if (!alSource)
+        return 0;
+
+    if (m_isReady) {
+        const ALint s = m_bindBuffer->sourceState(alSource);
+        const qreal offset = m_bindBuffer->sourceOffset(alSource);
+        switch (s) {
+        case AL_PLAYING:
+            m_virtualState = QSoundSource::PlayingState;
+            break;
+        case AL_PAUSED:
+            m_virtualState = QSoundSource::PausedState;
+            break;
+        default:
+            m_virtualState = QSoundSource::StoppedState;
+            break;
+        }
+        m_offset = m_virtualState == QSoundSource::StoppedState ? 0 : offset;
+        m_virtualClock.start();
+    }
+
+    if (m_bindBuffer) {
+        m_bindBuffer->stopSource(alSource);
+        m_bindBuffer->unbindFromSource(alSource);
+    } else {
+        alSourceStop(alSource);
+    }
+    m_alSource = 0;
+    return alSource;
+}
+
+qreal QSoundSourcePrivate::virtualOffset() const
+{
+    qreal offset = m_offset;
+    if (m_virtualState == QSoundSource::PlayingState)
+        offset += m_virtualClock.elapsed() * m_pitch / 1000;
+    const qreal duration = m_bindBuffer ? m_bindBuffer->duration() : 0;
+    if (m_looping && duration > 0)
+        offset = std::fmod(offset, duration);
+    return offset;
+}
+
+void QSoundSourcePrivate::applyParameters()
+{
+    alSourcef(m_alSource, AL_GAIN, m_gain);
+    alSourcef(m_alSource, AL_PITCH, m_pitch);
+    alSourcei(m_alSource, AL_LOOPING, m_looping ? AL_TRUE : AL_FALSE);
+    alSource3f(m_alSource, AL_POSITION, m_position.x(), m_position.y(), m_position.z());
+    alSource3f(m_alSource, AL_DIRECTION, m_direction.x(), m_direction.y(), m_direction.z());
+    alSource3f(m_alSource, AL_VELOCITY, m_velocity.x(), m_velocity.y(), m_velocity.z());
+    //recycled sources carry the cone of their previous owner, widen it first
+    //so outerAngle >= innerAngle holds after every step
+    alSourcef(m_alSource, AL_CONE_OUTER_ANGLE, 360);
+    alSourcef(m_alSource, AL_CONE_INNER_ANGLE, m_coneInnerAngle);
+    alSourcef(m_alSource, AL_CONE_OUTER_ANGLE, m_coneOuterAngle);
+    alSourcef(m_alSource, AL_CONE_OUTER_GAIN, m_coneOuterGain);
+#ifdef DEBUG_AUDIOENGINE
+    QAudioEnginePrivate::checkNoError("source apply parameters");
+#endif
+}
+
 void QSoundSourcePrivate::bindBuffer(QSoundBuffer* soundBuffer)
 {
     unbindBuffer();
     Q_ASSERT(soundBuffer->state() == QSoundBuffer::Ready);
     m_bindBuffer = qobject_cast<QSoundBufferPrivateAL*>(soundBuffer);
-    m_bindBuffer->bindToSource(m_alSource);
+    if (m_alSource) {
+        m_bindBuffer->bindToSource(m_alSource);
+        m_bindBuffer->setSourceLooping(m_alSource, m_looping);
+    }
     m_isReady = true;
 }
 
 void QSoundSourcePrivate::unbindBuffer()
 {
     if (m_bindBuffer) {
-        m_bindBuffer->unbindFromSource(m_alSource);
+        if (m_alSource)
+            m_bindBuffer->unbindFromSource(m_alSource);
         m_bindBuffer = 0;
     }
     m_isReady = false;
+    m_virtualState = QSoundSource::StoppedState;
+    m_offset = 0;
     if (m_state != QSoundSource::StoppedState) {
         m_state = QSoundSource::StoppedState;
         emit stateChanged(m_state);
@@ -112,39 +214,56 @@ void QSoundSourcePrivate::unbindBuffer()
 
 void QSoundSourcePrivate::play()
 {
-    if (!m_alSource || !m_isReady)
+    if (!m_isReady)
         return;
-    alSourcePlay(m_alSource);
+    if (!m_alSource) {
+        if (m_virtualState != QSoundSource::PausedState)
+            m_offset = 0;
+        m_virtualState = QSoundSource::PlayingState;
+        m_virtualClock.start();
+        //without a free voice the source keeps playing virtually until
+        //the engine finds it audible enough
+        if (ALuint alSource = m_engine->acquireVoice())
+            attachVoice(alSource);
+    } else {
+        m_bindBuffer->playSource(m_alSource);
 #ifdef DEBUG_AUDIOENGINE
-    QAudioEnginePrivate::checkNoError("play");
+        QAudioEnginePrivate::checkNoError("play");
 #endif
+    }
     emit activate(this);
 }
 
 bool QSoundSourcePrivate::isLooping() const
 {
-    if (!m_alSource)
-        return false;
-    ALint looping = 0;
-    alGetSourcei(m_alSource, AL_LOOPING, &looping);
-    return looping == AL_TRUE ? true : false;
+    return m_looping;
 }
 
 void QSoundSourcePrivate::pause()
 {
-    if (!m_alSource || !m_isReady)
+    if (!m_isReady)
         return;
-    alSourcePause(m_alSource);
+    if (m_alSource) {
+        alSourcePause(m_alSource);
 #ifdef DEBUG_AUDIOENGINE
-    QAudioEnginePrivate::checkNoError("pause");
+        QAudioEnginePrivate::checkNoError("pause");
 #endif
+    } else if (m_virtualState == QSoundSource::PlayingState) {
+        m_offset = virtualOffset();
+        m_virtualState = QSoundSource::PausedState;
+    }
 }
 
 void QSoundSourcePrivate::stop()
 {
+    m_virtualState = QSoundSource::StoppedState;
+    m_offset = 0;
     if (!m_alSource)
         return;
-    alSourceStop(m_alSource);
+    if (m_bindBuffer)
+        m_bindBuffer->stopSource(m_alSource);
+    else
+        alSourceStop(m_alSource);
 #ifdef DEBUG_AUDIOENGINE
     QAudioEnginePrivate::checkNoError("stop");
 #endif
@@ -160,9 +279,7 @@ void QSoundSourcePrivate::checkState()
     QSoundSource::State st;
     st = QSoundSource::StoppedState;
     if (m_alSource && m_isReady) {
-        ALint s;
-        alGetSourcei(m_alSource, AL_SOURCE_STATE, &s);
-        switch (s) {
+        switch (m_bindBuffer->sourceState(m_alSource)) {
         case AL_PLAYING:
             st = QSoundSource::PlayingState;
             break;
@@ -170,6 +287,15 @@ void QSoundSourcePrivate::checkState()
             st = QSoundSource::PausedState;
             break;
         }
+    } else if (m_isReady) {
+        if (m_virtualState == QSoundSource::PlayingState && !m_looping) {
+            const qreal duration = m_bindBuffer->duration();
+            if (duration > 0 && virtualOffset() >= duration) {
+                m_virtualState = QSoundSource::StoppedState;
+                m_offset = 0;
+            }
+        }
+        st = m_virtualState;
     }
     if (st == m_state)
         return;
@@ -179,13 +305,24 @@ void QSoundSourcePrivate::checkState()
 
 void QSoundSourcePrivate::setLooping(bool looping)
 {
+    if (m_looping == looping)
+        return;
+    if (!m_alSource && m_virtualState == QSoundSource::PlayingState) {
+        m_offset = virtualOffset();
+        m_virtualClock.start();
+    }
+    m_looping = looping;
     if (!m_alSource)
         return;
-    alSourcei(m_alSource, AL_LOOPING, looping ? AL_TRUE : AL_FALSE);
+    if (m_bindBuffer)
+        m_bindBuffer->setSourceLooping(m_alSource, looping);
+    else
+        alSourcei(m_alSource, AL_LOOPING, looping ? AL_TRUE : AL_FALSE);
 }
 
 void QSoundSourcePrivate::setPosition(const QVector3D& position)
 {
+    m_position = position;
     if (!m_alSource)
         return;
     alSource3f(m_alSource, AL_POSITION, position.x(), position.y(), position.z());
@@ -196,6 +333,7 @@ void QSoundSourcePrivate::setPosition(const QVector3D& position)
 
 void QSoundSourcePrivate::setDirection(const QVector3D& direction)
 {
+    m_direction = direction;
     if (!m_alSource)
         return;
     alSource3f(m_alSource, AL_DIRECTION, direction.x(), direction.y(), direction.z());
@@ -206,6 +344,7 @@ void QSoundSourcePrivate::setDirection(const QVector3D& direction)
 
 void QSoundSourcePrivate::setVelocity(const QVector3D& velocity)
 {
+    m_velocity = velocity;
     if (!m_alSource)
         return;
     alSource3f(m_alSource, AL_VELOCITY, velocity.x(), velocity.y(), velocity.z());
@@ -216,51 +355,47 @@ void QSoundSourcePrivate::setVelocity(const QVector3D& velocity)
 
 QVector3D QSoundSourcePrivate::velocity() const
 {
-    if (!m_alSource)
-        return QVector3D(0, 0, 0);
-    ALfloat x, y, z;
-    alGetSource3f(m_alSource, AL_VELOCITY, &x, &y, &z);
-    return QVector3D(x, y, z);
+    return m_velocity;
 }
 
 QVector3D QSoundSourcePrivate::position() const
 {
-    if (!m_alSource)
-        return QVector3D(0, 0, 0);
-    ALfloat x, y, z;
-    alGetSource3f(m_alSource, AL_POSITION, &x, &y, &z);
-    return QVector3D(x, y, z);
+    return m_position;
 }
 
 QVector3D QSoundSourcePrivate::direction() const
 {
-    if (!m_alSource)
-        return QVector3D(0, 1, 0);
-    ALfloat x, y, z;
-    alGetSource3f(m_alSource, AL_DIRECTION, &x, &y, &z);
-    return QVector3D(x, y, z);
+    return m_direction;
 }
 
 void QSoundSourcePrivate::setGain(qreal gain)
 {
-    if (!m_alSource || gain == m_gain)
+    if (gain == m_gain)
+        return;
+    m_gain = gain;
+    if (!m_alSource)
         return;
     alSourcef(m_alSource, AL_GAIN, gain);
 #ifdef DEBUG_AUDIOENGINE
     QAudioEnginePrivate::checkNoError("source set gain");
 #endif
-    m_gain = gain;
 }
 
 void QSoundSourcePrivate::setPitch(qreal pitch)
 {
-    if (!m_alSource || m_pitch == pitch)
+    if (m_pitch == pitch)
+        return;
+    if (!m_alSource && m_virtualState == QSoundSource::PlayingState) {
+        m_offset = virtualOffset();
+        m_virtualClock.start();
+    }
+    m_pitch = pitch;
+    if (!m_alSource)
         return;
     alSourcef(m_alSource, AL_PITCH, pitch);
 #ifdef DEBUG_AUDIOENGINE
     QAudioEnginePrivate::checkNoError("source set pitch");
 #endif
-    m_pitch = pitch;
 }
 
 void QSoundSourcePrivate::setCone(qreal innerAngle, qreal outerAngle, qreal outerGain)
@@ -269,6 +404,24 @@ void QSoundSourcePrivate::setCone(qreal innerAngle, qreal outerAngle, qreal oute
         outerAngle = innerAngle;
     Q_ASSERT(outerAngle <= 360 && innerAngle >= 0);
 
+    if (m_alSource)
+        applyCone(innerAngle, outerAngle);
+    m_coneInnerAngle = innerAngle;
+    m_coneOuterAngle = outerAngle;
+
+    if (outerGain != m_coneOuterGain) {
+        if (m_alSource) {
+            alSourcef(m_alSource, AL_CONE_OUTER_GAIN, outerGain);
+#ifdef DEBUG_AUDIOENGINE
+            QAudioEnginePrivate::checkNoError("source set cone outerGain");
+#endif
+        }
+        m_coneOuterGain = outerGain;
+    }
+}
+
+void QSoundSourcePrivate::applyCone(qreal innerAngle, qreal outerAngle)
+{
     //make sure the setting order will always keep outerAngle >= innerAngle in openAL
     if (outerAngle >= m_coneInnerAngle) {
         if (m_coneOuterAngle != outerAngle) {
@@ -276,14 +429,12 @@ void QSoundSourcePrivate::setCone(qreal innerAngle, qreal outerAngle, qreal oute
 #ifdef DEBUG_AUDIOENGINE
             QAudioEnginePrivate::checkNoError("source set cone outerAngle");
 #endif
-            m_coneOuterAngle = outerAngle;
         }
         if (m_coneInnerAngle != innerAngle) {
             alSourcef(m_alSource, AL_CONE_INNER_ANGLE, innerAngle);
 #ifdef DEBUG_AUDIOENGINE
             QAudioEnginePrivate::checkNoError("source set cone innerAngle");
 #endif
-            m_coneInnerAngle = innerAngle;
         }
     } else {
         if (m_coneInnerAngle != innerAngle) {
@@ -291,22 +442,12 @@ void QSoundSourcePrivate::setCone(qreal innerAngle, qreal outerAngle, qreal oute
 #ifdef DEBUG_AUDIOENGINE
             QAudioEnginePrivate::checkNoError("source set cone innerAngle");
 #endif
-            m_coneInnerAngle = innerAngle;
         }
         if (m_coneOuterAngle != outerAngle) {
             alSourcef(m_alSource, AL_CONE_OUTER_ANGLE, outerAngle);
 #ifdef DEBUG_AUDIOENGINE
             QAudioEnginePrivate::checkNoError("source set cone outerAngle");
 #endif
-            m_coneOuterAngle = outerAngle;
         }
     }
-
-    if (outerGain != m_coneOuterGain) {
-        alSourcef(m_alSource, AL_CONE_OUTER_GAIN, outerGain);
-#ifdef DEBUG_AUDIOENGINE
-        QAudioEnginePrivate::checkNoError("source set cone outerGain");
-#endif
-        m_coneOuterGain = outerGain;
-    }
 }
@@ -12,7 +12,8 @@ PUBLIC_HEADERS += \
            audio/qsoundeffect.h \
            audio/qsound.h \
            audio/qaudioprobe.h \
-           audio/qaudiodecoder.h
+           audio/qaudiodecoder.h \
+           audio/qaudiobatchdecoder.h
 
 PRIVATE_HEADERS += \
            audio/qaudiobuffer_p.h \
@@ -20,7 +21,9 @@ PRIVATE_HEADERS += \
            audio/qwavedecoder_p.h \
            audio/qsamplecache_p.h \
            audio/qaudiohelpers_p.h \
-           audio/qaudiosystempluginext_p.h
+           audio/qaudiosystempluginext_p.h \
+           audio/qaudioresampler_p.h \
+           audio/qaudioconvertingoutput_p.h
 
 SOURCES += \
            audio/qaudio.cpp \
@@ -38,7 +41,10 @@ SOURCES += \
            audio/qaudiobuffer.cpp \
            audio/qaudioprobe.cpp \
            audio/qaudiodecoder.cpp \
-           audio/qaudiohelpers.cpp
+           audio/qaudiobatchdecoder.cpp \
+           audio/qaudiohelpers.cpp \
+           audio/qaudioresampler_p.cpp \
+           audio/qaudioconvertingoutput_p.cpp
 
 qtConfig(pulseaudio) {
     QMAKE_USE_FOR_PRIVATE += pulseaudio
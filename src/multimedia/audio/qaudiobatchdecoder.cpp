@@ -0,0 +1,512 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qaudiobatchdecoder.h"
+#include "qaudiodecoderbatchcontrol.h"
+#include "qmediaservice.h"
+
+#include <QtCore/qabstracteventdispatcher.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qqueue.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qwaitcondition.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QAudioBatchDecoder
+    \brief The QAudioBatchDecoder class decodes many audio files concurrently.
+    \inmodule QtMultimedia
+    \ingroup multimedia
+    \ingroup multimedia_audio
+    \since 5.15
+
+    \preliminary
+
+    QAudioBatchDecoder runs a bounded pool of worker threads, each owning one
+    QAudioDecoder.  Files passed to decode() are queued and handed to the next
+    idle worker, which reuses its decoder, and with it the backend pipeline,
+    for every file it processes.
+
+    Decoded audio is delivered to the handler set with setBufferHandler(),
+    which is called directly from the worker threads.  When a file has been
+    decoded, or decoding failed, fileFinished() is emitted.
+
+    \code
+    QAudioBatchDecoder decoder;
+    decoder.setBufferHandler([&](int index, const QAudioBuffer &buffer) {
+        analyzer.process(index, buffer); // called from a worker thread
+    });
+    decoder.decode(fileNames);
+    decoder.waitForFinished();
+    \endcode
+
+    Where the backend supports it, the decoders run in synchronous mode, so
+    neither decoded buffers nor the end of each file go through the event
+    loop of any thread.
+
+    \sa QAudioDecoder
+*/
+
+class QAudioBatchDecoderPrivate;
+
+class QAudioBatchDecoderWorker : public QThread
+{
+public:
+    explicit QAudioBatchDecoderWorker(QAudioBatchDecoderPrivate *d)
+        : d(d)
+    {}
+
+protected:
+    void run() override;
+
+private:
+    QAudioBatchDecoderPrivate *d;
+};
+
+class QAudioBatchDecoderPrivate
+{
+public:
+    struct Job
+    {
+        int index;
+        QString fileName;
+    };
+
+    bool isBusy() const { return !jobs.isEmpty() || activeJobs > 0; }
+    bool isCancelled(quint32 jobGeneration) const
+    {
+        QMutexLocker locker(&mutex);
+        return shuttingDown || generation != jobGeneration;
+    }
+
+    void stopWorkers();
+
+    QAudioBatchDecoder *q = nullptr;
+
+    mutable QMutex mutex;
+    QWaitCondition jobAvailable;
+    QWaitCondition idle;
+    QQueue<Job> jobs;
+    QList<QAudioBatchDecoderWorker *> workers;
+
+    int maximumWorkerCount = qMax(1, QThread::idealThreadCount());
+    int framesPerBuffer = 0;
+    QAudioFormat format;
+    QAudioBatchDecoder::BufferHandler handler;
+
+    int nextIndex = 0;
+    int activeJobs = 0;
+    quint32 generation = 0;
+    bool shuttingDown = false;
+};
+
+void QAudioBatchDecoderPrivate::stopWorkers()
+{
+    {
+        QMutexLocker locker(&mutex);
+        shuttingDown = true;
+        jobAvailable.wakeAll();
+    }
+
+    for (QAudioBatchDecoderWorker *worker : qAsConst(workers)) {
+        if (QAbstractEventDispatcher *dispatcher = worker->eventDispatcher())
+            dispatcher->wakeUp();
+        worker->wait();
+        delete worker;
+    }
+    workers.clear();
+
+    QMutexLocker locker(&mutex);
+    shuttingDown = false;
+}
+
+// Media service plugins are not loaded in a thread-safe way,
+// so decoders are created and destroyed one at a time.
+Q_GLOBAL_STATIC(QMutex, serviceMutex)
+
+void QAudioBatchDecoderWorker::run()
+{
+    QScopedPointer<QAudioDecoder> decoder;
+    QAudioDecoderBatchControl *batchControl = nullptr;
+    {
+        QMutexLocker locker(serviceMutex());
+        decoder.reset(new QAudioDecoder);
+        if (QMediaService *service = decoder->service()) {
+            batchControl = qobject_cast<QAudioDecoderBatchControl *>(
+                        service->requestControl(QAudioDecoderBatchControl_iid));
+        }
+    }
+
+    QAtomicInt finished;
+    QAtomicInt error;
+    QObject::connect(decoder.data(), &QAudioDecoder::finished, [&finished]() {
+        finished.storeRelease(1);
+    });
+    QObject::connect(decoder.data(), QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error),
+                     [&error](QAudioDecoder::Error decoderError) {
+        error.storeRelease(decoderError);
+    });
+
+    for (;;) {
+        QAudioBatchDecoderPrivate::Job job;
+        quint32 jobGeneration;
+        int framesPerBuffer;
+        QAudioFormat format;
+        QAudioBatchDecoder::BufferHandler handler;
+        {
+            QMutexLocker locker(&d->mutex);
+            while (d->jobs.isEmpty() && !d->shuttingDown)
+                d->jobAvailable.wait(&d->mutex);
+            if (d->shuttingDown)
+                break;
+
+            job = d->jobs.dequeue();
+            ++d->activeJobs;
+            jobGeneration = d->generation;
+            framesPerBuffer = d->framesPerBuffer;
+            format = d->format;
+            handler = d->handler;
+        }
+
+        bool cancelled = false;
+        finished.storeRelease(0);
+        error.storeRelease(decoder->error() == QAudioDecoder::ServiceMissingError
+                           ? QAudioDecoder::ServiceMissingError : QAudioDecoder::NoError);
+
+        if (error.loadAcquire() == QAudioDecoder::NoError) {
+            decoder->setSourceFilename(job.fileName);
+            decoder->setAudioFormat(format);
+            decoder->setSynchronous(true);
+            decoder->start();
+
+            if (batchControl && decoder->isSynchronous()) {
+                // The end of the stream and errors are taken from the
+                // control, the signals reporting them are delivered through
+                // the owner's event loop, which may never run.
+                for (;;) {
+                    if (d->isCancelled(jobGeneration)) {
+                        cancelled = true;
+                        break;
+                    }
+
+                    const QAudioBuffer buffer = decoder->read(framesPerBuffer, 50);
+                    if (buffer.isValid()) {
+                        if (handler)
+                            handler(job.index, buffer);
+                    } else if (batchControl->atEnd()) {
+                        error.storeRelease(batchControl->streamError());
+                        break;
+                    }
+                }
+            } else {
+                // Without synchronous mode the decoder is driven by this
+                // thread's event loop, so wait for events instead of data.
+                while (!finished.loadAcquire() && error.loadAcquire() == QAudioDecoder::NoError) {
+                    if (d->isCancelled(jobGeneration)) {
+                        cancelled = true;
+                        break;
+                    }
+
+                    const QAudioBuffer buffer = decoder->read(framesPerBuffer, 0);
+                    if (buffer.isValid()) {
+                        if (handler)
+                            handler(job.index, buffer);
+                        continue;
+                    }
+
+                    QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+                }
+
+                // The end of stream is reported before the last buffers are read
+                while (finished.loadAcquire() && !cancelled) {
+                    const QAudioBuffer buffer = decoder->read(framesPerBuffer, 0);
+                    if (!buffer.isValid())
+                        break;
+                    if (handler)
+                        handler(job.index, buffer);
+                }
+            }
+
+            decoder->stop();
+        }
+
+        if (!cancelled && !d->isCancelled(jobGeneration))
+            emit d->q->fileFinished(job.index, job.fileName, QAudioDecoder::Error(error.loadAcquire()));
+
+        bool allDone;
+        {
+            QMutexLocker locker(&d->mutex);
+            --d->activeJobs;
+            allDone = !d->isBusy();
+            if (allDone)
+                d->idle.wakeAll();
+        }
+
+        if (allDone && !cancelled)
+            emit d->q->finished();
+    }
+
+    QMutexLocker locker(serviceMutex());
+    if (batchControl)
+        decoder->service()->releaseControl(batchControl);
+    decoder.reset();
+}
+
+/*!
+    \typedef QAudioBatchDecoder::BufferHandler
+
+    A function called with the index of a file, as returned by decode(), and
+    a buffer of audio decoded from it.  It is called from the worker threads,
+    possibly concurrently for different files, and must be thread-safe.
+    Buffers of one file are delivered in order.
+*/
+
+/*!
+    Constructs a batch decoder parented to \a parent.
+*/
+QAudioBatchDecoder::QAudioBatchDecoder(QObject *parent)
+    : QObject(parent)
+    , d(new QAudioBatchDecoderPrivate)
+{
+    d->q = this;
+}
+
+/*!
+    Destroys the batch decoder.  Pending files are discarded and the files
+    being decoded are cancelled.
+*/
+QAudioBatchDecoder::~QAudioBatchDecoder()
+{
+    cancel();
+    d->stopWorkers();
+    delete d;
+}
+
+/*!
+    Returns the maximum number of files decoded concurrently.
+
+    By default this is QThread::idealThreadCount().
+*/
+int QAudioBatchDecoder::maximumWorkerCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->maximumWorkerCount;
+}
+
+/*!
+    Sets the maximum number of files decoded concurrently to \a count.
+
+    This property can only be changed while no files are being decoded.
+    Setting it at other times is ignored.
+*/
+void QAudioBatchDecoder::setMaximumWorkerCount(int count)
+{
+    {
+        QMutexLocker locker(&d->mutex);
+        if (count < 1 || count == d->maximumWorkerCount || d->isBusy())
+            return;
+        d->maximumWorkerCount = count;
+    }
+
+    // Idle workers are started again on demand
+    d->stopWorkers();
+}
+
+/*!
+    Returns the number of frames per buffer passed to the buffer handler, or
+    0 if buffers are delivered in the size the backend decodes them.
+*/
+int QAudioBatchDecoder::framesPerBuffer() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->framesPerBuffer;
+}
+
+/*!
+    Sets the number of frames per delivered buffer to \a frames.  The last
+    buffer of a file, and the last buffer before a change of format, can be
+    shorter.
+
+    The new value applies to files that start decoding afterwards.
+*/
+void QAudioBatchDecoder::setFramesPerBuffer(int frames)
+{
+    QMutexLocker locker(&d->mutex);
+    d->framesPerBuffer = qMax(0, frames);
+}
+
+/*!
+    Returns the audio format decoded audio is converted to, or an invalid
+    format if each file is delivered in its own format.
+*/
+QAudioFormat QAudioBatchDecoder::audioFormat() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->format;
+}
+
+/*!
+    Sets the audio format decoded audio is converted to to \a format.
+
+    The new value applies to files that start decoding afterwards.
+
+    \sa QAudioDecoder::setAudioFormat()
+*/
+void QAudioBatchDecoder::setAudioFormat(const QAudioFormat &format)
+{
+    QMutexLocker locker(&d->mutex);
+    d->format = format;
+}
+
+/*!
+    Sets the function decoded buffers are passed to to \a handler.
+
+    The new handler applies to files that start decoding afterwards.
+*/
+void QAudioBatchDecoder::setBufferHandler(const BufferHandler &handler)
+{
+    QMutexLocker locker(&d->mutex);
+    d->handler = handler;
+}
+
+/*!
+    Queues \a fileNames for decoding and returns the index of the first one.
+    The following files get consecutive indexes.
+
+    Returns immediately; decoding happens on the worker threads.
+*/
+int QAudioBatchDecoder::decode(const QStringList &fileNames)
+{
+    QMutexLocker locker(&d->mutex);
+
+    const int first = d->nextIndex;
+    for (const QString &fileName : fileNames)
+        d->jobs.enqueue({ d->nextIndex++, fileName });
+
+    // Workers are started on demand and kept for later batches
+    const int wanted = qMin(d->maximumWorkerCount, d->jobs.size() + d->activeJobs);
+    while (d->workers.size() < wanted) {
+        QAudioBatchDecoderWorker *worker = new QAudioBatchDecoderWorker(d);
+        worker->setObjectName(QStringLiteral("QAudioBatchDecoderWorker"));
+        d->workers.append(worker);
+        worker->start();
+    }
+
+    d->jobAvailable.wakeAll();
+    return first;
+}
+
+/*!
+    Returns the number of files queued and not yet being decoded.
+*/
+int QAudioBatchDecoder::pendingCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->jobs.size();
+}
+
+/*!
+    Returns true if files are queued or being decoded.
+*/
+bool QAudioBatchDecoder::isDecoding() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->isBusy();
+}
+
+/*!
+    Waits until all queued files have been decoded, or until \a msecs
+    milliseconds have passed.  A negative \a msecs waits without a timeout.
+
+    Returns true if decoding finished.
+*/
+bool QAudioBatchDecoder::waitForFinished(int msecs)
+{
+    const QDeadlineTimer deadline(msecs < 0 ? qint64(-1) : qint64(msecs));
+
+    QMutexLocker locker(&d->mutex);
+    while (d->isBusy()) {
+        if (!d->idle.wait(&d->mutex, deadline))
+            return !d->isBusy();
+    }
+    return true;
+}
+
+/*!
+    Discards the queued files and stops decoding the current ones.
+    fileFinished() is not emitted for cancelled files.
+*/
+void QAudioBatchDecoder::cancel()
+{
+    QMutexLocker locker(&d->mutex);
+    d->jobs.clear();
+    ++d->generation;
+
+    // Wake up workers waiting for events of a non-synchronous decoder
+    for (QAudioBatchDecoderWorker *worker : qAsConst(d->workers)) {
+        if (QAbstractEventDispatcher *dispatcher = worker->eventDispatcher())
+            dispatcher->wakeUp();
+    }
+}
+
+/*!
+    \fn void QAudioBatchDecoder::fileFinished(int index, const QString &fileName, QAudioDecoder::Error error)
+
+    Signals that decoding of the file \a fileName with the given \a index has
+    ended.  \a error is QAudioDecoder::NoError if the whole file was decoded.
+
+    This signal is emitted from a worker thread.
+*/
+
+/*!
+    \fn void QAudioBatchDecoder::finished()
+
+    Signals that all queued files have been decoded.
+
+    This signal is emitted from a worker thread.
+*/
+
+QT_END_NAMESPACE
+
+#include "moc_qaudiobatchdecoder.cpp"
@@ -0,0 +1,390 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qaudioconvertingoutput_p.h"
+
+#include <QtCore/qdebug.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    QAudioConvertingOutput sits between QAudioOutput and a backend output that
+    cannot play the requested format. The backend is opened with the nearest
+    format the device supports and QAudioResampler converts the stream on its
+    way through, in both push and pull mode.
+*/
+
+QAudioConvertingDevice::QAudioConvertingDevice(QAudioConvertingOutput *output, QIODevice *source,
+                                               QIODevice *sink)
+    : QIODevice(output)
+    , m_output(output)
+    , m_source(source)
+    , m_sink(sink)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(10);
+    connect(&m_flushTimer, SIGNAL(timeout()), SLOT(flush()));
+
+    if (source)
+        connect(source, SIGNAL(readyRead()), SIGNAL(readyRead()));
+}
+
+bool QAudioConvertingDevice::isSequential() const
+{
+    return true;
+}
+
+/*
+    The ALSA, Windows and QNX outputs hand back the tail of a short write by
+    seeking their source to pos() minus the bytes they could not write,
+    without checking isSequential(). The device is a stream, so pos() stays
+    at zero, but a rewind of up to the size of the last read is honoured by
+    putting those bytes back at the front of the queue. Anything else fails.
+*/
+bool QAudioConvertingDevice::seek(qint64 pos)
+{
+    const qint64 rewind = this->pos() - pos;
+    if (rewind < 0 || rewind > m_lastRead.size())
+        return false;
+
+    m_queue.prepend(m_lastRead.right(int(rewind)));
+    m_lastRead.chop(int(rewind));
+    return true;
+}
+
+qint64 QAudioConvertingDevice::bytesAvailable() const
+{
+    qint64 available = m_queue.size();
+    if (m_source)
+        available += m_output->resampler()->outputBytesForInput(m_source->bytesAvailable());
+    return available;
+}
+
+qint64 QAudioConvertingDevice::readData(char *data, qint64 maxlen)
+{
+    if (!m_source)
+        return 0;
+
+    QAudioResampler *resampler = m_output->resampler();
+    const int inputFrameBytes = resampler->inputFormat().bytesPerFrame();
+
+    while (m_queue.size() < maxlen) {
+        const qint64 wanted = qMax<qint64>(resampler->inputBytesForOutput(maxlen - m_queue.size()),
+                                           inputFrameBytes);
+        m_input.resize(int(wanted));
+        const qint64 received = m_source->read(m_input.data(), wanted);
+        if (received <= 0)
+            break;
+        resampler->convert(m_input.constData(), received, &m_queue);
+    }
+
+    const int length = int(qMin<qint64>(maxlen, m_queue.size()));
+    memcpy(data, m_queue.constData(), size_t(length));
+    m_lastRead = m_queue.left(length);
+    m_queue.remove(0, length);
+    return length;
+}
+
+qint64 QAudioConvertingDevice::writeData(const char *data, qint64 len)
+{
+    if (!m_sink)
+        return 0;
+
+    flush();
+
+    // Only take what the device has room for, so the caller sees the same
+    // back pressure as without conversion.
+    const qint64 room = m_output->deviceOutput()->bytesFree() - m_queue.size();
+    const qint64 accepted = qMin(len, m_output->resampler()->inputBytesForOutput(room));
+    if (accepted <= 0)
+        return 0;
+
+    m_output->resampler()->convert(data, accepted, &m_queue);
+    flush();
+    return accepted;
+}
+
+void QAudioConvertingDevice::flush()
+{
+    if (!m_sink || m_queue.isEmpty())
+        return;
+
+    const qint64 written = m_sink->write(m_queue);
+    if (written > 0)
+        m_queue.remove(0, int(written));
+    if (!m_queue.isEmpty())
+        m_flushTimer.start();
+}
+
+QAudioConvertingOutput::QAudioConvertingOutput(QAbstractAudioOutput *output,
+                                               const QAudioDeviceInfo &deviceInfo,
+                                               const QAudioFormat &format,
+                                               QAudioResampler::Quality quality)
+    : m_output(output)
+    , m_deviceInfo(deviceInfo)
+    , m_format(format)
+    , m_quality(quality)
+    , m_resampler(new QAudioResampler(format, output->format(), quality))
+    , m_device(nullptr)
+{
+    m_output->setParent(this);
+    connect(m_output, SIGNAL(errorChanged(QAudio::Error)), SIGNAL(errorChanged(QAudio::Error)));
+    connect(m_output, SIGNAL(stateChanged(QAudio::State)), SIGNAL(stateChanged(QAudio::State)));
+    connect(m_output, SIGNAL(notify()), SIGNAL(notify()));
+}
+
+QAudioConvertingOutput::~QAudioConvertingOutput()
+{
+    m_output->stop();
+    closeDevice();
+    delete m_output;
+}
+
+/*
+    Applies \a format to \a output, or, if \a device can't play \a format,
+    opens \a output with the nearest supported format and returns a converting
+    output wrapping it.
+
+    QT_AUDIO_RESAMPLER sets the default resampling quality: "fast" selects
+    linear interpolation instead of the sinc filter, and "off" disables
+    conversion altogether. The quality can be changed per output with
+    setQuality().
+*/
+QAbstractAudioOutput *QAudioConvertingOutput::create(QAbstractAudioOutput *output,
+                                                     const QAudioDeviceInfo &device,
+                                                     const QAudioFormat &format)
+{
+    const QByteArray mode = qgetenv("QT_AUDIO_RESAMPLER").toLower();
+    if (mode == "off" || !format.isValid() || device.isFormatSupported(format)) {
+        output->setFormat(format);
+        return output;
+    }
+
+    const QAudioFormat deviceFormat = device.nearestFormat(format);
+    if (!QAudioResampler::canConvert(format, deviceFormat)) {
+        output->setFormat(format);
+        return output;
+    }
+
+    output->setFormat(deviceFormat);
+    return new QAudioConvertingOutput(output, device, format,
+                                      mode == "fast" ? QAudioResampler::FastQuality
+                                                     : QAudioResampler::HighQuality);
+}
+
+/*
+    Selects the resampling \a quality for this output. The resampler is
+    rebuilt straight away when the output is stopped, otherwise the new
+    quality applies from the next start(), as a pull mode backend may be
+    reading through the current resampler from another thread.
+*/
+void QAudioConvertingOutput::setQuality(QAudioResampler::Quality quality)
+{
+    if (m_quality == quality)
+        return;
+
+    m_quality = quality;
+    if (!m_device)
+        m_resampler.reset(new QAudioResampler(m_format, m_output->format(), m_quality));
+}
+
+void QAudioConvertingOutput::start(QIODevice *device)
+{
+    m_output->stop();
+    closeDevice();
+    m_resampler.reset(new QAudioResampler(m_format, m_output->format(), m_quality));
+
+    m_device = new QAudioConvertingDevice(this, device, nullptr);
+    m_device->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    m_output->start(m_device);
+}
+
+QIODevice *QAudioConvertingOutput::start()
+{
+    m_output->stop();
+    closeDevice();
+    m_resampler.reset(new QAudioResampler(m_format, m_output->format(), m_quality));
+
+    QIODevice *sink = m_output->start();
+    if (!sink)
+        return nullptr;
+
+    m_device = new QAudioConvertingDevice(this, nullptr, sink);
+    m_device->open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+    return m_device;
+}
+
+void QAudioConvertingOutput::stop()
+{
+    m_output->stop();
+    closeDevice();
+    m_resampler->reset();
+}
+
+void QAudioConvertingOutput::reset()
+{
+    m_output->reset();
+    closeDevice();
+    m_resampler->reset();
+}
+
+void QAudioConvertingOutput::suspend()
+{
+    m_output->suspend();
+}
+
+void QAudioConvertingOutput::resume()
+{
+    m_output->resume();
+}
+
+int QAudioConvertingOutput::bytesFree() const
+{
+    const int queued = m_device ? m_device->queuedBytes() : 0;
+    return toStreamBytes(qMax(0, m_output->bytesFree() - queued));
+}
+
+int QAudioConvertingOutput::periodSize() const
+{
+    return toStreamBytes(m_output->periodSize());
+}
+
+void QAudioConvertingOutput::setBufferSize(int value)
+{
+    m_output->setBufferSize(toDeviceBytes(value));
+}
+
+int QAudioConvertingOutput::bufferSize() const
+{
+    return toStreamBytes(m_output->bufferSize());
+}
+
+void QAudioConvertingOutput::setNotifyInterval(int milliSeconds)
+{
+    m_output->setNotifyInterval(milliSeconds);
+}
+
+int QAudioConvertingOutput::notifyInterval() const
+{
+    return m_output->notifyInterval();
+}
+
+qint64 QAudioConvertingOutput::processedUSecs() const
+{
+    return m_output->processedUSecs();
+}
+
+qint64 QAudioConvertingOutput::elapsedUSecs() const
+{
+    return m_output->elapsedUSecs();
+}
+
+QAudio::Error QAudioConvertingOutput::error() const
+{
+    return m_output->error();
+}
+
+QAudio::State QAudioConvertingOutput::state() const
+{
+    return m_output->state();
+}
+
+void QAudioConvertingOutput::setFormat(const QAudioFormat &format)
+{
+    m_format = format;
+
+    // Renegotiate the device format for the new stream format, a device
+    // format picked for the previous one may not be the nearest any more.
+    QAudioFormat deviceFormat = format;
+    if (!m_deviceInfo.isFormatSupported(format)) {
+        const QAudioFormat nearest = m_deviceInfo.nearestFormat(format);
+        if (QAudioResampler::canConvert(format, nearest))
+            deviceFormat = nearest;
+    }
+    m_output->setFormat(deviceFormat);
+
+    m_resampler.reset(new QAudioResampler(m_format, m_output->format(), m_quality));
+}
+
+QAudioFormat QAudioConvertingOutput::format() const
+{
+    return m_format;
+}
+
+void QAudioConvertingOutput::setVolume(qreal volume)
+{
+    m_output->setVolume(volume);
+}
+
+qreal QAudioConvertingOutput::volume() const
+{
+    return m_output->volume();
+}
+
+QString QAudioConvertingOutput::category() const
+{
+    return m_output->category();
+}
+
+void QAudioConvertingOutput::setCategory(const QString &category)
+{
+    m_output->setCategory(category);
+}
+
+void QAudioConvertingOutput::closeDevice()
+{
+    delete m_device;
+    m_device = nullptr;
+}
+
+int QAudioConvertingOutput::toStreamBytes(int deviceBytes) const
+{
+    return m_format.bytesForDuration(m_output->format().durationForBytes(deviceBytes));
+}
+
+int QAudioConvertingOutput::toDeviceBytes(int streamBytes) const
+{
+    return m_output->format().bytesForDuration(m_format.durationForBytes(streamBytes));
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qaudioconvertingoutput_p.cpp"
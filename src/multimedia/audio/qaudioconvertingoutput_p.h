@@ -0,0 +1,152 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QAUDIOCONVERTINGOUTPUT_P_H
+#define QAUDIOCONVERTINGOUTPUT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMultimedia/qaudiodeviceinfo.h>
+#include <QtMultimedia/qaudiosystem.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qtimer.h>
+
+#include "qaudioresampler_p.h"
+
+QT_BEGIN_NAMESPACE
+
+class QAudioConvertingOutput;
+
+class QAudioConvertingDevice : public QIODevice
+{
+    Q_OBJECT
+public:
+    QAudioConvertingDevice(QAudioConvertingOutput *output, QIODevice *source, QIODevice *sink);
+
+    bool isSequential() const override;
+    bool seek(qint64 pos) override;
+    qint64 bytesAvailable() const override;
+
+    int queuedBytes() const { return m_queue.size(); }
+
+private Q_SLOTS:
+    void flush();
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override;
+    qint64 writeData(const char *data, qint64 len) override;
+
+private:
+    QAudioConvertingOutput *m_output;
+    QPointer<QIODevice> m_source;
+    QPointer<QIODevice> m_sink;
+    QByteArray m_input;
+    QByteArray m_queue;
+    QByteArray m_lastRead;
+    QTimer m_flushTimer;
+};
+
+class QAudioConvertingOutput : public QAbstractAudioOutput
+{
+    Q_OBJECT
+public:
+    QAudioConvertingOutput(QAbstractAudioOutput *output, const QAudioDeviceInfo &deviceInfo,
+                           const QAudioFormat &format,
+                           QAudioResampler::Quality quality = QAudioResampler::HighQuality);
+    ~QAudioConvertingOutput();
+
+    static QAbstractAudioOutput *create(QAbstractAudioOutput *output, const QAudioDeviceInfo &device,
+                                        const QAudioFormat &format);
+
+    QAbstractAudioOutput *deviceOutput() const { return m_output; }
+    QAudioResampler *resampler() const { return m_resampler.data(); }
+
+    QAudioResampler::Quality quality() const { return m_quality; }
+    void setQuality(QAudioResampler::Quality quality);
+
+    void start(QIODevice *device) override;
+    QIODevice *start() override;
+    void stop() override;
+    void reset() override;
+    void suspend() override;
+    void resume() override;
+    int bytesFree() const override;
+    int periodSize() const override;
+    void setBufferSize(int value) override;
+    int bufferSize() const override;
+    void setNotifyInterval(int milliSeconds) override;
+    int notifyInterval() const override;
+    qint64 processedUSecs() const override;
+    qint64 elapsedUSecs() const override;
+    QAudio::Error error() const override;
+    QAudio::State state() const override;
+    void setFormat(const QAudioFormat &format) override;
+    QAudioFormat format() const override;
+    void setVolume(qreal volume) override;
+    qreal volume() const override;
+    QString category() const override;
+    void setCategory(const QString &category) override;
+
+private:
+    void closeDevice();
+    int toStreamBytes(int deviceBytes) const;
+    int toDeviceBytes(int streamBytes) const;
+
+    QAbstractAudioOutput *m_output;
+    QAudioDeviceInfo m_deviceInfo;
+    QAudioFormat m_format;
+    QAudioResampler::Quality m_quality;
+    QScopedPointer<QAudioResampler> m_resampler;
+    QAudioConvertingDevice *m_device;
+};
+
+QT_END_NAMESPACE
+
+#endif // QAUDIOCONVERTINGOUTPUT_P_H
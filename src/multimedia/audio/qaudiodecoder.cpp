@@ -42,9 +42,11 @@
 #include "qmediaobject_p.h"
 #include <qmediaservice.h>
 #include "qaudiodecodercontrol.h"
+#include "qaudiodecoderbatchcontrol.h"
 #include <private/qmediaserviceprovider_p.h>
 
 #include <QtCore/qcoreevent.h>
+#include <QtCore/qdeadlinetimer.h>
 #include <QtCore/qmetaobject.h>
 #include <QtCore/qtimer.h>
 #include <QtCore/qdebug.h>
@@ -86,12 +88,14 @@ public:
     QAudioDecoderPrivate()
         : provider(nullptr)
         , control(nullptr)
+        , batchControl(nullptr)
         , state(QAudioDecoder::StoppedState)
         , error(QAudioDecoder::NoError)
     {}
 
     QMediaServiceProvider *provider;
     QAudioDecoderControl *control;
+    QAudioDecoderBatchControl *batchControl;
     QAudioDecoder::State state;
     QAudioDecoder::Error error;
     QString errorString;
@@ -146,6 +150,9 @@ QAudioDecoder::QAudioDecoder(QObject *parent)
             connect(d->control ,SIGNAL(finished()), this, SIGNAL(finished()));
             connect(d->control ,SIGNAL(positionChanged(qint64)), this, SIGNAL(positionChanged(qint64)));
             connect(d->control ,SIGNAL(durationChanged(qint64)), this, SIGNAL(durationChanged(qint64)));
+
+            d->batchControl = qobject_cast<QAudioDecoderBatchControl*>(
+                        d->service->requestControl(QAudioDecoderBatchControl_iid));
         }
     }
     if (!d->control) {
@@ -163,6 +170,8 @@ QAudioDecoder::~QAudioDecoder()
     Q_D(QAudioDecoder);
 
     if (d->service) {
+        if (d->batchControl)
+            d->service->releaseControl(d->batchControl);
         if (d->control)
             d->service->releaseControl(d->control);
 
@@ -420,6 +429,179 @@ QAudioBuffer QAudioDecoder::read() const
     }
 }
 
+/*!
+    \since 5.15
+
+    Reads up to \a maxFrames frames of decoded audio, waiting at most
+    \a msecs milliseconds for them.  A negative \a msecs waits until
+    \a maxFrames frames have been decoded or decoding stops; 0 only returns
+    data that has already been decoded.  If \a maxFrames is 0 or negative,
+    a single decoded buffer is returned.
+
+    The returned buffer is shorter than requested if the timeout expires,
+    the end of the stream is reached or the audio format changes; an
+    invalid buffer is returned if no data could be read.  Frames that do not
+    fit into \a maxFrames are kept for the next read.
+
+    Unlike read(), this function can be called from any thread.  If the
+    backend does not support batched reads, this function behaves like
+    read() and does not block.
+
+    \sa readAll(), setSynchronous()
+*/
+QAudioBuffer QAudioDecoder::read(int maxFrames, int msecs) const
+{
+    Q_D(const QAudioDecoder);
+
+    if (d->batchControl)
+        return d->batchControl->read(maxFrames, msecs);
+
+    return read();
+}
+
+/*!
+    \since 5.15
+
+    Reads the remaining decoded audio into a single buffer, waiting at most
+    \a msecs milliseconds for decoding to finish.  A negative \a msecs
+    waits until the end of the stream.
+
+    Reading stops early if the audio format of the decoded stream changes,
+    since a QAudioBuffer can only hold data of one format.
+
+    If the backend does not support batched reads, only the buffers that
+    have already been decoded are returned.
+
+    \sa read(), setSynchronous()
+*/
+QAudioBuffer QAudioDecoder::readAll(int msecs) const
+{
+    Q_D(const QAudioDecoder);
+
+    const QDeadlineTimer deadline(msecs < 0 ? qint64(-1) : qint64(msecs));
+
+    QByteArray data;
+    QAudioFormat format;
+    qint64 startTime = -1;
+
+    for (;;) {
+        QAudioBuffer buffer;
+        if (d->batchControl) {
+            if (d->batchControl->atEnd())
+                break;
+            buffer = d->batchControl->read(0, deadline.isForever() ? -1 : int(deadline.remainingTime()));
+        } else {
+            buffer = read();
+        }
+
+        if (!buffer.isValid()) {
+            if (!d->batchControl || deadline.hasExpired())
+                break;
+            continue;
+        }
+
+        if (!format.isValid()) {
+            format = buffer.format();
+            startTime = buffer.startTime();
+        } else if (buffer.format() != format) {
+            qWarning("QAudioDecoder::readAll: audio format changed, data after the change is dropped");
+            break;
+        }
+
+        data.append(static_cast<const char *>(buffer.constData()), buffer.byteCount());
+    }
+
+    if (!format.isValid())
+        return QAudioBuffer();
+
+    return QAudioBuffer(data, format, startTime);
+}
+
+/*!
+    \since 5.15
+
+    Returns the maximum number of decoded buffers the backend queues before
+    decoding pauses to wait for them to be read, or 0 if the backend does not
+    support configuring it.
+
+    \sa setBufferQueueDepth()
+*/
+int QAudioDecoder::bufferQueueDepth() const
+{
+    Q_D(const QAudioDecoder);
+    if (d->batchControl)
+        return d->batchControl->bufferQueueDepth();
+    return 0;
+}
+
+/*!
+    \since 5.15
+
+    Sets the maximum number of queued decoded buffers to \a depth.  A deeper
+    queue lets the decoder run further ahead of the reader.
+
+    This property can only be set while the decoder is stopped.
+    Setting this property at other times will be ignored.
+*/
+void QAudioDecoder::setBufferQueueDepth(int depth)
+{
+    Q_D(QAudioDecoder);
+
+    if (state() != QAudioDecoder::StoppedState || depth < 1)
+        return;
+
+    if (d->batchControl)
+        d->batchControl->setBufferQueueDepth(depth);
+}
+
+/*!
+    \since 5.15
+
+    Returns true if the decoder hands out decoded audio only through
+    read(int, int) and readAll(), without emitting bufferReady() and
+    bufferAvailableChanged().
+
+    \sa setSynchronous()
+*/
+bool QAudioDecoder::isSynchronous() const
+{
+    Q_D(const QAudioDecoder);
+    if (d->batchControl)
+        return d->batchControl->isSynchronous();
+    return false;
+}
+
+/*!
+    \since 5.15
+
+    Enables or disables synchronous mode according to \a synchronous.
+
+    In synchronous mode no signal is emitted per decoded buffer, so decoding
+    does not depend on the event loop of the thread that owns the decoder.
+    This is the fastest way to decode a whole file:
+
+    \code
+    QAudioDecoder decoder;
+    decoder.setSourceFilename(fileName);
+    decoder.setSynchronous(true);
+    decoder.start();
+    QAudioBuffer pcm = decoder.readAll();
+    \endcode
+
+    This property can only be set while the decoder is stopped, and only if
+    the backend supports batched reads.
+*/
+void QAudioDecoder::setSynchronous(bool synchronous)
+{
+    Q_D(QAudioDecoder);
+
+    if (state() != QAudioDecoder::StoppedState)
+        return;
+
+    if (d->batchControl)
+        d->batchControl->setSynchronous(synchronous);
+}
+
 // Enums
 /*!
     \enum QAudioDecoder::State
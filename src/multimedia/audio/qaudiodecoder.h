@@ -95,8 +95,16 @@ public:
     QString errorString() const;
 
     QAudioBuffer read() const;
+    QAudioBuffer read(int maxFrames, int msecs = -1) const;
+    QAudioBuffer readAll(int msecs = -1) const;
     bool bufferAvailable() const;
 
+    int bufferQueueDepth() const;
+    void setBufferQueueDepth(int depth);
+
+    bool isSynchronous() const;
+    void setSynchronous(bool synchronous);
+
     qint64 position() const;
     qint64 duration() const;
 
@@ -45,6 +45,7 @@
 
 #include "qmediapluginloader_p.h"
 #include "qaudiodevicefactory_p.h"
+#include "qaudioconvertingoutput_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -247,7 +248,7 @@ QAbstractAudioOutput* QAudioDeviceFactory::createOutputDevice(QAudioDeviceInfo c
 
     if (plugin) {
         QAbstractAudioOutput* p = plugin->createOutput(deviceInfo.handle());
-        if (p) p->setFormat(format);
+        if (p) p = QAudioConvertingOutput::create(p, deviceInfo, format);
         return p;
     }
 #endif
@@ -44,6 +44,9 @@
 #include "qaudiooutput.h"
 
 #include "qaudiodevicefactory_p.h"
+#include "qaudioconvertingoutput_p.h"
+
+#include <QtCore/qmetaobject.h>
 
 
 QT_BEGIN_NAMESPACE
@@ -78,6 +81,15 @@ QT_BEGIN_NAMESPACE
     output device support it. If you run out of luck, check what's
     up with the error() function.
 
+    If the output device does not support the requested format, but
+    supports a PCM format close to it, QAudioOutput opens the device
+    with that format and converts the sample type, channel layout and
+    sample rate of the stream on the fly. format(), bytesFree() and
+    periodSize() keep referring to the requested format. The conversion
+    uses a windowed sinc resampler; setting the \c QT_AUDIO_RESAMPLER
+    environment variable to \c fast selects linear interpolation
+    instead, and \c off disables the conversion.
+
     After the file has finished playing, we need to stop the device:
 
     \snippet multimedia-snippets/audio.cpp Audio output state changed
@@ -411,6 +423,77 @@ void QAudioOutput::setCategory(const QString &category)
     d->setCategory(category);
 }
 
+// Low latency support is optional for backends and isn't part of
+// QAbstractAudioOutput, so it is reached through the properties of the
+// backend output that plays the stream.
+static QObject *backendObject(QAbstractAudioOutput *output)
+{
+    if (QAudioConvertingOutput *converting = qobject_cast<QAudioConvertingOutput *>(output))
+        return converting->deviceOutput();
+    return output;
+}
+
+static QMetaProperty backendProperty(QAbstractAudioOutput *output, const char *name)
+{
+    const QMetaObject *metaObject = backendObject(output)->metaObject();
+    return metaObject->property(metaObject->indexOfProperty(name));
+}
+
+/*!
+    \since 5.15
+
+    Requests a low latency stream if \a enabled is true.
+
+    A low latency stream keeps only about 10 milliseconds of audio queued
+    in the audio server, or bufferSize() if one was set, and asks for data
+    in small slices. It needs to be fed promptly to avoid underruns, so
+    it is meant for interactive audio such as games and instruments.
+
+    Changing this while the stream is opened will not take effect until
+    it is reopened. Backends without low latency support ignore it; this
+    is currently only supported with PulseAudio.
+
+    In pull mode, PulseAudio reads the QIODevice passed to start() from
+    its own thread as soon as the server asks for data, so the device must
+    be safe to read from another thread while the stream is active.
+
+    \sa isLowLatencyEnabled(), latencyUSecs()
+*/
+void QAudioOutput::setLowLatencyEnabled(bool enabled)
+{
+    const QMetaProperty property = backendProperty(d, "lowLatency");
+    if (property.isWritable())
+        property.write(backendObject(d), enabled);
+}
+
+/*!
+    \since 5.15
+
+    Returns true if a low latency stream was requested and the backend
+    supports it.
+
+    \sa setLowLatencyEnabled()
+*/
+bool QAudioOutput::isLowLatencyEnabled() const
+{
+    const QMetaProperty property = backendProperty(d, "lowLatency");
+    return property.isReadable() && property.read(backendObject(d)).toBool();
+}
+
+/*!
+    \since 5.15
+
+    Returns the current playback latency in microseconds: the time until
+    audio written now is heard. Returns -1 if the backend can't tell.
+
+    \sa setLowLatencyEnabled()
+*/
+qint64 QAudioOutput::latencyUSecs() const
+{
+    const QMetaProperty property = backendProperty(d, "latencyUSecs");
+    return property.isReadable() ? property.read(backendObject(d)).toLongLong() : -1;
+}
+
 /*!
     \fn QAudioOutput::stateChanged(QAudio::State state)
     This signal is emitted when the device \a state has changed.
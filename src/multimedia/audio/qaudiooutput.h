@@ -97,6 +97,10 @@ public:
     QString category() const;
     void setCategory(const QString &category);
 
+    void setLowLatencyEnabled(bool enabled);
+    bool isLowLatencyEnabled() const;
+    qint64 latencyUSecs() const;
+
 Q_SIGNALS:
     void stateChanged(QAudio::State state);
     void notify();
@@ -0,0 +1,552 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qaudioresampler_p.h"
+
+#include <QtCore/qendian.h>
+#include <QtCore/qmath.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    QAudioResampler converts interleaved PCM between sample formats, channel
+    layouts and sample rates, so that a stream can be played on a device that
+    does not support its format.
+
+    Samples are decoded to float, remixed to the output channel count, run
+    through a polyphase windowed sinc filter when the rates differ and then
+    encoded to the output format. FastQuality replaces the sinc filter with
+    linear interpolation.
+*/
+
+namespace {
+
+// Largest number of filter phases; ratios needing more are approximated.
+const int MaximumPhases = 1024;
+// Zero crossings of the sinc on each side of the centre tap at full bandwidth.
+const int HighQualityZeroCrossings = 16;
+const int MaximumHalfTaps = 64;
+const double KaiserBeta = 8.0;
+const int BlockFrames = 4096;
+
+template <typename T, bool BigEndian>
+inline T load(const uchar *p)
+{
+    return BigEndian ? qFromBigEndian<T>(p) : qFromLittleEndian<T>(p);
+}
+
+template <typename T, bool BigEndian>
+inline void store(T value, uchar *p)
+{
+    if (BigEndian)
+        qToBigEndian<T>(value, p);
+    else
+        qToLittleEndian<T>(value, p);
+}
+
+struct U8Sample
+{
+    enum { Bytes = 1 };
+    static float read(const uchar *p) { return (int(p[0]) - 128) * (1.0f / 128.0f); }
+    static void write(float v, uchar *p) { p[0] = uchar(qBound(0.0f, v * 128.0f + 128.0f, 255.0f)); }
+};
+
+struct S8Sample
+{
+    enum { Bytes = 1 };
+    static float read(const uchar *p) { return qint8(p[0]) * (1.0f / 128.0f); }
+    static void write(float v, uchar *p) { p[0] = uchar(qint8(qBound(-128.0f, v * 128.0f, 127.0f))); }
+};
+
+template <bool BigEndian>
+struct S16Sample
+{
+    enum { Bytes = 2 };
+    static float read(const uchar *p) { return load<qint16, BigEndian>(p) * (1.0f / 32768.0f); }
+    static void write(float v, uchar *p)
+    {
+        store<qint16, BigEndian>(qint16(qBound(-32768.0f, v * 32768.0f, 32767.0f)), p);
+    }
+};
+
+template <bool BigEndian>
+struct S24Sample
+{
+    enum { Bytes = 3 };
+    static float read(const uchar *p)
+    {
+        const quint32 v = BigEndian
+                ? (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8)
+                : (quint32(p[2]) << 24) | (quint32(p[1]) << 16) | (quint32(p[0]) << 8);
+        return qint32(v) * (1.0f / 2147483648.0f);
+    }
+    static void write(float v, uchar *p)
+    {
+        const quint32 s = quint32(qint32(qBound(-8388608.0f, v * 8388608.0f, 8388607.0f)));
+        p[BigEndian ? 2 : 0] = uchar(s);
+        p[1] = uchar(s >> 8);
+        p[BigEndian ? 0 : 2] = uchar(s >> 16);
+    }
+};
+
+template <bool BigEndian>
+struct S32Sample
+{
+    enum { Bytes = 4 };
+    static float read(const uchar *p) { return load<qint32, BigEndian>(p) * (1.0f / 2147483648.0f); }
+    static void write(float v, uchar *p)
+    {
+        // 2147483520 is the largest float below 2^31.
+        store<qint32, BigEndian>(qint32(qBound(-2147483648.0f, v * 2147483648.0f, 2147483520.0f)), p);
+    }
+};
+
+template <bool BigEndian>
+struct F32Sample
+{
+    enum { Bytes = 4 };
+    static float read(const uchar *p)
+    {
+        const quint32 bits = load<quint32, BigEndian>(p);
+        float v;
+        memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+    static void write(float v, uchar *p)
+    {
+        quint32 bits;
+        memcpy(&bits, &v, sizeof(bits));
+        store<quint32, BigEndian>(bits, p);
+    }
+};
+
+template <typename Sample>
+void readSamples(const uchar *src, float *dst, qint64 count)
+{
+    for (qint64 i = 0; i < count; ++i)
+        dst[i] = Sample::read(src + i * Sample::Bytes);
+}
+
+template <typename Sample>
+void writeSamples(const float *src, uchar *dst, qint64 count)
+{
+    for (qint64 i = 0; i < count; ++i)
+        Sample::write(src[i], dst + i * Sample::Bytes);
+}
+
+template <template <bool> class Sample>
+inline QAudioResampler::SampleReader reader(bool bigEndian)
+{
+    return bigEndian ? &readSamples<Sample<true> > : &readSamples<Sample<false> >;
+}
+
+template <template <bool> class Sample>
+inline QAudioResampler::SampleWriter writer(bool bigEndian)
+{
+    return bigEndian ? &writeSamples<Sample<true> > : &writeSamples<Sample<false> >;
+}
+
+QAudioResampler::SampleReader readerFor(const QAudioFormat &format)
+{
+    const bool bigEndian = format.byteOrder() == QAudioFormat::BigEndian;
+
+    switch (format.sampleType()) {
+    case QAudioFormat::UnSignedInt:
+        return format.sampleSize() == 8 ? &readSamples<U8Sample> : nullptr;
+    case QAudioFormat::SignedInt:
+        switch (format.sampleSize()) {
+        case 8: return &readSamples<S8Sample>;
+        case 16: return reader<S16Sample>(bigEndian);
+        case 24: return reader<S24Sample>(bigEndian);
+        case 32: return reader<S32Sample>(bigEndian);
+        default: return nullptr;
+        }
+    case QAudioFormat::Float:
+        return format.sampleSize() == 32 ? reader<F32Sample>(bigEndian) : nullptr;
+    default:
+        return nullptr;
+    }
+}
+
+QAudioResampler::SampleWriter writerFor(const QAudioFormat &format)
+{
+    const bool bigEndian = format.byteOrder() == QAudioFormat::BigEndian;
+
+    switch (format.sampleType()) {
+    case QAudioFormat::UnSignedInt:
+        return format.sampleSize() == 8 ? &writeSamples<U8Sample> : nullptr;
+    case QAudioFormat::SignedInt:
+        switch (format.sampleSize()) {
+        case 8: return &writeSamples<S8Sample>;
+        case 16: return writer<S16Sample>(bigEndian);
+        case 24: return writer<S24Sample>(bigEndian);
+        case 32: return writer<S32Sample>(bigEndian);
+        default: return nullptr;
+        }
+    case QAudioFormat::Float:
+        return format.sampleSize() == 32 ? writer<F32Sample>(bigEndian) : nullptr;
+    default:
+        return nullptr;
+    }
+}
+
+double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50 && term > 1e-12 * sum; ++k) {
+        const double t = x / (2.0 * k);
+        term *= t * t;
+        sum += term;
+    }
+    return sum;
+}
+
+int greatestCommonDivisor(int a, int b)
+{
+    while (b) {
+        const int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Four independent accumulators let the compiler map the dot product onto
+// vector registers without needing to reassociate a single running sum.
+inline float dotProduct(const float *a, const float *b, int count)
+{
+    float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < count; ++i)
+        s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+} // namespace
+
+QAudioResampler::QAudioResampler(const QAudioFormat &inputFormat, const QAudioFormat &outputFormat,
+                                 Quality quality)
+    : m_inputFormat(inputFormat)
+    , m_outputFormat(outputFormat)
+    , m_quality(quality)
+    , m_reader(nullptr)
+    , m_writer(nullptr)
+    , m_inputChannels(inputFormat.channelCount())
+    , m_outputChannels(outputFormat.channelCount())
+    , m_inputFrameBytes(inputFormat.bytesPerFrame())
+    , m_outputFrameBytes(outputFormat.bytesPerFrame())
+    , m_identityMatrix(false)
+    , m_up(1)
+    , m_down(1)
+    , m_halfTaps(1)
+    , m_taps(2)
+    , m_index(0)
+    , m_phase(0)
+{
+    if (!canConvert(inputFormat, outputFormat))
+        return;
+
+    m_reader = readerFor(inputFormat);
+    m_writer = writerFor(outputFormat);
+
+    buildMatrix();
+    buildFilter();
+    reset();
+}
+
+QAudioResampler::~QAudioResampler()
+{
+}
+
+/*
+    Returns true if samples in \a inputFormat can be converted to \a outputFormat.
+*/
+bool QAudioResampler::canConvert(const QAudioFormat &inputFormat, const QAudioFormat &outputFormat)
+{
+    const QString pcm = QStringLiteral("audio/pcm");
+    return inputFormat.isValid() && outputFormat.isValid()
+            && inputFormat.codec() == pcm && outputFormat.codec() == pcm
+            && readerFor(inputFormat) && writerFor(outputFormat);
+}
+
+/*
+    Converts \a length bytes of \a data and appends the result to \a output.
+    A trailing partial frame is kept until the next call.
+*/
+void QAudioResampler::convert(const char *data, qint64 length, QByteArray *output)
+{
+    if (!m_reader || !m_writer || length <= 0)
+        return;
+
+    QByteArray joined;
+    const uchar *src = reinterpret_cast<const uchar *>(data);
+    qint64 bytes = length;
+    if (!m_pending.isEmpty()) {
+        joined = m_pending;
+        joined.append(data, int(length));
+        src = reinterpret_cast<const uchar *>(joined.constData());
+        bytes = joined.size();
+    }
+
+    const qint64 frames = bytes / m_inputFrameBytes;
+    m_pending = QByteArray(reinterpret_cast<const char *>(src) + frames * m_inputFrameBytes,
+                           int(bytes - frames * m_inputFrameBytes));
+
+    const bool resampling = m_up != m_down;
+    for (qint64 done = 0; done < frames; done += BlockFrames) {
+        const int block = int(qMin<qint64>(frames - done, BlockFrames));
+
+        m_decoded.resize(block * m_inputChannels);
+        m_reader(src + done * m_inputFrameBytes, m_decoded.data(), qint64(block) * m_inputChannels);
+
+        m_remixed.resize(block * m_outputChannels);
+        remix(m_decoded.constData(), block, m_remixed.data());
+
+        const float *result = m_remixed.constData();
+        int resultFrames = block;
+        if (resampling) {
+            for (int ch = 0; ch < m_outputChannels; ++ch) {
+                QVector<float> &row = m_history[ch];
+                const int offset = row.size();
+                row.resize(offset + block);
+                float *dst = row.data() + offset;
+                for (int i = 0; i < block; ++i)
+                    dst[i] = m_remixed.at(i * m_outputChannels + ch);
+            }
+            resultFrames = resample();
+            result = m_resampled.constData();
+        }
+
+        const int offset = output->size();
+        output->resize(offset + resultFrames * m_outputFrameBytes);
+        m_writer(result, reinterpret_cast<uchar *>(output->data()) + offset,
+                 qint64(resultFrames) * m_outputChannels);
+    }
+}
+
+/*
+    Drops buffered input and filter history, for example after a seek.
+*/
+void QAudioResampler::reset()
+{
+    m_pending.clear();
+    m_history.resize(m_outputChannels);
+    for (QVector<float> &row : m_history)
+        row.fill(0.0f, m_halfTaps - 1);
+    m_index = m_halfTaps - 1;
+    m_phase = 0;
+}
+
+qint64 QAudioResampler::outputBytesForInput(qint64 inputBytes) const
+{
+    if (m_inputFrameBytes <= 0)
+        return 0;
+    const qint64 frames = (inputBytes + m_pending.size()) / m_inputFrameBytes;
+    return (frames * m_up / m_down + 1) * m_outputFrameBytes;
+}
+
+qint64 QAudioResampler::inputBytesForOutput(qint64 outputBytes) const
+{
+    if (m_outputFrameBytes <= 0)
+        return 0;
+    const qint64 frames = outputBytes / m_outputFrameBytes;
+    return ((frames * m_down + m_up - 1) / m_up) * m_inputFrameBytes;
+}
+
+void QAudioResampler::buildMatrix()
+{
+    const int in = m_inputChannels;
+    const int out = m_outputChannels;
+    m_matrix.fill(0.0f, in * out);
+    m_identityMatrix = in == out;
+
+    if (in == out) {
+        for (int ch = 0; ch < in; ++ch)
+            m_matrix[ch * in + ch] = 1.0f;
+    } else if (in == 1) {
+        // Mono goes to the front pair.
+        for (int ch = 0; ch < qMin(out, 2); ++ch)
+            m_matrix[ch] = 1.0f;
+    } else if (out == 1) {
+        // Average everything except the LFE channel.
+        const int used = in > 3 ? in - 1 : in;
+        for (int ch = 0; ch < in; ++ch) {
+            if (in <= 3 || ch != 3)
+                m_matrix[ch] = 1.0f / used;
+        }
+    } else if (out == 2) {
+        // Fold WAVE channel order (FL FR FC LFE BL BR SL SR) into stereo and
+        // scale each side so the sum can't clip.
+        const float side = float(M_SQRT1_2);
+        for (int ch = 0; ch < in; ++ch) {
+            if (ch < 2) {
+                m_matrix[ch * in + ch] = 1.0f;
+            } else if (ch == 2) {
+                m_matrix[ch] = side;
+                m_matrix[in + ch] = side;
+            } else if (ch != 3) {
+                m_matrix[(ch % 2) * in + ch] = side;
+            }
+        }
+        for (int row = 0; row < 2; ++row) {
+            float sum = 0.0f;
+            for (int ch = 0; ch < in; ++ch)
+                sum += m_matrix.at(row * in + ch);
+            if (sum > 1.0f) {
+                for (int ch = 0; ch < in; ++ch)
+                    m_matrix[row * in + ch] /= sum;
+            }
+        }
+    } else {
+        for (int ch = 0; ch < qMin(in, out); ++ch)
+            m_matrix[ch * in + ch] = 1.0f;
+    }
+}
+
+void QAudioResampler::buildFilter()
+{
+    const int inputRate = m_inputFormat.sampleRate();
+    const int outputRate = m_outputFormat.sampleRate();
+    const int divisor = greatestCommonDivisor(inputRate, outputRate);
+    m_up = outputRate / divisor;
+    m_down = inputRate / divisor;
+
+    if (m_up == m_down) {
+        m_up = m_down = 1;
+        m_halfTaps = 1;
+        m_taps = 2;
+        m_coefficients = QVector<float>() << 1.0f << 0.0f;
+        return;
+    }
+
+    if (m_up > MaximumPhases) {
+        // Unusual rate pairs: approximate the ratio, the error is well below 0.1%.
+        m_down = qMax(1, qRound(double(m_down) * MaximumPhases / m_up));
+        m_up = MaximumPhases;
+    }
+
+    const double cutoff = 0.95 * qMin(1.0, double(m_up) / m_down);
+    m_halfTaps = m_quality == FastQuality
+            ? 1 : qMin(MaximumHalfTaps, qCeil(HighQualityZeroCrossings / cutoff));
+    m_taps = 2 * m_halfTaps;
+    m_coefficients.resize(m_up * m_taps);
+
+    const double windowNorm = besselI0(KaiserBeta);
+    for (int phase = 0; phase < m_up; ++phase) {
+        const double frac = double(phase) / m_up;
+        float *c = m_coefficients.data() + phase * m_taps;
+        double sum = 0.0;
+        for (int j = 0; j < m_taps; ++j) {
+            // Distance in input samples from the tap to the output instant.
+            const double x = (j - m_halfTaps + 1) - frac;
+            double value;
+            if (m_quality == FastQuality) {
+                value = qMax(0.0, 1.0 - qAbs(x));
+            } else {
+                const double t = cutoff * x;
+                const double sinc = qFuzzyIsNull(t) ? 1.0 : qSin(M_PI * t) / (M_PI * t);
+                const double r = x / m_halfTaps;
+                const double window = r * r < 1.0 ? besselI0(KaiserBeta * qSqrt(1.0 - r * r)) / windowNorm : 0.0;
+                value = cutoff * sinc * window;
+            }
+            c[j] = float(value);
+            sum += value;
+        }
+        // Unity gain at DC for every phase.
+        for (int j = 0; j < m_taps; ++j)
+            c[j] = float(c[j] / sum);
+    }
+}
+
+void QAudioResampler::remix(const float *input, int frames, float *output) const
+{
+    if (m_identityMatrix) {
+        memcpy(output, input, size_t(frames) * m_inputChannels * sizeof(float));
+        return;
+    }
+
+    for (int frame = 0; frame < frames; ++frame) {
+        const float *in = input + frame * m_inputChannels;
+        float *out = output + frame * m_outputChannels;
+        for (int o = 0; o < m_outputChannels; ++o)
+            out[o] = dotProduct(m_matrix.constData() + o * m_inputChannels, in, m_inputChannels);
+    }
+}
+
+int QAudioResampler::resample()
+{
+    const int available = m_history.first().size();
+    const qint64 bound = qint64(available - m_index) * m_up / m_down + 2;
+    m_resampled.resize(int(bound * m_outputChannels));
+
+    float *out = m_resampled.data();
+    int produced = 0;
+    while (m_index + m_halfTaps < available) {
+        const float *c = m_coefficients.constData() + m_phase * m_taps;
+        const int first = m_index - m_halfTaps + 1;
+        for (int ch = 0; ch < m_outputChannels; ++ch)
+            *out++ = dotProduct(c, m_history.at(ch).constData() + first, m_taps);
+
+        ++produced;
+        m_phase += m_down;
+        m_index += m_phase / m_up;
+        m_phase %= m_up;
+    }
+
+    // Keep only the history the next output still needs.
+    const int consumed = m_index - m_halfTaps + 1;
+    if (consumed > 0) {
+        for (QVector<float> &row : m_history)
+            row.remove(0, consumed);
+        m_index -= consumed;
+    }
+
+    return produced;
+}
+
+QT_END_NAMESPACE
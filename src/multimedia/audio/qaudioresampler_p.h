@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QAUDIORESAMPLER_P_H
+#define QAUDIORESAMPLER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMultimedia/qtmultimediaglobal.h>
+#include <QtMultimedia/qaudioformat.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_MULTIMEDIA_EXPORT QAudioResampler
+{
+public:
+    enum Quality
+    {
+        FastQuality,
+        HighQuality
+    };
+
+    QAudioResampler(const QAudioFormat &inputFormat, const QAudioFormat &outputFormat,
+                    Quality quality = HighQuality);
+    ~QAudioResampler();
+
+    static bool canConvert(const QAudioFormat &inputFormat, const QAudioFormat &outputFormat);
+
+    QAudioFormat inputFormat() const { return m_inputFormat; }
+    QAudioFormat outputFormat() const { return m_outputFormat; }
+    Quality quality() const { return m_quality; }
+
+    void convert(const char *data, qint64 length, QByteArray *output);
+    void reset();
+
+    qint64 outputBytesForInput(qint64 inputBytes) const;
+    qint64 inputBytesForOutput(qint64 outputBytes) const;
+
+    typedef void (*SampleReader)(const uchar *src, float *dst, qint64 count);
+    typedef void (*SampleWriter)(const float *src, uchar *dst, qint64 count);
+
+private:
+    Q_DISABLE_COPY(QAudioResampler)
+
+    void buildMatrix();
+    void buildFilter();
+    void remix(const float *input, int frames, float *output) const;
+    int resample();
+
+    QAudioFormat m_inputFormat;
+    QAudioFormat m_outputFormat;
+    Quality m_quality;
+    SampleReader m_reader;
+    SampleWriter m_writer;
+    int m_inputChannels;
+    int m_outputChannels;
+    int m_inputFrameBytes;
+    int m_outputFrameBytes;
+
+    // Output channel o is the sum of m_matrix[o * m_inputChannels + i] * input channel i.
+    QVector<float> m_matrix;
+    bool m_identityMatrix;
+
+    // Polyphase filter for the rational ratio m_up / m_down; m_taps coefficients
+    // for each of the m_up phases, centred on the current input sample.
+    int m_up;
+    int m_down;
+    int m_halfTaps;
+    int m_taps;
+    QVector<float> m_coefficients;
+
+    // Planar history of remixed input, one row per output channel.
+    QVector<QVector<float> > m_history;
+    int m_index;
+    int m_phase;
+
+    QByteArray m_pending;
+    QVector<float> m_decoded;
+    QVector<float> m_remixed;
+    QVector<float> m_resampled;
+};
+
+QT_END_NAMESPACE
+
+#endif // QAUDIORESAMPLER_P_H
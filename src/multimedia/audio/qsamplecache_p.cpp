@@ -45,6 +45,7 @@
 #include <QtNetwork/QNetworkRequest>
 
 #include <QtCore/QDebug>
+#include <QtCore/QFile>
 //#define QT_SAMPLECACHE_DEBUG
 
 #include <mutex>
@@ -396,9 +397,28 @@ void QSample::load()
 #ifdef QT_SAMPLECACHE_DEBUG
     qDebug() << "QSample: load [" << m_url << "]";
 #endif
-    m_stream = m_parent->networkAccessManager().get(QNetworkRequest(m_url));
-    connect(m_stream, SIGNAL(errorOccurred(QNetworkReply::NetworkError)), SLOT(decoderError()));
+    // Local files and resources are opened directly so the decoder can map
+    // them instead of going through the network stack.
+    const bool isResource = m_url.scheme() == QLatin1String("qrc");
+    if (m_url.isLocalFile() || isResource) {
+        QFile *file = new QFile(isResource ? QLatin1Char(':') + m_url.path() : m_url.toLocalFile());
+        m_stream = file;
+        if (!file->open(QIODevice::ReadOnly)) {
+            QMetaObject::invokeMethod(this, "decoderError", Qt::QueuedConnection);
+            return;
+        }
+    } else {
+        m_stream = m_parent->networkAccessManager().get(QNetworkRequest(m_url));
+        connect(m_stream, SIGNAL(errorOccurred(QNetworkReply::NetworkError)), SLOT(decoderError()));
+    }
     m_waveDecoder = new QWaveDecoder(m_stream);
+
+    // Store samples in host byte order so no backend sees big endian data,
+    // but keep the sample type and width of the file so that 24 and 32 bit
+    // samples keep their precision.
+    QAudioFormat target;
+    target.setSampleType(QAudioFormat::Unknown);
+    m_waveDecoder->setTargetFormat(target);
     connect(m_waveDecoder, SIGNAL(formatKnown()), SLOT(decoderReady()));
     connect(m_waveDecoder, SIGNAL(parsingError()), SLOT(decoderError()));
     connect(m_waveDecoder, SIGNAL(readyRead()), SLOT(readSample()));
@@ -41,9 +41,107 @@
 
 #include <QtCore/qtimer.h>
 #include <QtCore/qendian.h>
+#include <QtCore/qfiledevice.h>
+#include <QtCore/qsysinfo.h>
+
+#include <string.h>
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+
+// Returns the sample at \a p scaled to the full signed 32-bit range, so that
+// every source depth can share one set of output conversions.
+template <int Bytes, bool BigEndian>
+inline qint32 loadSample(const uchar *p)
+{
+    if (Bytes == 1)
+        return qint32((quint32(p[0]) ^ 0x80) << 24);
+    if (Bytes == 2)
+        return qint32(quint32(BigEndian ? qFromBigEndian<quint16>(p) : qFromLittleEndian<quint16>(p)) << 16);
+    if (Bytes == 3) {
+        if (BigEndian)
+            return qint32((quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8));
+        return qint32((quint32(p[2]) << 24) | (quint32(p[1]) << 16) | (quint32(p[0]) << 8));
+    }
+    return BigEndian ? qFromBigEndian<qint32>(p) : qFromLittleEndian<qint32>(p);
+}
+
+// The loops below have no data dependent branches, so the compiler is free
+// to vectorize them for whatever instruction set the build targets.
+template <int Bytes, bool BigEndian>
+void convertToInt16(const uchar *src, uchar *dst, qint64 count)
+{
+    qint16 *out = reinterpret_cast<qint16 *>(dst);
+    for (qint64 i = 0; i < count; ++i)
+        out[i] = qint16(loadSample<Bytes, BigEndian>(src + i * Bytes) >> 16);
+}
+
+template <int Bytes, bool BigEndian>
+void convertToFloat(const uchar *src, uchar *dst, qint64 count)
+{
+    const float scale = 1.0f / 2147483648.0f;
+    float *out = reinterpret_cast<float *>(dst);
+    for (qint64 i = 0; i < count; ++i)
+        out[i] = float(loadSample<Bytes, BigEndian>(src + i * Bytes)) * scale;
+}
+
+template <int Bytes>
+void swapByteOrder(const uchar *src, uchar *dst, qint64 count)
+{
+    for (qint64 i = 0; i < count; ++i) {
+        for (int b = 0; b < Bytes; ++b)
+            dst[i * Bytes + b] = src[i * Bytes + Bytes - 1 - b];
+    }
+}
+
+typedef void (*SampleConverterFunction)(const uchar *src, uchar *dst, qint64 count);
+
+SampleConverterFunction byteSwapperFor(int bytes)
+{
+    switch (bytes) {
+    case 2:
+        return &swapByteOrder<2>;
+    case 3:
+        return &swapByteOrder<3>;
+    case 4:
+        return &swapByteOrder<4>;
+    default:
+        return nullptr;
+    }
+}
+
+template <bool ToFloat, int Bytes, bool BigEndian>
+inline SampleConverterFunction sampleConverter()
+{
+    return ToFloat ? &convertToFloat<Bytes, BigEndian> : &convertToInt16<Bytes, BigEndian>;
+}
+
+template <bool ToFloat>
+SampleConverterFunction sampleConverterFor(int bytes, bool bigEndian)
+{
+    switch (bytes) {
+    case 1:
+        return sampleConverter<ToFloat, 1, false>();
+    case 2:
+        return bigEndian ? sampleConverter<ToFloat, 2, true>() : sampleConverter<ToFloat, 2, false>();
+    case 3:
+        return bigEndian ? sampleConverter<ToFloat, 3, true>() : sampleConverter<ToFloat, 3, false>();
+    case 4:
+        return bigEndian ? sampleConverter<ToFloat, 4, true>() : sampleConverter<ToFloat, 4, false>();
+    default:
+        return nullptr;
+    }
+}
+
+inline QAudioFormat::Endian nativeByteOrder()
+{
+    return QSysInfo::ByteOrder == QSysInfo::BigEndian ? QAudioFormat::BigEndian
+                                                       : QAudioFormat::LittleEndian;
+}
+
+} // namespace
+
 QWaveDecoder::QWaveDecoder(QIODevice *s, QObject *parent):
     QIODevice(parent),
     haveFormat(false),
@@ -51,11 +149,22 @@ QWaveDecoder::QWaveDecoder(QIODevice *s, QObject *parent):
     source(s),
     state(QWaveDecoder::InitialState),
     junkToSkip(0),
-    bigEndian(false)
+    bigEndian(false),
+    hasTarget(false),
+    converter(nullptr),
+    inputSampleBytes(0),
+    outputSampleBytes(0),
+    mapped(nullptr),
+    mapSize(0),
+    headerOffset(0),
+    dataOffset(0),
+    dataRead(0)
 {
     open(QIODevice::ReadOnly | QIODevice::Unbuffered);
 
-    if (enoughDataAvailable())
+    mapSource();
+
+    if (mapped || enoughDataAvailable())
         QTimer::singleShot(0, this, SLOT(handleData()));
     else
         connect(source, SIGNAL(readyRead()), SLOT(handleData()));
@@ -63,21 +172,69 @@ QWaveDecoder::QWaveDecoder(QIODevice *s, QObject *parent):
 
 QWaveDecoder::~QWaveDecoder()
 {
+    if (mapped)
+        static_cast<QFileDevice *>(source)->unmap(const_cast<uchar *>(mapped));
 }
 
+/*
+    Returns the format of the data read from the decoder. This is the format
+    of the file, or the converted format if a target format was set.
+*/
 QAudioFormat QWaveDecoder::audioFormat() const
 {
     return format;
 }
 
+/*
+    Returns the format of the sample data as stored in the file.
+*/
+QAudioFormat QWaveDecoder::sourceFormat() const
+{
+    return fileFormat;
+}
+
 int QWaveDecoder::duration() const
 {
     return size() * 1000 / (format.sampleSize() / 8) / format.channelCount() / format.sampleRate();
 }
 
+/*
+    Requests that samples be converted to \a format while they are read.
+
+    Only the sample type and size are taken from \a format; 16 bit signed
+    integers and 32 bit floats are supported and are always produced in host
+    byte order. If the sample type of \a format is QAudioFormat::Unknown, the
+    sample type and size of the file are kept and only the byte order is
+    converted to the host's. The sample rate and channel layout of the file are
+    kept. If the file already matches, or \a format is not supported, the data
+    is passed through unchanged. This must be called before formatKnown() is
+    emitted.
+*/
+void QWaveDecoder::setTargetFormat(const QAudioFormat &format)
+{
+    if (!haveFormat) {
+        target = format;
+        hasTarget = true;
+    }
+}
+
+QAudioFormat QWaveDecoder::targetFormat() const
+{
+    return target;
+}
+
+/*
+    Returns true if the header and sample data are being read directly from a
+    memory map of the source file.
+*/
+bool QWaveDecoder::isMapped() const
+{
+    return mapped != nullptr;
+}
+
 qint64 QWaveDecoder::size() const
 {
-    return haveFormat ? dataSize : 0;
+    return haveFormat ? convertedSize(dataSize) : 0;
 }
 
 bool QWaveDecoder::isSequential() const
@@ -87,12 +244,53 @@ bool QWaveDecoder::isSequential() const
 
 qint64 QWaveDecoder::bytesAvailable() const
 {
-    return haveFormat ? source->bytesAvailable() : 0;
+    if (!haveFormat)
+        return 0;
+    if (mapped)
+        return convertedSize(dataSize - dataRead);
+    return convertedSize(source->bytesAvailable() + pending.size());
 }
 
 qint64 QWaveDecoder::readData(char *data, qint64 maxlen)
 {
-    return haveFormat ? source->read(data, maxlen) : 0;
+    if (!haveFormat)
+        return 0;
+
+    if (!converter) {
+        if (!mapped)
+            return source->read(data, maxlen);
+
+        const qint64 length = qMin(maxlen, dataSize - dataRead);
+        memcpy(data, mapped + dataOffset + dataRead, length);
+        dataRead += length;
+        return length;
+    }
+
+    qint64 samples = maxlen / outputSampleBytes;
+    if (samples == 0)
+        return 0;
+
+    if (mapped) {
+        samples = qMin(samples, (dataSize - dataRead) / inputSampleBytes);
+        converter(mapped + dataOffset + dataRead, reinterpret_cast<uchar *>(data), samples);
+        dataRead += samples * inputSampleBytes;
+        return samples * outputSampleBytes;
+    }
+
+    // Samples may straddle reads from the source, so keep any partial sample
+    // around for the next call.
+    const int carried = pending.size();
+    pending.resize(samples * inputSampleBytes);
+    qint64 received = 0;
+    if (pending.size() > carried)
+        received = source->read(pending.data() + carried, pending.size() - carried);
+    const qint64 available = carried + qMax<qint64>(received, 0);
+
+    samples = available / inputSampleBytes;
+    converter(reinterpret_cast<const uchar *>(pending.constData()), reinterpret_cast<uchar *>(data), samples);
+    pending.remove(0, int(samples * inputSampleBytes));
+    pending.resize(int(available - samples * inputSampleBytes));
+    return samples * outputSampleBytes;
 }
 
 qint64 QWaveDecoder::writeData(const char *data, qint64 len)
@@ -110,8 +308,176 @@ void QWaveDecoder::parsingFailed()
     emit parsingError();
 }
 
+void QWaveDecoder::sourceAboutToClose()
+{
+    // The mapping goes away with the file, so there is nothing left to read.
+    mapped = nullptr;
+    dataRead = dataSize;
+}
+
+void QWaveDecoder::mapSource()
+{
+    QFileDevice *file = qobject_cast<QFileDevice *>(source);
+    if (!file || !file->isOpen() || file->isSequential())
+        return;
+
+    const qint64 fileSize = file->size();
+    headerOffset = file->pos();
+    if (fileSize - headerOffset < qint64(sizeof(RIFFHeader)))
+        return;
+
+    // Compressed resources and some file systems can't be mapped, in which
+    // case the decoder reads through the device as usual.
+    mapped = file->map(0, fileSize);
+    if (!mapped)
+        return;
+
+    mapSize = fileSize;
+    connect(file, SIGNAL(aboutToClose()), SLOT(sourceAboutToClose()));
+}
+
+bool QWaveDecoder::parseMappedHeader()
+{
+    qint64 offset = headerOffset;
+
+    RIFFHeader riff;
+    memcpy(&riff, mapped + offset, sizeof(RIFFHeader));
+    if (((qstrncmp(riff.descriptor.id, "RIFF", 4) != 0) && (qstrncmp(riff.descriptor.id, "RIFX", 4) != 0))
+            || qstrncmp(riff.type, "WAVE", 4) != 0) {
+        return false;
+    }
+    bigEndian = qstrncmp(riff.descriptor.id, "RIFX", 4) == 0;
+    offset += sizeof(RIFFHeader);
+
+    // Walk the chunk table once; the fmt chunk has to precede the data chunk.
+    bool formatFound = false;
+    while (mapSize - offset >= qint64(sizeof(chunk))) {
+        chunk descriptor;
+        memcpy(&descriptor, mapped + offset, sizeof(chunk));
+        descriptor.size = bigEndian ? qFromBigEndian<quint32>(descriptor.size)
+                                    : qFromLittleEndian<quint32>(descriptor.size);
+
+        if (qstrncmp(descriptor.id, "fmt ", 4) == 0) {
+            if (descriptor.size < sizeof(WAVEHeader) - sizeof(chunk)
+                    || mapSize - offset < qint64(sizeof(WAVEHeader))) {
+                return false;
+            }
+            WAVEHeader wave;
+            memcpy(&wave, mapped + offset, sizeof(WAVEHeader));
+            if (!readFormatHeader(wave))
+                return false;
+            formatFound = true;
+        } else if (formatFound && qstrncmp(descriptor.id, "data", 4) == 0) {
+            dataOffset = offset + sizeof(chunk);
+            dataSize = qMin<qint64>(descriptor.size, mapSize - dataOffset);
+            return true;
+        }
+
+        // Chunks are padded to an even size.
+        offset += sizeof(chunk) + descriptor.size + (descriptor.size & 1);
+    }
+
+    return false;
+}
+
+bool QWaveDecoder::readFormatHeader(const WAVEHeader &wave)
+{
+    const quint16 audioFormat = bigEndian ? qFromBigEndian<quint16>(wave.audioFormat)
+                                          : qFromLittleEndian<quint16>(wave.audioFormat);
+
+    if (audioFormat != 0 && audioFormat != 1) {
+        // 32bit wave files have format == 0xFFFE (WAVE_FORMAT_EXTENSIBLE).
+        // but don't support them at the moment.
+        return false;
+    }
+
+    format.setCodec(QLatin1String("audio/pcm"));
+
+    if (bigEndian) {
+        int bps = qFromBigEndian<quint16>(wave.bitsPerSample);
+
+        format.setSampleType(bps == 8 ? QAudioFormat::UnSignedInt : QAudioFormat::SignedInt);
+        format.setByteOrder(QAudioFormat::BigEndian);
+        format.setSampleRate(qFromBigEndian<quint32>(wave.sampleRate));
+        format.setSampleSize(bps);
+        format.setChannelCount(qFromBigEndian<quint16>(wave.numChannels));
+    } else {
+        int bps = qFromLittleEndian<quint16>(wave.bitsPerSample);
+
+        format.setSampleType(bps == 8 ? QAudioFormat::UnSignedInt : QAudioFormat::SignedInt);
+        format.setByteOrder(QAudioFormat::LittleEndian);
+        format.setSampleRate(qFromLittleEndian<quint32>(wave.sampleRate));
+        format.setSampleSize(bps);
+        format.setChannelCount(qFromLittleEndian<quint16>(wave.numChannels));
+    }
+
+    return true;
+}
+
+void QWaveDecoder::formatComplete()
+{
+    fileFormat = format;
+
+    if (!hasTarget || fileFormat.sampleSize() % 8 != 0)
+        return;
+
+    const int bytes = fileFormat.sampleSize() / 8;
+
+    if (target.sampleType() == QAudioFormat::Unknown) {
+        if (fileFormat.byteOrder() == nativeByteOrder())
+            return;
+        converter = byteSwapperFor(bytes);
+        if (!converter)
+            return;
+        inputSampleBytes = bytes;
+        outputSampleBytes = bytes;
+        format.setByteOrder(nativeByteOrder());
+        return;
+    }
+
+    const bool toInt16 = target.sampleType() == QAudioFormat::SignedInt && target.sampleSize() == 16;
+    const bool toFloat = target.sampleType() == QAudioFormat::Float && target.sampleSize() == 32;
+    if (!toInt16 && !toFloat)
+        return;
+
+    if (fileFormat.sampleType() == target.sampleType()
+            && fileFormat.sampleSize() == target.sampleSize()
+            && fileFormat.byteOrder() == nativeByteOrder()) {
+        return;
+    }
+
+    converter = toFloat ? sampleConverterFor<true>(bytes, bigEndian) : sampleConverterFor<false>(bytes, bigEndian);
+    if (!converter)
+        return;
+
+    inputSampleBytes = bytes;
+    outputSampleBytes = target.sampleSize() / 8;
+    format.setSampleType(target.sampleType());
+    format.setSampleSize(target.sampleSize());
+    format.setByteOrder(nativeByteOrder());
+}
+
+qint64 QWaveDecoder::convertedSize(qint64 rawBytes) const
+{
+    if (!converter)
+        return rawBytes;
+    return rawBytes / inputSampleBytes * outputSampleBytes;
+}
+
 void QWaveDecoder::handleData()
 {
+    if (mapped && state == QWaveDecoder::InitialState) {
+        state = QWaveDecoder::WaitingForDataState;
+        if (!parseMappedHeader()) {
+            parsingFailed();
+            return;
+        }
+        formatComplete();
+        haveFormat = true;
+        emit formatKnown();
+        return;
+    }
+
     // As a special "state", if we have junk to skip, we do
     if (junkToSkip > 0) {
         discardBytes(junkToSkip); // this also updates junkToSkip
@@ -161,41 +527,12 @@ void QWaveDecoder::handleData()
             if (rawChunkSize > sizeof(WAVEHeader))
                 discardBytes(rawChunkSize - sizeof(WAVEHeader));
 
-            // Swizzle this
-            if (bigEndian) {
-                wave.audioFormat = qFromBigEndian<quint16>(wave.audioFormat);
-            } else {
-                wave.audioFormat = qFromLittleEndian<quint16>(wave.audioFormat);
-            }
-
-            if (wave.audioFormat != 0 && wave.audioFormat != 1) {
-                // 32bit wave files have format == 0xFFFE (WAVE_FORMAT_EXTENSIBLE).
-                // but don't support them at the moment.
+            if (!readFormatHeader(wave)) {
                 parsingFailed();
                 return;
-            } else {
-                format.setCodec(QLatin1String("audio/pcm"));
-
-                if (bigEndian) {
-                    int bps = qFromBigEndian<quint16>(wave.bitsPerSample);
-
-                    format.setSampleType(bps == 8 ? QAudioFormat::UnSignedInt : QAudioFormat::SignedInt);
-                    format.setByteOrder(QAudioFormat::BigEndian);
-                    format.setSampleRate(qFromBigEndian<quint32>(wave.sampleRate));
-                    format.setSampleSize(bps);
-                    format.setChannelCount(qFromBigEndian<quint16>(wave.numChannels));
-                } else {
-                    int bps = qFromLittleEndian<quint16>(wave.bitsPerSample);
-
-                    format.setSampleType(bps == 8 ? QAudioFormat::UnSignedInt : QAudioFormat::SignedInt);
-                    format.setByteOrder(QAudioFormat::LittleEndian);
-                    format.setSampleRate(qFromLittleEndian<quint32>(wave.sampleRate));
-                    format.setSampleSize(bps);
-                    format.setChannelCount(qFromLittleEndian<quint16>(wave.numChannels));
-                }
-
-                state = QWaveDecoder::WaitingForDataState;
             }
+
+            state = QWaveDecoder::WaitingForDataState;
         }
     }
 
@@ -212,6 +549,7 @@ void QWaveDecoder::handleData()
 
             dataSize = descriptor.size;
 
+            formatComplete();
             haveFormat = true;
             connect(source, SIGNAL(readyRead()), SIGNAL(readyRead()));
             emit formatKnown();
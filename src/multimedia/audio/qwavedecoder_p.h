@@ -68,8 +68,14 @@ public:
     ~QWaveDecoder();
 
     QAudioFormat audioFormat() const;
+    QAudioFormat sourceFormat() const;
     int duration() const;
 
+    void setTargetFormat(const QAudioFormat &format);
+    QAudioFormat targetFormat() const;
+
+    bool isMapped() const;
+
     qint64 size() const override;
     bool isSequential() const override;
     qint64 bytesAvailable() const override;
@@ -80,6 +86,7 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void handleData();
+    void sourceAboutToClose();
 
 private:
     qint64 readData(char *data, qint64 maxlen) override;
@@ -90,6 +97,11 @@ private:
     void discardBytes(qint64 numBytes);
     void parsingFailed();
 
+    void mapSource();
+    bool parseMappedHeader();
+    void formatComplete();
+    qint64 convertedSize(qint64 rawBytes) const;
+
     enum State {
         InitialState,
         WaitingForFormatState,
@@ -118,6 +130,7 @@ private:
         quint16     blockAlign;
         quint16     bitsPerSample;
     };
+    bool readFormatHeader(const WAVEHeader &wave);
 
     bool haveFormat;
     qint64 dataSize;
@@ -126,6 +139,24 @@ private:
     State state;
     quint32 junkToSkip;
     bool bigEndian;
+
+    // Output conversion, chosen once the fmt chunk is known.
+    typedef void (*SampleConverter)(const uchar *src, uchar *dst, qint64 count);
+    QAudioFormat fileFormat;
+    QAudioFormat target;
+    bool hasTarget;
+    SampleConverter converter;
+    int inputSampleBytes;
+    int outputSampleBytes;
+    QByteArray pending;
+
+    // Fast path for seekable files: the whole file is mapped and the chunk
+    // table is walked directly in memory.
+    const uchar *mapped;
+    qint64 mapSize;
+    qint64 headerOffset;
+    qint64 dataOffset;
+    qint64 dataRead;
 };
 
 QT_END_NAMESPACE
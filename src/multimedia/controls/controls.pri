@@ -24,6 +24,7 @@ PUBLIC_HEADERS += \
     controls/qmediagaplessplaybackcontrol.h \
     controls/qmedianetworkaccesscontrol.h \
     controls/qmediaplayercontrol.h \
+    controls/qmediaplayerframestepcontrol.h \
     controls/qmediarecordercontrol.h \
     controls/qmediastreamscontrol.h \
     controls/qmetadatareadercontrol.h \
@@ -38,7 +39,10 @@ PUBLIC_HEADERS += \
     controls/qmediavideoprobecontrol.h \
     controls/qmediaavailabilitycontrol.h \
     controls/qaudiorolecontrol.h \
-    controls/qcustomaudiorolecontrol.h
+    controls/qcustomaudiorolecontrol.h \
+    controls/qmediarecorderprerollcontrol.h \
+    controls/qmediarecordersegmentcontrol.h \
+    controls/qaudiodecoderbatchcontrol.h
 
 PRIVATE_HEADERS += \
     controls/qmediaplaylistcontrol_p.h \
@@ -63,6 +67,7 @@ SOURCES += \
     controls/qmediagaplessplaybackcontrol.cpp \
     controls/qmedianetworkaccesscontrol.cpp \
     controls/qmediaplayercontrol.cpp \
+    controls/qmediaplayerframestepcontrol.cpp \
     controls/qmediaplaylistcontrol.cpp \
     controls/qmediaplaylistsourcecontrol.cpp \
     controls/qmediarecordercontrol.cpp \
@@ -83,4 +88,7 @@ SOURCES += \
     controls/qaudiooutputselectorcontrol.cpp \
     controls/qvideodeviceselectorcontrol.cpp \
     controls/qaudiorolecontrol.cpp \
-    controls/qcustomaudiorolecontrol.cpp
+    controls/qcustomaudiorolecontrol.cpp \
+    controls/qmediarecorderprerollcontrol.cpp \
+    controls/qmediarecordersegmentcontrol.cpp \
+    controls/qaudiodecoderbatchcontrol.cpp
@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qaudiodecoderbatchcontrol.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QAudioDecoderBatchControl
+    \inmodule QtMultimedia
+    \ingroup multimedia_control
+    \since 5.15
+
+    \brief The QAudioDecoderBatchControl class provides pull-style access to
+    the decoded data of an audio decoding service.
+
+    The regular QAudioDecoderControl interface notifies the owner thread of
+    every decoded buffer.  This control lets a client pull decoded audio in
+    batches of a given number of frames instead, optionally blocking until
+    the data is available.  read() may be called from any thread, which makes
+    it possible to decode offline without running an event loop.
+
+    In synchronous mode the service does not emit
+    QAudioDecoderControl::bufferReady() or
+    QAudioDecoderControl::bufferAvailableChanged() at all; decoded buffers are
+    only handed out by read().
+
+    The functionality provided by this control is exposed to application
+    code through the QAudioDecoder class.
+
+    The interface name of QAudioDecoderBatchControl is
+    \c org.qt-project.qt.audiodecoderbatchcontrol/5.15 as defined in
+    QAudioDecoderBatchControl_iid.
+
+    \sa QMediaService::requestControl(), QAudioDecoder
+*/
+
+/*!
+    \macro QAudioDecoderBatchControl_iid
+
+    \c org.qt-project.qt.audiodecoderbatchcontrol/5.15
+
+    Defines the interface name of the QAudioDecoderBatchControl class.
+
+    \relates QAudioDecoderBatchControl
+*/
+
+/*!
+    Constructs a batch decoding control with the given \a parent.
+*/
+QAudioDecoderBatchControl::QAudioDecoderBatchControl(QObject *parent)
+    : QMediaControl(parent)
+{
+}
+
+/*!
+    Destroys the batch decoding control.
+*/
+QAudioDecoderBatchControl::~QAudioDecoderBatchControl()
+{
+}
+
+/*!
+    \fn int QAudioDecoderBatchControl::bufferQueueDepth() const
+
+    Returns the maximum number of decoded buffers the service queues before
+    the decoder waits for them to be read.
+*/
+
+/*!
+    \fn void QAudioDecoderBatchControl::setBufferQueueDepth(int depth)
+
+    Sets the maximum number of queued decoded buffers to \a depth.  The new
+    value takes effect the next time decoding is started.
+*/
+
+/*!
+    \fn bool QAudioDecoderBatchControl::isSynchronous() const
+
+    Returns true if the service hands out decoded buffers through read() only,
+    without notifying the owner thread.
+*/
+
+/*!
+    \fn void QAudioDecoderBatchControl::setSynchronous(bool synchronous)
+
+    Enables or disables synchronous mode according to \a synchronous.  The
+    new value takes effect the next time decoding is started.
+*/
+
+/*!
+    \fn QAudioBuffer QAudioDecoderBatchControl::read(int maxFrames, int msecs)
+
+    Returns up to \a maxFrames frames of decoded audio, waiting at most
+    \a msecs milliseconds for them to become available.  A negative \a msecs
+    waits until enough data has been decoded or the end of the stream is
+    reached; 0 returns only what is already queued.
+
+    If \a maxFrames is 0 or negative a single decoded buffer is returned, in
+    the size it was produced by the decoder.
+
+    The returned buffer holds fewer than \a maxFrames frames if the timeout
+    expires, the stream ends or the audio format changes.  Frames beyond
+    \a maxFrames are kept for the next call.
+
+    This function is thread-safe.
+*/
+
+/*!
+    \fn bool QAudioDecoderBatchControl::atEnd() const
+
+    Returns true if decoding has stopped and no more frames can be read.
+*/
+
+/*!
+    \fn QAudioDecoder::Error QAudioDecoderBatchControl::streamError() const
+
+    Returns the error that stopped decoding of the current stream, or
+    QAudioDecoder::NoError.  Unlike QAudioDecoderControl::error(), the value
+    is available as soon as the decoder stops, without the owner thread's
+    event loop running.
+
+    This function is thread-safe.
+*/
+
+QT_END_NAMESPACE
+
+#include "moc_qaudiodecoderbatchcontrol.cpp"
@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qmediaplayerframestepcontrol.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMediaPlayerFrameStepControl
+    \inmodule QtMultimedia
+    \ingroup multimedia_control
+    \since 5.15
+
+    \brief The QMediaPlayerFrameStepControl class provides frame accurate
+    seeking and single frame stepping for a media player service.
+
+    By default a media player seeks to the closest key frame, which is fast
+    but can land several frames away from the requested position.  With
+    accurate seeking enabled the service decodes from the preceding key frame
+    and presents exactly the frame at the requested position.
+
+    step() moves the playhead by a number of video frames, forwards or
+    backwards, and leaves the player paused.  Services may keep a small cache
+    of decoded frames around the playhead, so that stepping back and forth
+    within it does not decode the stream again.
+
+    The interface name of QMediaPlayerFrameStepControl is
+    \c org.qt-project.qt.mediaplayerframestepcontrol/5.15 as defined in
+    QMediaPlayerFrameStepControl_iid.
+
+    \sa QMediaService::requestControl(), QMediaPlayer
+*/
+
+/*!
+    \macro QMediaPlayerFrameStepControl_iid
+
+    \c org.qt-project.qt.mediaplayerframestepcontrol/5.15
+
+    Defines the interface name of the QMediaPlayerFrameStepControl class.
+
+    \relates QMediaPlayerFrameStepControl
+*/
+
+/*!
+    Constructs a frame step control with the given \a parent.
+*/
+QMediaPlayerFrameStepControl::QMediaPlayerFrameStepControl(QObject *parent)
+    : QMediaControl(parent)
+{
+}
+
+/*!
+    Destroys the frame step control.
+*/
+QMediaPlayerFrameStepControl::~QMediaPlayerFrameStepControl()
+{
+}
+
+/*!
+    \fn bool QMediaPlayerFrameStepControl::isAccurateSeekEnabled() const
+
+    Returns true if seeks land on the exact requested position rather than on
+    the closest key frame.
+*/
+
+/*!
+    \fn void QMediaPlayerFrameStepControl::setAccurateSeekEnabled(bool enabled)
+
+    Enables or disables accurate seeking according to \a enabled.
+*/
+
+/*!
+    \fn bool QMediaPlayerFrameStepControl::step(int frames)
+
+    Moves the playhead by \a frames video frames; a negative value steps
+    backwards.  The player is paused first if it is playing.
+
+    Returns true if the step was started.
+*/
+
+/*!
+    \fn int QMediaPlayerFrameStepControl::frameCacheSize() const
+
+    Returns the maximum number of decoded frames kept around the playhead, or
+    0 if no frames are cached.
+*/
+
+/*!
+    \fn void QMediaPlayerFrameStepControl::setFrameCacheSize(int frames)
+
+    Sets the maximum number of decoded frames kept around the playhead to
+    \a frames.  Setting 0 disables the cache.
+*/
+
+/*!
+    \fn void QMediaPlayerFrameStepControl::accurateSeekEnabledChanged(bool enabled)
+
+    Signals that accurate seeking has been \a enabled or disabled.
+*/
+
+/*!
+    \fn void QMediaPlayerFrameStepControl::frameCacheSizeChanged(int frames)
+
+    Signals that the frame cache size has changed to \a frames.
+*/
+
+QT_END_NAMESPACE
+
+#include "moc_qmediaplayerframestepcontrol.cpp"
@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qmediarecorderprerollcontrol.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMediaRecorderPreRollControl
+    \inmodule QtMultimedia
+    \ingroup multimedia_control
+    \since 5.15
+
+    \brief The QMediaRecorderPreRollControl class provides control over the
+    pre-roll ("instant replay") buffer of a recording service.
+
+    When pre-roll is enabled the media service encodes the captured streams
+    continuously and keeps the most recent encoded data in a bounded in-memory
+    buffer.  When recording is started the buffered data is written to the
+    output before the live data, so the recording includes up to
+    preRollDuration() milliseconds captured before QMediaRecorder::record()
+    was called.
+
+    The buffer always starts at a key frame, so the actual amount of pre-roll
+    in a recording can exceed the requested duration by up to one group of
+    pictures, and is limited by maximumPreRollSize().
+
+    The interface name of QMediaRecorderPreRollControl is
+    \c org.qt-project.qt.mediarecorderprerollcontrol/5.15 as defined in
+    QMediaRecorderPreRollControl_iid.
+
+    \sa QMediaService::requestControl(), QMediaRecorder
+*/
+
+/*!
+    \macro QMediaRecorderPreRollControl_iid
+
+    \c org.qt-project.qt.mediarecorderprerollcontrol/5.15
+
+    Defines the interface name of the QMediaRecorderPreRollControl class.
+
+    \relates QMediaRecorderPreRollControl
+*/
+
+/*!
+    Constructs a pre-roll control with the given \a parent.
+*/
+QMediaRecorderPreRollControl::QMediaRecorderPreRollControl(QObject *parent)
+    : QMediaControl(parent)
+{
+}
+
+/*!
+    Destroys the pre-roll control.
+*/
+QMediaRecorderPreRollControl::~QMediaRecorderPreRollControl()
+{
+}
+
+/*!
+    \fn qint64 QMediaRecorderPreRollControl::preRollDuration() const
+
+    Returns the requested pre-roll duration in milliseconds.  A value of 0
+    means pre-roll is disabled.
+*/
+
+/*!
+    \fn void QMediaRecorderPreRollControl::setPreRollDuration(qint64 msecs)
+
+    Sets the pre-roll duration to \a msecs milliseconds.  Setting 0 disables
+    pre-roll.
+
+    Enabling pre-roll may start the capture device, since data has to be
+    encoded before recording is requested.
+*/
+
+/*!
+    \fn qint64 QMediaRecorderPreRollControl::maximumPreRollSize() const
+
+    Returns the maximum amount of memory in bytes the pre-roll buffer may use
+    for each elementary stream.
+*/
+
+/*!
+    \fn void QMediaRecorderPreRollControl::setMaximumPreRollSize(qint64 bytes)
+
+    Sets the maximum amount of memory the pre-roll buffer may use for each
+    elementary stream to \a bytes.  When the limit is reached the oldest
+    group of pictures is discarded, even if the buffer then holds less than
+    preRollDuration().
+*/
+
+/*!
+    \fn qint64 QMediaRecorderPreRollControl::bufferedDuration() const
+
+    Returns the duration in milliseconds of the encoded data currently held
+    in the pre-roll buffer.
+*/
+
+/*!
+    \fn qint64 QMediaRecorderPreRollControl::bufferedSize() const
+
+    Returns the size in bytes of the encoded data currently held in the
+    pre-roll buffer.
+*/
+
+/*!
+    \fn void QMediaRecorderPreRollControl::preRollDurationChanged(qint64 msecs)
+
+    Signals that the pre-roll duration has changed to \a msecs.
+*/
+
+/*!
+    \fn void QMediaRecorderPreRollControl::maximumPreRollSizeChanged(qint64 bytes)
+
+    Signals that the maximum pre-roll buffer size has changed to \a bytes.
+*/
+
+QT_END_NAMESPACE
+
+#include "moc_qmediarecorderprerollcontrol.cpp"
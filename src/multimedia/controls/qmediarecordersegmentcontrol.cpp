@@ -0,0 +1,143 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qmediarecordersegmentcontrol.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QMediaRecorderSegmentControl
+    \inmodule QtMultimedia
+    \ingroup multimedia_control
+    \since 5.15
+
+    \brief The QMediaRecorderSegmentControl class provides control over
+    segmented recording.
+
+    When a maximum segment duration or size is set, the media service splits
+    the recording into several files instead of writing one ever-growing
+    file.  A new segment is started at the first key frame after a limit is
+    reached, and no samples are lost between two segments.
+
+    The segment files are named after the output location of the recorder,
+    with a zero padded segment number inserted before the file extension.
+    The segmentFinished() signal is emitted each time a segment file has been
+    completely written.
+
+    The interface name of QMediaRecorderSegmentControl is
+    \c org.qt-project.qt.mediarecordersegmentcontrol/5.15 as defined in
+    QMediaRecorderSegmentControl_iid.
+
+    \sa QMediaService::requestControl(), QMediaRecorder
+*/
+
+/*!
+    \macro QMediaRecorderSegmentControl_iid
+
+    \c org.qt-project.qt.mediarecordersegmentcontrol/5.15
+
+    Defines the interface name of the QMediaRecorderSegmentControl class.
+
+    \relates QMediaRecorderSegmentControl
+*/
+
+/*!
+    Constructs a segment control with the given \a parent.
+*/
+QMediaRecorderSegmentControl::QMediaRecorderSegmentControl(QObject *parent)
+    : QMediaControl(parent)
+{
+}
+
+/*!
+    Destroys the segment control.
+*/
+QMediaRecorderSegmentControl::~QMediaRecorderSegmentControl()
+{
+}
+
+/*!
+    \fn qint64 QMediaRecorderSegmentControl::maximumSegmentDuration() const
+
+    Returns the maximum duration of a segment in milliseconds, or 0 if the
+    segment duration is not limited.
+*/
+
+/*!
+    \fn void QMediaRecorderSegmentControl::setMaximumSegmentDuration(qint64 msecs)
+
+    Sets the maximum duration of a segment to \a msecs milliseconds.  The
+    setting is applied when the next recording starts.
+*/
+
+/*!
+    \fn qint64 QMediaRecorderSegmentControl::maximumSegmentSize() const
+
+    Returns the maximum size of a segment in bytes, or 0 if the segment size
+    is not limited.
+*/
+
+/*!
+    \fn void QMediaRecorderSegmentControl::setMaximumSegmentSize(qint64 bytes)
+
+    Sets the maximum size of a segment to \a bytes.  The setting is applied
+    when the next recording starts.
+*/
+
+/*!
+    \fn void QMediaRecorderSegmentControl::maximumSegmentDurationChanged(qint64 msecs)
+
+    Signals that the maximum segment duration has changed to \a msecs.
+*/
+
+/*!
+    \fn void QMediaRecorderSegmentControl::maximumSegmentSizeChanged(qint64 bytes)
+
+    Signals that the maximum segment size has changed to \a bytes.
+*/
+
+/*!
+    \fn void QMediaRecorderSegmentControl::segmentFinished(const QUrl &location)
+
+    Signals that the segment file at \a location has been completely written.
+*/
+
+QT_END_NAMESPACE
+
+#include "moc_qmediarecordersegmentcontrol.cpp"
@@ -26,7 +26,8 @@ PRIVATE_HEADERS += \
     qmediaresourceset_p.h \
     qmediastoragelocation_p.h \
     qmediaopenglhelper_p.h \
-    qmultimediautils_p.h
+    qmultimediautils_p.h \
+    qmultimediaobjectpool_p.h
 
 PUBLIC_HEADERS += \
     qtmultimediaglobal.h \
@@ -12,7 +12,8 @@ PRIVATE_HEADERS += \
     playback/qmediaplaylistioplugin_p.h \
     playback/qmediaplaylistnavigator_p.h \
     playback/qmedianetworkplaylistprovider_p.h \
-    playback/qplaylistfileparser_p.h
+    playback/qplaylistfileparser_p.h \
+    playback/qplaylisttokenizer_p.h
 
 SOURCES += \
     playback/qmedianetworkplaylistprovider.cpp \
@@ -23,4 +24,5 @@ SOURCES += \
     playback/qmediaplaylistnavigator.cpp \
     playback/qmediaplaylistprovider.cpp \
     playback/qmediaresource.cpp \
-    playback/qplaylistfileparser.cpp
+    playback/qplaylistfileparser.cpp \
+    playback/qplaylisttokenizer.cpp
@@ -51,6 +51,7 @@
 #include <qmedianetworkaccesscontrol.h>
 #include <qaudiorolecontrol.h>
 #include <qcustomaudiorolecontrol.h>
+#include <qmediaplayerframestepcontrol.h>
 
 #include <QtCore/qcoreevent.h>
 #include <QtCore/qmetaobject.h>
@@ -115,6 +116,7 @@ public:
         , control(nullptr)
         , audioRoleControl(nullptr)
         , customAudioRoleControl(nullptr)
+        , frameStepControl(nullptr)
         , playlist(nullptr)
         , networkAccessControl(nullptr)
         , state(QMediaPlayer::StoppedState)
@@ -129,6 +131,7 @@ public:
     QMediaPlayerControl* control;
     QAudioRoleControl *audioRoleControl;
     QCustomAudioRoleControl *customAudioRoleControl;
+    QMediaPlayerFrameStepControl *frameStepControl;
     QString errorString;
 
     QPointer<QObject> videoOutput;
@@ -642,6 +645,9 @@ QMediaPlayer::QMediaPlayer(QObject *parent, QMediaPlayer::Flags flags):
                             &QMediaPlayer::customAudioRoleChanged);
                 }
             }
+
+            d->frameStepControl = qobject_cast<QMediaPlayerFrameStepControl *>(
+                    d->service->requestControl(QMediaPlayerFrameStepControl_iid));
         }
         if (d->networkAccessControl != nullptr) {
             connect(d->networkAccessControl, &QMediaNetworkAccessControl::configurationChanged,
@@ -671,6 +677,8 @@ QMediaPlayer::~QMediaPlayer()
             d->service->releaseControl(d->audioRoleControl);
         if (d->customAudioRoleControl)
             d->service->releaseControl(d->customAudioRoleControl);
+        if (d->frameStepControl)
+            d->service->releaseControl(d->frameStepControl);
 
         d->provider->releaseService(d->service);
     }
@@ -1310,6 +1318,105 @@ QStringList QMediaPlayer::supportedCustomAudioRoles() const
     return QStringList();
 }
 
+/*!
+    \since 5.15
+
+    Returns true if setPosition() lands on the exact requested position
+    rather than on the closest key frame.
+
+    Accurate seeking is disabled by default, or if the backend does not
+    support it.
+
+    \sa setAccurateSeekEnabled(), stepFrames()
+*/
+bool QMediaPlayer::isAccurateSeekEnabled() const
+{
+    Q_D(const QMediaPlayer);
+
+    if (d->frameStepControl)
+        return d->frameStepControl->isAccurateSeekEnabled();
+
+    return false;
+}
+
+/*!
+    \since 5.15
+
+    Enables or disables accurate seeking according to \a enabled.
+
+    An accurate seek decodes from the key frame preceding the requested
+    position, so it can take noticeably longer than a key frame seek,
+    depending on the distance between key frames in the stream.
+*/
+void QMediaPlayer::setAccurateSeekEnabled(bool enabled)
+{
+    Q_D(QMediaPlayer);
+
+    if (d->frameStepControl)
+        d->frameStepControl->setAccurateSeekEnabled(enabled);
+}
+
+/*!
+    \since 5.15
+
+    Moves the playhead by \a frames video frames and presents the resulting
+    frame; a negative value steps backwards.  If the player is playing it is
+    paused first.
+
+    Returns false if the backend does not support frame stepping, or if the
+    current media cannot be stepped, for example because it is not seekable
+    or has no video.
+
+    \sa setFrameCacheSize(), setAccurateSeekEnabled()
+*/
+bool QMediaPlayer::stepFrames(int frames)
+{
+    Q_D(QMediaPlayer);
+
+    if (!d->frameStepControl || frames == 0 || d->state == StoppedState)
+        return false;
+
+    return d->frameStepControl->step(frames);
+}
+
+/*!
+    \since 5.15
+
+    Returns the maximum number of decoded video frames the backend keeps
+    around the playhead, or 0 if frames are not cached.
+
+    \sa setFrameCacheSize()
+*/
+int QMediaPlayer::frameCacheSize() const
+{
+    Q_D(const QMediaPlayer);
+
+    if (d->frameStepControl)
+        return d->frameStepControl->frameCacheSize();
+
+    return 0;
+}
+
+/*!
+    \since 5.15
+
+    Sets the maximum number of decoded video frames kept around the playhead
+    to \a frames.
+
+    Frames are cached while the player is paused, for example while stepping
+    with stepFrames().  Stepping back and forth within the cached frames
+    presents them directly instead of seeking and decoding the stream again.
+    Each cached frame holds a full decoded picture, so the cache should be
+    kept small for high resolution video.  Setting 0 disables the cache.
+*/
+void QMediaPlayer::setFrameCacheSize(int frames)
+{
+    Q_D(QMediaPlayer);
+
+    if (d->frameStepControl)
+        d->frameStepControl->setFrameCacheSize(qMax(frames, 0));
+}
+
 // Enums
 /*!
     \enum QMediaPlayer::State
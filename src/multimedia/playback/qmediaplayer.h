@@ -172,6 +172,13 @@ QT_WARNING_POP
     void setCustomAudioRole(const QString &audioRole);
     QStringList supportedCustomAudioRoles() const;
 
+    bool isAccurateSeekEnabled() const;
+    void setAccurateSeekEnabled(bool enabled);
+    bool stepFrames(int frames);
+
+    int frameCacheSize() const;
+    void setFrameCacheSize(int frames);
+
 public Q_SLOTS:
     void play();
     void pause();
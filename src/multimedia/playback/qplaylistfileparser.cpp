@@ -38,8 +38,10 @@
 ****************************************************************************/
 
 #include "qplaylistfileparser_p.h"
+#include "qplaylisttokenizer_p.h"
 #include <qfileinfo.h>
 #include <QtCore/QDebug>
+#include <QtCore/qfile.h>
 #include <QtCore/qiodevice.h>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
@@ -275,7 +277,9 @@ public:
         : q_ptr(q)
         , m_stream(nullptr)
         , m_type(QPlaylistFileParser::UNKNOWN)
-        , m_scanIndex(0)
+        , m_mapped(nullptr)
+        , m_chunkBegin(nullptr)
+        , m_chunkEnd(nullptr)
         , m_lineIndex(-1)
         , m_utf8(false)
         , m_aborted(false)
@@ -289,7 +293,9 @@ public:
 
     QScopedPointer<QNetworkReply, QScopedPointerDeleteLater> m_source;
     QScopedPointer<ParserBase> m_currentParser;
-    QByteArray      m_buffer;
+    QScopedPointer<QFile> m_file;
+    QPlaylistTokenizer m_tokenizer;
+    QByteArray      m_chunk;
     QUrl            m_root;
     QNetworkAccessManager m_mgr;
     QString m_mimeType;
@@ -304,19 +310,22 @@ public:
         bool isValid() const { return m_stream || !m_media.isNull(); }
         void reset() { m_stream = nullptr; m_media = QMediaContent(); m_mimeType = QString(); }
     } m_pendingJob;
-    int m_scanIndex;
+    const uchar *m_mapped;
+    // The data currently handed to m_tokenizer
+    const char *m_chunkBegin;
+    const char *m_chunkEnd;
     int m_lineIndex;
     bool m_utf8;
     bool m_aborted;
 
 private:
-    bool processLine(int startIndex, int length);
+    bool processLine(const QPlaylistTokenizer::Line &line);
+    bool parse();
 };
 
 #define LINE_LIMIT  4096
-#define READ_LIMIT  64
 
-bool QPlaylistFileParserPrivate::processLine(int startIndex, int length)
+bool QPlaylistFileParserPrivate::processLine(const QPlaylistTokenizer::Line &rawLine)
 {
     Q_Q(QPlaylistFileParser);
     m_lineIndex++;
@@ -324,8 +333,13 @@ bool QPlaylistFileParserPrivate::processLine(int startIndex, int length)
     if (!m_currentParser) {
         const QString urlString = m_root.toString();
         const QString &suffix = !urlString.isEmpty() ? QFileInfo(urlString).suffix() : urlString;
-        const QString &mimeType = m_source->header(QNetworkRequest::ContentTypeHeader).toString();
-        m_type = QPlaylistFileParser::findPlaylistType(suffix, !mimeType.isEmpty() ?  mimeType : m_mimeType, m_buffer.constData(), quint32(m_buffer.size()));
+        const QString &mimeType = m_source ? m_source->header(QNetworkRequest::ContentTypeHeader).toString() : QString();
+        // Give the header check everything from the first line on that is
+        // at hand, not just that line.
+        quint32 headerSize = quint32(rawLine.size);
+        if (rawLine.data >= m_chunkBegin && rawLine.data < m_chunkEnd)
+            headerSize = quint32(m_chunkEnd - rawLine.data);
+        m_type = QPlaylistFileParser::findPlaylistType(suffix, !mimeType.isEmpty() ?  mimeType : m_mimeType, rawLine.data, headerSize);
 
         switch (m_type) {
         case QPlaylistFileParser::UNKNOWN:
@@ -348,72 +362,74 @@ bool QPlaylistFileParserPrivate::processLine(int startIndex, int length)
         Q_ASSERT(!m_currentParser.isNull());
     }
 
-    QString line;
-
-    if (m_utf8) {
-        line = QString::fromUtf8(m_buffer.constData() + startIndex, length).trimmed();
-    } else {
-        line = QString::fromLatin1(m_buffer.constData() + startIndex, length).trimmed();
-    }
-    if (line.isEmpty())
+    const QPlaylistTokenizer::Line trimmed = rawLine.trimmed();
+    if (trimmed.size == 0)
         return true;
 
+    const QString line = m_utf8 ? QString::fromUtf8(trimmed.data, trimmed.size)
+                                : QString::fromLatin1(trimmed.data, trimmed.size);
+
     Q_ASSERT(m_currentParser);
     return m_currentParser->parseLine(m_lineIndex, line, m_root);
 }
 
-void QPlaylistFileParserPrivate::handleData()
+// Feeds the lines of the current chunk to the parser. Returns false when
+// parsing has to stop.
+bool QPlaylistFileParserPrivate::parse()
 {
     Q_Q(QPlaylistFileParser);
-    while (m_source->bytesAvailable() && !m_aborted) {
-        int expectedBytes = qMin(READ_LIMIT, int(qMin(m_source->bytesAvailable(),
-                                                      qint64(LINE_LIMIT - m_buffer.size()))));
-        m_buffer.push_back(m_source->read(expectedBytes));
-        int processedBytes = 0;
-        while (m_scanIndex < m_buffer.length() && !m_aborted) {
-            char s = m_buffer[m_scanIndex];
-            if (s == '\r' || s == '\n') {
-                int l = m_scanIndex - processedBytes;
-                if (l > 0) {
-                    if (!processLine(processedBytes, l))
-                        break;
-                }
-                processedBytes = m_scanIndex + 1;
-                if (!m_source) {
-                    //some error happened, so exit parsing
-                    return;
-                }
-            }
-            m_scanIndex++;
-        }
-
-        if (m_aborted)
-            break;
-
-        if (m_buffer.length() - processedBytes >= LINE_LIMIT) {
+    QPlaylistTokenizer::Line line;
+    while (!m_aborted && m_tokenizer.next(&line)) {
+        if (line.size >= LINE_LIMIT || m_tokenizer.pendingSize() >= LINE_LIMIT) {
             emit q->error(QPlaylistFileParser::FormatError, QPlaylistFileParser::tr("invalid line in playlist file"));
             q->abort();
-            break;
+            return false;
         }
+        if (!processLine(line))
+            return false;
+    }
 
-        if (m_source->isFinished() && !m_source->bytesAvailable()) {
-            //last line
-            processLine(processedBytes, -1);
-            break;
-        }
+    if (!m_aborted && m_tokenizer.pendingSize() >= LINE_LIMIT) {
+        emit q->error(QPlaylistFileParser::FormatError, QPlaylistFileParser::tr("invalid line in playlist file"));
+        q->abort();
+    }
 
-        Q_ASSERT(m_buffer.length() == m_scanIndex);
-        if (processedBytes == 0)
-            continue;
+    return !m_aborted;
+}
 
-        int copyLength = m_buffer.length() - processedBytes;
-        if (copyLength > 0) {
-            Q_ASSERT(copyLength <= READ_LIMIT);
-            m_buffer = m_buffer.right(copyLength);
-        } else {
-            m_buffer.clear();
-        }
-        m_scanIndex = 0;
+void QPlaylistFileParserPrivate::handleData()
+{
+    if (m_mapped) {
+        // A mapped local file is parsed in place, in one go.
+        m_chunkBegin = reinterpret_cast<const char *>(m_mapped);
+        m_chunkEnd = m_chunkBegin + m_file->size();
+        m_tokenizer.setData(m_chunkBegin, m_file->size());
+        m_tokenizer.finish();
+        parse();
+        handleParserFinished();
+        return;
+    }
+
+    QIODevice *device = m_source ? static_cast<QIODevice *>(m_source.data()) : m_stream;
+    if (!device)
+        return;
+
+    // Take everything that has arrived and tokenize it where it lies; only a
+    // line split across two reads is copied.
+    while (!m_aborted) {
+        const bool finished = m_source ? m_source->isFinished() : device->atEnd();
+        m_chunk = device->read(device->bytesAvailable());
+        if (m_chunk.isEmpty() && !finished)
+            return;
+
+        m_chunkBegin = m_chunk.constData();
+        m_chunkEnd = m_chunkBegin + m_chunk.size();
+        m_tokenizer.setData(m_chunkBegin, m_chunk.size());
+        if (finished && !device->bytesAvailable())
+            m_tokenizer.finish();
+
+        if (!parse() || m_tokenizer.isFinished())
+            break;
     }
 
     handleParserFinished();
@@ -526,7 +542,7 @@ void QPlaylistFileParser::start(QIODevice *stream, const QString &mimeType)
     d->reset();
     d->m_mimeType = mimeType;
     d->m_stream = stream;
-    connect(d->m_stream, SIGNAL(readyRead()), this, SLOT(_q_handleData()));
+    connect(d->m_stream, SIGNAL(readyRead()), this, SLOT(handleData()));
     d->handleData();
 }
 
@@ -549,6 +565,20 @@ void QPlaylistFileParser::start(const QNetworkRequest& request, const QString &m
     d->reset();
     d->m_root = url;
     d->m_mimeType = mimeType;
+
+    if (url.isLocalFile()) {
+        QScopedPointer<QFile> file(new QFile(url.toLocalFile()));
+        if (file->open(QIODevice::ReadOnly) && file->size() > 0)
+            d->m_mapped = file->map(0, file->size());
+        if (d->m_mapped) {
+            // Parse on the next event loop pass, so that items and finished()
+            // are delivered after start() returns, as for network replies.
+            d->m_file.swap(file);
+            QMetaObject::invokeMethod(this, "handleData", Qt::QueuedConnection);
+            return;
+        }
+    }
+
     d->m_source.reset(d->m_mgr.get(request));
     connect(d->m_source.data(), SIGNAL(readyRead()), this, SLOT(handleData()));
     connect(d->m_source.data(), SIGNAL(finished()), this, SLOT(handleData()));
@@ -594,6 +624,12 @@ void QPlaylistFileParserPrivate::handleParserFinished()
     if (!m_source.isNull())
         m_source.reset();
 
+    m_mapped = nullptr;
+    m_file.reset();
+    m_chunk.clear();
+    m_chunkBegin = nullptr;
+    m_chunkEnd = nullptr;
+
     if (m_pendingJob.isValid())
         q->start(m_pendingJob.m_media, m_pendingJob.m_stream, m_pendingJob.m_mimeType);
 }
@@ -609,12 +645,15 @@ void QPlaylistFileParserPrivate::reset()
 {
     Q_ASSERT(m_currentParser.isNull());
     Q_ASSERT(m_source.isNull());
-    m_buffer.clear();
+    m_tokenizer.reset();
+    m_chunk.clear();
     m_root.clear();
     m_mimeType.clear();
     m_stream = 0;
+    m_mapped = nullptr;
+    m_chunkBegin = nullptr;
+    m_chunkEnd = nullptr;
     m_type = QPlaylistFileParser::UNKNOWN;
-    m_scanIndex = 0;
     m_lineIndex = -1;
     m_utf8 = false;
     m_aborted = false;
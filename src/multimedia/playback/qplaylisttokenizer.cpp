@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplaylisttokenizer_p.h"
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+// Looks for either byte in a single pass. Searching for one of them to the
+// end of the data first would rescan the rest of the buffer on every line of
+// a file that only uses the other one.
+static const char *findLineBreak(const char *begin, const char *end)
+{
+    for (const char *p = begin; p < end; ++p) {
+        if (*p == '\n' || *p == '\r')
+            return p;
+    }
+    return nullptr;
+}
+
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\v' || c == '\f';
+}
+
+bool QPlaylistTokenizer::Line::startsWith(const char *prefix) const
+{
+    const int length = int(strlen(prefix));
+    return size >= length && memcmp(data, prefix, size_t(length)) == 0;
+}
+
+QPlaylistTokenizer::Line QPlaylistTokenizer::Line::trimmed() const
+{
+    Line line = *this;
+    while (line.size > 0 && isSpace(line.data[0])) {
+        ++line.data;
+        --line.size;
+    }
+    while (line.size > 0 && isSpace(line.data[line.size - 1]))
+        --line.size;
+    return line;
+}
+
+QPlaylistTokenizer::QPlaylistTokenizer()
+{
+    reset();
+}
+
+void QPlaylistTokenizer::setData(const char *data, qint64 size)
+{
+    m_data = data;
+    m_end = data + size;
+
+    if (m_atStart && m_pending.isEmpty() && size > 0) {
+        if (size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0)
+            m_data += 3;
+        m_atStart = false;
+    }
+}
+
+void QPlaylistTokenizer::finish()
+{
+    m_finished = true;
+}
+
+void QPlaylistTokenizer::reset()
+{
+    m_data = nullptr;
+    m_end = nullptr;
+    m_pending.clear();
+    m_line.clear();
+    m_atStart = true;
+    m_finished = false;
+}
+
+bool QPlaylistTokenizer::next(Line *line)
+{
+    while (m_data < m_end) {
+        const char *start = m_data;
+        const char *lineBreak = findLineBreak(start, m_end);
+        if (!lineBreak) {
+            // The line continues in the next chunk
+            m_pending.append(start, int(m_end - start));
+            m_data = m_end;
+            break;
+        }
+        m_data = lineBreak + 1;
+
+        if (!m_pending.isEmpty()) {
+            m_pending.append(start, int(lineBreak - start));
+            m_line.swap(m_pending);
+            m_pending.clear();
+            line->data = m_line.constData();
+            line->size = m_line.size();
+            return true;
+        }
+
+        if (lineBreak > start) {
+            line->data = start;
+            line->size = int(lineBreak - start);
+            return true;
+        }
+    }
+
+    if (m_finished && !m_pending.isEmpty()) {
+        m_line.swap(m_pending);
+        m_pending.clear();
+        line->data = m_line.constData();
+        line->size = m_line.size();
+        return true;
+    }
+
+    return false;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QPLAYLISTTOKENIZER_P_H
+#define QPLAYLISTTOKENIZER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qtmultimediaglobal.h"
+#include <QtCore/qbytearray.h>
+
+QT_BEGIN_NAMESPACE
+
+// Splits playlist data into lines without copying it.
+//
+// The data is handed over in chunks that stay owned by the caller; lines
+// that lie within a chunk are returned as pointers into it. Only a line
+// that straddles two chunks is assembled in an internal buffer. Line
+// breaks are '\n', '\r' or both, empty lines are skipped and a leading
+// UTF-8 byte order mark is dropped.
+class Q_MULTIMEDIA_EXPORT QPlaylistTokenizer
+{
+public:
+    struct Line
+    {
+        const char *data = nullptr;
+        int size = 0;
+
+        bool startsWith(const char *prefix) const;
+        Line trimmed() const;
+    };
+
+    QPlaylistTokenizer();
+
+    // The chunk must stay valid until next() returns false.
+    void setData(const char *data, qint64 size);
+    // No more data follows the current chunk.
+    void finish();
+    void reset();
+
+    // Returns false once the current chunk is used up.
+    bool next(Line *line);
+
+    bool isFinished() const { return m_finished && m_data == m_end && m_pending.isEmpty(); }
+    // Size of the incomplete line carried over to the next chunk.
+    int pendingSize() const { return m_pending.size(); }
+
+private:
+    const char *m_data;
+    const char *m_end;
+    QByteArray m_pending;
+    QByteArray m_line;
+    bool m_atStart;
+    bool m_finished;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPLAYLISTTOKENIZER_P_H
@@ -39,6 +39,9 @@
 
 #include <QtCore/qmetaobject.h>
 #include <QtCore/qdebug.h>
+#include <QtCore/qbasictimer.h>
+#include <QtCore/qcoreevent.h>
+#include <QtCore/qthreadstorage.h>
 
 #include "qmediaobject_p.h"
 
@@ -49,6 +52,88 @@
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+
+// Drives the property notifications of the media objects of one thread.
+// Objects with the same notify interval share a timer, so with many
+// players the thread wakes up once per interval and all bindings are
+// updated in the same pass.
+class QMediaObjectNotifier : public QObject
+{
+public:
+    static QMediaObjectNotifier *instance();
+
+    void add(QMediaObject *object, int interval);
+    void remove(QMediaObject *object, int interval);
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    struct Group
+    {
+        QBasicTimer timer;
+        QList<QMediaObject *> objects;
+    };
+
+    QHash<int, Group *> m_groups;
+};
+
+QMediaObjectNotifier *QMediaObjectNotifier::instance()
+{
+    static QThreadStorage<QMediaObjectNotifier *> notifiers;
+    if (!notifiers.hasLocalData())
+        notifiers.setLocalData(new QMediaObjectNotifier);
+    return notifiers.localData();
+}
+
+void QMediaObjectNotifier::add(QMediaObject *object, int interval)
+{
+    Group *&group = m_groups[interval];
+    if (!group) {
+        group = new Group;
+        group->timer.start(interval, this);
+    }
+    group->objects.append(object);
+}
+
+void QMediaObjectNotifier::remove(QMediaObject *object, int interval)
+{
+    Group *group = m_groups.value(interval);
+    if (!group)
+        return;
+
+    group->objects.removeOne(object);
+    if (group->objects.isEmpty()) {
+        m_groups.remove(interval);
+        delete group;
+    }
+}
+
+void QMediaObjectNotifier::timerEvent(QTimerEvent *event)
+{
+    for (auto it = m_groups.cbegin(), end = m_groups.cend(); it != end; ++it) {
+        if (it.value()->timer.timerId() != event->timerId())
+            continue;
+
+        const int interval = it.key();
+        // Notifications may add, remove or destroy media objects
+        const QList<QMediaObject *> objects = it.value()->objects;
+        for (QMediaObject *object : objects) {
+            const Group *group = m_groups.value(interval);
+            if (!group)
+                break;
+            if (group->objects.contains(object))
+                static_cast<QMediaObjectPrivate *>(QObjectPrivate::get(object))->_q_notify();
+        }
+        return;
+    }
+
+    QObject::timerEvent(event);
+}
+
+}
+
 void QMediaObjectPrivate::_q_notify()
 {
     Q_Q(QMediaObject);
@@ -63,11 +148,34 @@ void QMediaObjectPrivate::_q_notify()
 
     for (int pi : qAsConst(properties)) {
         QMetaProperty p = m->property(pi);
+        const QVariant value = p.read(q);
+
+        // Only signal values that changed since the last notification
+        auto last = notifyValues.find(pi);
+        if (last != notifyValues.end() && *last == value)
+            continue;
+        notifyValues.insert(pi, value);
+
         p.notifySignal().invoke(
-            q, QGenericArgument(QMetaType::typeName(p.userType()), p.read(q).data()));
+            q, QGenericArgument(QMetaType::typeName(p.userType()), value.data()));
     }
 }
 
+void QMediaObjectPrivate::updateNotifier()
+{
+    Q_Q(QMediaObject);
+
+    const bool active = !notifyProperties.isEmpty() && !notifySuspended;
+    if (active == notifyActive)
+        return;
+
+    notifyActive = active;
+    if (active)
+        QMediaObjectNotifier::instance()->add(q, notifyInterval);
+    else
+        QMediaObjectNotifier::instance()->remove(q, notifyInterval);
+}
+
 void QMediaObjectPrivate::_q_availabilityChanged()
 {
     Q_Q(QMediaObject);
@@ -113,6 +221,10 @@ void QMediaObjectPrivate::_q_availabilityChanged()
 
 QMediaObject::~QMediaObject()
 {
+    Q_D(QMediaObject);
+
+    d->notifyProperties.clear();
+    d->updateNotifier();
 }
 
 /*!
@@ -155,20 +267,84 @@ QMediaService* QMediaObject::service() const
 
 int QMediaObject::notifyInterval() const
 {
-    return d_func()->notifyTimer->interval();
+    return d_func()->notifyInterval;
 }
 
 void QMediaObject::setNotifyInterval(int milliSeconds)
 {
     Q_D(QMediaObject);
 
-    if (d->notifyTimer->interval() != milliSeconds) {
-        d->notifyTimer->setInterval(milliSeconds);
+    if (d->notifyInterval != milliSeconds) {
+        const bool active = d->notifyActive;
+        if (active)
+            QMediaObjectNotifier::instance()->remove(this, d->notifyInterval);
+        d->notifyInterval = milliSeconds;
+        if (active)
+            QMediaObjectNotifier::instance()->add(this, d->notifyInterval);
 
         emit notifyIntervalChanged(milliSeconds);
     }
 }
 
+/*!
+    \since 5.15
+
+    Returns true if the periodic notifications of watched properties, such
+    as QMediaPlayer::position, are suspended.
+
+    \sa setNotifySuspended(), notifyInterval
+*/
+bool QMediaObject::isNotifySuspended() const
+{
+    return d_func()->notifySuspended;
+}
+
+/*!
+    \since 5.15
+
+    Suspends or resumes the periodic notifications of watched properties,
+    as requested by \a suspended.
+
+    Suspending them is useful while nothing presents the values, for
+    example while the user interface of a player is hidden. When the
+    notifications are resumed, the properties that changed in the meantime
+    are signaled right away.
+
+    \sa isNotifySuspended(), notifyInterval
+*/
+void QMediaObject::setNotifySuspended(bool suspended)
+{
+    Q_D(QMediaObject);
+
+    if (d->notifySuspended == suspended)
+        return;
+
+    d->notifySuspended = suspended;
+    d->updateNotifier();
+
+    if (!suspended && !d->notifyProperties.isEmpty())
+        d->_q_notify();
+}
+
+/*!
+    \reimp
+*/
+bool QMediaObject::event(QEvent *event)
+{
+    Q_D(QMediaObject);
+
+    if (event->type() == QEvent::ThreadChange && d->notifyActive) {
+        // The notifiers are per thread. Leave the one of the current thread
+        // while still on it, and join the new thread's notifier once the
+        // object runs there; the queued call is delivered in that thread.
+        QMediaObjectNotifier::instance()->remove(this, d->notifyInterval);
+        d->notifyActive = false;
+        QMetaObject::invokeMethod(this, [d] { d->updateNotifier(); }, Qt::QueuedConnection);
+    }
+
+    return QObject::event(event);
+}
+
 /*!
     Bind \a object to this QMediaObject instance.
 
@@ -234,10 +410,6 @@ QMediaObject::QMediaObject(QObject *parent, QMediaService *service)
 {
     Q_D(QMediaObject);
 
-    d->notifyTimer = new QTimer(this);
-    d->notifyTimer->setInterval(1000);
-    connect(d->notifyTimer, SIGNAL(timeout()), SLOT(_q_notify()));
-
     d->service = service;
 
     setupControls();
@@ -252,18 +424,15 @@ QMediaObject::QMediaObject(QMediaObjectPrivate &dd, QObject *parent, QMediaServi
 {
     Q_D(QMediaObject);
 
-    d->notifyTimer = new QTimer(this);
-    d->notifyTimer->setInterval(1000);
-    connect(d->notifyTimer, SIGNAL(timeout()), SLOT(_q_notify()));
-
     d->service = service;
 
     setupControls();
 }
 
 /*!
-    Watch the property \a name. The property's notify signal will be emitted
-    once every \c notifyInterval milliseconds.
+    Watch the property \a name. The property is checked once every
+    \c notifyInterval milliseconds, and its notify signal is emitted when
+    the value differs from the one last signaled.
 
     \sa notifyInterval
 */
@@ -278,9 +447,7 @@ void QMediaObject::addPropertyWatch(QByteArray const &name)
 
     if (index != -1 && m->property(index).hasNotifySignal()) {
         d->notifyProperties.insert(index);
-
-        if (!d->notifyTimer->isActive())
-            d->notifyTimer->start();
+        d->updateNotifier();
     }
 }
 
@@ -299,9 +466,8 @@ void QMediaObject::removePropertyWatch(QByteArray const &name)
 
     if (index != -1) {
         d->notifyProperties.remove(index);
-
-        if (d->notifyProperties.isEmpty())
-            d->notifyTimer->stop();
+        d->notifyValues.remove(index);
+        d->updateNotifier();
     }
 }
 
@@ -311,8 +477,10 @@ void QMediaObject::removePropertyWatch(QByteArray const &name)
     The interval at which notifiable properties will update.
 
     The interval is expressed in milliseconds, the default value is 1000.
+    Media objects of the same thread that use the same interval are updated
+    together, and a property is only signaled when its value has changed.
 
-    \sa addPropertyWatch(), removePropertyWatch()
+    \sa addPropertyWatch(), removePropertyWatch(), setNotifySuspended()
 */
 
 /*!
@@ -68,6 +68,9 @@ public:
     int notifyInterval() const;
     void setNotifyInterval(int milliSeconds);
 
+    bool isNotifySuspended() const;
+    void setNotifySuspended(bool suspended);
+
     virtual bool bind(QObject *);
     virtual void unbind(QObject *);
 
@@ -93,6 +96,8 @@ protected:
     void addPropertyWatch(QByteArray const &name);
     void removePropertyWatch(QByteArray const &name);
 
+    bool event(QEvent *event) override;
+
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     QMediaObjectPrivate *d_ptr_deprecated;
 #endif
@@ -52,8 +52,10 @@
 //
 
 #include <QtCore/qbytearray.h>
+#include <QtCore/qhash.h>
 #include <QtCore/qset.h>
 #include <QtCore/qtimer.h>
+#include <QtCore/qvariant.h>
 
 #include "qmediaobject.h"
 #include "private/qobject_p.h"
@@ -74,18 +76,24 @@ class QMediaObjectPrivate : public QObjectPrivate
     Q_DECLARE_PUBLIC(QMediaObject)
 
 public:
-    QMediaObjectPrivate() : service(nullptr), metaDataControl(nullptr), availabilityControl(nullptr), notifyTimer(nullptr) {}
+    QMediaObjectPrivate() : service(nullptr), metaDataControl(nullptr), availabilityControl(nullptr), notifyInterval(1000), notifyActive(false), notifySuspended(false) {}
     virtual ~QMediaObjectPrivate() {}
 
     void _q_notify();
     void _q_availabilityChanged();
 
+    void updateNotifier();
+
     QMediaService *service;
     QMetaDataReaderControl *metaDataControl;
     QMediaAvailabilityControl *availabilityControl;
 
-    QTimer* notifyTimer;
+    int notifyInterval;
+    bool notifyActive;
+    bool notifySuspended;
     QSet<int> notifyProperties;
+    // Last value signaled for each watched property
+    QHash<int, QVariant> notifyValues;
 };
 
 QT_END_NAMESPACE
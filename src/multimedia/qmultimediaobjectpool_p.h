@@ -0,0 +1,155 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QMULTIMEDIAOBJECTPOOL_P_H
+#define QMULTIMEDIAOBJECTPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMultimedia/qtmultimediaglobal.h>
+#include <QtCore/qmutex.h>
+
+#include <new>
+
+QT_BEGIN_NAMESPACE
+
+// Keeps up to maximumCount released blocks of blockSize bytes for reuse, so
+// that objects created for every video frame don't hit the heap once the
+// stream is running.  Blocks of other sizes, e.g. of derived classes, are
+// passed through to the global allocator.
+//
+// Meant to be used through Q_GLOBAL_STATIC from class specific
+// operator new/delete, see QT_MULTIMEDIA_DECLARE_POOLED_ALLOCATOR.
+class QMultimediaObjectPool
+{
+public:
+    explicit QMultimediaObjectPool(size_t blockSize, int maximumCount = 64)
+        : m_blockSize(blockSize)
+        , m_maximumCount(maximumCount)
+    {
+        Q_ASSERT(blockSize >= sizeof(Block));
+    }
+
+    ~QMultimediaObjectPool()
+    {
+        while (m_free) {
+            Block *block = m_free;
+            m_free = block->next;
+            ::operator delete(block);
+        }
+    }
+
+    void *allocate(size_t size)
+    {
+        if (size == m_blockSize) {
+            QMutexLocker locker(&m_mutex);
+            if (Block *block = m_free) {
+                m_free = block->next;
+                --m_count;
+                return block;
+            }
+        }
+        return ::operator new(size);
+    }
+
+    void release(void *ptr, size_t size)
+    {
+        if (!ptr)
+            return;
+
+        if (size == m_blockSize) {
+            QMutexLocker locker(&m_mutex);
+            if (m_count < m_maximumCount) {
+                Block *block = static_cast<Block *>(ptr);
+                block->next = m_free;
+                m_free = block;
+                ++m_count;
+                return;
+            }
+        }
+        ::operator delete(ptr);
+    }
+
+private:
+    Q_DISABLE_COPY(QMultimediaObjectPool)
+
+    struct Block
+    {
+        Block *next;
+    };
+
+    QBasicMutex m_mutex;
+    Block *m_free = nullptr;
+    int m_count = 0;
+    const size_t m_blockSize;
+    const int m_maximumCount;
+};
+
+#define QT_MULTIMEDIA_DECLARE_POOLED_ALLOCATOR \
+    static void *operator new(size_t size); \
+    static void operator delete(void *ptr, size_t size);
+
+// Objects may outlive the pool during static destruction, so fall back to
+// the global allocator once it is gone.
+#define QT_MULTIMEDIA_DEFINE_POOLED_ALLOCATOR(Class, pool) \
+    Q_GLOBAL_STATIC_WITH_ARGS(QMultimediaObjectPool, pool, (sizeof(Class))) \
+    void *Class::operator new(size_t size) \
+    { \
+        return pool.isDestroyed() ? ::operator new(size) : pool()->allocate(size); \
+    } \
+    void Class::operator delete(void *ptr, size_t size) \
+    { \
+        if (pool.isDestroyed()) \
+            ::operator delete(ptr); \
+        else \
+            pool()->release(ptr, size); \
+    }
+
+QT_END_NAMESPACE
+
+#endif // QMULTIMEDIAOBJECTPOOL_P_H
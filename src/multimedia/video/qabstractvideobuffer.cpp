@@ -293,6 +293,8 @@ int QAbstractPlanarVideoBufferPrivate::map(
     \since 5.4
 */
 
+QT_MULTIMEDIA_DEFINE_POOLED_ALLOCATOR(QAbstractPlanarVideoBufferPrivate, planarVideoBufferPrivatePool)
+
 /*!
     Constructs an abstract planar video buffer of the given \a type.
 */
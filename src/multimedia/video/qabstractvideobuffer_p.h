@@ -56,6 +56,7 @@
 
 #include <qtmultimediaglobal.h>
 #include <qmultimedia.h>
+#include <private/qmultimediaobjectpool_p.h>
 
 
 QT_BEGIN_NAMESPACE
@@ -87,6 +88,9 @@ public:
 
     int map(QAbstractVideoBuffer::MapMode mode, int *numBytes, int bytesPerLine[4], uchar *data[4]) override;
 
+    // Created with every planar frame buffer
+    QT_MULTIMEDIA_DECLARE_POOLED_ALLOCATOR
+
 private:
     Q_DECLARE_PUBLIC(QAbstractPlanarVideoBuffer)
 };
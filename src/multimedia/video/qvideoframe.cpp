@@ -42,6 +42,7 @@
 #include "qimagevideobuffer_p.h"
 #include "qmemoryvideobuffer_p.h"
 #include "qvideoframeconversionhelper_p.h"
+#include "qmultimediaobjectpool_p.h"
 
 #include <qimage.h>
 #include <qpair.h>
@@ -114,12 +115,17 @@ public:
     QAbstractVideoBuffer *buffer;
     int mappedCount;
     QMutex mapMutex;
-    QVariantMap metadata;
+    QVariantMap metadata; // shares the empty map until metadata is set
+
+    // Frames are created at the video rate on the streaming threads
+    QT_MULTIMEDIA_DECLARE_POOLED_ALLOCATOR
 
 private:
     Q_DISABLE_COPY(QVideoFramePrivate)
 };
 
+QT_MULTIMEDIA_DEFINE_POOLED_ALLOCATOR(QVideoFramePrivate, videoFramePrivatePool)
+
 /*!
     \class QVideoFrame
     \brief The QVideoFrame class represents a frame of video data.
@@ -85,6 +85,24 @@ inline quint32 qConvertBGR555ToARGB32(quint16 bgr)
             | ((((bgr) << 19) & 0xf80000) | (((bgr) << 11) & 0x70000));
 }
 
+#define CLAMP(n) (n > 255 ? 255 : (n < 0 ? 0 : n))
+
+#define EXPAND_UV(u, v) \
+    int uu = u - 128; \
+    int vv = v - 128; \
+    int rv = 409 * vv + 128; \
+    int guv = 100 * uu + 208 * vv + 128; \
+    int bu = 516 * uu + 128; \
+
+inline quint32 qYUVToARGB32(int y, int rv, int guv, int bu, int a = 0xff)
+{
+    int yy = (y - 16) * 298;
+    return (a << 24)
+            | CLAMP((yy + rv) >> 8) << 16
+            | CLAMP((yy - guv) >> 8) << 8
+            | CLAMP((yy + bu) >> 8);
+}
+
 #define FETCH_INFO_PACKED(frame) \
     const uchar *src = frame.bits(); \
     int stride = frame.bytesPerLine(); \
@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QVIDEOFRAMETRIPLEBUFFER_P_H
+#define QVIDEOFRAMETRIPLEBUFFER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMultimedia/qvideoframe.h>
+#include <QtCore/qatomic.h>
+
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+// Hands video frames from one producer thread to one consumer thread without
+// either side ever waiting for the other.
+//
+// Three slots rotate between the roles: the producer owns the back slot, the
+// consumer owns the front slot and the middle slot holds the latest published
+// frame. Publishing swaps back and middle, taking swaps middle and front; both
+// swaps are a single atomic exchange. A frame still in the middle slot when the
+// next one is published is never shown and counted as dropped.
+class QVideoFrameTripleBuffer
+{
+public:
+    QVideoFrameTripleBuffer()
+        : m_back(0)
+        , m_middle(1)
+        , m_front(2)
+    {
+    }
+
+    // Producer side.
+    void publish(const QVideoFrame &frame)
+    {
+        m_slots[m_back] = frame;
+        const int previous = m_middle.fetchAndStoreAcqRel(m_back | FreshBit);
+        m_back = previous & IndexMask;
+        // The frame now in the back slot was either taken already or never
+        // seen; drop the reference here rather than on the next publish.
+        m_slots[m_back] = QVideoFrame();
+        if (previous & FreshBit)
+            m_dropped.fetchAndAddRelaxed(1);
+        m_published.fetchAndAddRelaxed(1);
+    }
+
+    // Consumer side. Returns false if nothing was published since the last call.
+    bool take(QVideoFrame *frame)
+    {
+        if (!(m_middle.loadAcquire() & FreshBit))
+            return false;
+        const int previous = m_middle.fetchAndStoreAcqRel(m_front);
+        m_front = previous & IndexMask;
+        *frame = std::move(m_slots[m_front]);
+        m_slots[m_front] = QVideoFrame();
+        return true;
+    }
+
+    int publishedFrames() const { return m_published.loadRelaxed(); }
+    int droppedFrames() const { return m_dropped.loadRelaxed(); }
+
+    void resetCounters()
+    {
+        m_published.storeRelaxed(0);
+        m_dropped.storeRelaxed(0);
+    }
+
+private:
+    Q_DISABLE_COPY(QVideoFrameTripleBuffer)
+
+    enum { IndexMask = 0x3, FreshBit = 0x4 };
+
+    QVideoFrame m_slots[3];
+    int m_back;             // producer only
+    QAtomicInt m_middle;
+    int m_front;            // consumer only
+    QAtomicInt m_published;
+    QAtomicInt m_dropped;
+};
+
+QT_END_NAMESPACE
+
+#endif // QVIDEOFRAMETRIPLEBUFFER_P_H
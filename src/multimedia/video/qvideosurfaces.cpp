@@ -39,13 +39,80 @@
 
 #include "qvideosurfaces_p.h"
 
+#include <QThread>
+
 QT_BEGIN_NAMESPACE
 
+QVideoSurfacesOutput::QVideoSurfacesOutput(QAbstractVideoSurface *surface)
+    : m_surface(surface)
+{
+    moveToThread(surface->thread());
+}
+
+bool QVideoSurfacesOutput::present(const QVideoFrame &frame)
+{
+    if (!m_surface || m_surface->thread() != QThread::currentThread()) {
+        post(frame);
+        return !hasFailed();
+    }
+
+    {
+        // Drop a frame queued while the surface was in another thread
+        QMutexLocker locker(&m_mutex);
+        m_pendingFrame = QVideoFrame();
+        m_hasPendingFrame = false;
+    }
+
+    const bool presented = !m_surface->isActive() || m_surface->present(frame);
+    m_failed.storeRelease(presented ? 0 : 1);
+    return presented;
+}
+
+void QVideoSurfacesOutput::post(const QVideoFrame &frame)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // A frame still waiting for the surface is replaced by the newer one
+    m_pendingFrame = frame;
+    m_hasPendingFrame = true;
+    if (!m_scheduled) {
+        m_scheduled = true;
+        QMetaObject::invokeMethod(this, [this] { deliver(); }, Qt::QueuedConnection);
+    }
+}
+
+void QVideoSurfacesOutput::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_pendingFrame = QVideoFrame();
+    m_hasPendingFrame = false;
+    m_failed.storeRelease(0);
+}
+
+void QVideoSurfacesOutput::deliver()
+{
+    QVideoFrame frame;
+    bool hasFrame = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        frame = m_pendingFrame;
+        hasFrame = m_hasPendingFrame;
+        m_pendingFrame = QVideoFrame();
+        m_hasPendingFrame = false;
+        m_scheduled = false;
+    }
+
+    if (hasFrame && m_surface && m_surface->isActive())
+        m_failed.storeRelease(m_surface->present(frame) ? 0 : 1);
+}
+
 QVideoSurfaces::QVideoSurfaces(const QVector<QAbstractVideoSurface *> &s, QObject *parent)
     : QAbstractVideoSurface(parent)
     , m_surfaces(s)
 {
     for (auto a : s) {
+        m_outputs.append(new QVideoSurfacesOutput(a));
+
         connect(a, &QAbstractVideoSurface::supportedFormatsChanged, this, [this, a] {
             auto context = property("GLContext").value<QObject *>();
             if (!context)
@@ -58,6 +125,9 @@ QVideoSurfaces::QVideoSurfaces(const QVector<QAbstractVideoSurface *> &s, QObjec
 
 QVideoSurfaces::~QVideoSurfaces()
 {
+    // Outputs may live in other threads and still have a frame queued
+    for (auto o : m_outputs)
+        o->deleteLater();
 }
 
 QList<QVideoFrame::PixelFormat> QVideoSurfaces::supportedPixelFormats(QAbstractVideoBuffer::HandleType type) const
@@ -85,6 +155,9 @@ bool QVideoSurfaces::start(const QVideoSurfaceFormat &format)
 
 void QVideoSurfaces::stop()
 {
+    for (auto &o : m_outputs)
+        o->reset();
+
     for (auto &s : m_surfaces)
         s->stop();
 
@@ -93,9 +166,11 @@ void QVideoSurfaces::stop()
 
 bool QVideoSurfaces::present(const QVideoFrame &frame)
 {
+    // Surfaces in other threads are presented to asynchronously, for those
+    // this reports failures of earlier frames
     bool result = true;
-    for (auto &s : m_surfaces)
-        result &= s->present(frame);
+    for (auto &o : m_outputs)
+        result &= o->present(frame);
 
     return result;
 }
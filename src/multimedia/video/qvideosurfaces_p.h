@@ -52,10 +52,49 @@
 //
 
 #include <QAbstractVideoSurface>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QPointer>
 #include <QVector>
 
 QT_BEGIN_NAMESPACE
 
+// Presents each frame on several surfaces.
+//
+// Surfaces living in the caller's thread are presented to directly. Every
+// other surface gets the frame from its own thread's event loop, so a slow
+// surface never holds back the others or the caller; if it falls behind it
+// skips to the latest frame. All surfaces receive the same QVideoFrame, which
+// lets renderers that share a GL context share its textures.
+class QVideoSurfacesOutput : public QObject
+{
+public:
+    QVideoSurfacesOutput(QAbstractVideoSurface *surface);
+
+    QAbstractVideoSurface *surface() const { return m_surface; }
+
+    // Presents the frame, or queues it if the surface lives in another
+    // thread. A queued frame's result is only known later, so false then
+    // means the surface rejected an earlier frame.
+    bool present(const QVideoFrame &frame);
+    void reset();
+
+    // Whether the surface rejected the last frame delivered to it; safe to
+    // call from any thread.
+    bool hasFailed() const { return m_failed.loadAcquire(); }
+
+private:
+    void post(const QVideoFrame &frame);
+    void deliver();
+
+    QPointer<QAbstractVideoSurface> m_surface;
+    QMutex m_mutex;
+    QVideoFrame m_pendingFrame;
+    bool m_hasPendingFrame = false;
+    bool m_scheduled = false;
+    QAtomicInt m_failed;
+};
+
 class QVideoSurfaces : public QAbstractVideoSurface
 {
 public:
@@ -69,6 +108,7 @@ public:
 
 private:
     QVector<QAbstractVideoSurface *> m_surfaces;
+    QVector<QVideoSurfacesOutput *> m_outputs;
     Q_DISABLE_COPY(QVideoSurfaces)
 };
 
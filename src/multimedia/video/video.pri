@@ -16,6 +16,7 @@ PRIVATE_HEADERS += \
     video/qvideooutputorientationhandler_p.h \
     video/qvideosurfaceoutput_p.h \
     video/qvideoframeconversionhelper_p.h \
+    video/qvideoframetriplebuffer_p.h \
     video/qvideosurfaces_p.h
 
 SOURCES += \
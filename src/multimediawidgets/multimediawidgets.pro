@@ -8,6 +8,7 @@ qtHaveModule(opengl): \
 PRIVATE_HEADERS += \
     qvideowidget_p.h \
     qpaintervideosurface_p.h \
+    qvideoframescaling_p.h \
 
 PUBLIC_HEADERS += \
     qtmultimediawidgetdefs.h \
@@ -19,7 +20,8 @@ SOURCES += \
     qcameraviewfinder.cpp \
     qpaintervideosurface.cpp \
     qvideowidgetcontrol.cpp \
-    qvideowidget.cpp
+    qvideowidget.cpp \
+    qvideoframescaling.cpp
 
 qtConfig(graphicsview) {
     SOURCES        += qgraphicsvideoitem.cpp
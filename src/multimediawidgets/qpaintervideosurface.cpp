@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qpaintervideosurface_p.h"
+#include "qvideoframescaling_p.h"
 
 #include <qmath.h>
 
@@ -87,12 +88,21 @@ public:
     void updateColors(int brightness, int contrast, int hue, int saturation) override;
 
 private:
+    static bool isYuvFormat(QVideoFrame::PixelFormat format);
+    bool convertFrame(const QRect &source, const QSize &size);
+
     QList<QVideoFrame::PixelFormat> m_imagePixelFormats;
     QVideoFrame m_frame;
     QSize m_imageSize;
     QImage::Format m_imageFormat;
     QVideoSurfaceFormat::Direction m_scanLineDirection;
     bool m_mirrored;
+
+    // YUV frames are converted and scaled to the painted size in one pass,
+    // the result is kept until the frame or the geometry changes.
+    QImage m_convertedImage;
+    QVideoFrame m_convertedFrame;
+    QRect m_convertedSource;
 };
 
 QVideoSurfaceGenericPainter::QVideoSurfaceGenericPainter()
@@ -109,7 +119,28 @@ QVideoSurfaceGenericPainter::QVideoSurfaceGenericPainter()
         m_imagePixelFormats << QVideoFrame::Format_RGB24;
 
      m_imagePixelFormats << QVideoFrame::Format_ARGB32
-                         << QVideoFrame::Format_RGB565;
+                         << QVideoFrame::Format_RGB565
+                         << QVideoFrame::Format_YUV420P
+                         << QVideoFrame::Format_YV12
+                         << QVideoFrame::Format_NV12
+                         << QVideoFrame::Format_NV21
+                         << QVideoFrame::Format_YUYV
+                         << QVideoFrame::Format_UYVY;
+}
+
+bool QVideoSurfaceGenericPainter::isYuvFormat(QVideoFrame::PixelFormat format)
+{
+    switch (format) {
+    case QVideoFrame::Format_YUV420P:
+    case QVideoFrame::Format_YV12:
+    case QVideoFrame::Format_NV12:
+    case QVideoFrame::Format_NV21:
+    case QVideoFrame::Format_YUYV:
+    case QVideoFrame::Format_UYVY:
+        return true;
+    default:
+        return false;
+    }
 }
 
 QList<QVideoFrame::PixelFormat> QVideoSurfaceGenericPainter::supportedPixelFormats(
@@ -152,9 +183,13 @@ QAbstractVideoSurface::Error QVideoSurfaceGenericPainter::start(const QVideoSurf
     m_scanLineDirection = format.scanLineDirection();
     m_mirrored = format.property("mirrored").toBool();
 
+    m_convertedImage = QImage();
+    m_convertedFrame = QVideoFrame();
+
     const QAbstractVideoBuffer::HandleType t = format.handleType();
     if (t == QAbstractVideoBuffer::NoHandle) {
-        bool ok = m_imageFormat != QImage::Format_Invalid && !m_imageSize.isEmpty();
+        bool ok = (m_imageFormat != QImage::Format_Invalid || isYuvFormat(format.pixelFormat()))
+                && !m_imageSize.isEmpty();
 #ifndef QT_NO_OPENGL
         if (QOpenGLContext::openGLModuleType() == QOpenGLContext::LibGLES)
             ok &= format.pixelFormat() != QVideoFrame::Format_RGB24;
@@ -170,6 +205,8 @@ QAbstractVideoSurface::Error QVideoSurfaceGenericPainter::start(const QVideoSurf
 void QVideoSurfaceGenericPainter::stop()
 {
     m_frame = QVideoFrame();
+    m_convertedImage = QImage();
+    m_convertedFrame = QVideoFrame();
 }
 
 QAbstractVideoSurface::Error QVideoSurfaceGenericPainter::setCurrentFrame(const QVideoFrame &frame)
@@ -187,15 +224,32 @@ QAbstractVideoSurface::Error QVideoSurfaceGenericPainter::paint(
         return QAbstractVideoSurface::NoError;
     }
 
+    const bool yuv = isYuvFormat(m_frame.pixelFormat());
+
     if (m_frame.handleType() == QAbstractVideoBuffer::QPixmapHandle) {
         painter->drawPixmap(target, m_frame.handle().value<QPixmap>(), source);
-    } else if (m_frame.map(QAbstractVideoBuffer::ReadOnly)) {
-        QImage image(
-                m_frame.bits(),
-                m_imageSize.width(),
-                m_imageSize.height(),
-                m_frame.bytesPerLine(),
-                m_imageFormat);
+    } else if (yuv || m_frame.map(QAbstractVideoBuffer::ReadOnly)) {
+        QImage image;
+        QRectF imageSource = source;
+        if (yuv) {
+            // Convert at the device resolution of the target, but never
+            // above the source resolution, upscaling is left to drawImage()
+            const QRect sourceRect = source.toAlignedRect();
+            const QSizeF deviceSize = painter->deviceTransform().mapRect(target).size();
+            const QSize size(qBound(1, qRound(deviceSize.width()), sourceRect.width()),
+                             qBound(1, qRound(deviceSize.height()), sourceRect.height()));
+            if (!convertFrame(sourceRect, size))
+                return QAbstractVideoSurface::IncorrectFormatError;
+            image = m_convertedImage;
+            imageSource = QRectF(QPointF(0, 0), size);
+        } else {
+            image = QImage(
+                    m_frame.bits(),
+                    m_imageSize.width(),
+                    m_imageSize.height(),
+                    m_frame.bytesPerLine(),
+                    m_imageFormat);
+        }
 
         const QTransform oldTransform = painter->transform();
         QTransform transform = oldTransform;
@@ -212,10 +266,11 @@ QAbstractVideoSurface::Error QVideoSurfaceGenericPainter::paint(
             targetRect = QRectF(0, targetRect.y(), target.width(), target.height());
         }
         painter->setTransform(transform);
-        painter->drawImage(targetRect, image, source);
+        painter->drawImage(targetRect, image, imageSource);
         painter->setTransform(oldTransform);
 
-        m_frame.unmap();
+        if (!yuv)
+            m_frame.unmap();
     } else if (m_frame.isValid()) {
         return QAbstractVideoSurface::IncorrectFormatError;
     } else {
@@ -228,6 +283,33 @@ void QVideoSurfaceGenericPainter::updateColors(int, int, int, int)
 {
 }
 
+bool QVideoSurfaceGenericPainter::convertFrame(const QRect &source, const QSize &size)
+{
+    if (m_convertedFrame == m_frame && m_convertedSource == source
+            && m_convertedImage.size() == size) {
+        return true;
+    }
+
+    if (!m_frame.map(QAbstractVideoBuffer::ReadOnly))
+        return false;
+
+    if (m_convertedImage.size() != size)
+        m_convertedImage = QImage(size, QImage::Format_RGB32);
+
+    const bool converted = qt_convert_scaled_to_ARGB32(m_frame, source, m_convertedImage.bits(),
+                                                       m_convertedImage.bytesPerLine(), size);
+    m_frame.unmap();
+
+    if (!converted) {
+        m_convertedFrame = QVideoFrame();
+        return false;
+    }
+
+    m_convertedFrame = m_frame;
+    m_convertedSource = source;
+    return true;
+}
+
 #if QT_CONFIG(opengl)
 
 #ifndef APIENTRYP
@@ -0,0 +1,182 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qvideoframescaling_p.h"
+
+#include <private/qvideoframeconversionhelper_p.h>
+#include <QtCore/qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Samplers for the scaled conversion, setLine() selects the source row
+// and pixel() converts the pixel at the given column.
+struct PlanarYUV420Sampler
+{
+    const uchar *y, *u, *v;
+    int yStride, uStride, vStride;
+    int uvPixelStride;
+    const uchar *lineY, *lineU, *lineV;
+
+    void setLine(int row)
+    {
+        lineY = y + row * yStride;
+        lineU = u + (row >> 1) * uStride;
+        lineV = v + (row >> 1) * vStride;
+    }
+
+    quint32 pixel(int x) const
+    {
+        const int uvOffset = (x >> 1) * uvPixelStride;
+        EXPAND_UV(lineU[uvOffset], lineV[uvOffset]);
+        return qYUVToARGB32(lineY[x], rv, guv, bu);
+    }
+};
+
+struct PackedYUV422Sampler
+{
+    const uchar *src;
+    int stride;
+    int yOffset, uOffset, vOffset;
+    const uchar *line;
+
+    void setLine(int row)
+    {
+        line = src + row * stride;
+    }
+
+    quint32 pixel(int x) const
+    {
+        const uchar *pair = line + ((x & ~1) << 1);
+        EXPAND_UV(pair[uOffset], pair[vOffset]);
+        return qYUVToARGB32(line[(x << 1) + yOffset], rv, guv, bu);
+    }
+};
+
+template <typename Sampler>
+static void scaleYUVToARGB32(Sampler &sampler, const QRect &source,
+                             quint32 *output, int outputStride, const QSize &size)
+{
+    // Nearest neighbour, sampling at the centre of each output pixel
+    QVarLengthArray<int, 2048> columns(size.width());
+    for (int i = 0; i < size.width(); ++i)
+        columns[i] = source.x() + int((2 * qint64(i) + 1) * source.width() / (2 * size.width()));
+
+    for (int j = 0; j < size.height(); ++j) {
+        sampler.setLine(source.y() + int((2 * qint64(j) + 1) * source.height() / (2 * size.height())));
+
+        quint32 *line = output;
+        for (int i = 0; i < size.width(); ++i)
+            line[i] = sampler.pixel(columns[i]);
+
+        output += outputStride;
+    }
+}
+
+} // namespace
+
+/*
+    Converts the \a source rectangle of a mapped YUV \a frame to ARGB32 and
+    scales it to \a size in a single pass, instead of converting the whole
+    frame and scaling the result.  \a outputStride is in bytes.
+
+    Returns false if the pixel format of the frame is not supported.
+*/
+bool qt_convert_scaled_to_ARGB32(const QVideoFrame &frame, const QRect &source,
+                                 uchar *output, int outputStride, const QSize &size)
+{
+    const QRect rect = source & QRect(QPoint(0, 0), frame.size());
+    if (rect.isEmpty() || size.isEmpty())
+        return false;
+
+    quint32 *argb = reinterpret_cast<quint32 *>(output);
+    const int pixelStride = outputStride / 4;
+
+    switch (frame.pixelFormat()) {
+    case QVideoFrame::Format_YUV420P:
+    case QVideoFrame::Format_YV12: {
+        FETCH_INFO_TRIPLANAR(frame)
+        Q_UNUSED(width);
+        Q_UNUSED(height);
+        const bool yv12 = frame.pixelFormat() == QVideoFrame::Format_YV12;
+        PlanarYUV420Sampler sampler = {
+            plane1, yv12 ? plane3 : plane2, yv12 ? plane2 : plane3,
+            plane1Stride, yv12 ? plane3Stride : plane2Stride, yv12 ? plane2Stride : plane3Stride,
+            1, nullptr, nullptr, nullptr
+        };
+        scaleYUVToARGB32(sampler, rect, argb, pixelStride, size);
+        return true;
+    }
+    case QVideoFrame::Format_NV12:
+    case QVideoFrame::Format_NV21: {
+        FETCH_INFO_BIPLANAR(frame)
+        Q_UNUSED(width);
+        Q_UNUSED(height);
+        const bool nv21 = frame.pixelFormat() == QVideoFrame::Format_NV21;
+        PlanarYUV420Sampler sampler = {
+            plane1, plane2 + (nv21 ? 1 : 0), plane2 + (nv21 ? 0 : 1),
+            plane1Stride, plane2Stride, plane2Stride,
+            2, nullptr, nullptr, nullptr
+        };
+        scaleYUVToARGB32(sampler, rect, argb, pixelStride, size);
+        return true;
+    }
+    case QVideoFrame::Format_YUYV:
+    case QVideoFrame::Format_UYVY: {
+        FETCH_INFO_PACKED(frame)
+        Q_UNUSED(width);
+        Q_UNUSED(height);
+        const bool yuyv = frame.pixelFormat() == QVideoFrame::Format_YUYV;
+        PackedYUV422Sampler sampler = {
+            src, stride,
+            yuyv ? 0 : 1, yuyv ? 1 : 0, yuyv ? 3 : 2,
+            nullptr
+        };
+        scaleYUVToARGB32(sampler, rect, argb, pixelStride, size);
+        return true;
+    }
+    default:
+        break;
+    }
+
+    return false;
+}
+
+QT_END_NAMESPACE
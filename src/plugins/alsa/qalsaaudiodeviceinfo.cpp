@@ -50,23 +50,28 @@
 
 #include "qalsaaudiodeviceinfo.h"
 
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qpair.h>
+
 #include <alsa/version.h>
 
+#include <algorithm>
+#include <iterator>
+
 QT_BEGIN_NAMESPACE
 
 QAlsaAudioDeviceInfo::QAlsaAudioDeviceInfo(const QByteArray &dev, QAudio::Mode mode)
 {
-    handle = 0;
-
     device = QLatin1String(dev);
     this->mode = mode;
 
+    capabilities = cachedCapabilities(device, mode);
     updateLists();
 }
 
 QAlsaAudioDeviceInfo::~QAlsaAudioDeviceInfo()
 {
-    close();
 }
 
 bool QAlsaAudioDeviceInfo::isFormatSupported(const QAudioFormat& format) const
@@ -143,87 +148,134 @@ QByteArray QAlsaAudioDeviceInfo::defaultDevice(QAudio::Mode mode)
     return devices.first();
 }
 
-bool QAlsaAudioDeviceInfo::open()
+namespace {
+
+struct CapabilityCache
 {
-    qDebug()<<__func__;
-    int err = 0;
-    QString dev;
+    QMutex mutex;
+    QHash<QPair<QString, int>, QAlsaAudioDeviceCapabilities> devices;
+};
 
-    if (!availableDevices(mode).contains(device.toLocal8Bit())){
-        qCritical()<<__func__<<"device"<<device<<"is not available";
+// Common rates and channel counts that are tested exactly when probing.
+const unsigned int probedRates[] = { 8000, 11025, 16000, 22050, 32000, 44100, 48000, 88200, 96000,
+                                     176400, 192000, 352800, 384000, 705600, 768000 };
+const unsigned int maxProbedChannels = 32;
+
+} // namespace
+
+Q_GLOBAL_STATIC(CapabilityCache, capabilityCache)
+
+bool QAlsaAudioDeviceCapabilities::isFormatSupported(const QAudioFormat &format) const
+{
+    if (!valid)
         return false;
-    }
 
-#if SND_LIB_VERSION < 0x1000e  // 1.0.14
-    if (device.compare(QLatin1String("default")) != 0)
-        dev = deviceFromCardName(device);
-    else
-#endif
-        dev = device;
+    const snd_pcm_format_t pcmFormat = QAlsaAudioDeviceInfo::pcmFormat(format);
+    if (pcmFormat == SND_PCM_FORMAT_UNKNOWN || !formats.testBit(pcmFormat))
+        return false;
 
-    if(mode == QAudio::AudioOutput) {
-        err=snd_pcm_open( &handle,dev.toLocal8Bit().constData(),SND_PCM_STREAM_PLAYBACK,0);
-    } else {
-        err=snd_pcm_open( &handle,dev.toLocal8Bit().constData(),SND_PCM_STREAM_CAPTURE,0);
+    if (format.channelCount() > 0) {
+        const unsigned int count = format.channelCount();
+        const bool supported = count <= maxProbedChannels
+                ? channels.contains(int(count))
+                : count >= minChannels && count <= maxChannels;
+        if (!supported)
+            return false;
     }
-    if(err < 0) {
-        qCritical()<<__func__<<"failed to open device"<<device<<"error:"<<snd_strerror(err);
-        handle = 0;
-        return false;
+
+    if (format.sampleRate() != -1) {
+        const unsigned int rate = format.sampleRate();
+        if (std::find(std::begin(probedRates), std::end(probedRates), rate) != std::end(probedRates))
+            return rates.contains(int(rate));
+        return rate >= minRate && rate <= maxRate;
     }
-    snd_pcm_nonblock(handle, 0);
+
     return true;
 }
 
-void QAlsaAudioDeviceInfo::close()
+QAlsaAudioDeviceCapabilities QAlsaAudioDeviceInfo::cachedCapabilities(const QString &device, QAudio::Mode mode)
 {
-    if(handle)
-        snd_pcm_close(handle);
-    handle = 0;
+    CapabilityCache *cache = capabilityCache();
+    QMutexLocker locker(&cache->mutex);
+
+    const QPair<QString, int> key(device, mode);
+    auto it = cache->devices.constFind(key);
+    if (it != cache->devices.constEnd())
+        return it.value();
+
+    // Only successful probes are kept; a busy device is probed again next time.
+    const QAlsaAudioDeviceCapabilities capabilities = probeCapabilities(device, mode);
+    if (capabilities.valid)
+        cache->devices.insert(key, capabilities);
+    return capabilities;
 }
 
-bool QAlsaAudioDeviceInfo::testSettings(const QAudioFormat& format) const
+QAlsaAudioDeviceCapabilities QAlsaAudioDeviceInfo::probeCapabilities(const QString &device, QAudio::Mode mode)
 {
-    qDebug()<<__func__<< device << format;
-    // Set nearest to closest settings that do work.
-    // See if what is in settings will work (return value).
-    int err = 0;
-    snd_pcm_t* pcmHandle;
-    snd_pcm_hw_params_t *params;
+    QAlsaAudioDeviceCapabilities capabilities;
+    QString dev;
 
-    // For now, just accept only audio/pcm codec
-    if (!format.codec().startsWith(QLatin1String("audio/pcm"))){
-        return false;
+#if SND_LIB_VERSION < 0x1000e  // 1.0.14
+    if (device.compare(QLatin1String("default")) != 0)
+        dev = deviceFromCardName(device);
+    else
+#endif
+        dev = device;
+
+    // Don't wait for a device that is in use.
+    snd_pcm_t *pcmHandle = 0;
+    int err = snd_pcm_open(&pcmHandle, dev.toLocal8Bit().constData(),
+                           mode == QAudio::AudioOutput ? SND_PCM_STREAM_PLAYBACK : SND_PCM_STREAM_CAPTURE,
+                           SND_PCM_NONBLOCK);
+    if (err < 0) {
+        qWarning() << __func__ << "failed to open device" << device << "error:" << snd_strerror(err);
+        return capabilities;
     }
-    bool openNeed = false;
-    if(!handle){
-        QString dev;
 
-#if SND_LIB_VERSION < 0x1000e  // 1.0.14
-        if (device.compare(QLatin1String("default")) != 0)
-            dev = deviceFromCardName(device);
-        else
-    #endif
-            dev = device;
-
-        if(mode == QAudio::AudioOutput) {
-            err=snd_pcm_open( &pcmHandle, dev.toLocal8Bit().constData(), SND_PCM_STREAM_PLAYBACK, 0);
-        } else {
-            err=snd_pcm_open( &pcmHandle, dev.toLocal8Bit().constData(), SND_PCM_STREAM_CAPTURE, 0);
+    snd_pcm_hw_params_t *params;
+    snd_pcm_hw_params_alloca(&params);
+    err = snd_pcm_hw_params_any(pcmHandle, params);
+
+    if (err >= 0) {
+        int dir = 0;
+        snd_pcm_hw_params_get_rate_min(params, &capabilities.minRate, &dir);
+        snd_pcm_hw_params_get_rate_max(params, &capabilities.maxRate, &dir);
+        snd_pcm_hw_params_get_channels_min(params, &capabilities.minChannels);
+        snd_pcm_hw_params_get_channels_max(params, &capabilities.maxChannels);
+
+        snd_pcm_format_mask_t *mask;
+        snd_pcm_format_mask_alloca(&mask);
+        snd_pcm_hw_params_get_format_mask(params, mask);
+        capabilities.formats.resize(SND_PCM_FORMAT_LAST + 1);
+        for (int f = 0; f <= SND_PCM_FORMAT_LAST; ++f) {
+            if (snd_pcm_format_mask_test(mask, snd_pcm_format_t(f)))
+                capabilities.formats.setBit(f);
         }
-        if(err < 0) {
-            return false;
+
+        // Testing against the open handle only refines the parameter space,
+        // it doesn't reopen the device.
+        for (unsigned int rate : probedRates) {
+            if (rate >= capabilities.minRate && rate <= capabilities.maxRate
+                    && snd_pcm_hw_params_test_rate(pcmHandle, params, rate, 0) == 0) {
+                capabilities.rates.append(int(rate));
+            }
         }
-        snd_pcm_nonblock(pcmHandle, 0);
-        openNeed = true;
-    }
-    else{
-        pcmHandle = handle;
+
+        const unsigned int maxChannels = qMin(capabilities.maxChannels, maxProbedChannels);
+        for (unsigned int count = qMax(capabilities.minChannels, 1u); count <= maxChannels; ++count) {
+            if (snd_pcm_hw_params_test_channels(pcmHandle, params, count) == 0)
+                capabilities.channels.append(int(count));
+        }
+
+        capabilities.valid = true;
     }
 
-    snd_pcm_hw_params_alloca(&params);
-    snd_pcm_hw_params_any(pcmHandle, params);
+    snd_pcm_close(pcmHandle);
+    return capabilities;
+}
 
+snd_pcm_format_t QAlsaAudioDeviceInfo::pcmFormat(const QAudioFormat &format)
+{
     snd_pcm_format_t pcmFormat = SND_PCM_FORMAT_UNKNOWN;
     switch (format.sampleSize()) {
     case 8:
@@ -271,38 +323,16 @@ bool QAlsaAudioDeviceInfo::testSettings(const QAudioFormat& format) const
                       ? SND_PCM_FORMAT_FLOAT_LE : SND_PCM_FORMAT_FLOAT_BE;
         }
     }
+    return pcmFormat;
+}
 
-    if(pcmFormat == SND_PCM_FORMAT_UNKNOWN){
-        if(openNeed){
-            snd_pcm_close(pcmHandle);
-        }
+bool QAlsaAudioDeviceInfo::testSettings(const QAudioFormat& format) const
+{
+    // For now, just accept only audio/pcm codec
+    if (!format.codec().startsWith(QLatin1String("audio/pcm")))
         return false;
-    }
-
-    err = snd_pcm_hw_params_test_format(pcmHandle, params, pcmFormat);
-    if(err < 0){
-        qDebug() << __func__ << device << "This format is not supported" << format.sampleType() << format.sampleSize();
-    }
-
-    if (err >= 0 && format.channelCount() > 0) {
-        err = snd_pcm_hw_params_test_channels(pcmHandle, params, format.channelCount());
-    }
-    if(err < 0){
-        qDebug() << __func__ << device <<"This channel count is not supported" << format.channelCount();
-    }
-
-    if (err >= 0 && format.sampleRate() != -1) {
-        err = snd_pcm_hw_params_test_rate(pcmHandle, params, format.sampleRate(), 0);
-    }
-    if(err < 0){
-        qDebug() << __func__ << device <<"This sample rate is not supported" << format.sampleRate();
-    }
 
-    if(openNeed){
-        snd_pcm_close(pcmHandle);
-    }
-
-    return (err == 0);
+    return capabilities.isFormatSupported(format);
 }
 
 void QAlsaAudioDeviceInfo::updateLists()
@@ -319,11 +349,9 @@ void QAlsaAudioDeviceInfo::updateLists()
     byteOrderz.append(QAudioFormat::LittleEndian);
     byteOrderz.append(QAudioFormat::BigEndian);
 
-    if(!handle)
-        open();
-
-    if(!handle)
+    if (!capabilities.valid)
         return;
+
     QAudioFormat referenceFormat = preferredFormat();
     const int sizes[] = {16, 20, 24, 32};
     referenceFormat.setSampleType(QAudioFormat::SignedInt);
@@ -362,7 +390,6 @@ void QAlsaAudioDeviceInfo::updateLists()
     referenceFormat.setSampleSize(32);
     if (isFormatSupported(referenceFormat))
         typez.append(QAudioFormat::Float);
-    close();
 }
 
 QList<QByteArray> QAlsaAudioDeviceInfo::availableDevices(QAudio::Mode mode)
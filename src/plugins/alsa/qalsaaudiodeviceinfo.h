@@ -54,6 +54,7 @@
 
 #include <alsa/asoundlib.h>
 
+#include <QtCore/qbitarray.h>
 #include <QtCore/qbytearray.h>
 #include <QtCore/qstringlist.h>
 #include <QtCore/qlist.h>
@@ -70,6 +71,22 @@ const unsigned int MAX_SAMPLE_RATES = 5;
 const unsigned int SAMPLE_RATES[] =
     { 8000, 11025, 22050, 44100, 48000 };
 
+// What a PCM device accepts, read from its hw params in one open.
+struct QAlsaAudioDeviceCapabilities
+{
+    bool isFormatSupported(const QAudioFormat &format) const;
+
+    bool valid = false;
+    QBitArray formats;
+    unsigned int minRate = 0;
+    unsigned int maxRate = 0;
+    unsigned int minChannels = 0;
+    unsigned int maxChannels = 0;
+    // Ranges can have holes, so common values are tested exactly.
+    QList<int> rates;
+    QList<int> channels;
+};
+
 class QAlsaAudioDeviceInfo : public QAbstractAudioDeviceInfo
 {
     Q_OBJECT
@@ -91,10 +108,11 @@ public:
     static QByteArray defaultDevice(QAudio::Mode mode);
     static QList<QByteArray> availableDevices(QAudio::Mode);
     static QString deviceFromCardName(const QString &card);
+    static snd_pcm_format_t pcmFormat(const QAudioFormat &format);
 
 private:
-    bool open();
-    void close();
+    static QAlsaAudioDeviceCapabilities probeCapabilities(const QString &device, QAudio::Mode mode);
+    static QAlsaAudioDeviceCapabilities cachedCapabilities(const QString &device, QAudio::Mode mode);
 
     QString device;
     QAudio::Mode mode;
@@ -105,8 +123,7 @@ private:
     QList<QAudioFormat::Endian> byteOrderz;
     QStringList codecz;
     QList<QAudioFormat::SampleType> typez;
-    snd_pcm_t* handle;
-    snd_pcm_hw_params_t *params;
+    QAlsaAudioDeviceCapabilities capabilities;
 };
 
 QT_END_NAMESPACE
@@ -48,19 +48,48 @@
 // INTERNAL USE ONLY: Do NOT use for any other purpose.
 //
 
-#include <QtCore/qcoreapplication.h>
-#include <QtCore/qvarlengtharray.h>
 #include <QtMultimedia/private/qaudiohelpers_p.h>
 #include "qalsaaudioinput.h"
 #include "qalsaaudiodeviceinfo.h"
 
+#include <string.h>
+
 QT_BEGIN_NAMESPACE
 
 //#define DEBUG_AUDIO 1
 
+// How long the capture thread blocks on the PCM before checking whether it
+// has been asked to stop.
+static const int captureWaitMs = 100;
+
+static qint64 volumeToBits(qreal volume)
+{
+    double value = volume;
+    qint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static qreal volumeFromBits(qint64 bits)
+{
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+QAlsaCaptureThread::QAlsaCaptureThread(QAlsaAudioInput *input)
+    : QThread(input)
+    , m_input(input)
+{
+}
+
+void QAlsaCaptureThread::run()
+{
+    m_input->capture();
+}
+
 QAlsaAudioInput::QAlsaAudioInput(const QByteArray &device)
 {
-    bytesAvailable = 0;
     handle = 0;
     access = SND_PCM_ACCESS_RW_INTERLEAVED;
     pcmformat = SND_PCM_FORMAT_S16;
@@ -76,30 +105,27 @@ QAlsaAudioInput::QAlsaAudioInput(const QByteArray &device)
     pullMode = true;
     resuming = false;
 
-    m_volume = 1.0f;
+    m_volume.storeRelease(volumeToBits(1.0));
 
     m_device = device;
 
-    timer = new QTimer(this);
-    connect(timer,SIGNAL(timeout()),SLOT(userFeed()));
+    captureThread = new QAlsaCaptureThread(this);
 }
 
 QAlsaAudioInput::~QAlsaAudioInput()
 {
     close();
-    disconnect(timer, SIGNAL(timeout()));
-    QCoreApplication::processEvents();
-    delete timer;
 }
 
 void QAlsaAudioInput::setVolume(qreal vol)
 {
-    m_volume = vol;
+    // Read by the capture thread, which applies it as the samples arrive.
+    m_volume.storeRelease(volumeToBits(vol));
 }
 
 qreal QAlsaAudioInput::volume() const
 {
-    return m_volume;
+    return volumeFromBits(m_volume.loadAcquire());
 }
 
 QAudio::Error QAlsaAudioInput::error() const
@@ -123,52 +149,6 @@ QAudioFormat QAlsaAudioInput::format() const
     return settings;
 }
 
-int QAlsaAudioInput::xrun_recovery(int err)
-{
-    int  count = 0;
-    bool reset = false;
-
-    // ESTRPIPE is not available in all OSes where ALSA is available
-    int estrpipe = EIO;
-#ifdef ESTRPIPE
-    estrpipe = ESTRPIPE;
-#endif
-
-    if(err == -EPIPE) {
-        errorState = QAudio::UnderrunError;
-        err = snd_pcm_prepare(handle);
-        if(err < 0)
-            reset = true;
-        else {
-            bytesAvailable = checkBytesReady();
-            if (bytesAvailable <= 0)
-                reset = true;
-        }
-    } else if ((err == -estrpipe)||(err == -EIO)) {
-        errorState = QAudio::IOError;
-        while((err = snd_pcm_resume(handle)) == -EAGAIN){
-            usleep(100);
-            count++;
-            if(count > 5) {
-                reset = true;
-                break;
-            }
-        }
-        if(err < 0) {
-            err = snd_pcm_prepare(handle);
-            if(err < 0)
-                reset = true;
-        }
-    }
-    if(reset) {
-        close();
-        open();
-        snd_pcm_prepare(handle);
-        return 0;
-    }
-    return err;
-}
-
 int QAlsaAudioInput::setFormat()
 {
     snd_pcm_format_t format = SND_PCM_FORMAT_UNKNOWN;
@@ -436,228 +416,228 @@ bool QAlsaAudioInput::open()
     snd_pcm_sw_params(handle, swparams);
 
     // Step 4: Prepare audio
-    ringBuffer.resize(buffer_size);
+    // The ring holds several device buffers, so capture carries on while the
+    // thread reading from it is busy.
+    int ringSize = qMax(buffer_size * 4, settings.bytesForDuration(500000));
+    ringSize -= ringSize % snd_pcm_frames_to_bytes(handle, 1);
+    ringBuffer.resize(ringSize);
     snd_pcm_prepare( handle );
     snd_pcm_start(handle);
 
-    // Step 5: Setup timer
-    bytesAvailable = checkBytesReady();
-
-    if(pullMode)
-        connect(audioSource,SIGNAL(readyRead()),this,SLOT(userFeed()));
-
-    // Step 6: Start audio processing
-    chunks = buffer_size/period_size;
-    timer->start(period_time*chunks/2000);
-
     errorState  = QAudio::NoError;
 
     totalTimeValue = 0;
 
+    // Step 5: Start audio processing
+    startCapture();
+
     return true;
 }
 
 void QAlsaAudioInput::close()
 {
-    timer->stop();
+    stopCapture();
 
     if ( handle ) {
         snd_pcm_drop( handle );
         snd_pcm_close( handle );
         handle = 0;
     }
+
+    ringBuffer.reset();
 }
 
-int QAlsaAudioInput::checkBytesReady()
+void QAlsaAudioInput::startCapture()
 {
-    if(resuming)
-        bytesAvailable = period_size;
-    else if(deviceState != QAudio::ActiveState
-            && deviceState != QAudio::IdleState)
-        bytesAvailable = 0;
-    else {
-        int frames = snd_pcm_avail_update(handle);
-        if (frames < 0) {
-            bytesAvailable = frames;
-        } else {
-            if((int)frames > (int)buffer_frames)
-                frames = buffer_frames;
-            bytesAvailable = snd_pcm_frames_to_bytes(handle, frames);
+    captureOverrun.storeRelease(0);
+    captureFailed.storeRelease(0);
+    capturePending.storeRelease(0);
+    captureRunning.storeRelease(1);
+    captureThread->start(QThread::TimeCriticalPriority);
+}
+
+void QAlsaAudioInput::stopCapture()
+{
+    captureRunning.storeRelease(0);
+    captureThread->wait();
+}
+
+// Runs on the capture thread. Blocks on the PCM and reads each period
+// straight into the ring, so nothing is lost while the owning thread is
+// stalled for less than the ring's length.
+void QAlsaAudioInput::capture()
+{
+    const int frameBytes = snd_pcm_frames_to_bytes(handle, 1);
+    QByteArray discard;
+
+    while (captureRunning.loadAcquire()) {
+        int err = snd_pcm_wait(handle, captureWaitMs);
+        if (err == 0)
+            continue;
+
+        if (err > 0) {
+            const RingBuffer::Region region = ringBuffer.acquireWriteRegion(period_size);
+            char *dst = region.first;
+            int frames = region.second / frameBytes;
+            if (frames == 0) {
+                // The reader is a whole ring behind. Keep draining the PCM so
+                // the device does not overrun as well, and drop the period.
+                captureOverrun.storeRelease(1);
+                if (capturePending.testAndSetOrdered(0, 1))
+                    QMetaObject::invokeMethod(this, "captured", Qt::QueuedConnection);
+                discard.resize(period_size);
+                dst = discard.data();
+                frames = period_frames;
+            }
+
+            const snd_pcm_sframes_t readFrames = snd_pcm_readi(handle, dst, frames);
+            if (readFrames > 0) {
+                if (dst == region.first) {
+                    const int bytes = snd_pcm_frames_to_bytes(handle, readFrames);
+                    const qreal vol = volumeFromBits(m_volume.loadAcquire());
+                    if (vol < 1.0)
+                        QAudioHelperInternal::qMultiplySamples(vol, settings, dst, dst, bytes);
+                    ringBuffer.releaseWriteRegion(RingBuffer::Region(dst, bytes));
+
+                    if (capturePending.testAndSetOrdered(0, 1))
+                        QMetaObject::invokeMethod(this, "captured", Qt::QueuedConnection);
+                }
+                continue;
+            }
+            err = int(readFrames);
+        }
+
+        if (err == 0 || err == -EAGAIN)
+            continue;
+
+        if (err == -EPIPE) {
+            captureOverrun.storeRelease(1);
+            if (capturePending.testAndSetOrdered(0, 1))
+                QMetaObject::invokeMethod(this, "captured", Qt::QueuedConnection);
+        }
+
+        if (snd_pcm_recover(handle, err, 1) < 0) {
+            captureFailed.storeRelease(1);
+            QMetaObject::invokeMethod(this, "captured", Qt::QueuedConnection);
+            return;
         }
+        // A recovered capture stream is only prepared.
+        snd_pcm_start(handle);
     }
-    return bytesAvailable;
 }
 
 int QAlsaAudioInput::bytesReady() const
 {
-    return qMax(bytesAvailable, 0);
+    return ringBuffer.used();
+}
+
+// Zero-copy access to the captured data: peek() returns the next contiguous
+// run of at most maxBytes bytes in the ring, which stays valid until commit()
+// consumes it. Only the thread owning this object may call them.
+RingBuffer::Region QAlsaAudioInput::peek(int maxBytes)
+{
+    return ringBuffer.acquireReadRegion(maxBytes);
+}
+
+void QAlsaAudioInput::commit(int bytes)
+{
+    ringBuffer.releaseReadRegion(RingBuffer::Region(0, bytes));
 }
 
 qint64 QAlsaAudioInput::read(char* data, qint64 len)
 {
-    // Read in some audio data and write it to QIODevice, pull mode
     if ( !handle )
         return 0;
 
-    int bytesRead = 0;
-    int bytesInRingbufferBeforeRead = ringBuffer.bytesOfDataInBuffer();
-
-    if (ringBuffer.bytesOfDataInBuffer() < len) {
-
-        // bytesAvaiable is saved as a side effect of checkBytesReady().
-        int bytesToRead = checkBytesReady();
+    if (deviceState != QAudio::ActiveState && deviceState != QAudio::IdleState)
+        return 0;
 
-        if (bytesToRead < 0) {
-            // bytesAvailable as negative is error code, try to recover from it.
-            xrun_recovery(bytesToRead);
-            bytesToRead = checkBytesReady();
-            if (bytesToRead < 0) {
-                // recovery failed must stop and set error.
-                close();
-                errorState = QAudio::IOError;
-                deviceState = QAudio::StoppedState;
-                emit stateChanged(deviceState);
-                return 0;
-            }
-        }
+    if (ringBuffer.used() == 0)
+        return 0;
 
-        bytesToRead = qMin<qint64>(len, bytesToRead);
-        bytesToRead = qMin<qint64>(ringBuffer.freeBytes(), bytesToRead);
-        bytesToRead -= bytesToRead % period_size;
-
-        int count=0;
-        int err = 0;
-        QVarLengthArray<char, 4096> buffer(bytesToRead);
-        while(count < 5 && bytesToRead > 0) {
-            int chunks = bytesToRead / period_size;
-            int frames = chunks * period_frames;
-            if (frames > (int)buffer_frames)
-                frames = buffer_frames;
-
-            int readFrames = snd_pcm_readi(handle, buffer.data(), frames);
-            bytesRead = snd_pcm_frames_to_bytes(handle, readFrames);
-            if (m_volume < 1.0f)
-                QAudioHelperInternal::qMultiplySamples(m_volume, settings,
-                                                       buffer.constData(),
-                                                       buffer.data(), bytesRead);
-
-            if (readFrames >= 0) {
-                ringBuffer.write(buffer.data(), bytesRead);
-#ifdef DEBUG_AUDIO
-                qDebug() << QString::fromLatin1("read in bytes = %1 (frames=%2)").arg(bytesRead).arg(readFrames).toLatin1().constData();
-#endif
+    if (pullMode) {
+        // Write to the QIODevice straight out of the ring.
+        qint64 l = 0;
+        qint64 bytesWritten = 0;
+        while (bytesWritten < len) {
+            const RingBuffer::Region region = peek(int(qMin<qint64>(len - bytesWritten, ringBuffer.size())));
+            if (region.second <= 0)
                 break;
-            } else if((readFrames == -EAGAIN) || (readFrames == -EINTR)) {
-                errorState = QAudio::IOError;
-                err = 0;
+            l = audioSource->write(region.first, region.second);
+            if (l <= 0)
                 break;
-            } else {
-                if(readFrames == -EPIPE) {
-                    errorState = QAudio::UnderrunError;
-                    err = snd_pcm_prepare(handle);
-#ifdef ESTRPIPE
-                } else if(readFrames == -ESTRPIPE) {
-                    err = snd_pcm_prepare(handle);
-#endif
-                }
-                if(err != 0) break;
-            }
-            count++;
+            commit(int(l));
+            bytesWritten += l;
         }
 
-    }
-
-    bytesRead += bytesInRingbufferBeforeRead;
-
-    if (bytesRead > 0) {
-        // got some send it onward
 #ifdef DEBUG_AUDIO
-        qDebug() << "frames to write to QIODevice = " <<
-            snd_pcm_bytes_to_frames( handle, (int)bytesRead ) << " (" << bytesRead << ") bytes";
+        qDebug() << "frames written to QIODevice = " <<
+            snd_pcm_bytes_to_frames( handle, (int)bytesWritten ) << " (" << bytesWritten << ") bytes";
 #endif
-        if (deviceState != QAudio::ActiveState && deviceState != QAudio::IdleState)
-            return 0;
-
-        if (pullMode) {
-            qint64 l = 0;
-            qint64 bytesWritten = 0;
-            while (ringBuffer.bytesOfDataInBuffer() > 0) {
-                l = audioSource->write(ringBuffer.availableData(), ringBuffer.availableDataBlockSize());
-                if (l > 0) {
-                    ringBuffer.readBytes(l);
-                    bytesWritten += l;
-                } else {
-                    break;
-                }
-            }
 
-            if (l < 0) {
-                close();
-                errorState = QAudio::IOError;
-                deviceState = QAudio::StoppedState;
+        if (l < 0) {
+            close();
+            errorState = QAudio::IOError;
+            deviceState = QAudio::StoppedState;
+            emit stateChanged(deviceState);
+        } else if (l == 0 && bytesWritten == 0) {
+            if (deviceState != QAudio::IdleState) {
+                errorState = QAudio::NoError;
+                deviceState = QAudio::IdleState;
                 emit stateChanged(deviceState);
-            } else if (l == 0 && bytesWritten == 0) {
-                if (deviceState != QAudio::IdleState) {
-                    errorState = QAudio::NoError;
-                    deviceState = QAudio::IdleState;
-                    emit stateChanged(deviceState);
-                }
-            } else {
-                bytesAvailable -= bytesWritten;
-                totalTimeValue += bytesWritten;
-                resuming = false;
-                if (deviceState != QAudio::ActiveState) {
-                    errorState = QAudio::NoError;
-                    deviceState = QAudio::ActiveState;
-                    emit stateChanged(deviceState);
-                }
             }
-
-            return bytesWritten;
         } else {
-            while (ringBuffer.bytesOfDataInBuffer() > 0) {
-                int size = ringBuffer.availableDataBlockSize();
-                memcpy(data, ringBuffer.availableData(), size);
-                data += size;
-                ringBuffer.readBytes(size);
-            }
-
-            bytesAvailable -= bytesRead;
-            totalTimeValue += bytesRead;
+            totalTimeValue += bytesWritten;
             resuming = false;
             if (deviceState != QAudio::ActiveState) {
                 errorState = QAudio::NoError;
                 deviceState = QAudio::ActiveState;
                 emit stateChanged(deviceState);
             }
-
-            return bytesRead;
         }
+
+        return bytesWritten;
     }
 
-    return 0;
+    qint64 bytesRead = 0;
+    while (bytesRead < len) {
+        const RingBuffer::Region region = peek(int(qMin<qint64>(len - bytesRead, ringBuffer.size())));
+        if (region.second <= 0)
+            break;
+        memcpy(data + bytesRead, region.first, region.second);
+        commit(region.second);
+        bytesRead += region.second;
+    }
+
+    totalTimeValue += bytesRead;
+    resuming = false;
+    if (deviceState != QAudio::ActiveState) {
+        errorState = QAudio::NoError;
+        deviceState = QAudio::ActiveState;
+        emit stateChanged(deviceState);
+    }
+
+    return bytesRead;
 }
 
 void QAlsaAudioInput::resume()
 {
     if(deviceState == QAudio::SuspendedState) {
-        int err = 0;
-
         if(handle) {
-            err = snd_pcm_prepare( handle );
-            if(err < 0)
-                xrun_recovery(err);
-
-            err = snd_pcm_start(handle);
-            if(err < 0)
-                xrun_recovery(err);
-
-            bytesAvailable = buffer_size;
+            int err = snd_pcm_prepare( handle );
+            if(err >= 0)
+                err = snd_pcm_start(handle);
+            if(err < 0) {
+                close();
+                errorState = QAudio::IOError;
+                deviceState = QAudio::StoppedState;
+                emit stateChanged(deviceState);
+                return;
+            }
+            startCapture();
         }
         resuming = true;
         deviceState = QAudio::ActiveState;
-        int chunks = buffer_size/period_size;
-        timer->start(period_time*chunks/2000);
         emit stateChanged(deviceState);
     }
 }
@@ -699,59 +679,58 @@ qint64 QAlsaAudioInput::processedUSecs() const
 void QAlsaAudioInput::suspend()
 {
     if(deviceState == QAudio::ActiveState||resuming) {
+        stopCapture();
         snd_pcm_drain(handle);
-        timer->stop();
         deviceState = QAudio::SuspendedState;
         emit stateChanged(deviceState);
     }
 }
 
-void QAlsaAudioInput::userFeed()
+void QAlsaAudioInput::captured()
 {
+    capturePending.storeRelease(0);
+
     if(deviceState == QAudio::StoppedState || deviceState == QAudio::SuspendedState)
         return;
 #ifdef DEBUG_AUDIO
     QTime now(QTime::currentTime());
-    qDebug()<<now.second()<<"s "<<now.msec()<<"ms :userFeed() IN";
+    qDebug()<<now.second()<<"s "<<now.msec()<<"ms :captured() IN";
 #endif
-    deviceReady();
-}
 
-bool QAlsaAudioInput::deviceReady()
-{
+    if (captureFailed.loadAcquire()) {
+        // The capture thread could not recover the PCM and has exited.
+        close();
+        errorState = QAudio::IOError;
+        deviceState = QAudio::StoppedState;
+        emit errorChanged(errorState);
+        emit stateChanged(deviceState);
+        return;
+    }
+
+    // The capture thread only flags an overrun; it is reported here, on
+    // the thread owning the input.
+    if (captureOverrun.fetchAndStoreAcquire(0) && errorState != QAudio::UnderrunError) {
+        errorState = QAudio::UnderrunError;
+        emit errorChanged(errorState);
+    }
+
     if(pullMode) {
-        // reads some audio data and writes it to QIODevice
-        read(0, buffer_size);
+        // writes the captured audio data to QIODevice
+        read(0, ringBuffer.used());
     } else {
         // emits readyRead() so user will call read() on QIODevice to get some audio data
         AlsaInputPrivate* a = qobject_cast<AlsaInputPrivate*>(audioSource);
         a->trigger();
     }
-    bytesAvailable = checkBytesReady();
 
     if(deviceState != QAudio::ActiveState)
-        return true;
-
-    if (bytesAvailable < 0) {
-        // bytesAvailable as negative is error code, try to recover from it.
-        xrun_recovery(bytesAvailable);
-        bytesAvailable = checkBytesReady();
-        if (bytesAvailable < 0) {
-            // recovery failed must stop and set error.
-            close();
-            errorState = QAudio::IOError;
-            deviceState = QAudio::StoppedState;
-            emit stateChanged(deviceState);
-            return 0;
-        }
-    }
+        return;
 
     if(intervalTime && (timeStamp.elapsed() + elapsedTimeOffset) > intervalTime) {
         emit notify();
         elapsedTimeOffset = timeStamp.elapsed() + elapsedTimeOffset - intervalTime;
         timeStamp.restart();
     }
-    return true;
 }
 
 qint64 QAlsaAudioInput::elapsedUSecs() const
@@ -764,10 +743,7 @@ qint64 QAlsaAudioInput::elapsedUSecs() const
 
 void QAlsaAudioInput::reset()
 {
-    if(handle)
-        snd_pcm_reset(handle);
     stop();
-    bytesAvailable = 0;
 }
 
 void QAlsaAudioInput::drain()
@@ -803,68 +779,72 @@ void AlsaInputPrivate::trigger()
 }
 
 RingBuffer::RingBuffer() :
-        m_head(0),
-        m_tail(0)
+        m_readPos(0),
+        m_writePos(0),
+        m_size(0)
 {
 }
 
+// Not thread-safe; only called while the capture thread is not running.
 void RingBuffer::resize(int size)
 {
-    m_data.resize(size);
+    if (size != m_size) {
+        m_data.reset(new char[size]);
+        m_size = size;
+    }
+    reset();
 }
 
-int RingBuffer::bytesOfDataInBuffer() const
+void RingBuffer::reset()
 {
-    if (m_head < m_tail)
-        return m_tail - m_head;
-    else if (m_tail < m_head)
-        return m_data.size() + m_tail - m_head;
-    else
-        return 0;
+    m_readPos = 0;
+    m_writePos = 0;
+    m_used.storeRelease(0);
 }
 
-int RingBuffer::freeBytes() const
+RingBuffer::Region RingBuffer::acquireReadRegion(int size)
 {
-    if (m_head > m_tail)
-        return m_head - m_tail - 1;
-    else if (m_tail > m_head)
-        return m_data.size() - m_tail + m_head - 1;
-    else
-        return m_data.size() - 1;
+    const int used = m_used.loadAcquire();
+
+    const int readSize = qMin(size, qMin(m_size - m_readPos, used));
+    return readSize > 0 ? Region(m_data.data() + m_readPos, readSize) : Region(0, 0);
 }
 
-const char *RingBuffer::availableData() const
+void RingBuffer::releaseReadRegion(const Region &region)
 {
-    return (m_data.constData() + m_head);
+    m_readPos = (m_readPos + region.second) % m_size;
+
+    m_used.fetchAndAddRelease(-region.second);
 }
 
-int RingBuffer::availableDataBlockSize() const
+RingBuffer::Region RingBuffer::acquireWriteRegion(int size)
 {
-    if (m_head > m_tail)
-        return m_data.size() - m_head;
-    else if (m_tail > m_head)
-        return m_tail - m_head;
-    else
-        return 0;
+    const int free = m_size - m_used.loadAcquire();
+
+    const int writeSize = qMin(size, qMin(m_size - m_writePos, free));
+    return writeSize > 0 ? Region(m_data.data() + m_writePos, writeSize) : Region(0, 0);
 }
 
-void RingBuffer::readBytes(int bytes)
+void RingBuffer::releaseWriteRegion(const Region &region)
 {
-    m_head = (m_head + bytes) % m_data.size();
+    m_writePos = (m_writePos + region.second) % m_size;
+
+    m_used.fetchAndAddRelease(region.second);
 }
 
-void RingBuffer::write(char *data, int len)
+int RingBuffer::used() const
 {
-    if (m_tail + len < m_data.size()) {
-        memcpy(m_data.data() + m_tail, data, len);
-        m_tail += len;
-    } else {
-        int bytesUntilEnd = m_data.size() - m_tail;
-        memcpy(m_data.data() + m_tail, data, bytesUntilEnd);
-        if (len - bytesUntilEnd > 0)
-            memcpy(m_data.data(), data + bytesUntilEnd, len - bytesUntilEnd);
-        m_tail = len - bytesUntilEnd;
-    }
+    return m_used.loadAcquire();
+}
+
+int RingBuffer::free() const
+{
+    return m_size - m_used.loadAcquire();
+}
+
+int RingBuffer::size() const
+{
+    return m_size;
 }
 
 QT_END_NAMESPACE
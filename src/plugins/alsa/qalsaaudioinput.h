@@ -54,9 +54,12 @@
 
 #include <alsa/asoundlib.h>
 
+#include <QtCore/qatomic.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qdebug.h>
-#include <QtCore/qtimer.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qthread.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qstringlist.h>
 #include <QtCore/qelapsedtimer.h>
@@ -70,28 +73,51 @@ QT_BEGIN_NAMESPACE
 
 
 class AlsaInputPrivate;
+class QAlsaAudioInput;
 
+// Single producer, single consumer ring. The capture thread writes into it
+// while the thread owning the QAlsaAudioInput reads from it, without locks.
+// The storage is allocated up front by resize(), so neither side ever
+// touches shared container state.
 class RingBuffer
 {
 public:
+    typedef QPair<char *, int> Region;
+
     RingBuffer();
 
     void resize(int size);
+    void reset();
 
-    int bytesOfDataInBuffer() const;
-    int freeBytes() const;
+    Region acquireReadRegion(int size);
+    void releaseReadRegion(const Region &region);
 
-    const char *availableData() const;
-    int availableDataBlockSize() const;
-    void readBytes(int bytes);
+    Region acquireWriteRegion(int size);
+    void releaseWriteRegion(const Region &region);
 
-    void write(char *data, int len);
+    int used() const;
+    int free() const;
+    int size() const;
 
 private:
-    int m_head;
-    int m_tail;
+    int m_readPos;
+    int m_writePos;
+    QAtomicInt m_used;
+
+    QScopedArrayPointer<char> m_data;
+    int m_size;
+};
+
+class QAlsaCaptureThread : public QThread
+{
+public:
+    QAlsaCaptureThread(QAlsaAudioInput *input);
+
+protected:
+    void run() override;
 
-    QByteArray m_data;
+private:
+    QAlsaAudioInput *m_input;
 };
 
 class QAlsaAudioInput : public QAbstractAudioInput
@@ -123,6 +149,10 @@ public:
     QAudioFormat format() const;
     void setVolume(qreal);
     qreal volume() const;
+
+    RingBuffer::Region peek(int maxBytes);
+    void commit(int bytes);
+
     bool resuming;
     snd_pcm_t* handle;
     qint64 totalTimeValue;
@@ -132,24 +162,29 @@ public:
     QAudio::State deviceState;
 
 private slots:
-    void userFeed();
-    bool deviceReady();
+    void captured();
 
 private:
-    int checkBytesReady();
-    int xrun_recovery(int err);
+    friend class QAlsaCaptureThread;
+
+    void capture();
+    void startCapture();
+    void stopCapture();
     int setFormat();
     bool open();
     void close();
     void drain();
 
-    QTimer* timer;
+    QAlsaCaptureThread *captureThread;
+    QAtomicInt captureRunning;
+    QAtomicInt capturePending;
+    QAtomicInt captureOverrun;
+    QAtomicInt captureFailed;
     QElapsedTimer timeStamp;
     QElapsedTimer clockStamp;
     qint64 elapsedTimeOffset;
     int intervalTime;
     RingBuffer ringBuffer;
-    int bytesAvailable;
     QByteArray m_device;
     bool pullMode;
     int buffer_size;
@@ -161,7 +196,7 @@ private:
     snd_pcm_access_t access;
     snd_pcm_format_t pcmformat;
     snd_pcm_hw_params_t *hwparams;
-    qreal m_volume;
+    QAtomicInteger<qint64> m_volume;
 };
 
 class AlsaInputPrivate : public QIODevice
@@ -42,6 +42,7 @@
 
 #include "qgstreameraudiodecoderservice.h"
 #include "qgstreameraudiodecodercontrol.h"
+#include "qgstreameraudiodecoderbatchcontrol.h"
 #include "qgstreameraudiodecodersession.h"
 
 QT_BEGIN_NAMESPACE
@@ -51,6 +52,7 @@ QGstreamerAudioDecoderService::QGstreamerAudioDecoderService(QObject *parent)
 {
     m_session = new QGstreamerAudioDecoderSession(this);
     m_control = new QGstreamerAudioDecoderControl(m_session, this);
+    m_batchControl = new QGstreamerAudioDecoderBatchControl(m_session, this);
 }
 
 QGstreamerAudioDecoderService::~QGstreamerAudioDecoderService()
@@ -62,6 +64,9 @@ QMediaControl *QGstreamerAudioDecoderService::requestControl(const char *name)
     if (qstrcmp(name, QAudioDecoderControl_iid) == 0)
         return m_control;
 
+    if (qstrcmp(name, QAudioDecoderBatchControl_iid) == 0)
+        return m_batchControl;
+
     return 0;
 }
 
@@ -47,6 +47,7 @@
 
 QT_BEGIN_NAMESPACE
 class QGstreamerAudioDecoderControl;
+class QGstreamerAudioDecoderBatchControl;
 class QGstreamerAudioDecoderSession;
 
 class QGstreamerAudioDecoderService : public QMediaService
@@ -61,6 +62,7 @@ public:
 
 private:
     QGstreamerAudioDecoderControl *m_control;
+    QGstreamerAudioDecoderBatchControl *m_batchControl;
     QGstreamerAudioDecoderSession *m_session;
 };
 
@@ -53,6 +53,7 @@
 #include <QtCore/qdebug.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qstandardpaths.h>
+#include <QtCore/qthread.h>
 #include <QtCore/qurl.h>
 
 #define MAX_BUFFERS_IN_QUEUE 4
@@ -86,6 +87,11 @@ QGstreamerAudioDecoderSession::QGstreamerAudioDecoderSession(QObject *parent)
 #endif
      mDevice(0),
      m_buffersAvailable(0),
+     m_appSinkQueueDepth(MAX_BUFFERS_IN_QUEUE),
+     m_endOfStream(true),
+     m_streamError(QAudioDecoder::NoError),
+     m_queueDepth(MAX_BUFFERS_IN_QUEUE),
+     m_synchronous(false),
      m_position(-1),
      m_duration(-1),
      m_durationQueries(0)
@@ -113,6 +119,10 @@ QGstreamerAudioDecoderSession::QGstreamerAudioDecoderSession(QObject *parent)
         gst_element_add_pad(GST_ELEMENT(m_outputBin), gst_ghost_pad_new("sink", pad));
         gst_object_unref(GST_OBJECT(pad));
 
+        // The appsink is kept for the lifetime of the session, only the
+        // source and decoder chain of playbin are rebuilt for each file.
+        addAppSink();
+
         g_object_set(G_OBJECT(m_playbin), "audio-sink", m_outputBin, NULL);
 #if QT_CONFIG(gstreamer_app)
         g_signal_connect(G_OBJECT(m_playbin), "deep-notify::source", (GCallback) &QGstreamerAudioDecoderSession::configureAppSrcElement, (gpointer)this);
@@ -127,7 +137,8 @@ QGstreamerAudioDecoderSession::QGstreamerAudioDecoderSession(QObject *parent)
 QGstreamerAudioDecoderSession::~QGstreamerAudioDecoderSession()
 {
     if (m_playbin) {
-        stop();
+        reset(GST_STATE_NULL);
+        removeAppSink();
 
         delete m_busHelper;
 #if QT_CONFIG(gstreamer_app)
@@ -189,10 +200,12 @@ bool QGstreamerAudioDecoderSession::processBusMessage(const QGstreamerMessage &m
                     switch (newState) {
                     case GST_STATE_VOID_PENDING:
                     case GST_STATE_NULL:
-                        m_state = QAudioDecoder::StoppedState;
-                        break;
                     case GST_STATE_READY:
-                        m_state = QAudioDecoder::StoppedState;
+                        // The pipeline is kept in READY between files, a
+                        // late message of the previous stop() must not
+                        // interrupt the file that is starting
+                        if (m_pendingState != QAudioDecoder::DecodingState)
+                            m_state = QAudioDecoder::StoppedState;
                         break;
                     case GST_STATE_PLAYING:
                         m_state = QAudioDecoder::DecodingState;
@@ -261,35 +274,7 @@ bool QGstreamerAudioDecoderSession::processBusMessage(const QGstreamerMessage &m
             GError *err;
             gchar *debug;
             gst_message_parse_error(gm, &err, &debug);
-            QAudioDecoder::Error qerror = QAudioDecoder::ResourceError;
-            if (err->domain == GST_STREAM_ERROR) {
-                switch (err->code) {
-                    case GST_STREAM_ERROR_DECRYPT:
-                    case GST_STREAM_ERROR_DECRYPT_NOKEY:
-                        qerror = QAudioDecoder::AccessDeniedError;
-                        break;
-                    case GST_STREAM_ERROR_FORMAT:
-                    case GST_STREAM_ERROR_DEMUX:
-                    case GST_STREAM_ERROR_DECODE:
-                    case GST_STREAM_ERROR_WRONG_TYPE:
-                    case GST_STREAM_ERROR_TYPE_NOT_FOUND:
-                    case GST_STREAM_ERROR_CODEC_NOT_FOUND:
-                        qerror = QAudioDecoder::FormatError;
-                        break;
-                    default:
-                        break;
-                }
-            } else if (err->domain == GST_CORE_ERROR) {
-                switch (err->code) {
-                    case GST_CORE_ERROR_MISSING_PLUGIN:
-                        qerror = QAudioDecoder::FormatError;
-                        break;
-                    default:
-                        break;
-                }
-            }
-
-            processInvalidMedia(qerror, QString::fromUtf8(err->message));
+            processInvalidMedia(errorForGError(err), QString::fromUtf8(err->message));
             g_error_free(err);
             g_free(debug);
         }
@@ -298,6 +283,58 @@ bool QGstreamerAudioDecoderSession::processBusMessage(const QGstreamerMessage &m
     return false;
 }
 
+QAudioDecoder::Error QGstreamerAudioDecoderSession::errorForGError(const GError *err)
+{
+    if (err->domain == GST_STREAM_ERROR) {
+        switch (err->code) {
+            case GST_STREAM_ERROR_DECRYPT:
+            case GST_STREAM_ERROR_DECRYPT_NOKEY:
+                return QAudioDecoder::AccessDeniedError;
+            case GST_STREAM_ERROR_FORMAT:
+            case GST_STREAM_ERROR_DEMUX:
+            case GST_STREAM_ERROR_DECODE:
+            case GST_STREAM_ERROR_WRONG_TYPE:
+            case GST_STREAM_ERROR_TYPE_NOT_FOUND:
+            case GST_STREAM_ERROR_CODEC_NOT_FOUND:
+                return QAudioDecoder::FormatError;
+            default:
+                break;
+        }
+    } else if (err->domain == GST_CORE_ERROR) {
+        switch (err->code) {
+            case GST_CORE_ERROR_MISSING_PLUGIN:
+                return QAudioDecoder::FormatError;
+            default:
+                break;
+        }
+    }
+
+    return QAudioDecoder::ResourceError;
+}
+
+bool QGstreamerAudioDecoderSession::processSyncMessage(const QGstreamerMessage &message)
+{
+    // Readers blocked in read(int, int) must not wait for the owner thread's
+    // event loop to deliver the error, it may be the thread that is blocked.
+    GstMessage* gm = message.rawMessage();
+    if (gm && GST_MESSAGE_TYPE(gm) == GST_MESSAGE_ERROR) {
+        GError *err;
+        gchar *debug;
+        gst_message_parse_error(gm, &err, &debug);
+        {
+            QMutexLocker locker(&m_buffersMutex);
+            if (m_streamError == QAudioDecoder::NoError)
+                m_streamError = errorForGError(err);
+        }
+        g_error_free(err);
+        g_free(debug);
+
+        setEndOfStream();
+    }
+
+    return false;
+}
+
 QString QGstreamerAudioDecoderSession::sourceFilename() const
 {
     return mSource;
@@ -341,8 +378,6 @@ void QGstreamerAudioDecoderSession::start()
         return;
     }
 
-    addAppSink();
-
     if (!mSource.isEmpty()) {
         g_object_set(G_OBJECT(m_playbin), "uri", QUrl::fromLocalFile(mSource).toEncoded().constData(), NULL);
     } else if (mDevice) {
@@ -365,6 +400,12 @@ void QGstreamerAudioDecoderSession::start()
 
     // Set audio format
     if (m_appSink) {
+        {
+            QMutexLocker locker(&m_buffersMutex);
+            m_appSinkQueueDepth = m_queueDepth;
+        }
+        gst_app_sink_set_max_buffers(m_appSink, m_appSinkQueueDepth);
+
         if (mFormat.isValid()) {
             setAudioFlags(false);
             GstCaps *caps = QGstUtils::capsForAudioFormat(mFormat);
@@ -377,9 +418,16 @@ void QGstreamerAudioDecoderSession::start()
         }
     }
 
+    {
+        QMutexLocker locker(&m_buffersMutex);
+        m_endOfStream = false;
+        m_streamError = QAudioDecoder::NoError;
+    }
+
     m_pendingState = QAudioDecoder::DecodingState;
     if (gst_element_set_state(m_playbin, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
         qWarning() << "GStreamer; Unable to start decoding process";
+        setEndOfStream();
         m_pendingState = m_state = QAudioDecoder::StoppedState;
 
         emit stateChanged(m_state);
@@ -387,24 +435,46 @@ void QGstreamerAudioDecoderSession::start()
 }
 
 void QGstreamerAudioDecoderSession::stop()
+{
+    // Keep the pipeline in READY so the next file starts without
+    // setting up the sink side again
+    reset(GST_STATE_READY);
+}
+
+void QGstreamerAudioDecoderSession::reset(GstState state)
 {
     if (m_playbin) {
-        gst_element_set_state(m_playbin, GST_STATE_NULL);
-        removeAppSink();
+        // Wake up readers first, they hold m_pullMutex while waiting
+        setEndOfStream();
+        gst_element_set_state(m_playbin, state);
+
+        // Going to NULL drops the pending bus messages, do the same for
+        // READY so messages of the previous file don't reach the next one
+        if (state != GST_STATE_NULL) {
+            gst_bus_set_flushing(m_bus, TRUE);
+            gst_bus_set_flushing(m_bus, FALSE);
+        }
 
         QAudioDecoder::State oldState = m_state;
         m_pendingState = m_state = QAudioDecoder::StoppedState;
 
-        // GStreamer thread is stopped. Can safely access m_buffersAvailable
-        if (m_buffersAvailable != 0) {
+        bool hadBuffers = false;
+        {
+            // GStreamer thread is stopped and the appsink is flushed. The
+            // count is shared with the appsink callback and the readers, so
+            // it is guarded by m_buffersMutex like everywhere else.
+            QMutexLocker pullLocker(&m_pullMutex);
+            m_pendingBuffer = QAudioBuffer();
+            QMutexLocker locker(&m_buffersMutex);
+            hadBuffers = m_buffersAvailable != 0;
             m_buffersAvailable = 0;
-            emit bufferAvailableChanged(false);
         }
 
-        if (m_position != -1) {
-            m_position = -1;
-            emit positionChanged(m_position);
-        }
+        if (hadBuffers && !m_synchronous)
+            emit bufferAvailableChanged(false);
+
+        if (setPosition(-1))
+            emit positionChanged(-1);
 
         if (m_duration != -1) {
             m_duration = -1;
@@ -429,61 +499,161 @@ void QGstreamerAudioDecoderSession::setAudioFormat(const QAudioFormat &format)
     }
 }
 
+void QGstreamerAudioDecoderSession::setBufferQueueDepth(int depth)
+{
+    // Applied to the appsink when decoding starts
+    m_queueDepth = qMax(1, depth);
+}
+
+void QGstreamerAudioDecoderSession::setSynchronous(bool synchronous)
+{
+    m_synchronous = synchronous;
+}
+
 QAudioBuffer QGstreamerAudioDecoderSession::read()
 {
-    QAudioBuffer audioBuffer;
+    return read(0, 0);
+}
 
-    int buffersAvailable;
+QAudioBuffer QGstreamerAudioDecoderSession::read(int maxFrames, int msecs)
+{
+    const QDeadlineTimer deadline(msecs < 0 ? qint64(-1) : qint64(msecs));
+
+    QAudioBuffer audioBuffer;
+    bool drained = false;
     {
-        QMutexLocker locker(&m_buffersMutex);
-        buffersAvailable = m_buffersAvailable;
+        QMutexLocker locker(&m_pullMutex);
+
+        QByteArray data;
+        QAudioFormat format;
+        qint64 startTime = -1;
+        int frames = 0;
+
+        while (maxFrames <= 0 || frames < maxFrames) {
+            QAudioBuffer chunk;
+            if (m_pendingBuffer.isValid()) {
+                chunk = m_pendingBuffer;
+                m_pendingBuffer = QAudioBuffer();
+            } else {
+                chunk = pullBuffer(deadline, &drained);
+            }
 
-        // need to decrement before pulling a buffer
-        // to make sure assert in QGstreamerAudioDecoderSession::new_buffer works
-        m_buffersAvailable--;
+            if (!chunk.isValid())
+                break;
+
+            if (maxFrames <= 0) {
+                audioBuffer = chunk;
+                break;
+            }
+
+            if (!format.isValid()) {
+                format = chunk.format();
+                startTime = chunk.startTime();
+            } else if (chunk.format() != format) {
+                // A buffer holds a single format, return the new one next time
+                m_pendingBuffer = chunk;
+                break;
+            }
+
+            const char *chunkData = static_cast<const char *>(chunk.constData());
+            const int chunkFrames = chunk.frameCount();
+            const int wanted = maxFrames - frames;
+            if (chunkFrames > wanted) {
+                const int bytes = format.bytesForFrames(wanted);
+                data.append(chunkData, bytes);
+                qint64 remainderStart = chunk.startTime();
+                if (remainderStart >= 0)
+                    remainderStart += format.durationForFrames(wanted);
+                m_pendingBuffer = QAudioBuffer(QByteArray(chunkData + bytes, chunk.byteCount() - bytes),
+                                               format, remainderStart);
+                frames += wanted;
+            } else {
+                data.append(chunkData, chunk.byteCount());
+                frames += chunkFrames;
+            }
+        }
+
+        if (maxFrames > 0 && format.isValid())
+            audioBuffer = QAudioBuffer(data, format, startTime);
     }
 
+    // read() may be called from any thread, the signals belong to the
+    // thread the session lives in
+    const bool ownerThread = QThread::currentThread() == thread();
 
-    if (buffersAvailable) {
-        if (buffersAvailable == 1)
+    if (drained && !m_synchronous) {
+        if (ownerThread)
             emit bufferAvailableChanged(false);
+        else
+            QMetaObject::invokeMethod(this, "bufferAvailableChanged", Qt::QueuedConnection, Q_ARG(bool, false));
+    }
+
+    if (audioBuffer.isValid()) {
+        const qint64 position = audioBuffer.startTime() / 1000; // convert to milliseconds
+        if (setPosition(position)) {
+            if (ownerThread)
+                emit positionChanged(position);
+            else
+                QMetaObject::invokeMethod(this, "positionChanged", Qt::QueuedConnection, Q_ARG(qint64, position));
+        }
+    }
+
+    return audioBuffer;
+}
+
+QAudioBuffer QGstreamerAudioDecoderSession::pullBuffer(const QDeadlineTimer &deadline, bool *drained)
+{
+    {
+        QMutexLocker locker(&m_buffersMutex);
+        while (m_buffersAvailable == 0 && !m_endOfStream) {
+            if (!m_bufferCondition.wait(&m_buffersMutex, deadline))
+                break;
+        }
+
+        if (m_buffersAvailable == 0 || !m_appSink)
+            return QAudioBuffer();
+
+        // need to decrement before pulling a buffer
+        // to make sure assert in QGstreamerAudioDecoderSession::new_sample works
+        if (--m_buffersAvailable == 0)
+            *drained = true;
+    }
 
-        const char* bufferData = 0;
-        int bufferSize = 0;
+    QAudioBuffer audioBuffer;
+    const char* bufferData = 0;
+    int bufferSize = 0;
 
 #if GST_CHECK_VERSION(1,0,0)
-        GstSample *sample = gst_app_sink_pull_sample(m_appSink);
-        GstBuffer *buffer = gst_sample_get_buffer(sample);
-        GstMapInfo mapInfo;
-        gst_buffer_map(buffer, &mapInfo, GST_MAP_READ);
-        bufferData = (const char*)mapInfo.data;
-        bufferSize = mapInfo.size;
-        QAudioFormat format = QGstUtils::audioFormatForSample(sample);
+    GstSample *sample = gst_app_sink_pull_sample(m_appSink);
+    if (!sample)
+        return audioBuffer;
+    GstBuffer *buffer = gst_sample_get_buffer(sample);
+    GstMapInfo mapInfo;
+    gst_buffer_map(buffer, &mapInfo, GST_MAP_READ);
+    bufferData = (const char*)mapInfo.data;
+    bufferSize = mapInfo.size;
+    QAudioFormat format = QGstUtils::audioFormatForSample(sample);
 #else
-        GstBuffer *buffer = gst_app_sink_pull_buffer(m_appSink);
-        bufferData = (const char*)buffer->data;
-        bufferSize = buffer->size;
-        QAudioFormat format = QGstUtils::audioFormatForBuffer(buffer);
+    GstBuffer *buffer = gst_app_sink_pull_buffer(m_appSink);
+    if (!buffer)
+        return audioBuffer;
+    bufferData = (const char*)buffer->data;
+    bufferSize = buffer->size;
+    QAudioFormat format = QGstUtils::audioFormatForBuffer(buffer);
 #endif
 
-        if (format.isValid()) {
-            // XXX At the moment we have to copy data from GstBuffer into QAudioBuffer.
-            // We could improve performance by implementing QAbstractAudioBuffer for GstBuffer.
-            qint64 position = getPositionFromBuffer(buffer);
-            audioBuffer = QAudioBuffer(QByteArray((const char*)bufferData, bufferSize), format, position);
-            position /= 1000; // convert to milliseconds
-            if (position != m_position) {
-                m_position = position;
-                emit positionChanged(m_position);
-            }
-        }
+    if (format.isValid()) {
+        // XXX At the moment we have to copy data from GstBuffer into QAudioBuffer.
+        // We could improve performance by implementing QAbstractAudioBuffer for GstBuffer.
+        qint64 position = getPositionFromBuffer(buffer);
+        audioBuffer = QAudioBuffer(QByteArray((const char*)bufferData, bufferSize), format, position);
+    }
 #if GST_CHECK_VERSION(1,0,0)
-        gst_buffer_unmap(buffer, &mapInfo);
-        gst_sample_unref(sample);
+    gst_buffer_unmap(buffer, &mapInfo);
+    gst_sample_unref(sample);
 #else
-        gst_buffer_unref(buffer);
+    gst_buffer_unref(buffer);
 #endif
-    }
 
     return audioBuffer;
 }
@@ -494,11 +664,37 @@ bool QGstreamerAudioDecoderSession::bufferAvailable() const
     return m_buffersAvailable > 0;
 }
 
+bool QGstreamerAudioDecoderSession::atEnd() const
+{
+    QMutexLocker pullLocker(&m_pullMutex);
+    if (m_pendingBuffer.isValid())
+        return false;
+
+    QMutexLocker locker(&m_buffersMutex);
+    return m_endOfStream && m_buffersAvailable == 0;
+}
+
 qint64 QGstreamerAudioDecoderSession::position() const
 {
+    QMutexLocker locker(&m_buffersMutex);
     return m_position;
 }
 
+QAudioDecoder::Error QGstreamerAudioDecoderSession::streamError() const
+{
+    QMutexLocker locker(&m_buffersMutex);
+    return m_streamError;
+}
+
+bool QGstreamerAudioDecoderSession::setPosition(qint64 position)
+{
+    QMutexLocker locker(&m_buffersMutex);
+    if (m_position == position)
+        return false;
+    m_position = position;
+    return true;
+}
+
 qint64 QGstreamerAudioDecoderSession::duration() const
 {
      return m_duration;
@@ -506,10 +702,18 @@ qint64 QGstreamerAudioDecoderSession::duration() const
 
 void QGstreamerAudioDecoderSession::processInvalidMedia(QAudioDecoder::Error errorCode, const QString& errorString)
 {
-    stop();
+    // Don't reuse a pipeline that failed
+    reset(GST_STATE_NULL);
     emit error(int(errorCode), errorString);
 }
 
+void QGstreamerAudioDecoderSession::setEndOfStream()
+{
+    QMutexLocker locker(&m_buffersMutex);
+    m_endOfStream = true;
+    m_bufferCondition.wakeAll();
+}
+
 GstFlowReturn QGstreamerAudioDecoderSession::new_sample(GstAppSink *, gpointer user_data)
 {
     // "Note that the preroll buffer will also be returned as the first buffer when calling gst_app_sink_pull_buffer()."
@@ -520,15 +724,26 @@ GstFlowReturn QGstreamerAudioDecoderSession::new_sample(GstAppSink *, gpointer u
         QMutexLocker locker(&session->m_buffersMutex);
         buffersAvailable = session->m_buffersAvailable;
         session->m_buffersAvailable++;
-        Q_ASSERT(session->m_buffersAvailable <= MAX_BUFFERS_IN_QUEUE);
+        Q_ASSERT(session->m_buffersAvailable <= session->m_appSinkQueueDepth);
+        session->m_bufferCondition.wakeAll();
     }
 
+    // In synchronous mode buffers are only handed out through read(int, int)
+    if (session->m_synchronous)
+        return GST_FLOW_OK;
+
     if (!buffersAvailable)
         QMetaObject::invokeMethod(session, "bufferAvailableChanged", Qt::QueuedConnection, Q_ARG(bool, true));
     QMetaObject::invokeMethod(session, "bufferReady", Qt::QueuedConnection);
     return GST_FLOW_OK;
 }
 
+void QGstreamerAudioDecoderSession::end_of_stream(GstAppSink *, gpointer user_data)
+{
+    QGstreamerAudioDecoderSession *session = reinterpret_cast<QGstreamerAudioDecoderSession*>(user_data);
+    session->setEndOfStream();
+}
+
 void QGstreamerAudioDecoderSession::setAudioFlags(bool wantNativeAudio)
 {
     int flags = 0;
@@ -558,8 +773,8 @@ void QGstreamerAudioDecoderSession::addAppSink()
 #else
     callbacks.new_buffer = &new_sample;
 #endif
+    callbacks.eos = &end_of_stream;
     gst_app_sink_set_callbacks(m_appSink, &callbacks, this, NULL);
-    gst_app_sink_set_max_buffers(m_appSink, MAX_BUFFERS_IN_QUEUE);
     gst_base_sink_set_sync(GST_BASE_SINK(m_appSink), FALSE);
 
     gst_bin_add(GST_BIN(m_outputBin), GST_ELEMENT(m_appSink));
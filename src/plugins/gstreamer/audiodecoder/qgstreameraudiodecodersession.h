@@ -43,6 +43,8 @@
 #include <QtMultimedia/private/qtmultimediaglobal_p.h>
 #include <QObject>
 #include <QtCore/qmutex.h>
+#include <QtCore/qwaitcondition.h>
+#include <QtCore/qdeadlinetimer.h>
 #include "qgstreameraudiodecodercontrol.h"
 #include <private/qgstreamerbushelper_p.h>
 #include "qaudiodecoder.h"
@@ -60,10 +62,11 @@ class QGstreamerBusHelper;
 class QGstreamerMessage;
 
 class QGstreamerAudioDecoderSession : public QObject,
-                                public QGstreamerBusMessageFilter
+                                public QGstreamerBusMessageFilter,
+                                public QGstreamerSyncMessageFilter
 {
 Q_OBJECT
-Q_INTERFACES(QGstreamerBusMessageFilter)
+Q_INTERFACES(QGstreamerBusMessageFilter QGstreamerSyncMessageFilter)
 
 public:
     QGstreamerAudioDecoderSession(QObject *parent);
@@ -75,6 +78,7 @@ public:
     QAudioDecoder::State pendingState() const { return m_pendingState; }
 
     bool processBusMessage(const QGstreamerMessage &message) override;
+    bool processSyncMessage(const QGstreamerMessage &message) override;
 
 #if QT_CONFIG(gstreamer_app)
     QGstAppSrc *appsrc() const { return m_appSrc; }
@@ -94,12 +98,22 @@ public:
     void setAudioFormat(const QAudioFormat &format);
 
     QAudioBuffer read();
+    QAudioBuffer read(int maxFrames, int msecs);
     bool bufferAvailable() const;
+    bool atEnd() const;
+    QAudioDecoder::Error streamError() const;
+
+    int bufferQueueDepth() const { return m_queueDepth; }
+    void setBufferQueueDepth(int depth);
+
+    bool isSynchronous() const { return m_synchronous; }
+    void setSynchronous(bool synchronous);
 
     qint64 position() const;
     qint64 duration() const;
 
     static GstFlowReturn new_sample(GstAppSink *sink, gpointer user_data);
+    static void end_of_stream(GstAppSink *sink, gpointer user_data);
 
 signals:
     void stateChanged(QAudioDecoder::State newState);
@@ -120,11 +134,16 @@ private slots:
 
 private:
     void setAudioFlags(bool wantNativeAudio);
+    void reset(GstState state);
     void addAppSink();
     void removeAppSink();
 
     void processInvalidMedia(QAudioDecoder::Error errorCode, const QString& errorString);
+    void setEndOfStream();
+    bool setPosition(qint64 position);
+    QAudioBuffer pullBuffer(const QDeadlineTimer &deadline, bool *drained);
     static qint64 getPositionFromBuffer(GstBuffer* buffer);
+    static QAudioDecoder::Error errorForGError(const GError *err);
 
     QAudioDecoder::State m_state;
     QAudioDecoder::State m_pendingState;
@@ -143,10 +162,23 @@ private:
     QIODevice *mDevice; // QWeakPointer perhaps
     QAudioFormat mFormat;
 
+    // Guards the buffer count and end of stream state, taken after
+    // m_pullMutex when both are needed
     mutable QMutex m_buffersMutex;
+    QWaitCondition m_bufferCondition;
     int m_buffersAvailable;
+    int m_appSinkQueueDepth;
+    bool m_endOfStream;
+    QAudioDecoder::Error m_streamError;
+
+    // Serializes readers and keeps the appsink alive while they pull from it
+    mutable QMutex m_pullMutex;
+    QAudioBuffer m_pendingBuffer;
+
+    int m_queueDepth;
+    bool m_synchronous;
 
-    qint64 m_position;
+    qint64 m_position; // guarded by m_buffersMutex
     qint64 m_duration;
 
     int m_durationQueries;
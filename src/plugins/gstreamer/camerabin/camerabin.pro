@@ -14,6 +14,7 @@ HEADERS += \
     $$PWD/camerabinserviceplugin.h \
     $$PWD/camerabinservice.h \
     $$PWD/camerabinsession.h \
+    $$PWD/camerabincapabilities.h \
     $$PWD/camerabincontrol.h \
     $$PWD/camerabinaudioencoder.h \
     $$PWD/camerabinimageencoder.h \
@@ -35,6 +36,7 @@ SOURCES += \
     $$PWD/camerabinserviceplugin.cpp \
     $$PWD/camerabinservice.cpp \
     $$PWD/camerabinsession.cpp \
+    $$PWD/camerabincapabilities.cpp \
     $$PWD/camerabincontrol.cpp \
     $$PWD/camerabinaudioencoder.cpp \
     $$PWD/camerabincontainer.cpp \
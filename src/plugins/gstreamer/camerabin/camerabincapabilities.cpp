@@ -0,0 +1,124 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "camerabincapabilities.h"
+
+QT_BEGIN_NAMESPACE
+
+CameraBinCapabilities::CameraBinCapabilities()
+    : m_hasViewfinderSettings(false)
+{
+}
+
+void CameraBinCapabilities::clear()
+{
+    m_hasViewfinderSettings = false;
+    m_viewfinderSettings.clear();
+    m_viewfinderSettingsByResolution.clear();
+    m_frameRates.clear();
+    m_resolutions.clear();
+}
+
+QList<QCameraViewfinderSettings> CameraBinCapabilities::viewfinderSettings(const QSize &resolution) const
+{
+    QList<QCameraViewfinderSettings> settings;
+
+    const QVector<int> indices = m_viewfinderSettingsByResolution.value(sizeKey(resolution));
+    settings.reserve(indices.size());
+    for (int index : indices)
+        settings.append(m_viewfinderSettings.at(index));
+
+    return settings;
+}
+
+void CameraBinCapabilities::setViewfinderSettings(const QList<QCameraViewfinderSettings> &settings)
+{
+    m_hasViewfinderSettings = true;
+    m_viewfinderSettings = settings;
+
+    m_viewfinderSettingsByResolution.clear();
+    for (int i = 0; i < settings.size(); ++i)
+        m_viewfinderSettingsByResolution[sizeKey(settings.at(i).resolution())].append(i);
+}
+
+bool CameraBinCapabilities::frameRates(const QSize &frameSize,
+                                       QList<FrameRate> *rates,
+                                       bool *continuous) const
+{
+    const auto it = m_frameRates.constFind(sizeKey(frameSize));
+    if (it == m_frameRates.constEnd())
+        return false;
+
+    *rates = it->values;
+    if (continuous)
+        *continuous = it->continuous;
+    return true;
+}
+
+void CameraBinCapabilities::setFrameRates(const QSize &frameSize,
+                                          const QList<FrameRate> &rates,
+                                          bool continuous)
+{
+    m_frameRates.insert(sizeKey(frameSize), { rates, continuous });
+}
+
+bool CameraBinCapabilities::resolutions(FrameRate rate,
+                                        QCamera::CaptureModes mode,
+                                        QList<QSize> *sizes,
+                                        bool *continuous) const
+{
+    const auto it = m_resolutions.constFind(ResolutionsKey(rate, int(mode)));
+    if (it == m_resolutions.constEnd())
+        return false;
+
+    *sizes = it->values;
+    if (continuous)
+        *continuous = it->continuous;
+    return true;
+}
+
+void CameraBinCapabilities::setResolutions(FrameRate rate,
+                                           QCamera::CaptureModes mode,
+                                           const QList<QSize> &sizes,
+                                           bool continuous)
+{
+    m_resolutions.insert(ResolutionsKey(rate, int(mode)), { sizes, continuous });
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef CAMERABINCAPABILITIES_H
+#define CAMERABINCAPABILITIES_H
+
+#include <qcamera.h>
+#include <qcameraviewfindersettings.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qsize.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+// What the camera source of a session can produce.
+//
+// Building the capabilities requires a caps query on the live source and
+// walking the result, so they are computed once per source and every query
+// after that is a hash lookup. The session clears them when the source is
+// rebuilt for another device.
+class CameraBinCapabilities
+{
+public:
+    typedef QPair<int,int> FrameRate;
+
+    CameraBinCapabilities();
+
+    void clear();
+
+    bool hasViewfinderSettings() const { return m_hasViewfinderSettings; }
+    QList<QCameraViewfinderSettings> viewfinderSettings() const { return m_viewfinderSettings; }
+    QList<QCameraViewfinderSettings> viewfinderSettings(const QSize &resolution) const;
+    void setViewfinderSettings(const QList<QCameraViewfinderSettings> &settings);
+
+    bool frameRates(const QSize &frameSize, QList<FrameRate> *rates, bool *continuous) const;
+    void setFrameRates(const QSize &frameSize, const QList<FrameRate> &rates, bool continuous);
+
+    bool resolutions(FrameRate rate, QCamera::CaptureModes mode,
+                     QList<QSize> *sizes, bool *continuous) const;
+    void setResolutions(FrameRate rate, QCamera::CaptureModes mode,
+                        const QList<QSize> &sizes, bool continuous);
+
+private:
+    template <typename T>
+    struct Entry
+    {
+        T values;
+        bool continuous;
+    };
+
+    typedef QPair<FrameRate, int> ResolutionsKey;
+
+    static quint64 sizeKey(const QSize &size)
+    {
+        return (quint64(quint32(size.width())) << 32) | quint32(size.height());
+    }
+
+    bool m_hasViewfinderSettings;
+    QList<QCameraViewfinderSettings> m_viewfinderSettings;
+    QHash<quint64, QVector<int> > m_viewfinderSettingsByResolution;
+
+    QHash<quint64, Entry<QList<FrameRate> > > m_frameRates;
+    QHash<ResolutionsKey, Entry<QList<QSize> > > m_resolutions;
+};
+
+QT_END_NAMESPACE
+
+#endif // CAMERABINCAPABILITIES_H
@@ -365,18 +365,17 @@ void CameraBinSession::setupCaptureResolution()
                 Both = 0x4
             };
             quint8 found = Nothing;
-            auto viewfinderSettings = supportedViewfinderSettings();
+            supportedViewfinderSettings();
+            const auto viewfinderSettings = m_capabilities.viewfinderSettings(viewfinderResolution);
             for (int i = 0; i < viewfinderSettings.count() && !(found & Both); ++i) {
                 const QCameraViewfinderSettings &s = viewfinderSettings.at(i);
-                if (s.resolution() == viewfinderResolution) {
-                    if ((qFuzzyIsNull(viewfinderFrameRate) || s.maximumFrameRate() == viewfinderFrameRate)
-                            && (viewfinderPixelFormat == QVideoFrame::Format_Invalid || s.pixelFormat() == viewfinderPixelFormat))
-                        found |= Both;
-                    else if (s.maximumFrameRate() == viewfinderFrameRate)
-                        found |= OnlyFrameRate;
-                    else if (s.pixelFormat() == viewfinderPixelFormat)
-                        found |= OnlyPixelFormat;
-                }
+                if ((qFuzzyIsNull(viewfinderFrameRate) || s.maximumFrameRate() == viewfinderFrameRate)
+                        && (viewfinderPixelFormat == QVideoFrame::Format_Invalid || s.pixelFormat() == viewfinderPixelFormat))
+                    found |= Both;
+                else if (s.maximumFrameRate() == viewfinderFrameRate)
+                    found |= OnlyFrameRate;
+                else if (s.pixelFormat() == viewfinderPixelFormat)
+                    found |= OnlyPixelFormat;
             }
 
             if (found & Both) {
@@ -478,6 +477,7 @@ GstElement *CameraBinSession::buildCameraSource()
 
     m_inputDeviceHasChanged = false;
     m_usingWrapperCameraBinSrc = false;
+    m_capabilities.clear();
 
     GstElement *camSrc = 0;
     g_object_get(G_OBJECT(m_camerabin), CAMERA_SOURCE_PROPERTY, &camSrc, NULL);
@@ -734,12 +734,19 @@ static QList<QCameraViewfinderSettings> capsToViewfinderSettings(GstCaps *suppor
 
 QList<QCameraViewfinderSettings> CameraBinSession::supportedViewfinderSettings() const
 {
-    if (m_status >= QCamera::LoadedStatus && m_supportedViewfinderSettings.isEmpty()) {
-        m_supportedViewfinderSettings =
+    // The source only reports what the device supports once it is loaded
+    if (m_capabilities.hasViewfinderSettings() || m_status < QCamera::LoadedStatus)
+        return m_capabilities.viewfinderSettings();
+
+    const QList<QCameraViewfinderSettings> settings =
             capsToViewfinderSettings(supportedCaps(QCamera::CaptureViewfinder));
-    }
 
-    return m_supportedViewfinderSettings;
+    // An empty answer means the source could not be queried yet; don't keep
+    // it, so that the next call asks again.
+    if (!settings.isEmpty())
+        m_capabilities.setViewfinderSettings(settings);
+
+    return settings;
 }
 
 QCameraViewfinderSettings CameraBinSession::viewfinderSettings() const
@@ -885,8 +892,6 @@ void CameraBinSession::unload()
     if (m_busy)
         emit busyChanged(m_busy = false);
 
-    m_supportedViewfinderSettings.clear();
-
     setStatus(QCamera::UnloadedStatus);
 }
 
@@ -1136,9 +1141,6 @@ bool CameraBinSession::processBusMessage(const QGstreamerMessage &message)
                         setStatus(QCamera::UnloadedStatus);
                         break;
                     case GST_STATE_READY:
-                        if (oldState == GST_STATE_NULL)
-                            m_supportedViewfinderSettings.clear();
-
                         setMetaData(m_metaData);
                         setStatus(QCamera::LoadedStatus);
                         break;
@@ -1286,6 +1288,13 @@ GstCaps *CameraBinSession::supportedCaps(QCamera::CaptureModes mode) const
 QList< QPair<int,int> > CameraBinSession::supportedFrameRates(const QSize &frameSize, bool *continuous) const
 {
     QList< QPair<int,int> > res;
+    bool isContinuous = false;
+
+    if (m_capabilities.frameRates(frameSize, &res, &isContinuous)) {
+        if (continuous)
+            *continuous = isContinuous;
+        return res;
+    }
 
     GstCaps *supportedCaps = this->supportedCaps(QCamera::CaptureVideo);
 
@@ -1340,7 +1349,7 @@ QList< QPair<int,int> > CameraBinSession::supportedFrameRates(const QSize &frame
         if (!rateValue)
             continue;
 
-        readValue(rateValue, &res, continuous);
+        readValue(rateValue, &res, &isContinuous);
     }
 
     std::sort(res.begin(), res.end(), rateLessThan);
@@ -1352,6 +1361,12 @@ QList< QPair<int,int> > CameraBinSession::supportedFrameRates(const QSize &frame
 
     gst_caps_unref(caps);
 
+    if (m_status >= QCamera::LoadedStatus && !res.isEmpty())
+        m_capabilities.setFrameRates(frameSize, res, isContinuous);
+
+    if (continuous)
+        *continuous = isContinuous;
+
     return res;
 }
 
@@ -1399,6 +1414,9 @@ QList<QSize> CameraBinSession::supportedResolutions(QPair<int,int> rate,
     if (continuous)
         *continuous = false;
 
+    if (m_capabilities.resolutions(rate, mode, &res, continuous))
+        return res;
+
     GstCaps *supportedCaps = this->supportedCaps(mode);
 
 #if CAMERABIN_DEBUG
@@ -1531,6 +1549,9 @@ QList<QSize> CameraBinSession::supportedResolutions(QPair<int,int> rate,
 
     gst_caps_unref(caps);
 
+    if (m_status >= QCamera::LoadedStatus && !res.isEmpty())
+        m_capabilities.setResolutions(rate, mode, res, isContinuous);
+
     if (continuous)
         *continuous = isContinuous;
 
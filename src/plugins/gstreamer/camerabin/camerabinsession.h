@@ -55,6 +55,7 @@
 #include <private/qgstreamervideoprobecontrol_p.h>
 #include <private/qmediastoragelocation_p.h>
 #include "qcamera.h"
+#include "camerabincapabilities.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -228,7 +229,7 @@ private:
     QGstreamerElementFactory *m_videoInputFactory;
     QObject *m_viewfinder;
     QGstreamerVideoRendererInterface *m_viewfinderInterface;
-    mutable QList<QCameraViewfinderSettings> m_supportedViewfinderSettings;
+    mutable CameraBinCapabilities m_capabilities;
     QCameraViewfinderSettings m_viewfinderSettings;
     QCameraViewfinderSettings m_actualViewfinderSettings;
 
@@ -44,6 +44,8 @@
 #include "qgstreameraudioencode.h"
 #include "qgstreamervideoencode.h"
 #include "qgstreamerimageencode.h"
+#include "qgstreamerprerollcontrol.h"
+#include "qgstreamersegmentcontrol.h"
 #include "qgstreamercameracontrol.h"
 #include <private/qgstreamerbushelper_p.h>
 #include "qgstreamercapturemetadatacontrol.h"
@@ -171,6 +173,12 @@ QMediaControl *QGstreamerCaptureService::requestControl(const char *name)
     if (qstrcmp(name,QMediaContainerControl_iid) == 0)
         return m_captureSession->mediaContainerControl();
 
+    if (qstrcmp(name,QMediaRecorderPreRollControl_iid) == 0)
+        return m_captureSession->preRollControl();
+
+    if (qstrcmp(name,QMediaRecorderSegmentControl_iid) == 0)
+        return m_captureSession->segmentControl();
+
     if (qstrcmp(name,QCameraControl_iid) == 0)
         return m_cameraControl;
 
@@ -43,6 +43,8 @@
 #include "qgstreameraudioencode.h"
 #include "qgstreamervideoencode.h"
 #include "qgstreamerimageencode.h"
+#include "qgstreamerprerollcontrol.h"
+#include "qgstreamersegmentcontrol.h"
 #include <qmediarecorder.h>
 #include <private/qgstreamervideorendererinterface_p.h>
 #include <private/qgstreameraudioprobecontrol_p.h>
@@ -89,6 +91,11 @@ QGstreamerCaptureSession::QGstreamerCaptureSession(QGstreamerCaptureSession::Cap
      m_videoPreview(0),
      m_imageCaptureBin(0),
      m_encodeBin(0),
+     m_muxBin(0),
+     m_preRollDuration(0),
+     m_maximumPreRollSize(64 * 1024 * 1024),
+     m_maximumSegmentDuration(0),
+     m_maximumSegmentSize(0),
      m_passImage(false),
      m_passPrerollImage(false)
 {
@@ -107,6 +114,8 @@ QGstreamerCaptureSession::QGstreamerCaptureSession(QGstreamerCaptureSession::Cap
         qWarning() << QMediaRecorder::Error(e) << ":" << str.toLatin1().constData();
     });
     m_mediaContainerControl = new QGstreamerMediaContainerControl(this);
+    m_preRollControl = new QGstreamerPreRollControl(this);
+    m_segmentControl = new QGstreamerSegmentControl(this);
 }
 
 QGstreamerCaptureSession::~QGstreamerCaptureSession()
@@ -122,26 +131,85 @@ void QGstreamerCaptureSession::setCaptureMode(CaptureMode mode)
     m_captureMode = mode;
 }
 
-GstElement *QGstreamerCaptureSession::buildEncodeBin()
+GstElement *QGstreamerCaptureSession::buildMuxer(GstBin *bin)
 {
-    GstElement *encodeBin = gst_bin_new("encode-bin");
-
     GstElement *muxer = gst_element_factory_make( m_mediaContainerControl->formatElementName().constData(), "muxer");
     if (!muxer) {
         qWarning() << "Could not create a media muxer element:" << m_mediaContainerControl->formatElementName();
-        gst_object_unref(encodeBin);
         return 0;
     }
 
     // Output location was rejected in setOutputlocation() if not a local file
     QUrl actualSink = QUrl::fromLocalFile(QDir::currentPath()).resolved(m_sink);
+
+#if GST_CHECK_VERSION(1,0,0)
+    if (isSegmented()) {
+        // splitmuxsink starts new files on key frames without dropping
+        // any data and takes ownership of the muxer.
+        if (GstElement *splitMuxSink = gst_element_factory_make("splitmuxsink", "splitmuxsink")) {
+            g_object_set(G_OBJECT(splitMuxSink),
+                         "muxer", muxer,
+                         "location", QGstreamerSegmentControl::locationPattern(actualSink.toLocalFile()).constData(),
+                         "max-size-time", guint64(m_maximumSegmentDuration) * GST_MSECOND,
+                         "max-size-bytes", guint64(m_maximumSegmentSize),
+                         NULL);
+            gst_bin_add(bin, splitMuxSink);
+            return splitMuxSink;
+        }
+        qWarning() << "Could not create a splitmuxsink element, recording to a single file";
+    }
+#endif
+
     GstElement *fileSink = gst_element_factory_make("filesink", "filesink");
     g_object_set(G_OBJECT(fileSink), "location", QFile::encodeName(actualSink.toLocalFile()).constData(), NULL);
-    gst_bin_add_many(GST_BIN(encodeBin), muxer, fileSink,  NULL);
+    gst_bin_add_many(bin, muxer, fileSink,  NULL);
 
-    if (!gst_element_link(muxer, fileSink)) {
-        gst_object_unref(encodeBin);
+    if (!gst_element_link(muxer, fileSink))
         return 0;
+
+    return muxer;
+}
+
+GstPad *QGstreamerCaptureSession::requestMuxerPad(GstElement *muxer, GstPad *srcPad, bool video)
+{
+    // splitmuxsink accepts any caps on its pads, so the stream type has to be
+    // chosen explicitly; video is used to decide where to split.
+    if (qstrcmp(GST_OBJECT_NAME(muxer), "splitmuxsink") == 0)
+        return gst_element_get_request_pad(muxer, video ? "video" : "audio_%u");
+
+    return gst_element_get_compatible_pad(muxer, srcPad, NULL);
+}
+
+bool QGstreamerCaptureSession::linkToMuxer(GstElement *encoder, GstElement *muxer, bool video)
+{
+    GstPad *srcPad = gst_element_get_static_pad(encoder, "src");
+    if (!srcPad)
+        return false;
+
+    GstPad *sinkPad = requestMuxerPad(muxer, srcPad, video);
+    const bool ok = sinkPad && gst_pad_link(srcPad, sinkPad) == GST_PAD_LINK_OK;
+
+    if (sinkPad)
+        gst_object_unref(GST_OBJECT(sinkPad));
+    gst_object_unref(GST_OBJECT(srcPad));
+
+    return ok;
+}
+
+GstElement *QGstreamerCaptureSession::buildEncodeBin()
+{
+    GstElement *encodeBin = gst_bin_new("encode-bin");
+
+    // In pre-roll mode the muxer is only attached once recording starts,
+    // the encoded streams are exposed on src pads until then.
+    const bool preRoll = isPreRollEnabled();
+    GstElement *muxer = 0;
+    if (!preRoll) {
+        muxer = buildMuxer(GST_BIN(encodeBin));
+        if (!muxer) {
+            gst_object_unref(encodeBin);
+            return 0;
+        }
     }
 
     if (m_captureMode & Audio) {
@@ -159,7 +227,8 @@ GstElement *QGstreamerCaptureSession::buildEncodeBin()
 
         gst_bin_add(GST_BIN(encodeBin), audioEncoder);
 
-        if (!gst_element_link_many(audioConvert, audioQueue, m_audioVolume, audioEncoder, muxer, NULL)) {
+        if (!gst_element_link_many(audioConvert, audioQueue, m_audioVolume, audioEncoder, NULL)
+                || (muxer && !linkToMuxer(audioEncoder, muxer, false))) {
             m_audioVolume = 0;
             gst_object_unref(encodeBin);
             return 0;
@@ -172,6 +241,15 @@ GstElement *QGstreamerCaptureSession::buildEncodeBin()
         GstPad *pad = gst_element_get_static_pad(audioConvert, "sink");
         gst_element_add_pad(GST_ELEMENT(encodeBin), gst_ghost_pad_new("audiosink", pad));
         gst_object_unref(GST_OBJECT(pad));
+
+        if (preRoll) {
+            pad = gst_element_get_static_pad(audioEncoder, "src");
+            GstPad *ghostPad = gst_ghost_pad_new("audiosrc", pad);
+            gst_element_add_pad(GST_ELEMENT(encodeBin), ghostPad);
+            gst_object_unref(GST_OBJECT(pad));
+
+            m_audioPreRoll.addProbeToPad(ghostPad);
+        }
     }
 
     if (m_captureMode & Video) {
@@ -189,7 +267,8 @@ GstElement *QGstreamerCaptureSession::buildEncodeBin()
 
         gst_bin_add(GST_BIN(encodeBin), videoEncoder);
 
-        if (!gst_element_link_many(videoQueue, colorspace, videoscale, videoEncoder, muxer, NULL)) {
+        if (!gst_element_link_many(videoQueue, colorspace, videoscale, videoEncoder, NULL)
+                || (muxer && !linkToMuxer(videoEncoder, muxer, true))) {
             gst_object_unref(encodeBin);
             return 0;
         }
@@ -198,11 +277,58 @@ GstElement *QGstreamerCaptureSession::buildEncodeBin()
         GstPad *pad = gst_element_get_static_pad(videoQueue, "sink");
         gst_element_add_pad(GST_ELEMENT(encodeBin), gst_ghost_pad_new("videosink", pad));
         gst_object_unref(GST_OBJECT(pad));
+
+        if (preRoll) {
+            pad = gst_element_get_static_pad(videoEncoder, "src");
+            GstPad *ghostPad = gst_ghost_pad_new("videosrc", pad);
+            gst_element_add_pad(GST_ELEMENT(encodeBin), ghostPad);
+            gst_object_unref(GST_OBJECT(pad));
+
+            m_videoPreRoll.addProbeToPad(ghostPad);
+        }
     }
 
+    if (preRoll)
+        updatePreRollLimits();
+
     return encodeBin;
 }
 
+GstElement *QGstreamerCaptureSession::buildMuxBin()
+{
+    GstElement *muxBin = gst_bin_new("mux-bin");
+
+    GstElement *muxer = buildMuxer(GST_BIN(muxBin));
+    if (!muxer) {
+        gst_object_unref(muxBin);
+        return 0;
+    }
+
+    static const struct {
+        const char *srcPad;
+        const char *sinkPad;
+        bool video;
+    } streams[] = { { "audiosrc", "audiosink", false }, { "videosrc", "videosink", true } };
+
+    for (const auto &stream : streams) {
+        GstPad *srcPad = gst_element_get_static_pad(m_encodeBin, stream.srcPad);
+        if (!srcPad)
+            continue;
+
+        GstPad *muxerPad = requestMuxerPad(muxer, srcPad, stream.video);
+        gst_object_unref(GST_OBJECT(srcPad));
+        if (!muxerPad) {
+            gst_object_unref(muxBin);
+            return 0;
+        }
+
+        gst_element_add_pad(muxBin, gst_ghost_pad_new(stream.sinkPad, muxerPad));
+        gst_object_unref(GST_OBJECT(muxerPad));
+    }
+
+    return muxBin;
+}
+
 GstElement *QGstreamerCaptureSession::buildAudioSrc()
 {
     GstElement *audioSrc = 0;
@@ -493,6 +619,8 @@ bool QGstreamerCaptureSession::rebuildGraph(QGstreamerCaptureSession::PipelineMo
     REMOVE_ELEMENT(m_videoPreview);
     REMOVE_ELEMENT(m_videoPreviewQueue);
     REMOVE_ELEMENT(m_videoTee);
+    removePreRollProbes();
+    REMOVE_ELEMENT(m_muxBin);
     REMOVE_ELEMENT(m_encodeBin);
     REMOVE_ELEMENT(m_imageCaptureBin);
     m_audioVolume = 0;
@@ -568,6 +696,7 @@ bool QGstreamerCaptureSession::rebuildGraph(QGstreamerCaptureSession::PipelineMo
                 setMetaData(m_metaData);
 
             break;
+        case PreviewAndPreRollPipeline:
         case PreviewAndRecordingPipeline:
             m_encodeBin = buildEncodeBin();
             if (m_encodeBin)
@@ -656,12 +785,81 @@ bool QGstreamerCaptureSession::rebuildGraph(QGstreamerCaptureSession::PipelineMo
         REMOVE_ELEMENT(m_videoPreview);
         REMOVE_ELEMENT(m_videoPreviewQueue);
         REMOVE_ELEMENT(m_videoTee);
+        removePreRollProbes();
         REMOVE_ELEMENT(m_encodeBin);
     }
 
     return ok;
 }
 
+bool QGstreamerCaptureSession::startPreRollRecording()
+{
+    m_muxBin = buildMuxBin();
+    if (!m_muxBin)
+        return false;
+
+    gst_bin_add(GST_BIN(m_pipeline), m_muxBin);
+
+    bool ok = true;
+    if (m_captureMode & Audio)
+        ok &= gst_element_link_pads(m_encodeBin, "audiosrc", m_muxBin, "audiosink");
+    if (m_captureMode & Video)
+        ok &= gst_element_link_pads(m_encodeBin, "videosrc", m_muxBin, "videosink");
+
+    if (!ok) {
+        REMOVE_ELEMENT(m_muxBin);
+        return false;
+    }
+
+    if (!m_metaData.isEmpty())
+        setMetaData(m_metaData);
+
+    gst_element_sync_state_with_parent(m_muxBin);
+
+    // Start all streams at the latest buffered key frame, so audio and video
+    // stay in sync, and shift the timestamps for the recording to start at 0.
+    GstClockTime startTime = GST_CLOCK_TIME_NONE;
+    for (const QGstreamerPreRollBuffer *preRoll : { &m_audioPreRoll, &m_videoPreRoll }) {
+        const GstClockTime time = preRoll->startTime();
+        if (GST_CLOCK_TIME_IS_VALID(time) && (!GST_CLOCK_TIME_IS_VALID(startTime) || time > startTime))
+            startTime = time;
+    }
+
+    if (!GST_CLOCK_TIME_IS_VALID(startTime)) {
+        startTime = 0;
+        if (GstClock *clock = gst_element_get_clock(m_pipeline)) {
+            startTime = gst_clock_get_time(clock) - gst_element_get_base_time(m_pipeline);
+            gst_object_unref(GST_OBJECT(clock));
+        }
+    }
+
+    static const char * const srcPads[] = { "audiosrc", "videosrc" };
+    for (const char *name : srcPads) {
+        if (GstPad *pad = gst_element_get_static_pad(m_encodeBin, name)) {
+            gst_pad_set_offset(pad, -gint64(startTime));
+            gst_object_unref(GST_OBJECT(pad));
+        }
+    }
+
+    m_audioPreRoll.release(startTime);
+    m_videoPreRoll.release(startTime);
+
+    return true;
+}
+
+void QGstreamerCaptureSession::removePreRollProbes()
+{
+    m_audioPreRoll.removeProbe();
+    m_videoPreRoll.removeProbe();
+}
+
+void QGstreamerCaptureSession::updatePreRollLimits()
+{
+    const GstClockTime duration = m_preRollDuration * GST_MSECOND;
+    m_audioPreRoll.setLimits(duration, m_maximumPreRollSize);
+    m_videoPreRoll.setLimits(duration, m_maximumPreRollSize);
+}
+
 void QGstreamerCaptureSession::dumpGraph(const QString &fileName)
 {
 #ifdef QT_GST_CAPTURE_DEBUG
@@ -758,11 +956,6 @@ QGstreamerCaptureSession::State QGstreamerCaptureSession::pendingState() const
 
 void QGstreamerCaptureSession::setState(QGstreamerCaptureSession::State newState)
 {
-    if (newState == m_pendingState && !m_waitingForEos)
-        return;
-
-    m_pendingState = newState;
-
     PipelineMode newMode = EmptyPipeline;
 
     switch (newState) {
@@ -771,13 +964,37 @@ void QGstreamerCaptureSession::setState(QGstreamerCaptureSession::State newState
             newMode = PreviewAndRecordingPipeline;
             break;
         case PreviewState:
-            newMode = PreviewPipeline;
+            newMode = isPreRollEnabled() ? PreviewAndPreRollPipeline : PreviewPipeline;
             break;
         case StoppedState:
             newMode = EmptyPipeline;
             break;
     }
 
+    if (newState == m_pendingState && !m_waitingForEos && newMode == m_pipelineMode)
+        return;
+
+    m_pendingState = newState;
+
+    if (m_pipelineMode == PreviewAndPreRollPipeline && newMode == PreviewAndRecordingPipeline) {
+        // The encoders are already running, only the muxer has to be
+        // attached and fed with the pre-roll data.
+        if (!startPreRollRecording()) {
+            emit error(int(QMediaRecorder::FormatError), tr("Failed to build media capture pipeline."));
+            setState(PreviewState);
+            return;
+        }
+
+        m_pipelineMode = PreviewAndRecordingPipeline;
+
+        // The pipeline is already playing, so no state change is reported on the bus.
+        if (newState == RecordingState) {
+            m_state = RecordingState;
+            emit stateChanged(m_state);
+            return;
+        }
+    }
+
     if (newMode != m_pipelineMode) {
         if (m_pipelineMode == PreviewAndRecordingPipeline) {
             if (!m_waitingForEos) {
@@ -833,12 +1050,100 @@ void QGstreamerCaptureSession::setState(QGstreamerCaptureSession::State newState
 qint64 QGstreamerCaptureSession::duration() const
 {
     gint64 duration = 0;
-    if (m_encodeBin && qt_gst_element_query_position(m_encodeBin, GST_FORMAT_TIME, &duration))
+    GstElement *sinkBin = m_muxBin ? m_muxBin : m_encodeBin;
+    if (sinkBin && qt_gst_element_query_position(sinkBin, GST_FORMAT_TIME, &duration))
         return duration / 1000000;
     else
         return 0;
 }
 
+void QGstreamerCaptureSession::setPreRollDuration(qint64 msecs)
+{
+    msecs = qMax<qint64>(0, msecs);
+    if (m_preRollDuration == msecs)
+        return;
+
+    const bool wasEnabled = isPreRollEnabled();
+    m_preRollDuration = msecs;
+    updatePreRollLimits();
+
+    emit preRollDurationChanged(m_preRollDuration);
+
+    if (wasEnabled == isPreRollEnabled())
+        return;
+
+    if (m_captureMode == Audio) {
+        // Without a preview the capture pipeline only runs while recording,
+        // pre-roll needs it running all the time.
+        if (isPreRollEnabled() && m_pendingState == StoppedState)
+            setState(PreviewState);
+        else if (!isPreRollEnabled() && m_pendingState == PreviewState)
+            setState(StoppedState);
+    } else if (m_pendingState == PreviewState) {
+        setState(PreviewState);
+    }
+}
+
+void QGstreamerCaptureSession::setMaximumPreRollSize(qint64 bytes)
+{
+    bytes = qMax<qint64>(0, bytes);
+    if (m_maximumPreRollSize == bytes)
+        return;
+
+    m_maximumPreRollSize = bytes;
+    updatePreRollLimits();
+
+    emit maximumPreRollSizeChanged(m_maximumPreRollSize);
+}
+
+void QGstreamerCaptureSession::setMaximumSegmentDuration(qint64 msecs)
+{
+    msecs = qMax<qint64>(0, msecs);
+    if (m_maximumSegmentDuration == msecs)
+        return;
+
+    m_maximumSegmentDuration = msecs;
+    emit maximumSegmentDurationChanged(m_maximumSegmentDuration);
+}
+
+void QGstreamerCaptureSession::setMaximumSegmentSize(qint64 bytes)
+{
+    bytes = qMax<qint64>(0, bytes);
+    if (m_maximumSegmentSize == bytes)
+        return;
+
+    m_maximumSegmentSize = bytes;
+    emit maximumSegmentSizeChanged(m_maximumSegmentSize);
+}
+
+bool QGstreamerCaptureSession::isPreRollEnabled() const
+{
+#if GST_CHECK_VERSION(1,0,0)
+    return m_preRollDuration > 0;
+#else
+    return false;
+#endif
+}
+
+bool QGstreamerCaptureSession::isSegmented() const
+{
+#if GST_CHECK_VERSION(1,0,0)
+    return m_maximumSegmentDuration > 0 || m_maximumSegmentSize > 0;
+#else
+    return false;
+#endif
+}
+
+qint64 QGstreamerCaptureSession::preRollBufferedDuration() const
+{
+    return qMax(m_audioPreRoll.duration(), m_videoPreRoll.duration()) / GST_MSECOND;
+}
+
+qint64 QGstreamerCaptureSession::preRollBufferedSize() const
+{
+    return m_audioPreRoll.size() + m_videoPreRoll.size();
+}
+
 void QGstreamerCaptureSession::setCaptureDevice(const QString &deviceName)
 {
     m_captureDevice = deviceName;
@@ -851,6 +1156,8 @@ void QGstreamerCaptureSession::setMetaData(const QMap<QByteArray, QVariant> &dat
 
     if (m_encodeBin)
         QGstUtils::setMetaData(GST_BIN(m_encodeBin), data);
+    if (m_muxBin)
+        QGstUtils::setMetaData(GST_BIN(m_muxBin), data);
 }
 
 bool QGstreamerCaptureSession::processBusMessage(const QGstreamerMessage &message)
@@ -867,6 +1174,16 @@ bool QGstreamerCaptureSession::processBusMessage(const QGstreamerMessage &messag
             g_free (debug);
         }
 
+#if GST_CHECK_VERSION(1,0,0)
+        if (GST_MESSAGE_TYPE(gm) == GST_MESSAGE_ELEMENT) {
+            const GstStructure *structure = gst_message_get_structure(gm);
+            if (structure && gst_structure_has_name(structure, "splitmuxsink-fragment-closed")) {
+                if (const gchar *location = gst_structure_get_string(structure, "location"))
+                    emit segmentFinished(QUrl::fromLocalFile(QFile::decodeName(location)));
+            }
+        }
+#endif
+
         if (GST_MESSAGE_SRC(gm) == GST_OBJECT_CAST(m_pipeline)) {
             switch (GST_MESSAGE_TYPE(gm))  {
             case GST_MESSAGE_DURATION:
@@ -52,6 +52,8 @@
 #include <private/qgstreamerbushelper_p.h>
 #include <private/qgstreamerbufferprobe_p.h>
 
+#include "qgstreamerprerollbuffer.h"
+
 QT_BEGIN_NAMESPACE
 
 class QGstreamerMessage;
@@ -61,6 +63,8 @@ class QGstreamerVideoEncode;
 class QGstreamerImageEncode;
 class QGstreamerRecorderControl;
 class QGstreamerMediaContainerControl;
+class QGstreamerPreRollControl;
+class QGstreamerSegmentControl;
 class QGstreamerVideoRendererInterface;
 class QGstreamerAudioProbeControl;
 
@@ -114,6 +118,8 @@ public:
 
     QGstreamerRecorderControl *recorderControl() const { return m_recorderControl; }
     QGstreamerMediaContainerControl *mediaContainerControl() const { return m_mediaContainerControl; }
+    QGstreamerPreRollControl *preRollControl() const { return m_preRollControl; }
+    QGstreamerSegmentControl *segmentControl() const { return m_segmentControl; }
 
     QGstreamerElementFactory *audioInput() const { return m_audioInputFactory; }
     void setAudioInput(QGstreamerElementFactory *audioInput);
@@ -138,6 +144,20 @@ public:
 
     bool isReady() const;
 
+    qint64 preRollDuration() const { return m_preRollDuration; }
+    void setPreRollDuration(qint64 msecs);
+    qint64 maximumPreRollSize() const { return m_maximumPreRollSize; }
+    void setMaximumPreRollSize(qint64 bytes);
+    bool isPreRollEnabled() const;
+    qint64 preRollBufferedDuration() const;
+    qint64 preRollBufferedSize() const;
+
+    qint64 maximumSegmentDuration() const { return m_maximumSegmentDuration; }
+    void setMaximumSegmentDuration(qint64 msecs);
+    qint64 maximumSegmentSize() const { return m_maximumSegmentSize; }
+    void setMaximumSegmentSize(qint64 bytes);
+    bool isSegmented() const;
+
     bool processBusMessage(const QGstreamerMessage &message) override;
 
     void addProbe(QGstreamerAudioProbeControl* probe);
@@ -154,6 +174,11 @@ signals:
     void volumeChanged(qreal);
     void readyChanged(bool);
     void viewfinderChanged();
+    void preRollDurationChanged(qint64 msecs);
+    void maximumPreRollSizeChanged(qint64 bytes);
+    void maximumSegmentDurationChanged(qint64 msecs);
+    void maximumSegmentSizeChanged(qint64 bytes);
+    void segmentFinished(const QUrl &location);
 
 public slots:
     void setState(QGstreamerCaptureSession::State);
@@ -169,9 +194,14 @@ private:
     void probeCaps(GstCaps *caps) override;
     bool probeBuffer(GstBuffer *buffer) override;
 
-    enum PipelineMode { EmptyPipeline, PreviewPipeline, RecordingPipeline, PreviewAndRecordingPipeline };
+    enum PipelineMode { EmptyPipeline, PreviewPipeline, RecordingPipeline, PreviewAndRecordingPipeline,
+                        PreviewAndPreRollPipeline };
 
+    GstElement *buildMuxer(GstBin *bin);
+    GstPad *requestMuxerPad(GstElement *muxer, GstPad *srcPad, bool video);
+    bool linkToMuxer(GstElement *encoder, GstElement *muxer, bool video);
     GstElement *buildEncodeBin();
+    GstElement *buildMuxBin();
     GstElement *buildAudioSrc();
     GstElement *buildAudioPreview();
     GstElement *buildVideoSrc();
@@ -179,6 +209,9 @@ private:
     GstElement *buildImageCapture();
 
     bool rebuildGraph(QGstreamerCaptureSession::PipelineMode newMode);
+    bool startPreRollRecording();
+    void removePreRollProbes();
+    void updatePreRollLimits();
 
     GstPad *getAudioProbePad();
     void removeAudioBufferProbe();
@@ -206,6 +239,8 @@ private:
     QGstreamerImageEncode *m_imageEncodeControl;
     QGstreamerRecorderControl *m_recorderControl;
     QGstreamerMediaContainerControl *m_mediaContainerControl;
+    QGstreamerPreRollControl *m_preRollControl;
+    QGstreamerSegmentControl *m_segmentControl;
 
     QGstreamerBusHelper *m_busHelper;
     GstBus* m_bus;
@@ -227,6 +262,15 @@ private:
     GstElement *m_imageCaptureBin;
 
     GstElement *m_encodeBin;
+    GstElement *m_muxBin;
+
+    qint64 m_preRollDuration;
+    qint64 m_maximumPreRollSize;
+    QGstreamerPreRollBuffer m_audioPreRoll;
+    QGstreamerPreRollBuffer m_videoPreRoll;
+
+    qint64 m_maximumSegmentDuration;
+    qint64 m_maximumSegmentSize;
 
 #if GST_CHECK_VERSION(1,0,0)
     GstVideoInfo m_previewInfo;
@@ -0,0 +1,285 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgstreamerprerollbuffer.h"
+
+QT_BEGIN_NAMESPACE
+
+QGstreamerPreRollBuffer::QGstreamerPreRollBuffer()
+{
+    gst_segment_init(&m_segment, GST_FORMAT_TIME);
+}
+
+QGstreamerPreRollBuffer::~QGstreamerPreRollBuffer()
+{
+    removeProbe();
+}
+
+void QGstreamerPreRollBuffer::setLimits(GstClockTime maximumDuration, qint64 maximumSize)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maximumDuration = maximumDuration;
+    m_maximumSize = maximumSize;
+    trim();
+}
+
+void QGstreamerPreRollBuffer::addProbeToPad(GstPad *pad)
+{
+    removeProbe();
+
+    QMutexLocker locker(&m_mutex);
+    m_pad = GST_PAD(gst_object_ref(pad));
+    m_state = Buffering;
+    m_releaseTime = GST_CLOCK_TIME_NONE;
+    gst_segment_init(&m_segment, GST_FORMAT_TIME);
+
+    m_probeId = gst_pad_add_probe(
+                pad,
+                GstPadProbeType(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM),
+                padProbe,
+                this,
+                nullptr);
+}
+
+void QGstreamerPreRollBuffer::removeProbe()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_pad) {
+        gst_pad_remove_probe(m_pad, m_probeId);
+        gst_object_unref(GST_OBJECT(m_pad));
+        m_pad = nullptr;
+        m_probeId = 0;
+    }
+    m_state = Buffering;
+    clear();
+}
+
+GstClockTime QGstreamerPreRollBuffer::startTime() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.isEmpty() ? GST_CLOCK_TIME_NONE : m_entries.first().runningTime;
+}
+
+GstClockTime QGstreamerPreRollBuffer::duration() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.isEmpty() ? 0 : m_entries.last().runningTime - m_entries.first().runningTime;
+}
+
+qint64 QGstreamerPreRollBuffer::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_size;
+}
+
+/*
+    Requests the buffered data to be pushed downstream, starting from the
+    first key frame at or after \a startTime.  The data is pushed from the
+    streaming thread together with the next buffer or EOS event.
+*/
+void QGstreamerPreRollBuffer::release(GstClockTime startTime)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_state == Buffering) {
+        m_state = Releasing;
+        m_releaseTime = startTime;
+    }
+}
+
+GstPadProbeReturn QGstreamerPreRollBuffer::padProbe(
+        GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    QGstreamerPreRollBuffer * const preRoll = static_cast<QGstreamerPreRollBuffer *>(user_data);
+
+    if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER)
+        return preRoll->processBuffer(pad, gst_pad_probe_info_get_buffer(info));
+
+    GstEvent * const event = gst_pad_probe_info_get_event(info);
+    QMutexLocker locker(&preRoll->m_mutex);
+    switch (GST_EVENT_TYPE(event)) {
+    case GST_EVENT_SEGMENT:
+        gst_event_copy_segment(event, &preRoll->m_segment);
+        break;
+    case GST_EVENT_EOS:
+        if (preRoll->m_state == Releasing)
+            preRoll->flush(pad, &locker);
+        break;
+    default:
+        break;
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn QGstreamerPreRollBuffer::processBuffer(GstPad *pad, GstBuffer *buffer)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const bool keyFrame = !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+    switch (m_state) {
+    case Passing:
+        return GST_PAD_PROBE_OK;
+    case Releasing:
+        flush(pad, &locker);
+        if (m_state == Passing)
+            return GST_PAD_PROBE_OK;
+        Q_FALLTHROUGH();
+    case WaitingForKeyFrame:
+        // Nothing was buffered, the recording has to start on live data.
+        if (!keyFrame)
+            return GST_PAD_PROBE_DROP;
+        m_state = Passing;
+        return GST_PAD_PROBE_OK;
+    case Buffering:
+        break;
+    }
+
+    if (m_entries.isEmpty() && !keyFrame)
+        return GST_PAD_PROBE_DROP;
+
+    GstClockTime timestamp = GST_BUFFER_PTS_IS_VALID(buffer)
+            ? GST_BUFFER_PTS(buffer)
+            : GST_BUFFER_DTS(buffer);
+    GstClockTime runningTime = GST_CLOCK_TIME_IS_VALID(timestamp)
+            ? gst_segment_to_running_time(&m_segment, GST_FORMAT_TIME, timestamp)
+            : GST_CLOCK_TIME_NONE;
+    if (!GST_CLOCK_TIME_IS_VALID(runningTime))
+        runningTime = m_entries.isEmpty() ? 0 : m_entries.last().runningTime;
+
+    m_entries.enqueue({ gst_buffer_ref(buffer), runningTime, keyFrame });
+    m_size += gst_buffer_get_size(buffer);
+    trim();
+
+    return GST_PAD_PROBE_DROP;
+}
+
+void QGstreamerPreRollBuffer::flush(GstPad *pad, QMutexLocker *locker)
+{
+    // Skip everything recorded before the requested start, but never start
+    // in the middle of a group of pictures. Without a key frame after the
+    // start, begin with the group of pictures containing it instead.
+    int first = 0;
+    while (first < m_entries.count()
+           && GST_CLOCK_TIME_IS_VALID(m_releaseTime)
+           && m_entries.at(first).runningTime < m_releaseTime) {
+        ++first;
+    }
+    int keyFrame = nextKeyFrame(first);
+    if (keyFrame < 0)
+        keyFrame = previousKeyFrame(first);
+    dropFront(keyFrame < 0 ? m_entries.count() : keyFrame);
+
+    if (m_entries.isEmpty()) {
+        m_state = WaitingForKeyFrame;
+        return;
+    }
+
+    GstBufferList *list = gst_buffer_list_new_sized(m_entries.count());
+    for (const Entry &entry : qAsConst(m_entries))
+        gst_buffer_list_add(list, entry.buffer);
+    m_entries.clear();
+    m_size = 0;
+    m_state = Passing;
+
+    // Push the buffered data through this pad, ahead of the buffer or event
+    // the probe was called for, so that it goes through the normal data flow
+    // and gets the pad offset applied.  The probe only inspects single
+    // buffers and lets the list through, and since the state is Passing now
+    // the live data that follows is not held back either.
+    locker->unlock();
+    gst_pad_push_list(pad, list);
+    locker->relock();
+}
+
+void QGstreamerPreRollBuffer::trim()
+{
+    // Drop whole groups of pictures from the front while the remaining data
+    // still covers the requested duration, or while it uses too much memory.
+    while (!m_entries.isEmpty()) {
+        const bool tooLarge = m_maximumSize > 0 && m_size > m_maximumSize;
+        const int next = nextKeyFrame(1);
+        if (next < 0) {
+            if (tooLarge)
+                clear();
+            return;
+        }
+
+        const GstClockTime remaining = m_entries.last().runningTime - m_entries.at(next).runningTime;
+        if (!tooLarge && remaining < m_maximumDuration)
+            return;
+
+        dropFront(next);
+    }
+}
+
+int QGstreamerPreRollBuffer::nextKeyFrame(int from) const
+{
+    for (int i = from; i < m_entries.count(); ++i) {
+        if (m_entries.at(i).keyFrame)
+            return i;
+    }
+    return -1;
+}
+
+int QGstreamerPreRollBuffer::previousKeyFrame(int before) const
+{
+    for (int i = qMin(before, m_entries.count()) - 1; i >= 0; --i) {
+        if (m_entries.at(i).keyFrame)
+            return i;
+    }
+    return -1;
+}
+
+void QGstreamerPreRollBuffer::dropFront(int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const Entry entry = m_entries.dequeue();
+        m_size -= gst_buffer_get_size(entry.buffer);
+        gst_buffer_unref(entry.buffer);
+    }
+}
+
+void QGstreamerPreRollBuffer::clear()
+{
+    dropFront(m_entries.count());
+    m_size = 0;
+}
+
+QT_END_NAMESPACE
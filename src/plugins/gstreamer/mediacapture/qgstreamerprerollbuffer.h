@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGSTREAMERPREROLLBUFFER_H
+#define QGSTREAMERPREROLLBUFFER_H
+
+#include <QtCore/qmutex.h>
+#include <QtCore/qqueue.h>
+
+#include <gst/gst.h>
+
+QT_BEGIN_NAMESPACE
+
+// Keeps the most recent encoded buffers of one elementary stream while
+// recording has not been requested yet.  The buffered data always starts
+// on a key frame and is bounded both in duration and in size.  Once
+// released, the buffered data is pushed downstream ahead of the live data
+// from the streaming thread.
+class QGstreamerPreRollBuffer
+{
+public:
+    QGstreamerPreRollBuffer();
+    ~QGstreamerPreRollBuffer();
+
+    void setLimits(GstClockTime maximumDuration, qint64 maximumSize);
+
+    void addProbeToPad(GstPad *pad);
+    void removeProbe();
+
+    GstClockTime startTime() const;
+    GstClockTime duration() const;
+    qint64 size() const;
+
+    void release(GstClockTime startTime);
+
+private:
+    enum State { Buffering, Releasing, WaitingForKeyFrame, Passing };
+
+    struct Entry
+    {
+        GstBuffer *buffer;
+        GstClockTime runningTime;
+        bool keyFrame;
+    };
+
+    static GstPadProbeReturn padProbe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data);
+    GstPadProbeReturn processBuffer(GstPad *pad, GstBuffer *buffer);
+    void flush(GstPad *pad, QMutexLocker *locker);
+
+    void trim();
+    int nextKeyFrame(int from) const;
+    int previousKeyFrame(int before) const;
+    void dropFront(int count);
+    void clear();
+
+    mutable QMutex m_mutex;
+    QQueue<Entry> m_entries;
+    GstSegment m_segment;
+    GstPad *m_pad = nullptr;
+    gulong m_probeId = 0;
+    GstClockTime m_maximumDuration = 0;
+    GstClockTime m_releaseTime = GST_CLOCK_TIME_NONE;
+    qint64 m_maximumSize = 0;
+    qint64 m_size = 0;
+    State m_state = Buffering;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGSTREAMERPREROLLBUFFER_H
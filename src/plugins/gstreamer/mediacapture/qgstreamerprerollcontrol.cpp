@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgstreamerprerollcontrol.h"
+#include "qgstreamercapturesession.h"
+
+QT_BEGIN_NAMESPACE
+
+QGstreamerPreRollControl::QGstreamerPreRollControl(QGstreamerCaptureSession *session)
+    : QMediaRecorderPreRollControl(session)
+    , m_session(session)
+{
+    connect(m_session, &QGstreamerCaptureSession::preRollDurationChanged,
+            this, &QGstreamerPreRollControl::preRollDurationChanged);
+    connect(m_session, &QGstreamerCaptureSession::maximumPreRollSizeChanged,
+            this, &QGstreamerPreRollControl::maximumPreRollSizeChanged);
+}
+
+QGstreamerPreRollControl::~QGstreamerPreRollControl()
+{
+}
+
+qint64 QGstreamerPreRollControl::preRollDuration() const
+{
+    return m_session->preRollDuration();
+}
+
+void QGstreamerPreRollControl::setPreRollDuration(qint64 msecs)
+{
+    m_session->setPreRollDuration(msecs);
+}
+
+qint64 QGstreamerPreRollControl::maximumPreRollSize() const
+{
+    return m_session->maximumPreRollSize();
+}
+
+void QGstreamerPreRollControl::setMaximumPreRollSize(qint64 bytes)
+{
+    m_session->setMaximumPreRollSize(bytes);
+}
+
+qint64 QGstreamerPreRollControl::bufferedDuration() const
+{
+    return m_session->preRollBufferedDuration();
+}
+
+qint64 QGstreamerPreRollControl::bufferedSize() const
+{
+    return m_session->preRollBufferedSize();
+}
+
+QT_END_NAMESPACE
@@ -201,7 +201,10 @@ void QGstreamerRecorderControl::stop()
     m_state = QMediaRecorder::StoppedState;
 
     if (!m_hasPreviewState) {
-        m_session->setState(QGstreamerCaptureSession::StoppedState);
+        // Keep capturing into the pre-roll buffer for the next recording.
+        m_session->setState(m_session->isPreRollEnabled()
+                            ? QGstreamerCaptureSession::PreviewState
+                            : QGstreamerCaptureSession::StoppedState);
     } else {
         if (m_session->state() != QGstreamerCaptureSession::StoppedState)
             m_session->setState(QGstreamerCaptureSession::PreviewState);
@@ -0,0 +1,98 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgstreamersegmentcontrol.h"
+#include "qgstreamercapturesession.h"
+
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+
+QT_BEGIN_NAMESPACE
+
+QGstreamerSegmentControl::QGstreamerSegmentControl(QGstreamerCaptureSession *session)
+    : QMediaRecorderSegmentControl(session)
+    , m_session(session)
+{
+    connect(m_session, &QGstreamerCaptureSession::maximumSegmentDurationChanged,
+            this, &QGstreamerSegmentControl::maximumSegmentDurationChanged);
+    connect(m_session, &QGstreamerCaptureSession::maximumSegmentSizeChanged,
+            this, &QGstreamerSegmentControl::maximumSegmentSizeChanged);
+    connect(m_session, &QGstreamerCaptureSession::segmentFinished,
+            this, &QGstreamerSegmentControl::segmentFinished);
+}
+
+QGstreamerSegmentControl::~QGstreamerSegmentControl()
+{
+}
+
+qint64 QGstreamerSegmentControl::maximumSegmentDuration() const
+{
+    return m_session->maximumSegmentDuration();
+}
+
+void QGstreamerSegmentControl::setMaximumSegmentDuration(qint64 msecs)
+{
+    m_session->setMaximumSegmentDuration(msecs);
+}
+
+qint64 QGstreamerSegmentControl::maximumSegmentSize() const
+{
+    return m_session->maximumSegmentSize();
+}
+
+void QGstreamerSegmentControl::setMaximumSegmentSize(qint64 bytes)
+{
+    m_session->setMaximumSegmentSize(bytes);
+}
+
+// Returns the splitmuxsink location pattern for recording to \a fileName,
+// with the segment number inserted before the file extension,
+// e.g. clip_0001_00000.mp4
+QByteArray QGstreamerSegmentControl::locationPattern(const QString &fileName)
+{
+    const QFileInfo info(fileName);
+    QString pattern = info.path() + QLatin1Char('/') + info.completeBaseName();
+    pattern.replace(QLatin1Char('%'), QLatin1String("%%"));
+    pattern += QLatin1String("_%05d");
+    if (!info.suffix().isEmpty())
+        pattern += QLatin1Char('.') + info.suffix();
+    return QFile::encodeName(pattern);
+}
+
+QT_END_NAMESPACE
@@ -7,6 +7,7 @@ INCLUDEPATH += $$PWD
 HEADERS += \
     $$PWD/qgstreamerplayerservice.h \
     $$PWD/qgstreamerstreamscontrol.h \
+    $$PWD/qgstreamerframestepcontrol.h \
     $$PWD/qgstreamermetadataprovider.h \
     $$PWD/qgstreameravailabilitycontrol.h \
     $$PWD/qgstreamerplayerserviceplugin.h
@@ -14,6 +15,7 @@ HEADERS += \
 SOURCES += \
     $$PWD/qgstreamerplayerservice.cpp \
     $$PWD/qgstreamerstreamscontrol.cpp \
+    $$PWD/qgstreamerframestepcontrol.cpp \
     $$PWD/qgstreamermetadataprovider.cpp \
     $$PWD/qgstreameravailabilitycontrol.cpp \
     $$PWD/qgstreamerplayerserviceplugin.cpp
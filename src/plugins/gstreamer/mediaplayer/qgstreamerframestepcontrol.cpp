@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgstreamerframestepcontrol.h"
+#include <private/qgstreamerplayercontrol_p.h>
+#include <private/qgstreamerplayersession_p.h>
+
+QT_BEGIN_NAMESPACE
+
+// Enough to step back and forth through a typical group of pictures.
+static const int defaultFrameCacheSize = 16;
+
+QGstreamerFrameStepControl::QGstreamerFrameStepControl(QGstreamerPlayerControl *control,
+                                                       QGstreamerPlayerSession *session,
+                                                       QObject *parent)
+    : QMediaPlayerFrameStepControl(parent)
+    , m_control(control)
+    , m_session(session)
+{
+    m_session->setFrameCacheSize(defaultFrameCacheSize);
+}
+
+QGstreamerFrameStepControl::~QGstreamerFrameStepControl()
+{
+}
+
+bool QGstreamerFrameStepControl::isAccurateSeekEnabled() const
+{
+    return m_session->isAccurateSeekEnabled();
+}
+
+void QGstreamerFrameStepControl::setAccurateSeekEnabled(bool enabled)
+{
+    if (m_session->isAccurateSeekEnabled() == enabled)
+        return;
+
+    m_session->setAccurateSeekEnabled(enabled);
+    emit accurateSeekEnabledChanged(enabled);
+}
+
+bool QGstreamerFrameStepControl::step(int frames)
+{
+    // Pause through the player control, so that it doesn't resume playback
+    // on the next state change of the session.
+    if (m_control->state() == QMediaPlayer::PlayingState)
+        m_control->pause();
+
+    return m_session->step(frames);
+}
+
+int QGstreamerFrameStepControl::frameCacheSize() const
+{
+    return m_session->frameCacheSize();
+}
+
+void QGstreamerFrameStepControl::setFrameCacheSize(int frames)
+{
+    if (m_session->frameCacheSize() == frames)
+        return;
+
+    m_session->setFrameCacheSize(frames);
+    emit frameCacheSizeChanged(frames);
+}
+
+QT_END_NAMESPACE
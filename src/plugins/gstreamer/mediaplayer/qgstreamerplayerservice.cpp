@@ -56,6 +56,7 @@
 #include <private/qgstreamervideorenderer_p.h>
 
 #include "qgstreamerstreamscontrol.h"
+#include "qgstreamerframestepcontrol.h"
 #include <private/qgstreameraudioprobecontrol_p.h>
 #include <private/qgstreamervideoprobecontrol_p.h>
 #include <private/qgstreamerplayersession_p.h>
@@ -74,6 +75,7 @@ QGstreamerPlayerService::QGstreamerPlayerService(QObject *parent)
     m_control = new QGstreamerPlayerControl(m_session, this);
     m_metaData = new QGstreamerMetaDataProvider(m_session, this);
     m_streamsControl = new QGstreamerStreamsControl(m_session,this);
+    m_frameStepControl = new QGstreamerFrameStepControl(m_control, m_session, this);
     m_availabilityControl = new QGStreamerAvailabilityControl(m_control->resources(), this);
     m_videoRenderer = new QGstreamerVideoRenderer(this);
     m_videoWindow = new QGstreamerVideoWindow(this);
@@ -112,6 +114,9 @@ QMediaControl *QGstreamerPlayerService::requestControl(const char *name)
     if (qstrcmp(name,QMediaStreamsControl_iid) == 0)
         return m_streamsControl;
 
+    if (qstrcmp(name, QMediaPlayerFrameStepControl_iid) == 0)
+        return m_frameStepControl;
+
     if (qstrcmp(name, QMediaAvailabilityControl_iid) == 0)
         return m_availabilityControl;
 
@@ -55,6 +55,7 @@ class QGstreamerPlayerControl;
 class QGstreamerPlayerSession;
 class QGstreamerMetaDataProvider;
 class QGstreamerStreamsControl;
+class QGstreamerFrameStepControl;
 class QGstreamerVideoRenderer;
 class QGstreamerVideoWindow;
 class QGstreamerVideoWidgetControl;
@@ -77,6 +78,7 @@ private:
     QGstreamerPlayerSession *m_session = nullptr;
     QGstreamerMetaDataProvider *m_metaData = nullptr;
     QGstreamerStreamsControl *m_streamsControl = nullptr;
+    QGstreamerFrameStepControl *m_frameStepControl = nullptr;
     QGStreamerAvailabilityControl *m_availabilityControl = nullptr;
 
     QGstreamerAudioProbeControl *m_audioProbeControl = nullptr;
@@ -39,6 +39,7 @@
 
 #include "qm3uhandler.h"
 #include <qmediaresource.h>
+#include <private/qplaylisttokenizer_p.h>
 #include <QtCore/qiodevice.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qtextstream.h>
@@ -46,11 +47,13 @@
 #include <QUrl>
 
 
+// Lines come from the shared playlist tokenizer: a local playlist is mapped
+// and split in place, a device is read in large chunks.
 class QM3uPlaylistReader : public QMediaPlaylistReader
 {
 public:
     QM3uPlaylistReader(QIODevice *device)
-        :m_ownDevice(false), m_device(device), m_textStream(new QTextStream(m_device))
+        :m_ownDevice(false), m_device(device)
     {
         readItem();
     }
@@ -59,14 +62,17 @@ public:
         :m_location(location), m_ownDevice(true)
     {
         QFile *f = new QFile(location.toLocalFile());
-        if (f->open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (f->open(QIODevice::ReadOnly)) {
             m_device = f;
-            m_textStream = new QTextStream(m_device);
+            const qint64 size = f->size();
+            if (const uchar *data = size > 0 ? f->map(0, size) : nullptr) {
+                m_tokenizer.setData(reinterpret_cast<const char *>(data), size);
+                m_tokenizer.finish();
+            }
             readItem();
         } else {
             delete f;
             m_device = 0;
-            m_textStream = 0;
         }
     }
 
@@ -75,12 +81,11 @@ public:
         if (m_ownDevice) {
             delete m_device;
         }
-        delete m_textStream;
     }
 
     virtual bool atEnd() const
     {
-        //we can't just use m_textStream->atEnd(),
+        //we can't just use m_device->atEnd(),
         //for files with empty lines/comments at end
         return nextResource.isNull();
     }
@@ -93,11 +98,13 @@ public:
 
         nextResource = QMediaContent();
 
-        while (m_textStream && !m_textStream->atEnd()) {
-            QString line = m_textStream->readLine().trimmed();
-            if (line.isEmpty() || line[0] == '#' || line.size() > 4096)
+        QPlaylistTokenizer::Line rawLine;
+        while (nextLine(&rawLine)) {
+            const QPlaylistTokenizer::Line trimmed = rawLine.trimmed();
+            if (trimmed.size == 0 || trimmed.data[0] == '#' || trimmed.size > 4096)
                 continue;
 
+            const QString line = QString::fromLocal8Bit(trimmed.data, trimmed.size);
             QUrl fileUrl = QUrl::fromLocalFile(line);
             QUrl url(line);
 
@@ -141,10 +148,27 @@ public:
     }
 
 private:
+    bool nextLine(QPlaylistTokenizer::Line *line)
+    {
+        while (!m_tokenizer.next(line)) {
+            if (!m_device || m_tokenizer.isFinished())
+                return false;
+
+            m_chunk = m_device->read(ChunkSize);
+            m_tokenizer.setData(m_chunk.constData(), m_chunk.size());
+            if (m_chunk.isEmpty())
+                m_tokenizer.finish();
+        }
+        return true;
+    }
+
+    static const int ChunkSize = 64 * 1024;
+
     QUrl m_location;
     bool m_ownDevice;
     QIODevice *m_device;
-    QTextStream *m_textStream;
+    QPlaylistTokenizer m_tokenizer;
+    QByteArray m_chunk;
     QMediaContent nextResource;
 };
 
@@ -53,15 +53,19 @@ QT_BEGIN_NAMESPACE
 
 const int LowLatencyBufferSizeMs = 40;
 
+// Target latency of streams with setLowLatencyEnabled(), and how many
+// requests PulseAudio makes per target length.
+const int LowLatencyTargetMs = 10;
+const int LowLatencyRequestsPerTarget = 4;
+
 #define LOW_LATENCY_CATEGORY_NAME "game"
 
 static void  outputStreamWriteCallback(pa_stream *stream, size_t length, void *userdata)
 {
     Q_UNUSED(stream);
-    Q_UNUSED(length);
-    Q_UNUSED(userdata);
     QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
     pa_threaded_mainloop_signal(pulseEngine->mainloop(), 0);
+    static_cast<QPulseAudioOutput *>(userdata)->streamWriteCallback(length);
 }
 
 static void outputStreamStateCallback(pa_stream *stream, void *userdata)
@@ -166,6 +170,9 @@ QPulseAudioOutput::QPulseAudioOutput(const QByteArray &device)
     , m_tickTimer(new QTimer(this))
     , m_audioBuffer(0)
     , m_resuming(false)
+    , m_lowLatencyEnabled(false)
+    , m_lowLatency(false)
+    , m_feeding(false)
     , m_volume(1.0)
 {
     m_tickTimer->setTimerType(Qt::PreciseTimer);
@@ -209,12 +216,83 @@ QAudio::State QPulseAudioOutput::state() const
 
 void QPulseAudioOutput::streamUnderflowCallback()
 {
+    // Low latency pull mode tracks starvation of the source itself; a short
+    // underflow there doesn't mean playback stopped.
+    if (m_feeding)
+        return;
+
     if (m_deviceState != QAudio::IdleState && !m_resuming) {
         setError(QAudio::UnderrunError);
         setState(QAudio::IdleState);
     }
 }
 
+// Called from the PulseAudio mainloop thread, with the mainloop locked.
+void QPulseAudioOutput::streamWriteCallback(size_t length)
+{
+    if (m_feeding)
+        pullLocked(length);
+}
+
+// Reads up to \a length bytes from the source straight into the stream, so
+// that a low latency stream in pull mode answers each request of the server
+// right away. The mainloop lock must be held. State changes are queued to
+// the output's thread.
+void QPulseAudioOutput::pullLocked(size_t length)
+{
+    length = qMin(length, pa_stream_writable_size(m_stream));
+    length = qMin(length, size_t(m_maxBufferSize));
+    if (length == 0)
+        return;
+
+    const qint64 pulled = m_audioSource->read(m_audioBuffer, qint64(length));
+    if (pulled > 0) {
+        if (writeLocked(m_audioBuffer, pulled) > 0 && m_starved.testAndSetOrdered(1, 0))
+            QMetaObject::invokeMethod(this, "onStreamFed", Qt::QueuedConnection);
+    } else if (m_starved.testAndSetOrdered(0, 1)) {
+        // Nothing more will be requested until data arrives, so let the tick
+        // timer poll the source again.
+        QMetaObject::invokeMethod(this, "onStreamStarved", Qt::QueuedConnection);
+    }
+}
+
+void QPulseAudioOutput::onStreamStarved()
+{
+    if (m_deviceState == QAudio::ActiveState && !m_resuming) {
+        setError(QAudio::UnderrunError);
+        setState(QAudio::IdleState);
+    }
+}
+
+void QPulseAudioOutput::onStreamFed()
+{
+    if (m_deviceState == QAudio::IdleState) {
+        setError(QAudio::NoError);
+        setState(QAudio::ActiveState);
+    }
+}
+
+/*
+    Returns the current playback latency of the stream, as reported by
+    PulseAudio: the time until data written now is heard.
+*/
+qint64 QPulseAudioOutput::latencyUSecs() const
+{
+    if (!m_stream)
+        return -1;
+
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+    pulseEngine->lock();
+    pa_usec_t usec = 0;
+    int negative = 0;
+    const bool known = pa_stream_get_latency(m_stream, &usec, &negative) == 0;
+    pulseEngine->unlock();
+
+    if (!known)
+        return -1;
+    return negative ? 0 : qint64(usec);
+}
+
 void QPulseAudioOutput::start(QIODevice *device)
 {
     setState(QAudio::StoppedState);
@@ -290,6 +368,7 @@ bool QPulseAudioOutput::open()
 
     m_spec = spec;
     m_totalTimeValue = 0;
+    m_lowLatency = m_lowLatencyEnabled;
 
     if (m_streamName.isNull())
         m_streamName = QString(QLatin1String("QtmPulseStream-%1-%2")).arg(::getpid()).arg(quintptr(this)).toUtf8();
@@ -346,7 +425,7 @@ bool QPulseAudioOutput::open()
     pa_stream_set_overflow_callback(m_stream, outputStreamOverflowCallback, this);
     pa_stream_set_latency_update_callback(m_stream, outputStreamLatencyCallback, this);
 
-    if (m_bufferSize <= 0 && m_category == LOW_LATENCY_CATEGORY_NAME) {
+    if (m_bufferSize <= 0 && !m_lowLatency && m_category == LOW_LATENCY_CATEGORY_NAME) {
         m_bufferSize = bytesPerSecond * LowLatencyBufferSizeMs / qint64(1000);
     }
 
@@ -357,7 +436,19 @@ bool QPulseAudioOutput::open()
     requestedBuffer.prebuf = (uint32_t)-1;
     requestedBuffer.tlength = m_bufferSize * 2;
 
-    if (pa_stream_connect_playback(m_stream, m_device.data(), (m_bufferSize > 0) ? &requestedBuffer : NULL, (pa_stream_flags_t)0, NULL, NULL) < 0) {
+    int flags = 0;
+    if (m_lowLatency) {
+        // tlength is the end to end latency with PA_STREAM_ADJUST_LATENCY, and
+        // a small minreq makes PulseAudio ask for data in short slices.
+        if (m_bufferSize <= 0)
+            m_bufferSize = bytesPerSecond * LowLatencyTargetMs / qint64(1000);
+        const uint32_t frame = pa_frame_size(&m_spec);
+        requestedBuffer.tlength = m_bufferSize;
+        requestedBuffer.minreq = qMax(frame, uint32_t(m_bufferSize / LowLatencyRequestsPerTarget) / frame * frame);
+        flags = PA_STREAM_ADJUST_LATENCY | PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_AUTO_TIMING_UPDATE;
+    }
+
+    if (pa_stream_connect_playback(m_stream, m_device.data(), (m_bufferSize > 0) ? &requestedBuffer : NULL, pa_stream_flags_t(flags), NULL, NULL) < 0) {
         qWarning() << "pa_stream_connect_playback() failed!";
         pa_stream_unref(m_stream);
         m_stream = 0;
@@ -377,6 +468,14 @@ bool QPulseAudioOutput::open()
     }
     m_periodSize = m_bufferSize;
     m_periodTime = pa_bytes_to_usec(m_periodSize, &m_spec) / 2000;
+    if (m_lowLatency) {
+        m_bufferSize = buffer->tlength;
+        m_periodSize = buffer->minreq;
+        // In pull mode the write callback does the feeding; the timer only
+        // emits notify() and polls a starved source, which PulseAudio stops
+        // requesting data for.
+        m_periodTime = qMax(1, int(pa_bytes_to_usec(m_pullMode ? m_bufferSize : m_periodSize, &m_spec) / 1000));
+    }
     if(m_pullMode){
         m_maxBufferSize = buffer->maxlength;
         m_audioBuffer = new char[m_maxBufferSize];
@@ -401,6 +500,14 @@ bool QPulseAudioOutput::open()
     qDebug() << "\tFragment size: " << buffer->fragsize;
 #endif
 
+    if (m_lowLatency && m_pullMode) {
+        // Requests that came in while connecting were ignored, so fill the
+        // buffer once; from here on the write callback keeps it topped up.
+        m_starved.storeRelaxed(0);
+        m_feeding = true;
+        pullLocked(pa_stream_writable_size(m_stream));
+    }
+
     pulseEngine->unlock();
 
     connect(pulseEngine, &QPulseAudioEngine::contextFailed, this, &QPulseAudioOutput::onPulseContextFailed);
@@ -428,6 +535,7 @@ void QPulseAudioOutput::close()
     if (m_stream) {
         pulseEngine->lock();
 
+        m_feeding = false;
         pa_stream_set_state_callback(m_stream, 0, 0);
         pa_stream_set_write_callback(m_stream, 0, 0);
         pa_stream_set_underflow_callback(m_stream, 0, 0);
@@ -465,7 +573,16 @@ void QPulseAudioOutput::userFeed()
 
     m_resuming = false;
 
-    if (m_pullMode) {
+    if (m_pullMode && m_lowLatency) {
+        // Normally fed from the write callback; only step in once the source
+        // ran dry, as PulseAudio won't ask again until it gets data.
+        if (m_starved.loadAcquire()) {
+            QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+            pulseEngine->lock();
+            pullLocked(pa_stream_writable_size(m_stream));
+            pulseEngine->unlock();
+        }
+    } else if (m_pullMode) {
         int writableSize = bytesFree();
         int audioBytesPulled = m_audioSource->read(m_audioBuffer, writableSize);
         if (m_audioBuffer && audioBytesPulled > 0) {
@@ -489,6 +606,25 @@ qint64 QPulseAudioOutput::write(const char *data, qint64 len)
     QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
 
     pulseEngine->lock();
+    len = writeLocked(data, len);
+    pulseEngine->unlock();
+
+    if (len < 0) {
+        setError(QAudio::IOError);
+        return 0;
+    }
+
+    setError(QAudio::NoError);
+    setState(QAudio::ActiveState);
+
+    return len;
+}
+
+// Writes to the stream with the mainloop locked. Doesn't touch the state, as
+// pullLocked() calls it from the write callback. Returns -1 on error.
+qint64 QPulseAudioOutput::writeLocked(const char *data, qint64 len)
+{
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
 
     len = qMin(len, static_cast<qint64>(pa_stream_writable_size(m_stream)));
 
@@ -500,8 +636,7 @@ qint64 QPulseAudioOutput::write(const char *data, qint64 len)
         if (pa_stream_begin_write(m_stream, &dest, &nbytes) < 0) {
             qWarning("QAudioOutput(pulseaudio): pa_stream_begin_write, error = %s",
                      pa_strerror(pa_context_errno(pulseEngine->context())));
-            setError(QAudio::IOError);
-            return 0;
+            return -1;
         }
 
         len = int(nbytes);
@@ -512,16 +647,10 @@ qint64 QPulseAudioOutput::write(const char *data, qint64 len)
     if (pa_stream_write(m_stream, data, len, NULL, 0, PA_SEEK_RELATIVE) < 0) {
         qWarning("QAudioOutput(pulseaudio): pa_stream_write, error = %s",
                  pa_strerror(pa_context_errno(pulseEngine->context())));
-        setError(QAudio::IOError);
-        return 0;
+        return -1;
     }
 
-    pulseEngine->unlock();
     m_totalTimeValue += len;
-
-    setError(QAudio::NoError);
-    setState(QAudio::ActiveState);
-
     return len;
 }
 
@@ -575,7 +704,13 @@ int QPulseAudioOutput::notifyInterval() const
 
 qint64 QPulseAudioOutput::processedUSecs() const
 {
-    qint64 result = qint64(1000000) * m_totalTimeValue /
+    // Also counted by the write callback in low latency pull mode.
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+    pulseEngine->lock();
+    const qint64 totalTimeValue = m_totalTimeValue;
+    pulseEngine->unlock();
+
+    qint64 result = qint64(1000000) * totalTimeValue /
         (m_format.channelCount() * (m_format.sampleSize() / 8)) /
         m_format.sampleRate();
 
@@ -599,6 +734,11 @@ void QPulseAudioOutput::resume()
         pulseEngine->wait(operation);
         pa_operation_unref(operation);
 
+        if (m_lowLatency && m_pullMode) {
+            m_feeding = true;
+            pullLocked(pa_stream_writable_size(m_stream));
+        }
+
         pulseEngine->unlock();
 
         m_tickTimer->start(m_periodTime);
@@ -631,6 +771,7 @@ void QPulseAudioOutput::suspend()
 
         pulseEngine->lock();
 
+        m_feeding = false;
         operation = pa_stream_cork(m_stream, 1, outputStreamSuccessCallback, NULL);
         pulseEngine->wait(operation);
         pa_operation_unref(operation);
@@ -702,6 +843,16 @@ QString QPulseAudioOutput::category() const
     return m_category;
 }
 
+void QPulseAudioOutput::setLowLatencyEnabled(bool enabled)
+{
+    m_lowLatencyEnabled = enabled;
+}
+
+bool QPulseAudioOutput::isLowLatencyEnabled() const
+{
+    return m_lowLatencyEnabled;
+}
+
 void QPulseAudioOutput::onPulseContextFailed()
 {
     close();
@@ -57,6 +57,7 @@
 #include <QtCore/qstringlist.h>
 #include <QtCore/qelapsedtimer.h>
 #include <QtCore/qiodevice.h>
+#include <QtCore/qatomic.h>
 
 #include "qaudio.h"
 #include "qaudiodeviceinfo.h"
@@ -70,6 +71,8 @@ class QPulseAudioOutput : public QAbstractAudioOutput
 {
     friend class PulseOutputPrivate;
     Q_OBJECT
+    Q_PROPERTY(bool lowLatency READ isLowLatencyEnabled WRITE setLowLatencyEnabled)
+    Q_PROPERTY(qint64 latencyUSecs READ latencyUSecs)
 
 public:
     QPulseAudioOutput(const QByteArray &device);
@@ -100,8 +103,13 @@ public:
     void setCategory(const QString &category);
     QString category() const;
 
+    void setLowLatencyEnabled(bool enabled);
+    bool isLowLatencyEnabled() const;
+    qint64 latencyUSecs() const;
+
 public:
     void streamUnderflowCallback();
+    void streamWriteCallback(size_t length);
 
 private:
     void setState(QAudio::State state);
@@ -110,10 +118,14 @@ private:
     bool open();
     void close();
     qint64 write(const char *data, qint64 len);
+    qint64 writeLocked(const char *data, qint64 len);
+    void pullLocked(size_t length);
 
 private Q_SLOTS:
     void userFeed();
     void onPulseContextFailed();
+    void onStreamStarved();
+    void onStreamFed();
 
 private:
     QByteArray m_device;
@@ -132,7 +144,7 @@ private:
     int m_bufferSize;
     int m_maxBufferSize;
     QElapsedTimer m_clockStamp;
-    qint64 m_totalTimeValue;
+    qint64 m_totalTimeValue; // guarded by the mainloop lock
     QTimer *m_tickTimer;
     char *m_audioBuffer;
     QElapsedTimer m_timeStamp;
@@ -140,6 +152,15 @@ private:
     bool m_resuming;
     QString m_category;
 
+    // m_lowLatency is m_lowLatencyEnabled as of the last open(). In low
+    // latency pull mode the source is read from the PulseAudio mainloop
+    // thread in the write callback while m_feeding is set; m_feeding is
+    // only changed with the mainloop locked.
+    bool m_lowLatencyEnabled;
+    bool m_lowLatency;
+    bool m_feeding;
+    QAtomicInt m_starved;
+
     qreal m_volume;
     pa_sample_spec m_spec;
 };
@@ -197,6 +197,8 @@ void QSGVideoNode_EGL::setCurrentFrame(const QVideoFrame &frame, FrameFlags)
 {
     EGLImageKHR image = frame.handle().value<void *>();
     m_material.setImage(image);
+    // Keep the frame, the image may be destroyed and its buffer reused with it
+    m_frame = frame;
     markDirty(DirtyMaterial);
 }
 
@@ -224,12 +226,16 @@ QList<QVideoFrame::PixelFormat> QSGVideoNodeFactory_EGL::supportedPixelFormats(
 
     return QList<QVideoFrame::PixelFormat>()
             << QVideoFrame::Format_Invalid
+            << QVideoFrame::Format_YUV420P
             << QVideoFrame::Format_YV12
             << QVideoFrame::Format_UYVY
+            << QVideoFrame::Format_NV12
             << QVideoFrame::Format_NV21
             << QVideoFrame::Format_YUYV
             << QVideoFrame::Format_RGB32
+            << QVideoFrame::Format_ARGB32
             << QVideoFrame::Format_BGR32
+            << QVideoFrame::Format_BGRA32
             << QVideoFrame::Format_RGB24
             << QVideoFrame::Format_BGR24
             << QVideoFrame::Format_RGB565
@@ -90,6 +90,7 @@ public:
 private:
     QSGVideoMaterial_EGL m_material;
     QVideoFrame::PixelFormat m_pixelFormat;
+    QVideoFrame m_frame;
 };
 
 class QSGVideoNodeFactory_EGL : public QSGVideoNodeFactoryPlugin
@@ -50,6 +50,8 @@
 #include <QtGui/QOpenGLContext>
 #include <QtQuick/QQuickWindow>
 #include <QtCore/QRunnable>
+#include <QtCore/qmath.h>
+#include <QtCore/qthread.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -267,6 +269,52 @@ void QDeclarativeVideoRendererBackend::updateGeometry()
         m_sourceTextureRect.setLeft(m_sourceTextureRect.right());
         m_sourceTextureRect.setRight(left);
     }
+
+    updatePreferredSize();
+}
+
+void QDeclarativeVideoRendererBackend::updatePreferredSize()
+{
+    // Let the source know how large whole frames are shown, so that it can
+    // scale them down before they are handed to the surface.
+    QSizeF shownSize = m_renderedRect.size();
+    if (!qIsDefaultAspect(q->orientation()))
+        shownSize.transpose();
+
+    const qreal sourceWidth = qAbs(m_sourceTextureRect.width());
+    const qreal sourceHeight = qAbs(m_sourceTextureRect.height());
+    const QSize frameSize = m_surfaceFormat.frameSize();
+
+    QSize preferredSize;
+    if (sourceWidth > 0 && sourceHeight > 0 && !shownSize.isEmpty() && !frameSize.isEmpty()) {
+        const qreal ratio = q->window() ? q->window()->effectiveDevicePixelRatio() : qreal(1);
+        const qreal aspect = qreal(frameSize.width()) / frameSize.height();
+
+        // One scale factor for both directions, large enough for the more
+        // magnified one, so that the frame keeps its aspect ratio. The
+        // width is rounded up so that resizing the item does not
+        // renegotiate every frame.
+        const qreal width = qMax(shownSize.width() / sourceWidth,
+                                 shownSize.height() / sourceHeight * aspect) * ratio;
+        const int alignedWidth = (qCeil(width) + 15) & ~15;
+        preferredSize = QSize(alignedWidth, (qCeil(alignedWidth / aspect) + 1) & ~1);
+    }
+
+    if (m_preferredSize == preferredSize)
+        return;
+    m_preferredSize = preferredSize;
+
+    // Called from the render thread as well; the surface and the sink that
+    // watches its properties live in the GUI thread.
+    const QVariant value = preferredSize.isValid() ? QVariant(preferredSize) : QVariant();
+    QSGVideoItemSurface *surface = m_surface;
+    if (surface->thread() == QThread::currentThread()) {
+        surface->setProperty("_q_preferredSize", value);
+    } else {
+        QMetaObject::invokeMethod(surface, [surface, value] {
+            surface->setProperty("_q_preferredSize", value);
+        }, Qt::QueuedConnection);
+    }
 }
 
 QSGNode *QDeclarativeVideoRendererBackend::updatePaintNode(QSGNode *oldNode,
@@ -277,6 +325,19 @@ QSGNode *QDeclarativeVideoRendererBackend::updatePaintNode(QSGNode *oldNode,
 
     QMutexLocker lock(&m_frameMutex);
 
+    if (m_stopped.fetchAndStoreAcquire(0)) {
+        // The surface stopped: drop what the producer published before, and
+        // show the flush frame instead. The triple buffer has a single
+        // producer, so stop() must not publish into it itself.
+        QVideoFrame stale;
+        m_frames.take(&stale);
+        QMutexLocker flushLock(&m_flushMutex);
+        m_frame = m_frameOnFlush;
+        m_frameChanged = true;
+    } else if (m_frames.take(&m_frame)) {
+        m_frameChanged = true;
+    }
+
     if (!m_glContext) {
         m_glContext = QOpenGLContext::currentContext();
         m_surface->scheduleOpenGLContextUpdate();
@@ -367,11 +428,14 @@ QSGNode *QDeclarativeVideoRendererBackend::updatePaintNode(QSGNode *oldNode,
             flags |= QSGVideoNode::FrameFiltered;
         videoNode->setCurrentFrame(m_frame, flags);
 
-        if ((q->flushMode() == QDeclarativeVideoOutput::FirstFrame && !m_frameOnFlush.isValid())
+        if ((q->flushMode() == QDeclarativeVideoOutput::FirstFrame && !frameOnFlushValid())
             || q->flushMode() == QDeclarativeVideoOutput::LastFrame) {
-            m_frameOnFlush = m_surfaceFormat.handleType() == QAbstractVideoBuffer::NoHandle
+            // Convert outside of the lock, present() may be waiting for it
+            const QVideoFrame frameOnFlush = m_surfaceFormat.handleType() == QAbstractVideoBuffer::NoHandle
                 ? m_frame
-                : m_frame.image();
+                : QVideoFrame(m_frame.image());
+            QMutexLocker flushLock(&m_flushMutex);
+            m_frameOnFlush = frameOnFlush;
         }
 
         //don't keep the frame for more than really necessary
@@ -407,19 +471,38 @@ QOpenGLContext *QDeclarativeVideoRendererBackend::glContext() const
     return m_glContext;
 }
 
+bool QDeclarativeVideoRendererBackend::frameOnFlushValid()
+{
+    QMutexLocker lock(&m_flushMutex);
+    return m_frameOnFlush.isValid();
+}
+
+void QDeclarativeVideoRendererBackend::setFrameOnFlush(const QVideoFrame &frame)
+{
+    QMutexLocker lock(&m_flushMutex);
+    m_frameOnFlush = frame;
+}
+
 void QDeclarativeVideoRendererBackend::present(const QVideoFrame &frame)
 {
-    m_frameMutex.lock();
-    m_frame = frame.isValid() ? frame : m_frameOnFlush;
-    m_frameChanged = true;
-    m_frameMutex.unlock();
+    // Called on the producer thread; must not wait for a render pass in progress
+    if (frame.isValid()) {
+        m_frames.publish(frame);
+    } else {
+        QMutexLocker lock(&m_flushMutex);
+        m_frames.publish(m_frameOnFlush);
+    }
 
     q->update();
 }
 
 void QDeclarativeVideoRendererBackend::stop()
 {
-    present(QVideoFrame());
+    qCDebug(qLcVideo) << "Video surface stopped, frames presented:" << m_frames.publishedFrames()
+                      << "overwritten before display:" << m_frames.droppedFrames();
+    m_frames.resetCounters();
+    m_stopped.storeRelease(1);
+    q->update();
 }
 
 QSGVideoItemSurface::QSGVideoItemSurface(QDeclarativeVideoRendererBackend *backend, QObject *parent)
@@ -457,7 +540,7 @@ QList<QVideoFrame::PixelFormat> QSGVideoItemSurface::supportedPixelFormats(
 bool QSGVideoItemSurface::start(const QVideoSurfaceFormat &format)
 {
     qCDebug(qLcVideo) << "Video surface format:" << format << "all supported formats:" << supportedPixelFormats(format.handleType());
-    m_backend->m_frameOnFlush = QVideoFrame();
+    m_backend->setFrameOnFlush(QVideoFrame());
 
     if (!supportedPixelFormats(format.handleType()).contains(format.pixelFormat()))
         return false;
@@ -56,6 +56,7 @@
 #include <private/qsgvideonode_yuv_p.h>
 #include <private/qsgvideonode_rgb_p.h>
 #include <private/qsgvideonode_texture_p.h>
+#include <private/qvideoframetriplebuffer_p.h>
 
 #include <QtCore/qmutex.h>
 #include <QtMultimedia/qabstractvideosurface.h>
@@ -96,19 +97,26 @@ public:
 
 private:
     void scheduleDeleteFilterResources();
+    void updatePreferredSize();
+    bool frameOnFlushValid();
+    void setFrameOnFlush(const QVideoFrame &frame);
 
     QPointer<QVideoRendererControl> m_rendererControl;
     QList<QSGVideoNodeFactoryInterface*> m_videoNodeFactories;
     QSGVideoItemSurface *m_surface;
     QVideoSurfaceFormat m_surfaceFormat;
     QOpenGLContext *m_glContext;
-    QVideoFrame m_frame;
+    QVideoFrameTripleBuffer m_frames;  // producer -> render thread, never blocks
+    QVideoFrame m_frame;               // render thread only
     QVideoFrame m_frameOnFlush;
-    bool m_frameChanged;
+    QAtomicInt m_stopped;              // set by stop(), cleared by the render thread
+    bool m_frameChanged;               // render thread only
     QSGVideoNodeFactory_YUV m_i420Factory;
     QSGVideoNodeFactory_RGB m_rgbFactory;
     QSGVideoNodeFactory_Texture m_textureFactory;
-    QMutex m_frameMutex;
+    QMutex m_frameMutex;               // filters and render state
+    QMutex m_flushMutex;               // m_frameOnFlush only
+    QSize m_preferredSize;         // Last size hinted to the surface
     QRectF m_renderedRect;         // Destination pixel coordinates, clipped
     QRectF m_sourceTextureRect;    // Source texture coordinates
 
@@ -37,6 +37,7 @@
 **
 ****************************************************************************/
 #include "qsgvideonode_rgb_p.h"
+#include "qsgvideotexturecache_p.h"
 #include <QtQuick/qsgtexturematerial.h>
 #include <QtQuick/qsgmaterial.h>
 #include <QtCore/qmutex.h>
@@ -134,6 +135,8 @@ class QSGVideoMaterial_RGB : public QSGMaterial
 public:
     QSGVideoMaterial_RGB(const QVideoSurfaceFormat &format) :
         m_format(format),
+        m_textures(nullptr),
+        m_pendingTextures(nullptr),
         m_textureId(0),
         m_opacity(1.0),
         m_width(1.0)
@@ -143,8 +146,9 @@ public:
 
     ~QSGVideoMaterial_RGB()
     {
-        if (m_textureId)
-            QOpenGLContext::currentContext()->functions()->glDeleteTextures(1, &m_textureId);
+        QSGVideoTextureCache::release(m_textures);
+        QSGVideoTextureCache::frameDone(m_pendingTextures);
+        QSGVideoTextureCache::release(m_pendingTextures);
     }
 
     QSGMaterialType *type() const override {
@@ -174,74 +178,108 @@ public:
     void setVideoFrame(const QVideoFrame &frame) {
         QMutexLocker lock(&m_frameMutex);
         m_frame = frame;
+
+        // Look the texture up right away, so that other nodes showing the
+        // same frame find it until all of them have bound the frame
+        QSGVideoTextureCache::frameDone(m_pendingTextures);
+        QSGVideoTextureCache::release(m_pendingTextures);
+        m_pendingTextures = nullptr;
+        if (m_frame.isValid()) {
+            if (QSGVideoTextureCache *cache = QSGVideoTextureCache::instance(QOpenGLContext::currentContext()))
+                m_pendingTextures = cache->acquire(m_frame, 1);
+        }
     }
 
     void bind()
     {
-        QOpenGLFunctions *functions = QOpenGLContext::currentContext()->functions();
+        QOpenGLContext *context = QOpenGLContext::currentContext();
+        QOpenGLFunctions *functions = context->functions();
 
         QMutexLocker lock(&m_frameMutex);
         if (m_frame.isValid()) {
-            if (m_frame.map(QAbstractVideoBuffer::ReadOnly)) {
-                QSize textureSize = m_frame.size();
-
-                int stride = m_frame.bytesPerLine();
-                switch (m_frame.pixelFormat()) {
-                case QVideoFrame::Format_RGB565:
-                    stride /= 2;
-                    break;
-                default:
-                    stride /= 4;
-                }
-
-                m_width = qreal(m_frame.width()) / stride;
-                textureSize.setWidth(stride);
-
-                if (m_textureSize != textureSize) {
-                    if (!m_textureSize.isEmpty())
-                        functions->glDeleteTextures(1, &m_textureId);
-                    functions->glGenTextures(1, &m_textureId);
-                    m_textureSize = textureSize;
-                }
-
-                GLint dataType = GL_UNSIGNED_BYTE;
-                GLint dataFormat = GL_RGBA;
-
-                if (m_frame.pixelFormat() == QVideoFrame::Format_RGB565) {
-                    dataType = GL_UNSIGNED_SHORT_5_6_5;
-                    dataFormat = GL_RGB;
-                }
-
-                GLint previousAlignment;
-                functions->glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
-                functions->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-                functions->glActiveTexture(GL_TEXTURE0);
-                functions->glBindTexture(GL_TEXTURE_2D, m_textureId);
-                functions->glTexImage2D(GL_TEXTURE_2D, 0, dataFormat,
-                                        m_textureSize.width(), m_textureSize.height(),
-                                        0, dataFormat, dataType, m_frame.bits());
-
-                functions->glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
-
-                functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-                functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-                m_frame.unmap();
+            QSGVideoTextureCache::Entry *textures = m_pendingTextures;
+            m_pendingTextures = nullptr;
+            if (!textures)
+                textures = QSGVideoTextureCache::instance(context)->acquire(m_frame, 1);
+
+            // Only the first node to bind a shared frame uploads it
+            if (!textures->uploaded)
+                textures->uploaded = uploadFrame(textures);
+            QSGVideoTextureCache::frameDone(textures);
+            if (!textures->uploaded) {
+                QSGVideoTextureCache::release(textures);
+                textures = nullptr;
+            }
+
+            if (textures) {
+                QSGVideoTextureCache::release(m_textures);
+                m_textures = textures;
+                m_textureId = textures->textureIds[0];
+                m_width = textures->planeWidth[0];
             }
             m_frame = QVideoFrame();
-        } else {
-            functions->glActiveTexture(GL_TEXTURE0);
-            functions->glBindTexture(GL_TEXTURE_2D, m_textureId);
         }
+
+        functions->glActiveTexture(GL_TEXTURE0);
+        functions->glBindTexture(GL_TEXTURE_2D, m_textureId);
+    }
+
+    bool uploadFrame(QSGVideoTextureCache::Entry *textures)
+    {
+        if (!m_frame.map(QAbstractVideoBuffer::ReadOnly))
+            return false;
+
+        QOpenGLFunctions *functions = QOpenGLContext::currentContext()->functions();
+
+        QSize textureSize = m_frame.size();
+
+        int stride = m_frame.bytesPerLine();
+        switch (m_frame.pixelFormat()) {
+        case QVideoFrame::Format_RGB565:
+            stride /= 2;
+            break;
+        default:
+            stride /= 4;
+        }
+
+        textures->planeWidth[0] = qreal(m_frame.width()) / stride;
+        textureSize.setWidth(stride);
+
+        GLint dataType = GL_UNSIGNED_BYTE;
+        GLint dataFormat = GL_RGBA;
+
+        if (m_frame.pixelFormat() == QVideoFrame::Format_RGB565) {
+            dataType = GL_UNSIGNED_SHORT_5_6_5;
+            dataFormat = GL_RGB;
+        }
+
+        GLint previousAlignment;
+        functions->glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+        functions->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        functions->glActiveTexture(GL_TEXTURE0);
+        functions->glBindTexture(GL_TEXTURE_2D, textures->textureIds[0]);
+        functions->glTexImage2D(GL_TEXTURE_2D, 0, dataFormat,
+                                textureSize.width(), textureSize.height(),
+                                0, dataFormat, dataType, m_frame.bits());
+
+        functions->glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+
+        functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        functions->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        m_frame.unmap();
+        return true;
     }
 
     QVideoFrame m_frame;
     QMutex m_frameMutex;
-    QSize m_textureSize;
     QVideoSurfaceFormat m_format;
+    QSGVideoTextureCache::Entry *m_textures;
+    // Texture for m_frame, shared with other nodes handed the same frame
+    QSGVideoTextureCache::Entry *m_pendingTextures;
     GLuint m_textureId;
     qreal m_opacity;
     GLfloat m_width;
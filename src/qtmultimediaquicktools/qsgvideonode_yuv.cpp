@@ -37,6 +37,7 @@
 **
 ****************************************************************************/
 #include "qsgvideonode_yuv_p.h"
+#include "qsgvideotexturecache_p.h"
 #include <QtCore/qmutex.h>
 #include <QtQuick/qsgtexturematerial.h>
 #include <QtQuick/qsgmaterial.h>
@@ -273,16 +274,16 @@ public:
         setFlag(Blending, qFuzzyCompare(m_opacity, qreal(1.0)) ? false : true);
     }
 
-    void setCurrentFrame(const QVideoFrame &frame) {
-        QMutexLocker lock(&m_frameMutex);
-        m_frame = frame;
-    }
+    void setCurrentFrame(const QVideoFrame &frame);
 
     void bind();
+    bool uploadFrame(QSGVideoTextureCache::Entry *textures);
     void bindTexture(int id, int w, int h, const uchar *bits, GLenum format);
 
     QVideoSurfaceFormat m_format;
-    QSize m_textureSize;
+    QSGVideoTextureCache::Entry *m_textures;
+    // Textures for m_frame, shared with other nodes handed the same frame
+    QSGVideoTextureCache::Entry *m_pendingTextures;
     int m_planeCount;
 
     GLuint m_textureIds[3];
@@ -297,6 +298,8 @@ public:
 
 QSGVideoMaterial_YUV::QSGVideoMaterial_YUV(const QVideoSurfaceFormat &format) :
     m_format(format),
+    m_textures(nullptr),
+    m_pendingTextures(nullptr),
     m_opacity(1.0)
 {
     memset(m_textureIds, 0, sizeof(m_textureIds));
@@ -347,98 +350,138 @@ QSGVideoMaterial_YUV::QSGVideoMaterial_YUV(const QVideoSurfaceFormat &format) :
 
 QSGVideoMaterial_YUV::~QSGVideoMaterial_YUV()
 {
-    if (!m_textureSize.isEmpty()) {
-        if (QOpenGLContext *current = QOpenGLContext::currentContext())
-            current->functions()->glDeleteTextures(m_planeCount, m_textureIds);
-        else
-            qWarning() << "QSGVideoMaterial_YUV: Cannot obtain GL context, unable to delete textures";
+    if (m_textures && !QOpenGLContext::currentContext())
+        qWarning() << "QSGVideoMaterial_YUV: Cannot obtain GL context, unable to delete textures";
+    QSGVideoTextureCache::release(m_textures);
+    QSGVideoTextureCache::frameDone(m_pendingTextures);
+    QSGVideoTextureCache::release(m_pendingTextures);
+}
+
+void QSGVideoMaterial_YUV::setCurrentFrame(const QVideoFrame &frame)
+{
+    QMutexLocker lock(&m_frameMutex);
+    m_frame = frame;
+
+    // Frames are handed to the nodes on the render thread, so the textures
+    // can be looked up right away. Other nodes showing the same frame then
+    // find them until the frame is bound by all of them.
+    QSGVideoTextureCache::frameDone(m_pendingTextures);
+    QSGVideoTextureCache::release(m_pendingTextures);
+    m_pendingTextures = nullptr;
+    if (m_frame.isValid()) {
+        if (QSGVideoTextureCache *cache = QSGVideoTextureCache::instance(QOpenGLContext::currentContext()))
+            m_pendingTextures = cache->acquire(m_frame, m_planeCount);
     }
 }
 
 void QSGVideoMaterial_YUV::bind()
 {
-    QOpenGLFunctions *functions = QOpenGLContext::currentContext()->functions();
-    QSurfaceFormat::OpenGLContextProfile profile = QOpenGLContext::currentContext()->format().profile();
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    QOpenGLFunctions *functions = context->functions();
 
     QMutexLocker lock(&m_frameMutex);
     if (m_frame.isValid()) {
-        if (m_frame.map(QAbstractVideoBuffer::ReadOnly)) {
-            int fw = m_frame.width();
-            int fh = m_frame.height();
-
-            // Frame has changed size, recreate textures...
-            if (m_textureSize != m_frame.size()) {
-                if (!m_textureSize.isEmpty())
-                    functions->glDeleteTextures(m_planeCount, m_textureIds);
-                functions->glGenTextures(m_planeCount, m_textureIds);
-                m_textureSize = m_frame.size();
-            }
+        QSGVideoTextureCache::Entry *textures = m_pendingTextures;
+        m_pendingTextures = nullptr;
+        if (!textures)
+            textures = QSGVideoTextureCache::instance(context)->acquire(m_frame, m_planeCount);
+
+        // Only the first node to bind a shared frame uploads it
+        if (!textures->uploaded)
+            textures->uploaded = uploadFrame(textures);
+        QSGVideoTextureCache::frameDone(textures);
+        if (!textures->uploaded) {
+            QSGVideoTextureCache::release(textures);
+            textures = nullptr;
+        }
 
-            GLint previousAlignment;
-            const GLenum texFormat1 = (profile == QSurfaceFormat::CoreProfile) ? GL_RED : GL_LUMINANCE;
-            const GLenum texFormat2 = (profile == QSurfaceFormat::CoreProfile) ? GL_RG : GL_LUMINANCE_ALPHA;
-
-            functions->glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
-            functions->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-             if (m_format.pixelFormat() == QVideoFrame::Format_UYVY
-              || m_format.pixelFormat() == QVideoFrame::Format_YUYV) {
-                int fw = m_frame.width();
-
-                m_planeWidth[0] = fw;
-                 // In YUYV texture the UV plane appears with the 1/2 of image and Y width.
-                m_planeWidth[1] = fw / 2;
-                functions->glActiveTexture(GL_TEXTURE1);
-                // Either r,b (YUYV) or g,a (UYVY) values are used as source of UV.
-                // Additionally U and V are set per 2 pixels hence only 1/2 of image width is used.
-                // Interpreting this properly in shaders allows to not copy or not make conditionals inside shaders,
-                // only interpretation of data changes.
-                bindTexture(m_textureIds[1], m_planeWidth[1], m_frame.height(), m_frame.bits(), GL_RGBA);
-                functions->glActiveTexture(GL_TEXTURE0); // Finish with 0 as default texture unit
-                // Either red (YUYV) or alpha (UYVY) values are used as source of Y
-                bindTexture(m_textureIds[0], m_planeWidth[0], m_frame.height(), m_frame.bits(), texFormat2);
-            } else if (m_format.pixelFormat() == QVideoFrame::Format_NV12
-                    || m_format.pixelFormat() == QVideoFrame::Format_NV21) {
-                const int y = 0;
-                const int uv = 1;
-
-                m_planeWidth[0] = m_planeWidth[1] = qreal(fw) / m_frame.bytesPerLine(y);
-
-                functions->glActiveTexture(GL_TEXTURE1);
-                bindTexture(m_textureIds[1], m_frame.bytesPerLine(uv) / 2, fh / 2, m_frame.bits(uv), texFormat2);
-                functions->glActiveTexture(GL_TEXTURE0); // Finish with 0 as default texture unit
-                bindTexture(m_textureIds[0], m_frame.bytesPerLine(y), fh, m_frame.bits(y), texFormat1);
-
-            } else { // YUV420P || YV12 || YUV422P
-                const int y = 0;
-                const int u = m_frame.pixelFormat() == QVideoFrame::Format_YV12 ? 2 : 1;
-                const int v = m_frame.pixelFormat() == QVideoFrame::Format_YV12 ? 1 : 2;
-
-                m_planeWidth[0] = qreal(fw) / m_frame.bytesPerLine(y);
-                m_planeWidth[1] = m_planeWidth[2] = qreal(fw) / (2 * m_frame.bytesPerLine(u));
-
-                const int uvHeight = m_frame.pixelFormat() == QVideoFrame::Format_YUV422P ? fh : fh / 2;
-
-                functions->glActiveTexture(GL_TEXTURE1);
-                bindTexture(m_textureIds[1], m_frame.bytesPerLine(u), uvHeight, m_frame.bits(u), texFormat1);
-                functions->glActiveTexture(GL_TEXTURE2);
-                bindTexture(m_textureIds[2], m_frame.bytesPerLine(v), uvHeight, m_frame.bits(v), texFormat1);
-                functions->glActiveTexture(GL_TEXTURE0); // Finish with 0 as default texture unit
-                bindTexture(m_textureIds[0], m_frame.bytesPerLine(y), fh, m_frame.bits(y), texFormat1);
+        if (textures) {
+            QSGVideoTextureCache::release(m_textures);
+            m_textures = textures;
+            for (int i = 0; i < m_planeCount; ++i) {
+                m_textureIds[i] = textures->textureIds[i];
+                m_planeWidth[i] = textures->planeWidth[i];
             }
-
-            functions->glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
-            m_frame.unmap();
         }
 
         m_frame = QVideoFrame();
-    } else {
-        // Go backwards to finish with GL_TEXTURE0
-        for (int i = m_planeCount - 1; i >= 0; --i) {
-            functions->glActiveTexture(GL_TEXTURE0 + i);
-            functions->glBindTexture(GL_TEXTURE_2D, m_textureIds[i]);
-        }
     }
+
+    // Go backwards to finish with GL_TEXTURE0
+    for (int i = m_planeCount - 1; i >= 0; --i) {
+        functions->glActiveTexture(GL_TEXTURE0 + i);
+        functions->glBindTexture(GL_TEXTURE_2D, m_textureIds[i]);
+    }
+}
+
+bool QSGVideoMaterial_YUV::uploadFrame(QSGVideoTextureCache::Entry *textures)
+{
+    if (!m_frame.map(QAbstractVideoBuffer::ReadOnly))
+        return false;
+
+    QOpenGLFunctions *functions = QOpenGLContext::currentContext()->functions();
+    QSurfaceFormat::OpenGLContextProfile profile = QOpenGLContext::currentContext()->format().profile();
+
+    const GLuint *textureIds = textures->textureIds;
+    GLfloat *planeWidth = textures->planeWidth;
+
+    int fw = m_frame.width();
+    int fh = m_frame.height();
+
+    GLint previousAlignment;
+    const GLenum texFormat1 = (profile == QSurfaceFormat::CoreProfile) ? GL_RED : GL_LUMINANCE;
+    const GLenum texFormat2 = (profile == QSurfaceFormat::CoreProfile) ? GL_RG : GL_LUMINANCE_ALPHA;
+
+    functions->glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+    functions->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    if (m_format.pixelFormat() == QVideoFrame::Format_UYVY
+     || m_format.pixelFormat() == QVideoFrame::Format_YUYV) {
+        planeWidth[0] = fw;
+        // In YUYV texture the UV plane appears with the 1/2 of image and Y width.
+        planeWidth[1] = fw / 2;
+        functions->glActiveTexture(GL_TEXTURE1);
+        // Either r,b (YUYV) or g,a (UYVY) values are used as source of UV.
+        // Additionally U and V are set per 2 pixels hence only 1/2 of image width is used.
+        // Interpreting this properly in shaders allows to not copy or not make conditionals inside shaders,
+        // only interpretation of data changes.
+        bindTexture(textureIds[1], planeWidth[1], m_frame.height(), m_frame.bits(), GL_RGBA);
+        functions->glActiveTexture(GL_TEXTURE0); // Finish with 0 as default texture unit
+        // Either red (YUYV) or alpha (UYVY) values are used as source of Y
+        bindTexture(textureIds[0], planeWidth[0], m_frame.height(), m_frame.bits(), texFormat2);
+    } else if (m_format.pixelFormat() == QVideoFrame::Format_NV12
+            || m_format.pixelFormat() == QVideoFrame::Format_NV21) {
+        const int y = 0;
+        const int uv = 1;
+
+        planeWidth[0] = planeWidth[1] = qreal(fw) / m_frame.bytesPerLine(y);
+
+        functions->glActiveTexture(GL_TEXTURE1);
+        bindTexture(textureIds[1], m_frame.bytesPerLine(uv) / 2, fh / 2, m_frame.bits(uv), texFormat2);
+        functions->glActiveTexture(GL_TEXTURE0); // Finish with 0 as default texture unit
+        bindTexture(textureIds[0], m_frame.bytesPerLine(y), fh, m_frame.bits(y), texFormat1);
+
+    } else { // YUV420P || YV12 || YUV422P
+        const int y = 0;
+        const int u = m_frame.pixelFormat() == QVideoFrame::Format_YV12 ? 2 : 1;
+        const int v = m_frame.pixelFormat() == QVideoFrame::Format_YV12 ? 1 : 2;
+
+        planeWidth[0] = qreal(fw) / m_frame.bytesPerLine(y);
+        planeWidth[1] = planeWidth[2] = qreal(fw) / (2 * m_frame.bytesPerLine(u));
+
+        const int uvHeight = m_frame.pixelFormat() == QVideoFrame::Format_YUV422P ? fh : fh / 2;
+
+        functions->glActiveTexture(GL_TEXTURE1);
+        bindTexture(textureIds[1], m_frame.bytesPerLine(u), uvHeight, m_frame.bits(u), texFormat1);
+        functions->glActiveTexture(GL_TEXTURE2);
+        bindTexture(textureIds[2], m_frame.bytesPerLine(v), uvHeight, m_frame.bits(v), texFormat1);
+        functions->glActiveTexture(GL_TEXTURE0); // Finish with 0 as default texture unit
+        bindTexture(textureIds[0], m_frame.bytesPerLine(y), fh, m_frame.bits(y), texFormat1);
+    }
+
+    functions->glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+    m_frame.unmap();
+    return true;
 }
 
 void QSGVideoMaterial_YUV::bindTexture(int id, int w, int h, const uchar *bits, GLenum format)
@@ -0,0 +1,174 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgvideotexturecache_p.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtGui/qopenglcontext.h>
+#include <QtGui/qopenglfunctions.h>
+
+QT_BEGIN_NAMESPACE
+
+// Textures kept around for the next frames, enough for one frame of each
+// plane layout
+static const int MaxFreeTextures = 2 * QSGVideoTextureCache::MaxPlanes;
+
+typedef QHash<QOpenGLContext *, QSGVideoTextureCache *> QSGVideoTextureCaches;
+Q_GLOBAL_STATIC(QSGVideoTextureCaches, textureCaches)
+Q_GLOBAL_STATIC(QMutex, textureCachesMutex)
+
+QSGVideoTextureCache *QSGVideoTextureCache::instance(QOpenGLContext *context)
+{
+    if (!context)
+        return nullptr;
+
+    QMutexLocker locker(textureCachesMutex());
+
+    QSGVideoTextureCache *&cache = (*textureCaches())[context];
+    if (!cache) {
+        cache = new QSGVideoTextureCache;
+        QObject::connect(context, &QOpenGLContext::aboutToBeDestroyed, [context] {
+            QSGVideoTextureCache *cache = nullptr;
+            {
+                QMutexLocker locker(textureCachesMutex());
+                cache = textureCaches()->take(context);
+            }
+            if (cache)
+                cache->invalidate();
+        });
+    }
+
+    return cache;
+}
+
+QSGVideoTextureCache::~QSGVideoTextureCache()
+{
+    Q_ASSERT(m_entries.isEmpty());
+}
+
+QSGVideoTextureCache::Entry *QSGVideoTextureCache::acquire(const QVideoFrame &frame,
+                                                           int planeCount)
+{
+    Q_ASSERT(planeCount > 0 && planeCount <= MaxPlanes);
+
+    // Entries without a frame are no longer matched; their frame may be gone
+    // and a new one could have taken its place.
+    for (Entry *entry : qAsConst(m_entries)) {
+        if (entry->waiting > 0 && entry->frame == frame && entry->planeCount == planeCount) {
+            ++entry->refs;
+            ++entry->waiting;
+            return entry;
+        }
+    }
+
+    Entry *entry = new Entry;
+    entry->frame = frame;
+    entry->planeCount = planeCount;
+    entry->uploaded = false;
+    entry->cache = this;
+    entry->refs = 1;
+    entry->waiting = 1;
+    for (int i = 0; i < MaxPlanes; ++i) {
+        entry->textureIds[i] = 0;
+        entry->planeWidth[i] = 1;
+    }
+
+    const int reused = qMin(planeCount, m_freeTextures.size());
+    for (int i = 0; i < reused; ++i)
+        entry->textureIds[i] = m_freeTextures.takeLast();
+    if (reused < planeCount) {
+        QOpenGLContext::currentContext()->functions()->glGenTextures(
+                    planeCount - reused, entry->textureIds + reused);
+    }
+
+    m_entries.append(entry);
+    return entry;
+}
+
+void QSGVideoTextureCache::frameDone(Entry *entry)
+{
+    if (!entry)
+        return;
+
+    Q_ASSERT(entry->waiting > 0);
+    if (--entry->waiting == 0)
+        entry->frame = QVideoFrame();
+}
+
+void QSGVideoTextureCache::release(Entry *entry)
+{
+    if (!entry || --entry->refs > 0)
+        return;
+
+    Q_ASSERT(entry->waiting == 0);
+
+    QSGVideoTextureCache *cache = entry->cache;
+    cache->m_entries.removeOne(entry);
+
+    if (cache->m_valid) {
+        for (int i = 0; i < entry->planeCount; ++i)
+            cache->m_freeTextures.append(entry->textureIds[i]);
+
+        const int excess = cache->m_freeTextures.size() - MaxFreeTextures;
+        if (excess > 0) {
+            if (QOpenGLContext *current = QOpenGLContext::currentContext())
+                current->functions()->glDeleteTextures(excess, cache->m_freeTextures.constData());
+            cache->m_freeTextures.remove(0, excess);
+        }
+    }
+
+    delete entry;
+
+    if (!cache->m_valid && cache->m_entries.isEmpty())
+        delete cache;
+}
+
+void QSGVideoTextureCache::invalidate()
+{
+    // The textures go away with the context; entries still referenced by
+    // video materials keep the cache alive until they are released.
+    m_valid = false;
+    m_freeTextures.clear();
+
+    if (m_entries.isEmpty())
+        delete this;
+}
+
+QT_END_NAMESPACE
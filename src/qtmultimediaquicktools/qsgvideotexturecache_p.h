@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSGVIDEOTEXTURECACHE_P_H
+#define QSGVIDEOTEXTURECACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qvector.h>
+#include <QtGui/qopengl.h>
+#include <QtMultimedia/qvideoframe.h>
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLContext;
+
+// Textures of the video frames shown in one GL context.
+//
+// Video nodes that show the same frame, e.g. several VideoOutputs fed by
+// one player, share its textures instead of each uploading a copy. Nodes
+// acquire the textures when they are handed the frame, and only the first
+// of them to bind it uploads it.
+//
+// An entry only holds on to its frame while some node was handed the frame
+// but has not bound it yet, and such a node holds the frame anyway. Textures
+// that are shown don't keep decoder buffers alive.
+class QSGVideoTextureCache
+{
+public:
+    enum { MaxPlanes = 3 };
+
+    struct Entry
+    {
+        QVideoFrame frame;
+        int planeCount;
+        bool uploaded;
+        GLuint textureIds[MaxPlanes];
+        // Parameters derived from the frame layout while uploading
+        GLfloat planeWidth[MaxPlanes];
+        QSGVideoTextureCache *cache;
+        int refs;
+        // Nodes that acquired the entry and have not called frameDone()
+        int waiting;
+    };
+
+    static QSGVideoTextureCache *instance(QOpenGLContext *context);
+
+    // Returns the textures of the frame. Unless they are uploaded already,
+    // the caller has to upload the frame into them and set uploaded. Once
+    // the caller doesn't need the frame any more, it calls frameDone().
+    Entry *acquire(const QVideoFrame &frame, int planeCount);
+    static void frameDone(Entry *entry);
+    static void release(Entry *entry);
+
+private:
+    QSGVideoTextureCache() = default;
+    ~QSGVideoTextureCache();
+
+    void invalidate();
+
+    QVector<Entry *> m_entries;
+    QVector<GLuint> m_freeTextures;
+    bool m_valid = true;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSGVIDEOTEXTURECACHE_P_H
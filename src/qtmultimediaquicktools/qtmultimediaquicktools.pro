@@ -22,11 +22,13 @@ qtConfig(opengl) {
     SOURCES += qdeclarativevideooutput_render.cpp \
                qsgvideonode_rgb.cpp \
                qsgvideonode_yuv.cpp \
-               qsgvideonode_texture.cpp
+               qsgvideonode_texture.cpp \
+               qsgvideotexturecache.cpp
     HEADERS += qdeclarativevideooutput_render_p.h \
                qsgvideonode_rgb_p.h \
                qsgvideonode_yuv_p.h \
-               qsgvideonode_texture_p.h
+               qsgvideonode_texture_p.h \
+               qsgvideotexturecache_p.h
 }
 
 RESOURCES += \
@@ -29,6 +29,7 @@
 #include <QtTest/QtTest>
 #include <QDebug>
 #include "qaudiodecoder.h"
+#include "qaudiobatchdecoder.h"
 
 #include "../shared/mediafileselector.h"
 
@@ -58,6 +59,8 @@ private slots:
     void unsupportedFileTest();
     void corruptedFileTest();
     void deviceTest();
+    void restartAfterStopTest();
+    void batchDecodeTest();
 
 private:
     bool isWavSupported();
@@ -566,6 +569,126 @@ void tst_QAudioDecoderBackend::deviceTest()
     QCOMPARE(d.duration(), qint64(-1));
 }
 
+/*
+ Stopping in the middle of a file and starting the next one reuses the
+ pipeline. Nothing left over from the stopped file, like its READY state
+ change or an EOS, may end or stop the next one early.
+*/
+void tst_QAudioDecoderBackend::restartAfterStopTest()
+{
+    if (!isWavSupported())
+        QSKIP("Sound format is not supported");
+
+    QAudioDecoder d;
+    if (d.error() == QAudioDecoder::ServiceMissingError)
+        QSKIP("There is no audio decoding support on this platform.");
+
+    const QString fileName = QFileInfo(QFINDTESTDATA(TEST_FILE_NAME)).absoluteFilePath();
+
+    for (int i = 0; i < 3; ++i) {
+        d.setSourceFilename(fileName);
+        d.start();
+        QTRY_VERIFY(d.bufferAvailable());
+        QVERIFY(d.read().isValid());
+
+        d.stop();
+        QTRY_COMPARE(d.state(), QAudioDecoder::StoppedState);
+        QVERIFY(!d.bufferAvailable());
+
+        QSignalSpy errorSpy(&d, SIGNAL(error(QAudioDecoder::Error)));
+        QSignalSpy stateSpy(&d, SIGNAL(stateChanged(QAudioDecoder::State)));
+        QSignalSpy finishedSpy(&d, SIGNAL(finished()));
+
+        d.setSourceFilename(fileName);
+        d.start();
+        QTRY_COMPARE(d.state(), QAudioDecoder::DecodingState);
+
+        // Test file is 44.1K 16bit mono, 44094 samples
+        int sampleCount = 0;
+        while (sampleCount < 44094) {
+            QTRY_VERIFY(d.bufferAvailable() || !finishedSpy.isEmpty());
+            if (!d.bufferAvailable())
+                break;
+            const QAudioBuffer buffer = d.read();
+            QVERIFY(buffer.isValid());
+            sampleCount += buffer.sampleCount();
+            QCOMPARE(d.state(), QAudioDecoder::DecodingState);
+        }
+
+        QCOMPARE(sampleCount, 44094);
+        QTRY_COMPARE(finishedSpy.count(), 1);
+        QTRY_COMPARE(d.state(), QAudioDecoder::StoppedState);
+        QCOMPARE(stateSpy.count(), 2);
+        QCOMPARE(stateSpy.at(0).at(0).value<QAudioDecoder::State>(), QAudioDecoder::DecodingState);
+        QCOMPARE(stateSpy.at(1).at(0).value<QAudioDecoder::State>(), QAudioDecoder::StoppedState);
+        QVERIFY(errorSpy.isEmpty());
+
+        d.stop();
+    }
+}
+
+void tst_QAudioDecoderBackend::batchDecodeTest()
+{
+    if (!isWavSupported())
+        QSKIP("Sound format is not supported");
+
+    QAudioDecoder d;
+    if (d.error() == QAudioDecoder::ServiceMissingError)
+        QSKIP("There is no audio decoding support on this platform.");
+
+    const QString fileName = QFileInfo(QFINDTESTDATA(TEST_FILE_NAME)).absoluteFilePath();
+    const QString unsupportedFileName = QFileInfo(QFINDTESTDATA(TEST_UNSUPPORTED_FILE_NAME)).absoluteFilePath();
+
+    QAudioBatchDecoder decoder;
+    decoder.setMaximumWorkerCount(2);
+    decoder.setFramesPerBuffer(1000);
+    QCOMPARE(decoder.maximumWorkerCount(), 2);
+
+    QMutex mutex;
+    QHash<int, int> frameCounts;
+    QHash<int, int> oversized;
+    decoder.setBufferHandler([&](int index, const QAudioBuffer &buffer) {
+        QMutexLocker locker(&mutex);
+        frameCounts[index] += buffer.frameCount();
+        if (buffer.frameCount() > 1000)
+            oversized[index]++;
+    });
+
+    QSignalSpy fileFinishedSpy(&decoder, SIGNAL(fileFinished(int,QString,QAudioDecoder::Error)));
+    QSignalSpy finishedSpy(&decoder, SIGNAL(finished()));
+
+    // More files than workers, so decoders are reused
+    const QStringList fileNames = QStringList() << fileName << fileName << unsupportedFileName
+                                                << fileName << fileName;
+    QCOMPARE(decoder.decode(fileNames), 0);
+    QVERIFY(decoder.waitForFinished(30000));
+    QVERIFY(!decoder.isDecoding());
+    QCOMPARE(decoder.pendingCount(), 0);
+
+    QTRY_COMPARE(fileFinishedSpy.count(), fileNames.size());
+    QTRY_COMPARE(finishedSpy.count(), 1);
+
+    for (const QList<QVariant> &arguments : qAsConst(fileFinishedSpy)) {
+        const int index = arguments.at(0).toInt();
+        QCOMPARE(arguments.at(1).toString(), fileNames.at(index));
+        const auto error = arguments.at(2).value<QAudioDecoder::Error>();
+        if (index == 2) {
+            QVERIFY(error != QAudioDecoder::NoError);
+        } else {
+            QCOMPARE(error, QAudioDecoder::NoError);
+            // Test file is 44.1K 16bit mono, 44094 samples
+            QCOMPARE(frameCounts.value(index), 44094);
+        }
+    }
+    QVERIFY(oversized.isEmpty());
+
+    // Indexes continue across batches
+    QCOMPARE(decoder.decode(QStringList() << fileName), int(fileNames.size()));
+    decoder.cancel();
+    QVERIFY(decoder.waitForFinished(30000));
+    QCOMPARE(decoder.pendingCount(), 0);
+}
+
 QTEST_MAIN(tst_QAudioDecoderBackend)
 
 #include "tst_qaudiodecoderbackend.moc"
@@ -1,5 +1,7 @@
 
 TEMPLATE = subdirs
+QT_FOR_CONFIG += multimedia-private
+
 SUBDIRS += \
     qabstractvideobuffer \
     qabstractvideosurface \
@@ -16,6 +18,7 @@ SUBDIRS += \
     qmediaplayer \
     qmediaplaylist \
     qmediaplaylistnavigator \
+    qplaylisttokenizer \
     qmediapluginloader \
     qmediarecorder \
     qmediaresource \
@@ -28,10 +31,22 @@ SUBDIRS += \
     qradiotuner \
     qvideoencodersettingscontrol \
     qvideoframe \
+    qvideosurfaces \
     qvideosurfaceformat \
     qwavedecoder \
     qaudiobuffer \
+    qaudioresampler \
+    qaudioconvertingoutput \
     qaudiodecoder \
     qaudioprobe \
     qvideoprobe \
     qsamplecache
+
+qtConfig(gstreamer_1_0): SUBDIRS += \
+    qgstreamerplaybackclock \
+    qgstreamerprerollbuffer \
+    qgstreamersegmentcontrol \
+    qgstvideorenderersink
+
+qtConfig(gstreamer_1_0):qtConfig(gstreamer_app): SUBDIRS += \
+    qgstreamerframeextractor
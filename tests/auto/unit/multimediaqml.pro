@@ -1,9 +1,14 @@
 
 TEMPLATE = subdirs
+QT_FOR_CONFIG += multimedia-private
+
 SUBDIRS += \
     qdeclarativemultimediaglobal \
     qdeclarativeaudio \
-    qdeclarativecamera
+    qdeclarativecamera \
+    qsgvideotexturecache
+
+qtConfig(openal): SUBDIRS += qsoundemittertable
 
 disabled {
     SUBDIRS += \
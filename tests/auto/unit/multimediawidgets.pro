@@ -4,6 +4,7 @@ SUBDIRS += \
     qcameraviewfinder \
     qcamerawidgets \
     qmediaplayerwidgets \
+    qvideoframescaling \
 
 # Tests depending on private interfaces should only be built if
 # these interfaces are exported.
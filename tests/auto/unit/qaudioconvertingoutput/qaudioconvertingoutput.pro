@@ -0,0 +1,14 @@
+CONFIG += testcase
+TARGET = tst_qaudioconvertingoutput
+
+QT += core multimedia-private testlib
+
+AUDIO = ../../../../src/multimedia/audio
+
+INCLUDEPATH += $$AUDIO
+
+HEADERS += $$AUDIO/qaudioconvertingoutput_p.h
+
+SOURCES += \
+        tst_qaudioconvertingoutput.cpp \
+        $$AUDIO/qaudioconvertingoutput_p.cpp
@@ -0,0 +1,158 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/multimedia
+
+#include <QtTest/QtTest>
+#include <QtCore/qbuffer.h>
+#include <QtCore/qpointer.h>
+
+#include "qaudioconvertingoutput_p.h"
+
+QT_USE_NAMESPACE
+
+// Backend stand-in that opens with a fixed device format and hands the
+// converting output's device back to the test.
+class FakeAudioOutput : public QAbstractAudioOutput
+{
+    Q_OBJECT
+public:
+    void start(QIODevice *device) override { source = device; }
+    QIODevice *start() override
+    {
+        sink.open(QIODevice::WriteOnly);
+        return &sink;
+    }
+    void stop() override { source = nullptr; sink.close(); }
+    void reset() override { stop(); }
+    void suspend() override { }
+    void resume() override { }
+    int bytesFree() const override { return 65536; }
+    int periodSize() const override { return 4096; }
+    void setBufferSize(int) override { }
+    int bufferSize() const override { return 65536; }
+    void setNotifyInterval(int) override { }
+    int notifyInterval() const override { return 1000; }
+    qint64 processedUSecs() const override { return 0; }
+    qint64 elapsedUSecs() const override { return 0; }
+    QAudio::Error error() const override { return QAudio::NoError; }
+    QAudio::State state() const override { return QAudio::StoppedState; }
+    void setFormat(const QAudioFormat &format) override { deviceFormat = format; }
+    QAudioFormat format() const override { return deviceFormat; }
+
+    QAudioFormat deviceFormat;
+    QPointer<QIODevice> source;
+    QBuffer sink;
+};
+
+class tst_QAudioConvertingOutput : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void setQuality();
+    void rewindLastRead();
+
+private:
+    static QAudioFormat pcmFormat(int sampleRate, int channels);
+};
+
+QAudioFormat tst_QAudioConvertingOutput::pcmFormat(int sampleRate, int channels)
+{
+    QAudioFormat format;
+    format.setCodec(QStringLiteral("audio/pcm"));
+    format.setByteOrder(QAudioFormat::LittleEndian);
+    format.setSampleType(QAudioFormat::SignedInt);
+    format.setSampleSize(16);
+    format.setSampleRate(sampleRate);
+    format.setChannelCount(channels);
+    return format;
+}
+
+void tst_QAudioConvertingOutput::setQuality()
+{
+    FakeAudioOutput *backend = new FakeAudioOutput;
+    backend->setFormat(pcmFormat(48000, 2));
+    QAudioConvertingOutput output(backend, QAudioDeviceInfo(), pcmFormat(44100, 2));
+    QCOMPARE(output.quality(), QAudioResampler::HighQuality);
+    QCOMPARE(output.resampler()->quality(), QAudioResampler::HighQuality);
+
+    // Applied at once while stopped.
+    output.setQuality(QAudioResampler::FastQuality);
+    QCOMPARE(output.quality(), QAudioResampler::FastQuality);
+    QCOMPARE(output.resampler()->quality(), QAudioResampler::FastQuality);
+
+    // Deferred to the next start while the backend may be pulling.
+    QBuffer source;
+    source.open(QIODevice::ReadOnly);
+    output.start(&source);
+    output.setQuality(QAudioResampler::HighQuality);
+    QCOMPARE(output.quality(), QAudioResampler::HighQuality);
+    QCOMPARE(output.resampler()->quality(), QAudioResampler::FastQuality);
+
+    output.stop();
+    output.start(&source);
+    QCOMPARE(output.resampler()->quality(), QAudioResampler::HighQuality);
+}
+
+void tst_QAudioConvertingOutput::rewindLastRead()
+{
+    QByteArray samples(4000, Qt::Uninitialized);
+    for (int i = 0; i < samples.size() / 2; ++i)
+        qToLittleEndian<qint16>(qint16(i * 16), samples.data() + i * 2);
+    QBuffer source(&samples);
+    source.open(QIODevice::ReadOnly);
+
+    FakeAudioOutput *backend = new FakeAudioOutput;
+    backend->setFormat(pcmFormat(8000, 2));
+    QAudioConvertingOutput output(backend, QAudioDeviceInfo(), pcmFormat(8000, 1));
+    output.start(&source);
+
+    QIODevice *device = backend->source;
+    QVERIFY(device);
+    QVERIFY(device->isSequential());
+
+    const QByteArray first = device->read(256);
+    QCOMPARE(first.size(), 256);
+
+    // A backend hands back the 96 bytes it could not write.
+    QVERIFY(device->seek(device->pos() - 96));
+    QCOMPARE(device->read(96), first.right(96));
+
+    // Only the last read can be handed back.
+    QVERIFY(!device->seek(device->pos() - 512));
+    QVERIFY(!device->seek(device->pos() + 4));
+
+    const QByteArray next = device->read(64);
+    QCOMPARE(next.size(), 64);
+    QVERIFY(next != first.right(64));
+}
+
+QTEST_MAIN(tst_QAudioConvertingOutput)
+
+#include "tst_qaudioconvertingoutput.moc"
@@ -49,6 +49,10 @@ private Q_SLOTS:
     void format();
     void source();
     void readAll();
+    void readFrames();
+    void readAllBlocking();
+    void batchSettings();
+    void readWithoutBatchControl();
     void nullControl();
     void nullService();
 
@@ -327,6 +331,114 @@ void tst_QAudioDecoder::readAll()
     }
 }
 
+void tst_QAudioDecoder::readFrames()
+{
+    QAudioDecoder d;
+    d.setSourceFilename("Foo");
+
+    // Nothing to read before decoding starts
+    QVERIFY(!d.read(6, 0).isValid());
+
+    d.start();
+
+    // Spans two decoded buffers, the rest is kept for the next read
+    QAudioBuffer b = d.read(6);
+    QVERIFY(b.isValid());
+    QCOMPARE(b.frameCount(), 6);
+    QCOMPARE(b.startTime(), qint64(0));
+
+    b = d.read(6);
+    QVERIFY(b.isValid());
+    QCOMPARE(b.frameCount(), 6);
+    QCOMPARE(b.startTime(), qint64(6000));
+
+    // Only what is left is returned at the end of the stream
+    b = d.read(1000);
+    QVERIFY(b.isValid());
+    QCOMPARE(b.frameCount(), int(sizeof(int)) * MOCK_DECODER_MAX_BUFFERS - 12);
+    QCOMPARE(b.startTime(), qint64(12000));
+
+    QVERIFY(!d.read(6).isValid());
+    QVERIFY(d.state() == QAudioDecoder::StoppedState);
+}
+
+void tst_QAudioDecoder::readAllBlocking()
+{
+    QAudioDecoder d;
+    d.setSourceFilename("Foo");
+    d.start();
+
+    // A zero timeout only returns what has been decoded so far
+    QVERIFY(!d.readAll(0).isValid());
+    QTRY_VERIFY(d.bufferAvailable());
+    QAudioBuffer first = d.readAll(0);
+    QVERIFY(first.isValid());
+    QCOMPARE(first.startTime(), qint64(0));
+    QVERIFY(first.frameCount() < int(sizeof(int)) * MOCK_DECODER_MAX_BUFFERS);
+
+    // Without a timeout the rest of the stream is returned in one buffer
+    QAudioBuffer rest = d.readAll();
+    QVERIFY(rest.isValid());
+    QCOMPARE(first.frameCount() + rest.frameCount(), int(sizeof(int)) * MOCK_DECODER_MAX_BUFFERS);
+    QCOMPARE(rest.startTime(), qint64(first.frameCount()) * 1000);
+    QCOMPARE(rest.format(), d.audioFormat());
+    QVERIFY(d.state() == QAudioDecoder::StoppedState);
+
+    QVERIFY(!d.readAll().isValid());
+}
+
+void tst_QAudioDecoder::batchSettings()
+{
+    QAudioDecoder d;
+    d.setSourceFilename("Foo");
+
+    QCOMPARE(d.bufferQueueDepth(), 3);
+    d.setBufferQueueDepth(8);
+    QCOMPARE(d.bufferQueueDepth(), 8);
+    d.setBufferQueueDepth(0);
+    QCOMPARE(d.bufferQueueDepth(), 8);
+
+    QVERIFY(!d.isSynchronous());
+    d.setSynchronous(true);
+    QVERIFY(d.isSynchronous());
+
+    // Ignored while decoding
+    d.start();
+    QVERIFY(d.state() == QAudioDecoder::DecodingState);
+    d.setBufferQueueDepth(2);
+    QCOMPARE(d.bufferQueueDepth(), 8);
+    d.setSynchronous(false);
+    QVERIFY(d.isSynchronous());
+
+    d.stop();
+    d.setSynchronous(false);
+    QVERIFY(!d.isSynchronous());
+}
+
+void tst_QAudioDecoder::readWithoutBatchControl()
+{
+    mockAudioDecoderService->setBatchControlNull();
+    QAudioDecoder d;
+    d.setSourceFilename("Foo");
+
+    QCOMPARE(d.bufferQueueDepth(), 0);
+    d.setBufferQueueDepth(8);
+    QCOMPARE(d.bufferQueueDepth(), 0);
+    d.setSynchronous(true);
+    QVERIFY(!d.isSynchronous());
+
+    d.start();
+
+    // Falls back to read(), which never blocks
+    QVERIFY(!d.read(6).isValid());
+    QVERIFY(!d.readAll().isValid());
+
+    QTRY_VERIFY(d.bufferAvailable());
+    QAudioBuffer b = d.read(6);
+    QVERIFY(b.isValid());
+    QCOMPARE(b.frameCount(), int(sizeof(int)));
+}
+
 void tst_QAudioDecoder::nullControl()
 {
     mockAudioDecoderService->setControlNull();
@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = tst_qaudioresampler
+
+QT += core multimedia-private testlib
+
+SOURCES += tst_qaudioresampler.cpp
@@ -0,0 +1,230 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/multimedia
+
+#include <QtTest/QtTest>
+#include <QtCore/qmath.h>
+#include <private/qaudioresampler_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QAudioResampler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void canConvert();
+    void sampleFormat();
+    void monoToStereo();
+    void stereoToMono();
+    void sampleRate_data();
+    void sampleRate();
+    void partialFrames();
+
+private:
+    static QAudioFormat pcmFormat(int sampleRate, int channels,
+                                  QAudioFormat::SampleType type = QAudioFormat::SignedInt,
+                                  int sampleSize = 16);
+    static QByteArray sine(int sampleRate, int frequency, int frames);
+};
+
+QAudioFormat tst_QAudioResampler::pcmFormat(int sampleRate, int channels,
+                                            QAudioFormat::SampleType type, int sampleSize)
+{
+    QAudioFormat format;
+    format.setCodec(QStringLiteral("audio/pcm"));
+    format.setByteOrder(QAudioFormat::LittleEndian);
+    format.setSampleType(type);
+    format.setSampleSize(sampleSize);
+    format.setSampleRate(sampleRate);
+    format.setChannelCount(channels);
+    return format;
+}
+
+// Mono 16 bit little endian sine at half scale
+QByteArray tst_QAudioResampler::sine(int sampleRate, int frequency, int frames)
+{
+    QByteArray data(frames * 2, Qt::Uninitialized);
+    for (int i = 0; i < frames; ++i) {
+        const qint16 value = qint16(16384 * qSin(2 * M_PI * frequency * i / sampleRate));
+        qToLittleEndian<qint16>(value, data.data() + i * 2);
+    }
+    return data;
+}
+
+void tst_QAudioResampler::canConvert()
+{
+    QVERIFY(QAudioResampler::canConvert(pcmFormat(44100, 2), pcmFormat(48000, 6)));
+    QVERIFY(QAudioResampler::canConvert(pcmFormat(8000, 1, QAudioFormat::UnSignedInt, 8),
+                                        pcmFormat(48000, 2, QAudioFormat::Float, 32)));
+    QVERIFY(!QAudioResampler::canConvert(QAudioFormat(), pcmFormat(48000, 2)));
+    QVERIFY(!QAudioResampler::canConvert(pcmFormat(48000, 2, QAudioFormat::Float, 64),
+                                         pcmFormat(48000, 2)));
+
+    QAudioFormat compressed = pcmFormat(48000, 2);
+    compressed.setCodec(QStringLiteral("audio/mpeg"));
+    QVERIFY(!QAudioResampler::canConvert(compressed, pcmFormat(48000, 2)));
+}
+
+void tst_QAudioResampler::sampleFormat()
+{
+    QAudioFormat output = pcmFormat(48000, 1, QAudioFormat::Float, 32);
+    QAudioResampler resampler(pcmFormat(48000, 1), output);
+
+    QByteArray input(8, Qt::Uninitialized);
+    const qint16 values[] = { 0, 16384, -32768, 32767 };
+    for (int i = 0; i < 4; ++i)
+        qToLittleEndian<qint16>(values[i], input.data() + i * 2);
+
+    QByteArray converted;
+    resampler.convert(input.constData(), input.size(), &converted);
+    QCOMPARE(converted.size(), 16);
+
+    const float *samples = reinterpret_cast<const float *>(converted.constData());
+    QCOMPARE(samples[0], 0.0f);
+    QCOMPARE(samples[1], 0.5f);
+    QCOMPARE(samples[2], -1.0f);
+    QCOMPARE(samples[3], 32767 / 32768.0f);
+
+    // And back again, without loss.
+    QAudioResampler back(output, pcmFormat(48000, 1));
+    QByteArray roundTrip;
+    back.convert(converted.constData(), converted.size(), &roundTrip);
+    QCOMPARE(roundTrip, input);
+}
+
+void tst_QAudioResampler::monoToStereo()
+{
+    QAudioResampler resampler(pcmFormat(48000, 1), pcmFormat(48000, 2));
+
+    const QByteArray input = sine(48000, 1000, 480);
+    QByteArray converted;
+    resampler.convert(input.constData(), input.size(), &converted);
+    QCOMPARE(converted.size(), input.size() * 2);
+
+    const qint16 *in = reinterpret_cast<const qint16 *>(input.constData());
+    const qint16 *out = reinterpret_cast<const qint16 *>(converted.constData());
+    for (int i = 0; i < 480; ++i) {
+        QCOMPARE(out[2 * i], in[i]);
+        QCOMPARE(out[2 * i + 1], in[i]);
+    }
+}
+
+void tst_QAudioResampler::stereoToMono()
+{
+    QAudioResampler resampler(pcmFormat(48000, 2), pcmFormat(48000, 1));
+
+    QByteArray input(4 * 3, Qt::Uninitialized);
+    const qint16 values[] = { 1000, 3000, -2000, 2000, 8192, 8192 };
+    for (int i = 0; i < 6; ++i)
+        qToLittleEndian<qint16>(values[i], input.data() + i * 2);
+
+    QByteArray converted;
+    resampler.convert(input.constData(), input.size(), &converted);
+    QCOMPARE(converted.size(), 6);
+
+    const qint16 *out = reinterpret_cast<const qint16 *>(converted.constData());
+    QCOMPARE(out[0], qint16(2000));
+    QCOMPARE(out[1], qint16(0));
+    QCOMPARE(out[2], qint16(8192));
+}
+
+void tst_QAudioResampler::sampleRate_data()
+{
+    QTest::addColumn<int>("inputRate");
+    QTest::addColumn<int>("outputRate");
+    QTest::addColumn<int>("quality");
+
+    QTest::newRow("44100 -> 48000, fast") << 44100 << 48000 << int(QAudioResampler::FastQuality);
+    QTest::newRow("44100 -> 48000, high") << 44100 << 48000 << int(QAudioResampler::HighQuality);
+    QTest::newRow("48000 -> 44100, high") << 48000 << 44100 << int(QAudioResampler::HighQuality);
+    QTest::newRow("8000 -> 48000, high") << 8000 << 48000 << int(QAudioResampler::HighQuality);
+    QTest::newRow("48000 -> 16000, high") << 48000 << 16000 << int(QAudioResampler::HighQuality);
+}
+
+void tst_QAudioResampler::sampleRate()
+{
+    QFETCH(int, inputRate);
+    QFETCH(int, outputRate);
+    QFETCH(int, quality);
+
+    const int frequency = 1000;
+    QAudioResampler resampler(pcmFormat(inputRate, 1), pcmFormat(outputRate, 1),
+                              QAudioResampler::Quality(quality));
+
+    // One second of input, fed in blocks that don't line up with the ratio.
+    const QByteArray input = sine(inputRate, frequency, inputRate);
+    QByteArray converted;
+    for (int offset = 0; offset < input.size(); offset += 1000)
+        resampler.convert(input.constData() + offset, qMin(1000, input.size() - offset), &converted);
+
+    // The filter holds back a few input samples of look ahead.
+    const int frames = converted.size() / 2;
+    QVERIFY(frames <= outputRate);
+    QVERIFY(frames > outputRate - outputRate / 100);
+
+    // The output is the same tone at the new rate; skip the filter's run in.
+    const qint16 *out = reinterpret_cast<const qint16 *>(converted.constData());
+    double maxError = 0;
+    for (int i = outputRate / 100; i < frames; ++i) {
+        const double expected = 16384 * qSin(2 * M_PI * frequency * i / outputRate);
+        maxError = qMax(maxError, qAbs(out[i] - expected));
+    }
+    QVERIFY2(maxError < (quality == QAudioResampler::FastQuality ? 200 : 20),
+             QByteArray::number(maxError));
+}
+
+void tst_QAudioResampler::partialFrames()
+{
+    const QAudioFormat input = pcmFormat(44100, 2);
+    const QAudioFormat output = pcmFormat(48000, 2);
+    QByteArray data = sine(44100, 440, 2000);
+    data += data;
+
+    QAudioResampler whole(input, output);
+    QByteArray expected;
+    whole.convert(data.constData(), data.size(), &expected);
+
+    // Feeding single bytes has to give the same result.
+    QAudioResampler bytewise(input, output);
+    QByteArray converted;
+    for (int i = 0; i < data.size(); ++i)
+        bytewise.convert(data.constData() + i, 1, &converted);
+    QCOMPARE(converted, expected);
+
+    // reset() starts over.
+    bytewise.reset();
+    QByteArray again;
+    bytewise.convert(data.constData(), data.size(), &again);
+    QCOMPARE(again, expected);
+}
+
+QTEST_MAIN(tst_QAudioResampler)
+
+#include "tst_qaudioresampler.moc"
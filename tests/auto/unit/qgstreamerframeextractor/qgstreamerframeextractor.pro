@@ -0,0 +1,8 @@
+CONFIG += testcase
+TARGET = tst_qgstreamerframeextractor
+
+QT += multimedia-private multimediagsttools-private testlib
+
+QMAKE_USE += gstreamer
+
+SOURCES += tst_qgstreamerframeextractor.cpp
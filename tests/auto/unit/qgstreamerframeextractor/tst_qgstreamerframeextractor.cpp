@@ -0,0 +1,194 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/gsttools
+
+#include <QtTest/QtTest>
+#include <QtCore/qtemporarydir.h>
+#include <QtGui/qcolor.h>
+#include <QtGui/qimage.h>
+
+#include <private/qgstreamerframeextractor_p.h>
+
+#include <gst/gst.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGstreamerFrameExtractor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void extractFrames_data();
+    void extractFrames();
+    void extractJob();
+    void invalidFile();
+
+private:
+    QTemporaryDir m_dir;
+    QUrl m_url;
+};
+
+// Two seconds of a solid red 320x240 picture, stored as raw video so that
+// no decoder plugin is needed to read it back.
+void tst_QGstreamerFrameExtractor::initTestCase()
+{
+    gst_init(nullptr, nullptr);
+    QVERIFY(m_dir.isValid());
+
+    const QString fileName = m_dir.filePath(QStringLiteral("red.avi"));
+    const QByteArray description = "videotestsrc pattern=red num-buffers=50 "
+            "! video/x-raw,format=I420,width=320,height=240,framerate=25/1 "
+            "! avimux ! filesink location=\"" + fileName.toUtf8() + '"';
+
+    GError *error = nullptr;
+    GstElement *pipeline = gst_parse_launch(description.constData(), &error);
+    if (error) {
+        const QByteArray message = error->message;
+        g_error_free(error);
+        if (pipeline)
+            gst_object_unref(pipeline);
+        QSKIP(("Could not create the test media: " + message).constData());
+    }
+
+    gst_element_set_state(pipeline, GST_STATE_PLAYING);
+    GstBus *bus = gst_element_get_bus(pipeline);
+    GstMessage *message = gst_bus_timed_pop_filtered(
+            bus, 10 * GST_SECOND, GstMessageType(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+    const bool finished = message && GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS;
+    if (message)
+        gst_message_unref(message);
+    gst_object_unref(bus);
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(pipeline);
+
+    QVERIFY(finished);
+    m_url = QUrl::fromLocalFile(fileName);
+}
+
+static void verifyRed(const QVideoFrame &frame)
+{
+    const QImage image = frame.image();
+    QVERIFY(!image.isNull());
+
+    const QPoint points[] = {
+        QPoint(0, 0),
+        QPoint(image.width() - 1, 0),
+        QPoint(image.width() / 2, image.height() / 2),
+        QPoint(0, image.height() - 1),
+        QPoint(image.width() - 1, image.height() - 1)
+    };
+    for (const QPoint &point : points) {
+        const QColor color = image.pixelColor(point);
+        QVERIFY2(color.red() > 230 && color.green() < 25 && color.blue() < 25,
+                 qPrintable(QStringLiteral("Unexpected color %1 at %2,%3")
+                            .arg(color.name()).arg(point.x()).arg(point.y())));
+    }
+}
+
+void tst_QGstreamerFrameExtractor::extractFrames_data()
+{
+    QTest::addColumn<QSize>("maximumSize");
+    QTest::addColumn<bool>("keyFramesOnly");
+    QTest::addColumn<QSize>("expectedSize");
+
+    QTest::newRow("native") << QSize() << true << QSize(320, 240);
+    QTest::newRow("scaled") << QSize(80, 80) << true << QSize(80, 60);
+    QTest::newRow("scaled accurate") << QSize(160, 160) << false << QSize(160, 120);
+}
+
+void tst_QGstreamerFrameExtractor::extractFrames()
+{
+    QFETCH(QSize, maximumSize);
+    QFETCH(bool, keyFramesOnly);
+    QFETCH(QSize, expectedSize);
+
+    const QList<qint64> positions = QList<qint64>() << 1200 << 0 << 600;
+
+    QString errorString;
+    const QList<QVideoFrame> frames = QGstreamerFrameExtractor::extractFrames(
+            m_url, positions, maximumSize, keyFramesOnly, 10000, &errorString);
+    QVERIFY2(errorString.isEmpty(), qPrintable(errorString));
+    QCOMPARE(frames.size(), positions.size());
+
+    for (const QVideoFrame &frame : frames) {
+        QVERIFY(frame.isValid());
+        QCOMPARE(frame.pixelFormat(), QVideoFrame::Format_RGB32);
+        QCOMPARE(frame.size(), expectedSize);
+        verifyRed(frame);
+        if (QTest::currentTestFailed())
+            return;
+    }
+
+    // Frames come in the order of the positions, and accurate seeks land
+    // on the requested frames.
+    if (!keyFramesOnly) {
+        for (int i = 0; i < positions.size(); ++i)
+            QCOMPARE(frames.at(i).startTime(), positions.at(i) * 1000);
+    }
+}
+
+void tst_QGstreamerFrameExtractor::extractJob()
+{
+    QGstreamerFrameExtractor extractor;
+    extractor.setMaximumSize(QSize(64, 64));
+
+    QSignalSpy frameSpy(&extractor, &QGstreamerFrameExtractor::frameExtracted);
+    QSignalSpy finishedSpy(&extractor, &QGstreamerFrameExtractor::finished);
+    QSignalSpy errorSpy(&extractor, &QGstreamerFrameExtractor::error);
+
+    const int job = extractor.extract(m_url, QList<qint64>() << 0 << 1000);
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 10000);
+    QCOMPARE(finishedSpy.at(0).at(0).toInt(), job);
+    QCOMPARE(errorSpy.count(), 0);
+    QCOMPARE(frameSpy.count(), 2);
+
+    for (const QList<QVariant> &arguments : qAsConst(frameSpy)) {
+        QCOMPARE(arguments.at(0).toInt(), job);
+        const QVideoFrame frame = arguments.at(2).value<QVideoFrame>();
+        QCOMPARE(frame.pixelFormat(), QVideoFrame::Format_RGB32);
+        QCOMPARE(frame.size(), QSize(64, 48));
+        verifyRed(frame);
+    }
+}
+
+void tst_QGstreamerFrameExtractor::invalidFile()
+{
+    QString errorString;
+    const QList<QVideoFrame> frames = QGstreamerFrameExtractor::extractFrames(
+            QUrl::fromLocalFile(m_dir.filePath(QStringLiteral("missing.avi"))),
+            QList<qint64>() << 0, QSize(), true, 10000, &errorString);
+    QVERIFY(!errorString.isEmpty());
+    QCOMPARE(frames.size(), 1);
+    QVERIFY(!frames.first().isValid());
+}
+
+QTEST_MAIN(tst_QGstreamerFrameExtractor)
+
+#include "tst_qgstreamerframeextractor.moc"
@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = tst_qgstreamerplaybackclock
+
+QT += multimediagsttools-private testlib
+
+SOURCES += tst_qgstreamerplaybackclock.cpp
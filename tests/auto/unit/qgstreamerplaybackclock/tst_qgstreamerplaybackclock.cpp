@@ -0,0 +1,151 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/gsttools
+
+#include <QtTest/QtTest>
+
+#include <private/qgstreamerplaybackclock_p.h>
+
+QT_USE_NAMESPACE
+
+static const qint64 Millisecond = Q_INT64_C(1000000);
+static const qint64 Second = 1000 * Millisecond;
+
+class tst_QGstreamerPlaybackClock : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void reset();
+    void slew();
+    void jump();
+    void pause();
+    void negativeRate();
+};
+
+void tst_QGstreamerPlaybackClock::reset()
+{
+    QGstreamerPlaybackClock clock;
+    QCOMPARE(clock.position(), qint64(0));
+    QVERIFY(!clock.isRunning());
+
+    clock.reset(5 * Second);
+    QCOMPARE(clock.position(), 5 * Second);
+    QTest::qSleep(10);
+    QCOMPARE(clock.position(), 5 * Second);
+
+    clock.reset(2 * Second, true);
+    QVERIFY(clock.isRunning());
+    QTest::qSleep(10);
+    const qint64 position = clock.position();
+    QVERIFY(position >= 2 * Second + 10 * Millisecond);
+    QVERIFY(position < 3 * Second);
+
+    // A reset may move backwards.
+    clock.reset(Second, true);
+    QVERIFY(clock.position() < position);
+
+    clock.reset(-Second);
+    QCOMPARE(clock.position(), qint64(0));
+}
+
+void tst_QGstreamerPlaybackClock::slew()
+{
+    QGstreamerPlaybackClock clock;
+    clock.reset(10 * Second, true);
+    QTest::qSleep(10);
+
+    // A small correction backwards holds the position until the pipeline
+    // catches up instead of reporting an earlier position.
+    const qint64 before = clock.position();
+    clock.update(before - 50 * Millisecond, true, 1.0);
+    QVERIFY(clock.position() >= before);
+    QVERIFY(clock.position() < before + 50 * Millisecond);
+
+    // Corrections forwards are taken straight away.
+    const qint64 ahead = clock.position() + 50 * Millisecond;
+    clock.update(ahead, true, 1.0);
+    QVERIFY(clock.position() >= ahead);
+}
+
+void tst_QGstreamerPlaybackClock::jump()
+{
+    QGstreamerPlaybackClock clock;
+    clock.reset(10 * Second, true);
+    QTest::qSleep(10);
+
+    const qint64 before = clock.position();
+    clock.update(before - Second, true, 1.0);
+    const qint64 after = clock.position();
+    QVERIFY(after >= before - Second);
+    QVERIFY(after < before - Second + 100 * Millisecond);
+}
+
+void tst_QGstreamerPlaybackClock::pause()
+{
+    QGstreamerPlaybackClock clock;
+    clock.reset(10 * Second, true);
+    QTest::qSleep(10);
+
+    // Pausing reports where the pipeline stopped, even if the
+    // interpolated position had run slightly ahead of it.
+    const qint64 paused = clock.position() - 5 * Millisecond;
+    clock.update(paused, false, 1.0);
+    QVERIFY(!clock.isRunning());
+    QCOMPARE(clock.position(), paused);
+    QTest::qSleep(10);
+    QCOMPARE(clock.position(), paused);
+
+    clock.update(paused, true, 1.0);
+    QTest::qSleep(10);
+    QVERIFY(clock.position() >= paused + 10 * Millisecond);
+}
+
+void tst_QGstreamerPlaybackClock::negativeRate()
+{
+    QGstreamerPlaybackClock clock;
+    clock.reset(10 * Second, true, -1.0);
+    QTest::qSleep(10);
+
+    const qint64 before = clock.position();
+    QVERIFY(before <= 10 * Second - 10 * Millisecond);
+
+    // When playing backwards, a small correction forwards is held.
+    clock.update(before + 50 * Millisecond, true, -1.0);
+    QVERIFY(clock.position() <= before);
+
+    // The position never goes below zero.
+    clock.reset(Millisecond, true, -1.0);
+    QTest::qSleep(10);
+    QCOMPARE(clock.position(), qint64(0));
+}
+
+QTEST_MAIN(tst_QGstreamerPlaybackClock)
+
+#include "tst_qgstreamerplaybackclock.moc"
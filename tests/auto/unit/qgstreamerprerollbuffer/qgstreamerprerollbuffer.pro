@@ -0,0 +1,17 @@
+CONFIG += testcase
+TARGET = tst_qgstreamerprerollbuffer
+
+QT += testlib
+
+QMAKE_USE += gstreamer
+
+MEDIACAPTURE = ../../../../src/plugins/gstreamer/mediacapture
+
+INCLUDEPATH += $$MEDIACAPTURE
+
+HEADERS += \
+        $$MEDIACAPTURE/qgstreamerprerollbuffer.h
+
+SOURCES += \
+        tst_qgstreamerprerollbuffer.cpp \
+        $$MEDIACAPTURE/qgstreamerprerollbuffer.cpp
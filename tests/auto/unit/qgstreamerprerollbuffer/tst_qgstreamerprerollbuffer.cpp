@@ -0,0 +1,269 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/plugins/gstreamer/mediacapture
+
+#include <QtTest/QtTest>
+
+#include "qgstreamerprerollbuffer.h"
+
+QT_USE_NAMESPACE
+
+static const GstClockTime FrameDuration = 100 * GST_MSECOND;
+static const int FramesPerKeyFrame = 10;
+static const gsize FrameSize = 100;
+
+// A source pad linked to a sink pad that collects whatever reaches it. The
+// pre-roll buffer is attached to the source pad, as it is to the encoder's
+// source pad in the capture session.
+class PadPair
+{
+public:
+    PadPair()
+    {
+        src = gst_pad_new("src", GST_PAD_SRC);
+        sink = gst_pad_new("sink", GST_PAD_SINK);
+        gst_pad_set_element_private(sink, this);
+        gst_pad_set_chain_function(sink, chain);
+        gst_pad_set_active(src, TRUE);
+        gst_pad_set_active(sink, TRUE);
+        gst_pad_link(src, sink);
+
+        gst_pad_push_event(src, gst_event_new_stream_start("preroll"));
+        GstSegment segment;
+        gst_segment_init(&segment, GST_FORMAT_TIME);
+        gst_pad_push_event(src, gst_event_new_segment(&segment));
+    }
+
+    ~PadPair()
+    {
+        gst_pad_set_active(src, FALSE);
+        gst_pad_set_active(sink, FALSE);
+        gst_object_unref(src);
+        gst_object_unref(sink);
+        for (GstBuffer *buffer : qAsConst(received))
+            gst_buffer_unref(buffer);
+    }
+
+    // Pushes the frames [first, last), every FramesPerKeyFrame-th frame is a
+    // key frame.
+    bool pushFrames(int first, int last)
+    {
+        for (int i = first; i < last; ++i) {
+            GstBuffer *buffer = gst_buffer_new_allocate(nullptr, FrameSize, nullptr);
+            GST_BUFFER_PTS(buffer) = i * FrameDuration;
+            GST_BUFFER_DURATION(buffer) = FrameDuration;
+            if (i % FramesPerKeyFrame != 0)
+                GST_BUFFER_FLAG_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+            if (gst_pad_push(src, buffer) != GST_FLOW_OK)
+                return false;
+        }
+        return true;
+    }
+
+    QList<int> receivedFrames() const
+    {
+        QList<int> frames;
+        for (GstBuffer *buffer : received)
+            frames.append(int(GST_BUFFER_PTS(buffer) / FrameDuration));
+        return frames;
+    }
+
+    GstPad *src = nullptr;
+    GstPad *sink = nullptr;
+    QList<GstBuffer *> received;
+
+private:
+    static GstFlowReturn chain(GstPad *pad, GstObject *, GstBuffer *buffer)
+    {
+        static_cast<PadPair *>(gst_pad_get_element_private(pad))->received.append(buffer);
+        return GST_FLOW_OK;
+    }
+};
+
+static QList<int> frameRange(int first, int last)
+{
+    QList<int> frames;
+    for (int i = first; i < last; ++i)
+        frames.append(i);
+    return frames;
+}
+
+class tst_QGstreamerPreRollBuffer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void trimByDuration();
+    void trimBySize();
+    void oversizedGroupOfPictures();
+    void releaseOnNextKeyFrame();
+    void releaseOnPreviousKeyFrame();
+    void releaseWithoutData();
+    void releaseOnEndOfStream();
+};
+
+void tst_QGstreamerPreRollBuffer::initTestCase()
+{
+    gst_init(nullptr, nullptr);
+}
+
+void tst_QGstreamerPreRollBuffer::trimByDuration()
+{
+    PadPair pads;
+    QGstreamerPreRollBuffer preRoll;
+    preRoll.setLimits(GST_SECOND, 0);
+    preRoll.addProbeToPad(pads.src);
+
+    // Whole groups of pictures are dropped from the front as long as the
+    // remaining ones still cover the requested duration.
+    QVERIFY(pads.pushFrames(0, 35));
+    QCOMPARE(preRoll.startTime(), 2 * GST_SECOND);
+    QCOMPARE(preRoll.duration(), 14 * FrameDuration);
+    QCOMPARE(preRoll.size(), qint64(15 * FrameSize));
+    QVERIFY(pads.received.isEmpty());
+
+    // Lowering the limit trims right away.
+    preRoll.setLimits(3 * FrameDuration, 0);
+    QCOMPARE(preRoll.startTime(), 3 * GST_SECOND);
+    QCOMPARE(preRoll.size(), qint64(5 * FrameSize));
+
+    preRoll.removeProbe();
+    QCOMPARE(preRoll.size(), qint64(0));
+    QCOMPARE(preRoll.startTime(), GST_CLOCK_TIME_NONE);
+}
+
+void tst_QGstreamerPreRollBuffer::trimBySize()
+{
+    PadPair pads;
+    QGstreamerPreRollBuffer preRoll;
+    const qint64 maximumSize = 15 * FrameSize;
+    preRoll.setLimits(60 * GST_SECOND, maximumSize);
+    preRoll.addProbeToPad(pads.src);
+
+    QVERIFY(pads.pushFrames(0, 15));
+    QCOMPARE(preRoll.startTime(), GstClockTime(0));
+    QCOMPARE(preRoll.size(), maximumSize);
+
+    // One more frame exceeds the limit, the first group of pictures goes.
+    QVERIFY(pads.pushFrames(15, 16));
+    QCOMPARE(preRoll.startTime(), GST_SECOND);
+    QCOMPARE(preRoll.size(), qint64(6 * FrameSize));
+
+    QVERIFY(pads.pushFrames(16, 42));
+    QVERIFY(preRoll.size() <= maximumSize);
+    QCOMPARE(preRoll.startTime() % (FramesPerKeyFrame * FrameDuration), GstClockTime(0));
+    QVERIFY(pads.received.isEmpty());
+}
+
+void tst_QGstreamerPreRollBuffer::oversizedGroupOfPictures()
+{
+    PadPair pads;
+    QGstreamerPreRollBuffer preRoll;
+    preRoll.setLimits(60 * GST_SECOND, 5 * FrameSize);
+    preRoll.addProbeToPad(pads.src);
+
+    // A single group of pictures larger than the limit can't be trimmed
+    // without losing its key frame, so it is dropped altogether, and so is
+    // the rest of it until the next key frame.
+    QVERIFY(pads.pushFrames(0, 8));
+    QCOMPARE(preRoll.size(), qint64(0));
+    QCOMPARE(preRoll.startTime(), GST_CLOCK_TIME_NONE);
+
+    QVERIFY(pads.pushFrames(8, 12));
+    QCOMPARE(preRoll.startTime(), GST_SECOND);
+    QCOMPARE(preRoll.size(), qint64(2 * FrameSize));
+}
+
+void tst_QGstreamerPreRollBuffer::releaseOnNextKeyFrame()
+{
+    PadPair pads;
+    QGstreamerPreRollBuffer preRoll;
+    preRoll.setLimits(60 * GST_SECOND, 0);
+    preRoll.addProbeToPad(pads.src);
+
+    QVERIFY(pads.pushFrames(0, 25));
+    preRoll.release(15 * FrameDuration);
+    QVERIFY(pads.received.isEmpty());
+
+    // The buffered data is released ahead of the next live frame, starting
+    // from the first key frame after the requested start.
+    QVERIFY(pads.pushFrames(25, 28));
+    QCOMPARE(pads.receivedFrames(), frameRange(20, 28));
+    QVERIFY(!GST_BUFFER_FLAG_IS_SET(pads.received.first(), GST_BUFFER_FLAG_DELTA_UNIT));
+    QCOMPARE(preRoll.size(), qint64(0));
+}
+
+void tst_QGstreamerPreRollBuffer::releaseOnPreviousKeyFrame()
+{
+    PadPair pads;
+    QGstreamerPreRollBuffer preRoll;
+    preRoll.setLimits(60 * GST_SECOND, 0);
+    preRoll.addProbeToPad(pads.src);
+
+    // Without a key frame after the requested start, the group of pictures
+    // containing it is released instead of starting on a delta frame.
+    QVERIFY(pads.pushFrames(0, 19));
+    preRoll.release(15 * FrameDuration);
+    QVERIFY(pads.pushFrames(19, 21));
+    QCOMPARE(pads.receivedFrames(), frameRange(10, 21));
+    QVERIFY(!GST_BUFFER_FLAG_IS_SET(pads.received.first(), GST_BUFFER_FLAG_DELTA_UNIT));
+}
+
+void tst_QGstreamerPreRollBuffer::releaseWithoutData()
+{
+    PadPair pads;
+    QGstreamerPreRollBuffer preRoll;
+    preRoll.setLimits(60 * GST_SECOND, 0);
+    preRoll.addProbeToPad(pads.src);
+
+    // Nothing buffered, so the recording waits for the next live key frame.
+    preRoll.release(0);
+    QVERIFY(pads.pushFrames(5, 12));
+    QCOMPARE(pads.receivedFrames(), frameRange(10, 12));
+}
+
+void tst_QGstreamerPreRollBuffer::releaseOnEndOfStream()
+{
+    PadPair pads;
+    QGstreamerPreRollBuffer preRoll;
+    preRoll.setLimits(60 * GST_SECOND, 0);
+    preRoll.addProbeToPad(pads.src);
+
+    QVERIFY(pads.pushFrames(0, 15));
+    preRoll.release(0);
+
+    // Stopping before the next frame still writes out the buffered data.
+    gst_pad_push_event(pads.src, gst_event_new_eos());
+    QCOMPARE(pads.receivedFrames(), frameRange(0, 15));
+}
+
+QTEST_GUILESS_MAIN(tst_QGstreamerPreRollBuffer)
+
+#include "tst_qgstreamerprerollbuffer.moc"
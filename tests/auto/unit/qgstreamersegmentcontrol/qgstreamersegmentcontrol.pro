@@ -0,0 +1,33 @@
+CONFIG += testcase
+TARGET = tst_qgstreamersegmentcontrol
+
+QT += multimedia-private multimediagsttools-private testlib
+
+QMAKE_USE += gstreamer
+
+MEDIACAPTURE = ../../../../src/plugins/gstreamer/mediacapture
+
+INCLUDEPATH += $$MEDIACAPTURE
+
+HEADERS += \
+        $$MEDIACAPTURE/qgstreamercapturesession.h \
+        $$MEDIACAPTURE/qgstreameraudioencode.h \
+        $$MEDIACAPTURE/qgstreamervideoencode.h \
+        $$MEDIACAPTURE/qgstreamerimageencode.h \
+        $$MEDIACAPTURE/qgstreamerrecordercontrol.h \
+        $$MEDIACAPTURE/qgstreamermediacontainercontrol.h \
+        $$MEDIACAPTURE/qgstreamerprerollbuffer.h \
+        $$MEDIACAPTURE/qgstreamerprerollcontrol.h \
+        $$MEDIACAPTURE/qgstreamersegmentcontrol.h
+
+SOURCES += \
+        tst_qgstreamersegmentcontrol.cpp \
+        $$MEDIACAPTURE/qgstreamercapturesession.cpp \
+        $$MEDIACAPTURE/qgstreameraudioencode.cpp \
+        $$MEDIACAPTURE/qgstreamervideoencode.cpp \
+        $$MEDIACAPTURE/qgstreamerimageencode.cpp \
+        $$MEDIACAPTURE/qgstreamerrecordercontrol.cpp \
+        $$MEDIACAPTURE/qgstreamermediacontainercontrol.cpp \
+        $$MEDIACAPTURE/qgstreamerprerollbuffer.cpp \
+        $$MEDIACAPTURE/qgstreamerprerollcontrol.cpp \
+        $$MEDIACAPTURE/qgstreamersegmentcontrol.cpp
@@ -0,0 +1,142 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/plugins/gstreamer/mediacapture
+
+#include <QtTest/QtTest>
+
+#include "qgstreamercapturesession.h"
+#include "qgstreamersegmentcontrol.h"
+
+#include <private/qgstreamermessage_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGstreamerSegmentControl : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void locationPattern_data();
+    void locationPattern();
+    void limitsChanged();
+    void segmentFinished();
+};
+
+void tst_QGstreamerSegmentControl::initTestCase()
+{
+    gst_init(nullptr, nullptr);
+}
+
+void tst_QGstreamerSegmentControl::locationPattern_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QByteArray>("pattern");
+
+    QTest::newRow("suffix")
+            << QStringLiteral("/tmp/clip.mp4") << QByteArray("/tmp/clip_%05d.mp4");
+    QTest::newRow("no suffix")
+            << QStringLiteral("/tmp/clip") << QByteArray("/tmp/clip_%05d");
+    QTest::newRow("dots in name")
+            << QStringLiteral("/tmp/my.clip.mkv") << QByteArray("/tmp/my.clip_%05d.mkv");
+    QTest::newRow("percent in name")
+            << QStringLiteral("/tmp/100%.mp4") << QByteArray("/tmp/100%%_%05d.mp4");
+}
+
+void tst_QGstreamerSegmentControl::locationPattern()
+{
+    QFETCH(QString, fileName);
+    QFETCH(QByteArray, pattern);
+
+    QCOMPARE(QGstreamerSegmentControl::locationPattern(fileName), pattern);
+}
+
+void tst_QGstreamerSegmentControl::limitsChanged()
+{
+    QGstreamerCaptureSession session(QGstreamerCaptureSession::Audio, nullptr);
+    QGstreamerSegmentControl *control = session.segmentControl();
+    QVERIFY(control);
+
+    QSignalSpy durationSpy(control, &QMediaRecorderSegmentControl::maximumSegmentDurationChanged);
+    QSignalSpy sizeSpy(control, &QMediaRecorderSegmentControl::maximumSegmentSizeChanged);
+
+    control->setMaximumSegmentDuration(60000);
+    QCOMPARE(control->maximumSegmentDuration(), qint64(60000));
+    QCOMPARE(durationSpy.count(), 1);
+    QCOMPARE(durationSpy.last().value(0).toLongLong(), qint64(60000));
+
+    // Setting the same value again doesn't signal a change.
+    control->setMaximumSegmentDuration(60000);
+    QCOMPARE(durationSpy.count(), 1);
+
+    // Negative limits mean no limit.
+    control->setMaximumSegmentDuration(-1);
+    QCOMPARE(control->maximumSegmentDuration(), qint64(0));
+    QCOMPARE(durationSpy.count(), 2);
+    QCOMPARE(durationSpy.last().value(0).toLongLong(), qint64(0));
+
+    control->setMaximumSegmentSize(1024 * 1024);
+    QCOMPARE(control->maximumSegmentSize(), qint64(1024 * 1024));
+    QCOMPARE(sizeSpy.count(), 1);
+    QCOMPARE(sizeSpy.last().value(0).toLongLong(), qint64(1024 * 1024));
+
+    control->setMaximumSegmentSize(1024 * 1024);
+    QCOMPARE(sizeSpy.count(), 1);
+    QCOMPARE(durationSpy.count(), 2);
+}
+
+void tst_QGstreamerSegmentControl::segmentFinished()
+{
+    QGstreamerCaptureSession session(QGstreamerCaptureSession::Audio, nullptr);
+    QGstreamerSegmentControl *control = session.segmentControl();
+    QSignalSpy spy(control, &QMediaRecorderSegmentControl::segmentFinished);
+
+    // Other element messages are ignored.
+    GstMessage *message = gst_message_new_element(
+                nullptr, gst_structure_new("splitmuxsink-fragment-opened",
+                                           "location", G_TYPE_STRING, "/tmp/clip_00003.mp4",
+                                           NULL));
+    session.processBusMessage(QGstreamerMessage(message));
+    gst_message_unref(message);
+    QCOMPARE(spy.count(), 0);
+
+    message = gst_message_new_element(
+                nullptr, gst_structure_new("splitmuxsink-fragment-closed",
+                                           "location", G_TYPE_STRING, "/tmp/clip_00003.mp4",
+                                           "running-time", G_TYPE_UINT64, guint64(10 * GST_SECOND),
+                                           NULL));
+    session.processBusMessage(QGstreamerMessage(message));
+    gst_message_unref(message);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.last().value(0).toUrl(), QUrl::fromLocalFile(QStringLiteral("/tmp/clip_00003.mp4")));
+}
+
+QTEST_GUILESS_MAIN(tst_QGstreamerSegmentControl)
+
+#include "tst_qgstreamersegmentcontrol.moc"
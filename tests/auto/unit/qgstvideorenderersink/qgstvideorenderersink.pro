@@ -0,0 +1,8 @@
+CONFIG += testcase
+TARGET = tst_qgstvideorenderersink
+
+QT += multimedia-private multimediagsttools-private testlib
+
+QMAKE_USE += gstreamer
+
+SOURCES += tst_qgstvideorenderersink.cpp
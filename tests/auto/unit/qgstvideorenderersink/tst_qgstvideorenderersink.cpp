@@ -0,0 +1,179 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/gsttools
+
+#include <QtTest/QtTest>
+#include <QtMultimedia/qabstractvideosurface.h>
+
+#include <private/qgstvideorenderersink_p.h>
+
+#include <gst/gst.h>
+
+QT_USE_NAMESPACE
+
+class TestSurface : public QAbstractVideoSurface
+{
+public:
+    QList<QVideoFrame::PixelFormat> supportedPixelFormats(
+            QAbstractVideoBuffer::HandleType type) const override
+    {
+        if (type != QAbstractVideoBuffer::NoHandle)
+            return QList<QVideoFrame::PixelFormat>();
+        return QList<QVideoFrame::PixelFormat>() << QVideoFrame::Format_RGB32;
+    }
+
+    bool present(const QVideoFrame &) override { return true; }
+};
+
+class tst_QGstVideoRendererSink : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void preferredSizeInPlaySink();
+    void preferredSizeOutsidePlaySink();
+
+private:
+    static GstCaps *sinkCaps(GstElement *sink);
+    static int maximumWidth(GstCaps *caps);
+    static int maximumHeight(GstCaps *caps);
+    static bool acceptsSize(GstCaps *caps, const QSize &size);
+};
+
+void tst_QGstVideoRendererSink::initTestCase()
+{
+    gst_init(nullptr, nullptr);
+}
+
+GstCaps *tst_QGstVideoRendererSink::sinkCaps(GstElement *sink)
+{
+    GstPad *pad = gst_element_get_static_pad(sink, "sink");
+    GstCaps *caps = gst_pad_query_caps(pad, nullptr);
+    gst_object_unref(pad);
+    return caps;
+}
+
+static int maximumOfField(GstCaps *caps, const char *field)
+{
+    const GValue *value = gst_structure_get_value(gst_caps_get_structure(caps, 0), field);
+    if (!value)
+        return -1;
+    if (GST_VALUE_HOLDS_INT_RANGE(value))
+        return gst_value_get_int_range_max(value);
+    return G_VALUE_HOLDS_INT(value) ? g_value_get_int(value) : -1;
+}
+
+int tst_QGstVideoRendererSink::maximumWidth(GstCaps *caps)
+{
+    return maximumOfField(caps, "width");
+}
+
+int tst_QGstVideoRendererSink::maximumHeight(GstCaps *caps)
+{
+    return maximumOfField(caps, "height");
+}
+
+bool tst_QGstVideoRendererSink::acceptsSize(GstCaps *caps, const QSize &size)
+{
+    GstCaps *sized = gst_caps_new_simple("video/x-raw",
+            "width", G_TYPE_INT, size.width(),
+            "height", G_TYPE_INT, size.height(),
+            nullptr);
+    const bool accepted = gst_caps_can_intersect(caps, sized);
+    gst_caps_unref(sized);
+    return accepted;
+}
+
+void tst_QGstVideoRendererSink::preferredSizeInPlaySink()
+{
+    GstElement *playSink = gst_element_factory_make("playsink", nullptr);
+    if (!playSink)
+        QSKIP("playsink is not available");
+    gst_object_ref_sink(playSink);
+
+    TestSurface surface;
+    surface.setProperty("_q_preferredSize", QSize(320, 180));
+
+    GstElement *sink = GST_ELEMENT(QGstVideoRendererSink::createSink(&surface));
+    QVERIFY(sink);
+    QVERIFY(gst_bin_add(GST_BIN(playSink), sink));
+    QCOMPARE(gst_element_set_state(sink, GST_STATE_READY), GST_STATE_CHANGE_SUCCESS);
+
+    // The preferred size comes first, the full range follows as a fallback
+    // for sources that cannot scale.
+    GstCaps *caps = sinkCaps(sink);
+    QVERIFY(!gst_caps_is_empty(caps));
+    QCOMPARE(maximumWidth(caps), 320);
+    QCOMPARE(maximumHeight(caps), 180);
+    QVERIFY(acceptsSize(caps, QSize(320, 180)));
+    QVERIFY(acceptsSize(caps, QSize(1920, 1080)));
+    gst_caps_unref(caps);
+
+    // Changes of the property are picked up
+    surface.setProperty("_q_preferredSize", QSize(640, 360));
+    caps = sinkCaps(sink);
+    QCOMPARE(maximumWidth(caps), 640);
+    QCOMPARE(maximumHeight(caps), 360);
+    gst_caps_unref(caps);
+
+    surface.setProperty("_q_preferredSize", QVariant());
+    caps = sinkCaps(sink);
+    QVERIFY(maximumWidth(caps) > 1920);
+    QVERIFY(maximumHeight(caps) > 1080);
+    gst_caps_unref(caps);
+
+    gst_element_set_state(sink, GST_STATE_NULL);
+    gst_object_unref(playSink);
+}
+
+void tst_QGstVideoRendererSink::preferredSizeOutsidePlaySink()
+{
+    TestSurface surface;
+    surface.setProperty("_q_preferredSize", QSize(320, 180));
+
+    GstElement *bin = gst_bin_new(nullptr);
+    gst_object_ref_sink(bin);
+    GstElement *sink = GST_ELEMENT(QGstVideoRendererSink::createSink(&surface));
+    QVERIFY(gst_bin_add(GST_BIN(bin), sink));
+    QCOMPARE(gst_element_set_state(sink, GST_STATE_READY), GST_STATE_CHANGE_SUCCESS);
+
+    // Without a scaler upstream the size is left to the source
+    GstCaps *caps = sinkCaps(sink);
+    QVERIFY(maximumWidth(caps) > 1920);
+    QVERIFY(maximumHeight(caps) > 1080);
+    gst_caps_unref(caps);
+
+    gst_element_set_state(sink, GST_STATE_NULL);
+    gst_object_unref(bin);
+}
+
+QTEST_MAIN(tst_QGstVideoRendererSink)
+
+#include "tst_qgstvideorenderersink.moc"
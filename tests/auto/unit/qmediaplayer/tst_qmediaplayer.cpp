@@ -134,6 +134,7 @@ private slots:
     void testQrc();
     void testAudioRole();
     void testCustomAudioRole();
+    void testFrameStep();
 
 private:
     void setupCommonTestData();
@@ -1431,5 +1432,44 @@ void tst_QMediaPlayer::testCustomAudioRole()
     }
 }
 
+void tst_QMediaPlayer::testFrameStep()
+{
+    {
+        mockService->setHasFrameStep(false);
+        QMediaPlayer player;
+        mockService->setState(QMediaPlayer::PausedState);
+
+        player.setAccurateSeekEnabled(true);
+        QCOMPARE(player.isAccurateSeekEnabled(), false);
+        player.setFrameCacheSize(8);
+        QCOMPARE(player.frameCacheSize(), 0);
+        QCOMPARE(player.stepFrames(1), false);
+    }
+
+    {
+        mockService->reset();
+        QMediaPlayer player;
+
+        player.setAccurateSeekEnabled(true);
+        QCOMPARE(player.isAccurateSeekEnabled(), true);
+        QCOMPARE(mockService->mockFrameStepControl->isAccurateSeekEnabled(), true);
+
+        player.setFrameCacheSize(8);
+        QCOMPARE(player.frameCacheSize(), 8);
+        player.setFrameCacheSize(-1);
+        QCOMPARE(player.frameCacheSize(), 0);
+
+        // Nothing to step while stopped.
+        QCOMPARE(player.stepFrames(1), false);
+        QCOMPARE(mockService->mockFrameStepControl->m_steppedFrames, 0);
+
+        mockService->setState(QMediaPlayer::PausedState);
+        QCOMPARE(player.stepFrames(0), false);
+        QCOMPARE(player.stepFrames(3), true);
+        QCOMPARE(player.stepFrames(-5), true);
+        QCOMPARE(mockService->mockFrameStepControl->m_steppedFrames, -2);
+    }
+}
+
 QTEST_GUILESS_MAIN(tst_QMediaPlayer)
 #include "tst_qmediaplayer.moc"
@@ -0,0 +1,138 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef MOCKAUDIODECODERBATCHCONTROL_H
+#define MOCKAUDIODECODERBATCHCONTROL_H
+
+#include "qaudiodecoderbatchcontrol.h"
+#include "mockaudiodecodercontrol.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdeadlinetimer.h>
+
+QT_BEGIN_NAMESPACE
+
+class MockAudioDecoderBatchControl : public QAudioDecoderBatchControl
+{
+    Q_OBJECT
+
+public:
+    MockAudioDecoderBatchControl(MockAudioDecoderControl *control, QObject *parent = 0)
+        : QAudioDecoderBatchControl(parent)
+        , mControl(control)
+        , mQueueDepth(3)
+        , mSynchronous(false)
+    {
+    }
+
+    int bufferQueueDepth() const
+    {
+        return mQueueDepth;
+    }
+
+    void setBufferQueueDepth(int depth)
+    {
+        mQueueDepth = depth;
+    }
+
+    bool isSynchronous() const
+    {
+        return mSynchronous;
+    }
+
+    void setSynchronous(bool synchronous)
+    {
+        mSynchronous = synchronous;
+    }
+
+    // The mock decoder is driven by timers, so waiting means
+    // spinning the event loop of the calling thread.
+    QAudioBuffer read(int maxFrames, int msecs)
+    {
+        const QDeadlineTimer deadline(msecs < 0 ? qint64(-1) : qint64(msecs));
+
+        QByteArray data;
+        QAudioFormat format;
+        qint64 startTime = -1;
+
+        while (maxFrames <= 0 || format.framesForBytes(data.size()) < maxFrames) {
+            QAudioBuffer chunk = mPending;
+            mPending = QAudioBuffer();
+
+            while (!chunk.isValid() && !atEnd()) {
+                chunk = mControl->read();
+                if (chunk.isValid() || deadline.hasExpired())
+                    break;
+                QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+            }
+
+            if (!chunk.isValid())
+                break;
+            if (maxFrames <= 0)
+                return chunk;
+
+            if (!format.isValid()) {
+                format = chunk.format();
+                startTime = chunk.startTime();
+            }
+
+            const int wanted = maxFrames - format.framesForBytes(data.size());
+            const int bytes = qMin(chunk.byteCount(), format.bytesForFrames(wanted));
+            data.append(static_cast<const char *>(chunk.constData()), bytes);
+            if (bytes < chunk.byteCount()) {
+                mPending = QAudioBuffer(QByteArray(static_cast<const char *>(chunk.constData()) + bytes,
+                                                   chunk.byteCount() - bytes),
+                                        format, chunk.startTime() + format.durationForBytes(bytes));
+            }
+        }
+
+        if (!format.isValid())
+            return QAudioBuffer();
+        return QAudioBuffer(data, format, startTime);
+    }
+
+    bool atEnd() const
+    {
+        return !mPending.isValid() && mControl->mBuffers.isEmpty()
+                && mControl->mState == QAudioDecoder::StoppedState;
+    }
+
+    QAudioDecoder::Error streamError() const
+    {
+        return QAudioDecoder::NoError;
+    }
+
+    MockAudioDecoderControl *mControl;
+    int mQueueDepth;
+    bool mSynchronous;
+    QAudioBuffer mPending;
+};
+
+QT_END_NAMESPACE
+
+#endif // MOCKAUDIODECODERBATCHCONTROL_H
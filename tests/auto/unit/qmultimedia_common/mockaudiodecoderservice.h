@@ -32,6 +32,7 @@
 #include "qmediaservice.h"
 
 #include "mockaudiodecodercontrol.h"
+#include "mockaudiodecoderbatchcontrol.h"
 
 class MockAudioDecoderService : public QMediaService
 {
@@ -43,10 +44,13 @@ public:
     {
         mockControl = new MockAudioDecoderControl(this);
         validControl = mockControl;
+        mockBatchControl = new MockAudioDecoderBatchControl(mockControl, this);
+        validBatchControl = mockBatchControl;
     }
 
     ~MockAudioDecoderService()
     {
+        delete validBatchControl;
         delete mockControl;
     }
 
@@ -54,6 +58,8 @@ public:
     {
         if (qstrcmp(iid, QAudioDecoderControl_iid) == 0)
             return mockControl;
+        if (qstrcmp(iid, QAudioDecoderBatchControl_iid) == 0)
+            return mockBatchControl;
         return 0;
     }
 
@@ -72,8 +78,15 @@ public:
         mockControl = validControl;
     }
 
+    void setBatchControlNull()
+    {
+        mockBatchControl = 0;
+    }
+
     MockAudioDecoderControl *mockControl;
     MockAudioDecoderControl *validControl;
+    MockAudioDecoderBatchControl *mockBatchControl;
+    MockAudioDecoderBatchControl *validBatchControl;
 };
 
 
@@ -6,4 +6,5 @@ INCLUDEPATH += $$PWD \
 
 HEADERS *= \
     ../qmultimedia_common/mockaudiodecoderservice.h \
-    ../qmultimedia_common/mockaudiodecodercontrol.h
+    ../qmultimedia_common/mockaudiodecodercontrol.h \
+    ../qmultimedia_common/mockaudiodecoderbatchcontrol.h
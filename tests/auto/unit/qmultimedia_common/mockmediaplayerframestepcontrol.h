@@ -0,0 +1,77 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef MOCKMEDIAPLAYERFRAMESTEPCONTROL_H
+#define MOCKMEDIAPLAYERFRAMESTEPCONTROL_H
+
+#include <qmediaplayerframestepcontrol.h>
+
+class MockMediaPlayerFrameStepControl : public QMediaPlayerFrameStepControl
+{
+    friend class MockMediaPlayerService;
+
+public:
+    MockMediaPlayerFrameStepControl()
+        : QMediaPlayerFrameStepControl()
+    {
+    }
+
+    bool isAccurateSeekEnabled() const
+    {
+        return m_accurateSeek;
+    }
+
+    void setAccurateSeekEnabled(bool enabled)
+    {
+        if (enabled != m_accurateSeek)
+            emit accurateSeekEnabledChanged(m_accurateSeek = enabled);
+    }
+
+    bool step(int frames)
+    {
+        m_steppedFrames += frames;
+        return true;
+    }
+
+    int frameCacheSize() const
+    {
+        return m_frameCacheSize;
+    }
+
+    void setFrameCacheSize(int frames)
+    {
+        if (frames != m_frameCacheSize)
+            emit frameCacheSizeChanged(m_frameCacheSize = frames);
+    }
+
+    bool m_accurateSeek = false;
+    int m_steppedFrames = 0;
+    int m_frameCacheSize = 0;
+};
+
+#endif // MOCKMEDIAPLAYERFRAMESTEPCONTROL_H
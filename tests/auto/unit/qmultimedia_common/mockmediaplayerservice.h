@@ -39,6 +39,7 @@
 #include "mockvideowindowcontrol.h"
 #include "mockaudiorolecontrol.h"
 #include "mockcustomaudiorolecontrol.h"
+#include "mockmediaplayerframestepcontrol.h"
 
 class MockMediaPlayerService : public QMediaService
 {
@@ -50,6 +51,7 @@ public:
         mockControl = new MockMediaPlayerControl;
         mockAudioRoleControl = new MockAudioRoleControl;
         mockCustomAudioRoleControl = new MockCustomAudioRoleControl;
+        mockFrameStepControl = new MockMediaPlayerFrameStepControl;
         mockStreamsControl = new MockStreamsControl;
         mockNetworkControl = new MockNetworkAccessControl;
         rendererControl = new MockVideoRendererControl;
@@ -59,6 +61,7 @@ public:
         windowRef = 0;
         enableAudioRole = true;
         enableCustomAudioRole = true;
+        enableFrameStep = true;
     }
 
     ~MockMediaPlayerService()
@@ -66,6 +69,7 @@ public:
         delete mockControl;
         delete mockAudioRoleControl;
         delete mockCustomAudioRoleControl;
+        delete mockFrameStepControl;
         delete mockStreamsControl;
         delete mockNetworkControl;
         delete rendererControl;
@@ -94,6 +98,8 @@ public:
             return mockAudioRoleControl;
         } else if (enableCustomAudioRole && qstrcmp(iid, QCustomAudioRoleControl_iid) == 0) {
             return mockCustomAudioRoleControl;
+        } else if (enableFrameStep && qstrcmp(iid, QMediaPlayerFrameStepControl_iid) == 0) {
+            return mockFrameStepControl;
         }
 
         if (qstrcmp(iid, QMediaNetworkAccessControl_iid) == 0)
@@ -134,6 +140,7 @@ public:
 
     void setHasAudioRole(bool enable) { enableAudioRole = enable; }
     void setHasCustomAudioRole(bool enable) { enableCustomAudioRole = enable; }
+    void setHasFrameStep(bool enable) { enableFrameStep = enable; }
 
     void reset()
     {
@@ -157,6 +164,10 @@ public:
         mockAudioRoleControl->m_audioRole = QAudio::UnknownRole;
         enableCustomAudioRole = true;
         mockCustomAudioRoleControl->m_customAudioRole.clear();
+        enableFrameStep = true;
+        mockFrameStepControl->m_accurateSeek = false;
+        mockFrameStepControl->m_steppedFrames = 0;
+        mockFrameStepControl->m_frameCacheSize = 0;
 
         mockNetworkControl->_current = QNetworkConfiguration();
         mockNetworkControl->_configurations = QList<QNetworkConfiguration>();
@@ -165,6 +176,7 @@ public:
     MockMediaPlayerControl *mockControl;
     MockAudioRoleControl *mockAudioRoleControl;
     MockCustomAudioRoleControl *mockCustomAudioRoleControl;
+    MockMediaPlayerFrameStepControl *mockFrameStepControl;
     MockStreamsControl *mockStreamsControl;
     MockNetworkAccessControl *mockNetworkControl;
     MockVideoRendererControl *rendererControl;
@@ -174,6 +186,7 @@ public:
     int rendererRef;
     bool enableAudioRole;
     bool enableCustomAudioRole;
+    bool enableFrameStep;
 };
 
 
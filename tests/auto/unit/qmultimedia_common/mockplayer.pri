@@ -10,6 +10,7 @@ HEADERS *= \
     ../qmultimedia_common/mockmedianetworkaccesscontrol.h \
     ../qmultimedia_common/mockvideoprobecontrol.h \
     ../qmultimedia_common/mockaudiorolecontrol.h \
-    ../qmultimedia_common/mockcustomaudiorolecontrol.h
+    ../qmultimedia_common/mockcustomaudiorolecontrol.h \
+    ../qmultimedia_common/mockmediaplayerframestepcontrol.h
 
 include(mockvideo.pri)
@@ -241,14 +241,26 @@ void tst_QPainterVideoSurface::supportedFormat_data()
             << QAbstractVideoBuffer::NoHandle
             << QVideoFrame::Format_YUV420P
             << QSize(640, 480)
-            << false
-            << false;
+            << true
+            << true;
     QTest::newRow("YUV420P 640x-480")
             << QAbstractVideoBuffer::NoHandle
             << QVideoFrame::Format_YUV420P
             << QSize(640, -480)
-            << false
+            << true
             << false;
+    QTest::newRow("NV12 640x480")
+            << QAbstractVideoBuffer::NoHandle
+            << QVideoFrame::Format_NV12
+            << QSize(640, 480)
+            << true
+            << true;
+    QTest::newRow("UYVY 640x480")
+            << QAbstractVideoBuffer::NoHandle
+            << QVideoFrame::Format_UYVY
+            << QSize(640, 480)
+            << true
+            << true;
     QTest::newRow("Y8 640x480")
             << QAbstractVideoBuffer::NoHandle
             << QVideoFrame::Format_Y8
@@ -417,6 +429,30 @@ void tst_QPainterVideoSurface::present_data()
                 << int(sizeof(rgb565ImageData))
                 << 4;
 #endif
+
+    QTest::newRow("yuv420p -> rgb32")
+            << QVideoFrame::Format_YUV420P
+            << QSize(8, 8)
+            << static_cast<const uchar *>(yuvPlanarImageData)
+            << int(sizeof(yuvPlanarImageData))
+            << 8
+            << QVideoFrame::Format_RGB32
+            << QSize(2, 2)
+            << static_cast<const uchar *>(rgb32ImageData)
+            << int(sizeof(rgb32ImageData))
+            << 8;
+
+    QTest::newRow("rgb32 -> yv12")
+            << QVideoFrame::Format_RGB32
+            << QSize(2, 2)
+            << static_cast<const uchar *>(rgb32ImageData)
+            << int(sizeof(rgb32ImageData))
+            << 8
+            << QVideoFrame::Format_YV12
+            << QSize(8, 8)
+            << static_cast<const uchar *>(yuvPlanarImageData)
+            << int(sizeof(yuvPlanarImageData))
+            << 8;
 }
 
 void tst_QPainterVideoSurface::present()
@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = tst_qplaylisttokenizer
+
+QT += core multimedia-private testlib
+
+SOURCES += tst_qplaylisttokenizer.cpp
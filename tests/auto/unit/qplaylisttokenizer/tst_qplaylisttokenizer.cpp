@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/multimedia
+
+#include <QtTest/QtTest>
+#include <private/qplaylisttokenizer_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QPlaylistTokenizer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void lineBreaks_data();
+    void lineBreaks();
+    void chunked_data();
+    void chunked();
+    void byteOrderMark();
+    void trimmed();
+
+private:
+    static QStringList tokenize(const QByteArray &data, int chunkSize);
+};
+
+// Feeds data in chunks of chunkSize bytes, each living in its own buffer
+QStringList tst_QPlaylistTokenizer::tokenize(const QByteArray &data, int chunkSize)
+{
+    QPlaylistTokenizer tokenizer;
+    QStringList lines;
+    QPlaylistTokenizer::Line line;
+
+    for (int offset = 0; offset < data.size(); offset += chunkSize) {
+        const QByteArray chunk = data.mid(offset, chunkSize);
+        tokenizer.setData(chunk.constData(), chunk.size());
+        while (tokenizer.next(&line))
+            lines << QString::fromLatin1(line.data, line.size);
+    }
+
+    tokenizer.setData(nullptr, 0);
+    tokenizer.finish();
+    while (tokenizer.next(&line))
+        lines << QString::fromLatin1(line.data, line.size);
+
+    return lines;
+}
+
+void tst_QPlaylistTokenizer::lineBreaks_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QStringList>("lines");
+
+    const QStringList abc = QStringList() << "a" << "bb" << "ccc";
+
+    QTest::newRow("lf") << QByteArray("a\nbb\nccc\n") << abc;
+    QTest::newRow("crlf") << QByteArray("a\r\nbb\r\nccc\r\n") << abc;
+    QTest::newRow("cr") << QByteArray("a\rbb\rccc\r") << abc;
+    QTest::newRow("no final break") << QByteArray("a\nbb\nccc") << abc;
+    QTest::newRow("empty lines") << QByteArray("\n\na\n\r\n\nbb\nccc\n\n") << abc;
+    QTest::newRow("empty") << QByteArray() << QStringList();
+}
+
+void tst_QPlaylistTokenizer::lineBreaks()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QStringList, lines);
+
+    QCOMPARE(tokenize(data, qMax(1, data.size())), lines);
+}
+
+void tst_QPlaylistTokenizer::chunked_data()
+{
+    QTest::addColumn<int>("chunkSize");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    QTest::newRow("3") << 3;
+    QTest::newRow("7") << 7;
+}
+
+void tst_QPlaylistTokenizer::chunked()
+{
+    QFETCH(int, chunkSize);
+
+    const QByteArray data("#EXTM3U\r\n#EXTINF:123,Artist - Title\r\nmusic/track one.mp3\r\n"
+                          "http://example.com/stream\n\nlast");
+    const QStringList lines = QStringList()
+            << "#EXTM3U"
+            << "#EXTINF:123,Artist - Title"
+            << "music/track one.mp3"
+            << "http://example.com/stream"
+            << "last";
+
+    QCOMPARE(tokenize(data, chunkSize), lines);
+}
+
+void tst_QPlaylistTokenizer::byteOrderMark()
+{
+    const QByteArray data("\xEF\xBB\xBF#EXTM3U\nfile.mp3\n");
+    const QStringList lines = QStringList() << "#EXTM3U" << "file.mp3";
+
+    QCOMPARE(tokenize(data, data.size()), lines);
+}
+
+void tst_QPlaylistTokenizer::trimmed()
+{
+    const char text[] = " \t File1=a.mp3 \t";
+    QPlaylistTokenizer::Line line;
+    line.data = text;
+    line.size = int(sizeof(text) - 1);
+
+    const QPlaylistTokenizer::Line trimmed = line.trimmed();
+    QCOMPARE(QByteArray(trimmed.data, trimmed.size), QByteArray("File1=a.mp3"));
+    QVERIFY(trimmed.startsWith("File"));
+    QVERIFY(!trimmed.startsWith("File1=a.mp3 "));
+}
+
+QTEST_MAIN(tst_QPlaylistTokenizer)
+
+#include "tst_qplaylisttokenizer.moc"
@@ -0,0 +1,12 @@
+CONFIG += testcase
+TARGET = tst_qsgvideotexturecache
+
+QT += multimedia gui testlib
+
+QUICKTOOLS = ../../../../src/qtmultimediaquicktools
+
+INCLUDEPATH += $$QUICKTOOLS
+
+SOURCES += \
+        tst_qsgvideotexturecache.cpp \
+        $$QUICKTOOLS/qsgvideotexturecache.cpp
@@ -0,0 +1,176 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/qtmultimediaquicktools
+
+#include <QtTest/QtTest>
+#include <QtGui/qoffscreensurface.h>
+#include <QtGui/qopenglcontext.h>
+
+#include "qsgvideotexturecache_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QSGVideoTextureCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void shareBetweenNodes();
+    void differentFrames();
+    void reuseTextures();
+    void contextDestroyed();
+
+private:
+    static QVideoFrame createFrame();
+
+    QOffscreenSurface *m_surface = nullptr;
+    QOpenGLContext *m_context = nullptr;
+};
+
+QVideoFrame tst_QSGVideoTextureCache::createFrame()
+{
+    return QVideoFrame(4 * 4 * 4, QSize(4, 4), 4 * 4, QVideoFrame::Format_RGB32);
+}
+
+void tst_QSGVideoTextureCache::initTestCase()
+{
+    m_surface = new QOffscreenSurface;
+    m_surface->create();
+    m_context = new QOpenGLContext;
+    if (!m_context->create() || !m_context->makeCurrent(m_surface))
+        QSKIP("No OpenGL context available");
+}
+
+void tst_QSGVideoTextureCache::cleanupTestCase()
+{
+    delete m_context;
+    delete m_surface;
+}
+
+void tst_QSGVideoTextureCache::shareBetweenNodes()
+{
+    QSGVideoTextureCache *cache = QSGVideoTextureCache::instance(m_context);
+    QVERIFY(cache);
+    QCOMPARE(QSGVideoTextureCache::instance(m_context), cache);
+
+    // The first node to bind the frame uploads it
+    const QVideoFrame frame = createFrame();
+    QSGVideoTextureCache::Entry *first = cache->acquire(frame, 2);
+    QVERIFY(first);
+    QVERIFY(!first->uploaded);
+    QVERIFY(first->textureIds[0] != 0);
+    QVERIFY(first->textureIds[1] != 0);
+    QVERIFY(first->frame == frame);
+
+    // A second node handed the same frame gets the same textures and skips
+    // the upload.
+    QSGVideoTextureCache::Entry *second = cache->acquire(frame, 2);
+    QCOMPARE(second, first);
+    first->uploaded = true;
+    QVERIFY(second->uploaded);
+    QCOMPARE(first->refs, 2);
+
+    // The frame is held until both nodes are done with it
+    QSGVideoTextureCache::frameDone(first);
+    QVERIFY(first->frame == frame);
+    QSGVideoTextureCache::frameDone(second);
+    QVERIFY(!first->frame.isValid());
+
+    // Once released by the entry, the frame is not matched any more
+    QSGVideoTextureCache::Entry *third = cache->acquire(frame, 2);
+    QVERIFY(third != first);
+    QVERIFY(!third->uploaded);
+
+    QSGVideoTextureCache::frameDone(third);
+    QSGVideoTextureCache::release(third);
+    QSGVideoTextureCache::release(second);
+    QSGVideoTextureCache::release(first);
+}
+
+void tst_QSGVideoTextureCache::differentFrames()
+{
+    QSGVideoTextureCache *cache = QSGVideoTextureCache::instance(m_context);
+
+    const QVideoFrame frame = createFrame();
+    QSGVideoTextureCache::Entry *first = cache->acquire(frame, 1);
+    QSGVideoTextureCache::Entry *other = cache->acquire(createFrame(), 1);
+    QSGVideoTextureCache::Entry *planes = cache->acquire(frame, 3);
+
+    QVERIFY(other != first);
+    QVERIFY(other->textureIds[0] != first->textureIds[0]);
+    QVERIFY(planes != first);
+    QCOMPARE(planes->planeCount, 3);
+
+    for (QSGVideoTextureCache::Entry *entry : { first, other, planes }) {
+        QSGVideoTextureCache::frameDone(entry);
+        QSGVideoTextureCache::release(entry);
+    }
+}
+
+void tst_QSGVideoTextureCache::reuseTextures()
+{
+    QSGVideoTextureCache *cache = QSGVideoTextureCache::instance(m_context);
+
+    QSGVideoTextureCache::Entry *entry = cache->acquire(createFrame(), 1);
+    const GLuint texture = entry->textureIds[0];
+    QSGVideoTextureCache::frameDone(entry);
+    QSGVideoTextureCache::release(entry);
+
+    // The next frame is uploaded into the released texture
+    entry = cache->acquire(createFrame(), 1);
+    QCOMPARE(entry->textureIds[0], texture);
+    QVERIFY(!entry->uploaded);
+    QSGVideoTextureCache::frameDone(entry);
+    QSGVideoTextureCache::release(entry);
+}
+
+void tst_QSGVideoTextureCache::contextDestroyed()
+{
+    QOpenGLContext *context = new QOpenGLContext;
+    QVERIFY(context->create());
+    QVERIFY(context->makeCurrent(m_surface));
+
+    QSGVideoTextureCache *cache = QSGVideoTextureCache::instance(context);
+    QSGVideoTextureCache::Entry *entry = cache->acquire(createFrame(), 1);
+    QSGVideoTextureCache::frameDone(entry);
+
+    // Entries still in use outlive the context
+    delete context;
+    QCOMPARE(entry->cache, cache);
+    QSGVideoTextureCache::release(entry);
+
+    QVERIFY(m_context->makeCurrent(m_surface));
+}
+
+QTEST_MAIN(tst_QSGVideoTextureCache)
+
+#include "tst_qsgvideotexturecache.moc"
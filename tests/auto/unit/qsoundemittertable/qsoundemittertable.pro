@@ -0,0 +1,45 @@
+CONFIG += testcase
+TARGET = tst_qsoundemittertable
+
+QT += multimedia-private qml quick testlib
+
+QMAKE_USE += openal
+mac: DEFINES += HEADER_OPENAL_PREFIX
+
+AUDIOENGINE = ../../../../src/imports/audioengine
+
+INCLUDEPATH += \
+        $$AUDIOENGINE \
+        ../../../../src/multimedia/audio
+
+HEADERS += \
+        $$AUDIOENGINE/qdeclarative_attenuationmodel_p.h \
+        $$AUDIOENGINE/qdeclarative_audioengine_p.h \
+        $$AUDIOENGINE/qdeclarative_soundinstance_p.h \
+        $$AUDIOENGINE/qdeclarative_audiocategory_p.h \
+        $$AUDIOENGINE/qdeclarative_audiolistener_p.h \
+        $$AUDIOENGINE/qdeclarative_playvariation_p.h \
+        $$AUDIOENGINE/qdeclarative_audiosample_p.h \
+        $$AUDIOENGINE/qdeclarative_sound_p.h \
+        $$AUDIOENGINE/qsoundinstance_p.h \
+        $$AUDIOENGINE/qsoundemittertable_p.h \
+        $$AUDIOENGINE/qaudioengine_p.h \
+        $$AUDIOENGINE/qsoundsource_p.h \
+        $$AUDIOENGINE/qsoundbuffer_p.h \
+        $$AUDIOENGINE/qaudioengine_openal_p.h
+
+SOURCES += \
+        tst_qsoundemittertable.cpp \
+        $$AUDIOENGINE/qdeclarative_attenuationmodel_p.cpp \
+        $$AUDIOENGINE/qdeclarative_audioengine_p.cpp \
+        $$AUDIOENGINE/qdeclarative_soundinstance_p.cpp \
+        $$AUDIOENGINE/qdeclarative_audiocategory_p.cpp \
+        $$AUDIOENGINE/qdeclarative_audiolistener_p.cpp \
+        $$AUDIOENGINE/qdeclarative_playvariation_p.cpp \
+        $$AUDIOENGINE/qdeclarative_audiosample_p.cpp \
+        $$AUDIOENGINE/qdeclarative_sound_p.cpp \
+        $$AUDIOENGINE/qsoundinstance_p.cpp \
+        $$AUDIOENGINE/qsoundemittertable_p.cpp \
+        $$AUDIOENGINE/qaudioengine_p.cpp \
+        $$AUDIOENGINE/qsoundsource_openal_p.cpp \
+        $$AUDIOENGINE/qaudioengine_openal_p.cpp
@@ -0,0 +1,205 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/imports/audioengine
+
+#include <QtTest/QtTest>
+
+#include "qsoundemittertable_p.h"
+#include "qsoundinstance_p.h"
+#include "qdeclarative_attenuationmodel_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QSoundEmitterTable : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void linearGain_data();
+    void linearGain();
+    void inverseGain_data();
+    void inverseGain();
+    void swapRemoval();
+
+private:
+    void compareGain(QDeclarativeAttenuationModel *model, qreal distance);
+};
+
+// The table evaluates the built-in curves in single precision.
+static bool gainsMatch(qreal tableGain, qreal modelGain)
+{
+    return qAbs(tableGain - modelGain) < 1e-5;
+}
+
+void tst_QSoundEmitterTable::compareGain(QDeclarativeAttenuationModel *model, qreal distance)
+{
+    QSoundInstance instance(nullptr);
+    QSoundEmitterTable table;
+
+    const QVector3D listener(1, 2, 3);
+    const QVector3D position = listener + QVector3D(0, 0.6f, 0.8f) * float(distance);
+
+    table.setListenerPosition(listener);
+    const int index = table.add(&instance, model, position);
+    QCOMPARE(index, 0);
+    QCOMPARE(instance.emitterIndex(), 0);
+
+    table.update();
+    const qreal expected = model->calculateGain(listener, position);
+    QVERIFY2(gainsMatch(table.gain(index), expected),
+             qPrintable(QString::fromLatin1("gain %1, expected %2").arg(table.gain(index)).arg(expected)));
+
+    table.clear();
+    QCOMPARE(instance.emitterIndex(), -1);
+}
+
+void tst_QSoundEmitterTable::linearGain_data()
+{
+    QTest::addColumn<qreal>("start");
+    QTest::addColumn<qreal>("end");
+    QTest::addColumn<qreal>("distance");
+
+    QTest::newRow("inside") << qreal(10) << qreal(50) << qreal(27);
+    QTest::newRow("before start") << qreal(10) << qreal(50) << qreal(4);
+    QTest::newRow("at start") << qreal(10) << qreal(50) << qreal(10);
+    QTest::newRow("at end") << qreal(10) << qreal(50) << qreal(50);
+    QTest::newRow("beyond end") << qreal(10) << qreal(50) << qreal(80);
+    QTest::newRow("zero start") << qreal(0) << qreal(20) << qreal(5);
+    QTest::newRow("end equals start") << qreal(10) << qreal(10) << qreal(15);
+    QTest::newRow("end before start") << qreal(30) << qreal(10) << qreal(20);
+}
+
+void tst_QSoundEmitterTable::linearGain()
+{
+    QFETCH(qreal, start);
+    QFETCH(qreal, end);
+    QFETCH(qreal, distance);
+
+    QDeclarativeAttenuationModelLinear model;
+    model.setStartDistance(start);
+    model.setEndDistance(end);
+
+    compareGain(&model, distance);
+}
+
+void tst_QSoundEmitterTable::inverseGain_data()
+{
+    QTest::addColumn<qreal>("reference");
+    QTest::addColumn<qreal>("maximum");
+    QTest::addColumn<qreal>("rolloff");
+    QTest::addColumn<qreal>("distance");
+
+    QTest::newRow("inside") << qreal(5) << qreal(100) << qreal(1) << qreal(40);
+    QTest::newRow("before reference") << qreal(5) << qreal(100) << qreal(1) << qreal(2);
+    QTest::newRow("at reference") << qreal(5) << qreal(100) << qreal(1) << qreal(5);
+    QTest::newRow("at maximum") << qreal(5) << qreal(100) << qreal(1) << qreal(100);
+    QTest::newRow("beyond maximum") << qreal(5) << qreal(100) << qreal(1) << qreal(250);
+    QTest::newRow("steep rolloff") << qreal(5) << qreal(100) << qreal(3.5) << qreal(60);
+    QTest::newRow("no rolloff") << qreal(5) << qreal(100) << qreal(0) << qreal(60);
+    QTest::newRow("maximum equals reference") << qreal(20) << qreal(20) << qreal(1) << qreal(30);
+    QTest::newRow("maximum before reference") << qreal(20) << qreal(10) << qreal(1) << qreal(15);
+}
+
+void tst_QSoundEmitterTable::inverseGain()
+{
+    QFETCH(qreal, reference);
+    QFETCH(qreal, maximum);
+    QFETCH(qreal, rolloff);
+    QFETCH(qreal, distance);
+
+    QDeclarativeAttenuationModelInverse model;
+    model.setReferenceDistance(reference);
+    model.setMaxDistance(maximum);
+    model.setRolloffFactor(rolloff);
+
+    compareGain(&model, distance);
+}
+
+void tst_QSoundEmitterTable::swapRemoval()
+{
+    QDeclarativeAttenuationModelLinear linear;
+    linear.setStartDistance(0);
+    linear.setEndDistance(100);
+
+    QDeclarativeAttenuationModelInverse inverse;
+    inverse.setReferenceDistance(2);
+    inverse.setMaxDistance(50);
+    inverse.setRolloffFactor(2);
+
+    QSoundInstance first(nullptr);
+    QSoundInstance second(nullptr);
+    QSoundInstance third(nullptr);
+
+    const QVector3D listener;
+    const QVector3D secondPosition(0, 30, 0);
+    const QVector3D thirdPosition(0, 0, 10);
+
+    QSoundEmitterTable table;
+    table.add(&first, &linear, QVector3D(70, 0, 0));
+    table.add(&second, &linear, secondPosition);
+    table.add(&third, &inverse, thirdPosition);
+    QCOMPARE(table.count(), 3);
+
+    // The last row moves into the hole left by the removed one
+    table.remove(0);
+    QCOMPARE(table.count(), 2);
+    QCOMPARE(first.emitterIndex(), -1);
+    QCOMPARE(third.emitterIndex(), 0);
+    QCOMPARE(second.emitterIndex(), 1);
+
+    QVERIFY(table.isDirty());
+    table.update();
+    QVERIFY(!table.isDirty());
+    QVERIFY(gainsMatch(table.gain(third.emitterIndex()),
+                       inverse.calculateGain(listener, thirdPosition)));
+    QVERIFY(gainsMatch(table.gain(second.emitterIndex()),
+                       linear.calculateGain(listener, secondPosition)));
+
+    // Positions follow the moved row
+    const QVector3D movedPosition(0, 0, 30);
+    table.setPosition(third.emitterIndex(), movedPosition);
+    table.update();
+    QVERIFY(gainsMatch(table.gain(third.emitterIndex()),
+                       inverse.calculateGain(listener, movedPosition)));
+    QVERIFY(gainsMatch(table.gain(second.emitterIndex()),
+                       linear.calculateGain(listener, secondPosition)));
+
+    // Removing the last row does not move anything
+    table.remove(1);
+    QCOMPARE(table.count(), 1);
+    QCOMPARE(second.emitterIndex(), -1);
+    QCOMPARE(third.emitterIndex(), 0);
+
+    table.clear();
+    QCOMPARE(third.emitterIndex(), -1);
+}
+
+QTEST_GUILESS_MAIN(tst_QSoundEmitterTable)
+
+#include "tst_qsoundemittertable.moc"
@@ -0,0 +1,15 @@
+CONFIG += testcase
+TARGET = tst_qvideoframescaling
+
+QT += multimedia-private testlib
+
+# The scaled conversion is internal to Qt Multimedia Widgets
+MULTIMEDIAWIDGETS = ../../../../src/multimediawidgets
+
+INCLUDEPATH += $$MULTIMEDIAWIDGETS
+
+HEADERS += $$MULTIMEDIAWIDGETS/qvideoframescaling_p.h
+
+SOURCES += \
+        tst_qvideoframescaling.cpp \
+        $$MULTIMEDIAWIDGETS/qvideoframescaling.cpp
@@ -0,0 +1,190 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/multimediawidgets
+
+#include <QtTest/QtTest>
+#include <QtGui/qimage.h>
+#include <qvideoframe.h>
+
+#include "qvideoframescaling_p.h"
+
+QT_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QVideoFrame::PixelFormat)
+
+// The full frame conversion works on pairs of pixels and lines, so the
+// frames have even sizes. The odd sizes are in the source and target
+// rectangles.
+static const QSize FrameSize(34, 18);
+
+class tst_QVideoFrameScaling : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void compareWithFullConversion_data();
+    void compareWithFullConversion();
+    void unsupportedFormat();
+    void emptySource();
+
+private:
+    static QVideoFrame createFrame(QVideoFrame::PixelFormat format);
+};
+
+// A frame filled with a pattern that differs in every byte, so that a wrong
+// plane, chroma sample or component order shows up in the result.
+QVideoFrame tst_QVideoFrameScaling::createFrame(QVideoFrame::PixelFormat format)
+{
+    int bytesPerLine = FrameSize.width();
+    int bytes = 0;
+
+    switch (format) {
+    case QVideoFrame::Format_YUV420P:
+    case QVideoFrame::Format_YV12:
+    case QVideoFrame::Format_NV12:
+    case QVideoFrame::Format_NV21:
+        bytes = FrameSize.width() * FrameSize.height() * 3 / 2;
+        break;
+    default:
+        bytesPerLine *= 2;
+        bytes = bytesPerLine * FrameSize.height();
+        break;
+    }
+
+    QVideoFrame frame(bytes, FrameSize, bytesPerLine, format);
+    if (frame.map(QAbstractVideoBuffer::WriteOnly)) {
+        uchar *data = frame.bits();
+        for (int i = 0; i < frame.mappedBytes(); ++i)
+            data[i] = uchar(i * 7 + i / bytesPerLine * 13);
+        frame.unmap();
+    }
+    return frame;
+}
+
+void tst_QVideoFrameScaling::compareWithFullConversion_data()
+{
+    QTest::addColumn<QVideoFrame::PixelFormat>("pixelFormat");
+    QTest::addColumn<QRect>("source");
+    QTest::addColumn<QSize>("size");
+
+    const QList<QPair<QVideoFrame::PixelFormat, const char *>> formats = {
+        { QVideoFrame::Format_YUV420P, "YUV420P" },
+        { QVideoFrame::Format_YV12, "YV12" },
+        { QVideoFrame::Format_NV12, "NV12" },
+        { QVideoFrame::Format_NV21, "NV21" },
+        { QVideoFrame::Format_YUYV, "YUYV" },
+        { QVideoFrame::Format_UYVY, "UYVY" }
+    };
+
+    const QRect frameRect(QPoint(0, 0), FrameSize);
+    const QRect oddRect(3, 1, 25, 13);
+
+    for (const auto &format : formats) {
+        QTest::addRow("%s, 1:1", format.second)
+                << format.first << frameRect << FrameSize;
+        QTest::addRow("%s, odd size", format.second)
+                << format.first << frameRect << QSize(13, 7);
+        QTest::addRow("%s, odd source, 1:1", format.second)
+                << format.first << oddRect << oddRect.size();
+        QTest::addRow("%s, odd source, odd size", format.second)
+                << format.first << oddRect << QSize(9, 5);
+        QTest::addRow("%s, upscaled", format.second)
+                << format.first << oddRect << QSize(51, 27);
+        QTest::addRow("%s, single pixel", format.second)
+                << format.first << oddRect << QSize(1, 1);
+    }
+}
+
+// The scaled conversion has to produce the same pixels as converting the
+// whole frame and sampling the result at the centre of each target pixel.
+void tst_QVideoFrameScaling::compareWithFullConversion()
+{
+    QFETCH(QVideoFrame::PixelFormat, pixelFormat);
+    QFETCH(QRect, source);
+    QFETCH(QSize, size);
+
+    QVideoFrame frame = createFrame(pixelFormat);
+    QVERIFY(frame.isValid());
+
+    const QImage converted = frame.image();
+    QCOMPARE(converted.size(), FrameSize);
+
+    QVERIFY(frame.map(QAbstractVideoBuffer::ReadOnly));
+    QImage scaled(size, QImage::Format_RGB32);
+    const bool ok = qt_convert_scaled_to_ARGB32(frame, source, scaled.bits(),
+                                                scaled.bytesPerLine(), size);
+    frame.unmap();
+    QVERIFY(ok);
+
+    for (int y = 0; y < size.height(); ++y) {
+        const int sourceY = source.y() + (2 * y + 1) * source.height() / (2 * size.height());
+        for (int x = 0; x < size.width(); ++x) {
+            const int sourceX = source.x() + (2 * x + 1) * source.width() / (2 * size.width());
+            const QRgb expected = converted.pixel(sourceX, sourceY);
+            const QRgb actual = scaled.pixel(x, y);
+            if (actual != expected) {
+                QFAIL(qPrintable(QStringLiteral("Pixel (%1, %2) is %3, expected %4 from (%5, %6)")
+                                 .arg(x).arg(y)
+                                 .arg(actual, 8, 16, QLatin1Char('0'))
+                                 .arg(expected, 8, 16, QLatin1Char('0'))
+                                 .arg(sourceX).arg(sourceY)));
+            }
+        }
+    }
+}
+
+void tst_QVideoFrameScaling::unsupportedFormat()
+{
+    QVideoFrame frame(FrameSize.width() * FrameSize.height() * 4, FrameSize,
+                      FrameSize.width() * 4, QVideoFrame::Format_RGB32);
+    QVERIFY(frame.map(QAbstractVideoBuffer::ReadOnly));
+
+    QImage scaled(QSize(5, 5), QImage::Format_RGB32);
+    QVERIFY(!qt_convert_scaled_to_ARGB32(frame, QRect(QPoint(0, 0), FrameSize), scaled.bits(),
+                                         scaled.bytesPerLine(), scaled.size()));
+    frame.unmap();
+}
+
+void tst_QVideoFrameScaling::emptySource()
+{
+    QVideoFrame frame = createFrame(QVideoFrame::Format_YUV420P);
+    QVERIFY(frame.map(QAbstractVideoBuffer::ReadOnly));
+
+    // Sources outside of the frame and empty targets are rejected
+    QImage scaled(QSize(5, 5), QImage::Format_RGB32);
+    QVERIFY(!qt_convert_scaled_to_ARGB32(frame, QRect(QPoint(40, 20), QSize(10, 10)), scaled.bits(),
+                                         scaled.bytesPerLine(), scaled.size()));
+    QVERIFY(!qt_convert_scaled_to_ARGB32(frame, QRect(QPoint(0, 0), FrameSize), scaled.bits(),
+                                         scaled.bytesPerLine(), QSize(0, 5)));
+    frame.unmap();
+}
+
+QTEST_GUILESS_MAIN(tst_QVideoFrameScaling)
+
+#include "tst_qvideoframescaling.moc"
@@ -0,0 +1,14 @@
+CONFIG += testcase
+TARGET = tst_qvideosurfaces
+
+QT += multimedia-private testlib
+
+VIDEO = ../../../../src/multimedia/video
+
+INCLUDEPATH += $$VIDEO
+
+HEADERS += $$VIDEO/qvideosurfaces_p.h
+
+SOURCES += \
+        tst_qvideosurfaces.cpp \
+        $$VIDEO/qvideosurfaces.cpp
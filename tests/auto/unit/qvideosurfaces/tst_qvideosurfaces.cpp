@@ -0,0 +1,206 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/multimedia
+
+#include <QtTest/QtTest>
+#include <QtCore/qthread.h>
+#include <QtMultimedia/qvideosurfaceformat.h>
+
+#include "qvideosurfaces_p.h"
+
+QT_USE_NAMESPACE
+
+class RecordingSurface : public QAbstractVideoSurface
+{
+public:
+    QList<QVideoFrame::PixelFormat> supportedPixelFormats(
+            QAbstractVideoBuffer::HandleType type) const override
+    {
+        if (type != QAbstractVideoBuffer::NoHandle)
+            return QList<QVideoFrame::PixelFormat>();
+        return QList<QVideoFrame::PixelFormat>() << QVideoFrame::Format_RGB32;
+    }
+
+    bool present(const QVideoFrame &frame) override
+    {
+        QMutexLocker locker(&mutex);
+        frames.append(frame);
+        threads.append(QThread::currentThread());
+        return !rejectFrames;
+    }
+
+    int frameCount()
+    {
+        QMutexLocker locker(&mutex);
+        return frames.size();
+    }
+
+    QMutex mutex;
+    QList<QVideoFrame> frames;
+    QList<QThread *> threads;
+    bool rejectFrames = false;
+};
+
+class tst_QVideoSurfaces : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fanOut();
+    void rejectedFrame();
+    void otherThread();
+    void otherThreadRejectedFrame();
+
+private:
+    static QVideoFrame createFrame();
+    static QVideoSurfaceFormat surfaceFormat();
+};
+
+QVideoFrame tst_QVideoSurfaces::createFrame()
+{
+    return QVideoFrame(4 * 4 * 4, QSize(4, 4), 4 * 4, QVideoFrame::Format_RGB32);
+}
+
+QVideoSurfaceFormat tst_QVideoSurfaces::surfaceFormat()
+{
+    return QVideoSurfaceFormat(QSize(4, 4), QVideoFrame::Format_RGB32);
+}
+
+void tst_QVideoSurfaces::fanOut()
+{
+    RecordingSurface first;
+    RecordingSurface second;
+    QVideoSurfaces surfaces({ &first, &second });
+
+    QCOMPARE(surfaces.supportedPixelFormats(QAbstractVideoBuffer::NoHandle),
+             QList<QVideoFrame::PixelFormat>() << QVideoFrame::Format_RGB32);
+    QVERIFY(surfaces.start(surfaceFormat()));
+    QVERIFY(first.isActive());
+    QVERIFY(second.isActive());
+
+    // Surfaces in the calling thread are presented to right away, and all
+    // of them get the same frame.
+    const QVideoFrame frame = createFrame();
+    QVERIFY(surfaces.present(frame));
+    QCOMPARE(first.frames.size(), 1);
+    QCOMPARE(second.frames.size(), 1);
+    QVERIFY(first.frames.first() == frame);
+    QVERIFY(second.frames.first() == frame);
+    QCOMPARE(first.threads.first(), QThread::currentThread());
+
+    QVERIFY(surfaces.present(createFrame()));
+    QCOMPARE(first.frames.size(), 2);
+    QCOMPARE(second.frames.size(), 2);
+
+    surfaces.stop();
+    QVERIFY(!first.isActive());
+    QVERIFY(!second.isActive());
+
+    // Nothing is queued for later
+    QCoreApplication::processEvents();
+    QCOMPARE(first.frames.size(), 2);
+}
+
+void tst_QVideoSurfaces::rejectedFrame()
+{
+    RecordingSurface first;
+    RecordingSurface second;
+    second.rejectFrames = true;
+    QVideoSurfaces surfaces({ &first, &second });
+    QVERIFY(surfaces.start(surfaceFormat()));
+
+    // Reported for the frame itself, and every surface still gets it
+    QVERIFY(!surfaces.present(createFrame()));
+    QCOMPARE(first.frames.size(), 1);
+    QCOMPARE(second.frames.size(), 1);
+
+    second.rejectFrames = false;
+    QVERIFY(surfaces.present(createFrame()));
+}
+
+void tst_QVideoSurfaces::otherThread()
+{
+    QThread thread;
+    thread.start();
+
+    RecordingSurface local;
+    RecordingSurface remote;
+    remote.moveToThread(&thread);
+
+    {
+        QVideoSurfaces surfaces({ &local, &remote });
+        QVERIFY(surfaces.start(surfaceFormat()));
+
+        const QVideoFrame frame = createFrame();
+        QVERIFY(surfaces.present(frame));
+        QCOMPARE(local.frames.size(), 1);
+
+        QTRY_COMPARE(remote.frameCount(), 1);
+        QMutexLocker locker(&remote.mutex);
+        QVERIFY(remote.frames.first() == frame);
+        QCOMPARE(remote.threads.first(), &thread);
+    }
+
+    thread.quit();
+    thread.wait();
+}
+
+void tst_QVideoSurfaces::otherThreadRejectedFrame()
+{
+    QThread thread;
+    thread.start();
+
+    RecordingSurface remote;
+    remote.rejectFrames = true;
+    remote.moveToThread(&thread);
+
+    {
+        QVideoSurfaces surfaces({ &remote });
+        QVERIFY(surfaces.start(surfaceFormat()));
+
+        // The failure is only known once the surface's thread presented the
+        // frame, so it is reported by the next call.
+        QVERIFY(surfaces.present(createFrame()));
+        QTRY_COMPARE(remote.frameCount(), 1);
+        QVERIFY(!surfaces.present(createFrame()));
+
+        {
+            QMutexLocker locker(&remote.mutex);
+            remote.rejectFrames = false;
+        }
+        QTRY_VERIFY(surfaces.present(createFrame()));
+    }
+
+    thread.quit();
+    thread.wait();
+}
+
+QTEST_MAIN(tst_QVideoSurfaces)
+
+#include "tst_qvideosurfaces.moc"
@@ -65,6 +65,13 @@ private slots:
 
     void readAllAtOnce();
     void readPerByte();
+
+    void mappedFile();
+    void targetFormat_data();
+    void targetFormat();
+    void targetFormatSequential();
+    void hostByteOrder_data();
+    void hostByteOrder();
 };
 
 Q_DECLARE_METATYPE(tst_QWaveDecoder::Corruption)
@@ -299,6 +306,187 @@ void tst_QWaveDecoder::readPerByte()
     stream.close();
 }
 
+void tst_QWaveDecoder::mappedFile()
+{
+    QFile stream(testFilePath("isawav_1_16_44100_le_2.wav"));
+    QVERIFY(stream.open(QIODevice::ReadOnly));
+
+    QWaveDecoder waveDecoder(&stream);
+    QVERIFY(waveDecoder.isMapped());
+
+    QSignalSpy validFormatSpy(&waveDecoder, SIGNAL(formatKnown()));
+    QTRY_COMPARE(validFormatSpy.count(), 1);
+
+    // The data chunk starts after the 18 byte fmt chunk.
+    const QByteArray raw = stream.readAll();
+    const int dataOffset = raw.indexOf("data") + 8;
+    QCOMPARE(waveDecoder.size(), qint64(raw.size() - dataOffset));
+    QCOMPARE(waveDecoder.bytesAvailable(), waveDecoder.size());
+
+    const QByteArray samples = waveDecoder.readAll();
+    QCOMPARE(samples, raw.mid(dataOffset));
+    QCOMPARE(waveDecoder.bytesAvailable(), qint64(0));
+
+    stream.close();
+    QVERIFY(!waveDecoder.isMapped());
+}
+
+void tst_QWaveDecoder::targetFormat_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<QAudioFormat::SampleType>("sampleType");
+    QTest::addColumn<int>("sampleSize");
+
+    QTest::newRow("u8 -> s16") << testFilePath("isawav_2_8_44100.wav") << QAudioFormat::SignedInt << 16;
+    QTest::newRow("u8 -> f32") << testFilePath("isawav_2_8_44100.wav") << QAudioFormat::Float << 32;
+    QTest::newRow("s16le -> s16") << testFilePath("isawav_1_16_44100_le.wav") << QAudioFormat::SignedInt << 16;
+    QTest::newRow("s16le -> f32") << testFilePath("isawav_1_16_44100_le.wav") << QAudioFormat::Float << 32;
+    QTest::newRow("s16be -> s16") << testFilePath("isawav_2_16_44100_be.wav") << QAudioFormat::SignedInt << 16;
+    QTest::newRow("s16be -> f32") << testFilePath("isawav_2_16_44100_be.wav") << QAudioFormat::Float << 32;
+}
+
+static qint32 referenceSample(const QAudioFormat &format, const char *p)
+{
+    if (format.sampleSize() == 8)
+        return (quint8(*p) - 128) * (1 << 24);
+    const qint16 value = format.byteOrder() == QAudioFormat::BigEndian
+            ? qFromBigEndian<qint16>(p) : qFromLittleEndian<qint16>(p);
+    return qint32(value) * 65536;
+}
+
+void tst_QWaveDecoder::targetFormat()
+{
+    QFETCH(QString, file);
+    QFETCH(QAudioFormat::SampleType, sampleType);
+    QFETCH(int, sampleSize);
+
+    QFile stream(file);
+    QVERIFY(stream.open(QIODevice::ReadOnly));
+
+    QAudioFormat target;
+    target.setSampleType(sampleType);
+    target.setSampleSize(sampleSize);
+
+    QWaveDecoder waveDecoder(&stream);
+    waveDecoder.setTargetFormat(target);
+    QSignalSpy validFormatSpy(&waveDecoder, SIGNAL(formatKnown()));
+    QTRY_COMPARE(validFormatSpy.count(), 1);
+
+    const QAudioFormat source = waveDecoder.sourceFormat();
+    const QAudioFormat format = waveDecoder.audioFormat();
+    QCOMPARE(format.sampleType(), sampleType);
+    QCOMPARE(format.sampleSize(), sampleSize);
+    QCOMPARE(format.byteOrder(), QSysInfo::ByteOrder == QSysInfo::BigEndian
+             ? QAudioFormat::BigEndian : QAudioFormat::LittleEndian);
+    QCOMPARE(format.channelCount(), source.channelCount());
+    QCOMPARE(format.sampleRate(), source.sampleRate());
+    QCOMPARE(waveDecoder.duration(), 250);
+
+    const qint64 sampleCount = waveDecoder.size() / (sampleSize / 8);
+    const QByteArray raw = stream.readAll();
+    const QByteArray rawSamples = raw.right(int(sampleCount * (source.sampleSize() / 8)));
+
+    // Read in odd sized pieces so that samples straddle reads.
+    QByteArray converted;
+    while (waveDecoder.bytesAvailable() > 0)
+        converted += waveDecoder.read(7);
+    QCOMPARE(qint64(converted.size()), waveDecoder.size());
+
+    for (qint64 i = 0; i < sampleCount; ++i) {
+        const qint32 expected = referenceSample(source, rawSamples.constData() + i * (source.sampleSize() / 8));
+        if (sampleType == QAudioFormat::Float) {
+            const float value = reinterpret_cast<const float *>(converted.constData())[i];
+            QCOMPARE(value, float(expected) / 2147483648.0f);
+        } else {
+            const qint16 value = reinterpret_cast<const qint16 *>(converted.constData())[i];
+            QCOMPARE(value, qint16(expected >> 16));
+        }
+    }
+}
+
+void tst_QWaveDecoder::targetFormatSequential()
+{
+    // Over the network the decoder can't map the file and converts as the
+    // data arrives instead.
+    QNetworkAccessManager nam;
+    QNetworkReply *reply = nam.get(QNetworkRequest(QUrl::fromLocalFile(testFilePath("isawav_2_16_44100_be.wav"))));
+
+    QAudioFormat target;
+    target.setSampleType(QAudioFormat::Float);
+    target.setSampleSize(32);
+
+    QWaveDecoder waveDecoder(reply);
+    waveDecoder.setTargetFormat(target);
+    QVERIFY(!waveDecoder.isMapped());
+
+    QSignalSpy validFormatSpy(&waveDecoder, SIGNAL(formatKnown()));
+    QTRY_COMPARE(validFormatSpy.count(), 1);
+    QCOMPARE(waveDecoder.audioFormat().sampleType(), QAudioFormat::Float);
+    QCOMPARE(waveDecoder.size(), qint64(waveDecoder.sourceFormat().bytesForDuration(250000) * 2));
+
+    QByteArray converted = waveDecoder.readAll();
+    for (int i = 0; i < 100 && converted.size() < waveDecoder.size(); ++i) {
+        QTest::qWait(10);
+        converted += waveDecoder.readAll();
+    }
+    QCOMPARE(qint64(converted.size()), waveDecoder.size());
+
+    delete reply;
+}
+
+void tst_QWaveDecoder::hostByteOrder_data()
+{
+    QTest::addColumn<QString>("file");
+
+    QTest::newRow("u8") << testFilePath("isawav_2_8_44100.wav");
+    QTest::newRow("s16le") << testFilePath("isawav_1_16_44100_le.wav");
+    QTest::newRow("s16be") << testFilePath("isawav_2_16_44100_be.wav");
+    QTest::newRow("s32le") << testFilePath("isawav_1_32_44100_le.wav");
+    QTest::newRow("s32be") << testFilePath("isawav_2_32_44100_be.wav");
+}
+
+void tst_QWaveDecoder::hostByteOrder()
+{
+    QFETCH(QString, file);
+
+    QFile stream(file);
+    QVERIFY(stream.open(QIODevice::ReadOnly));
+
+    // An unknown sample type keeps the width and only fixes the byte order
+    QAudioFormat target;
+    target.setSampleType(QAudioFormat::Unknown);
+
+    QWaveDecoder waveDecoder(&stream);
+    waveDecoder.setTargetFormat(target);
+    QSignalSpy validFormatSpy(&waveDecoder, SIGNAL(formatKnown()));
+    QTRY_COMPARE(validFormatSpy.count(), 1);
+
+    const QAudioFormat source = waveDecoder.sourceFormat();
+    const QAudioFormat format = waveDecoder.audioFormat();
+    const int bytes = source.sampleSize() / 8;
+    QCOMPARE(format.sampleType(), source.sampleType());
+    QCOMPARE(format.sampleSize(), source.sampleSize());
+    if (bytes > 1) {
+        QCOMPARE(format.byteOrder(), QSysInfo::ByteOrder == QSysInfo::BigEndian
+                 ? QAudioFormat::BigEndian : QAudioFormat::LittleEndian);
+    }
+    QCOMPARE(waveDecoder.size(), qint64(source.bytesForDuration(250000)));
+
+    const QByteArray raw = stream.readAll();
+    const QByteArray rawSamples = raw.right(int(waveDecoder.size()));
+
+    QByteArray converted;
+    while (waveDecoder.bytesAvailable() > 0)
+        converted += waveDecoder.read(7);
+    QCOMPARE(converted.size(), rawSamples.size());
+
+    const bool swapped = bytes > 1 && source.byteOrder() != format.byteOrder();
+    for (int i = 0; i < converted.size(); i += bytes) {
+        for (int b = 0; b < bytes; ++b)
+            QCOMPARE(converted.at(i + b), rawSamples.at(i + (swapped ? bytes - 1 - b : b)));
+    }
+}
+
 QTEST_MAIN(tst_QWaveDecoder)
 
 #include "tst_qwavedecoder.moc"
@@ -0,0 +1,19 @@
+TEMPLATE = subdirs
+QT_FOR_CONFIG += multimedia-private
+
+# The benchmarks generate their own media and need no audio or video
+# hardware. Pass e.g. "-o results.xml,xml" or "-csv" to a benchmark for
+# results that regression tracking can consume.
+
+SUBDIRS += \
+    qaudiobatchdecoder \
+    qaudiodecoder \
+    qaudiohelpers \
+    qaudioresampler \
+    qmediatimerange \
+    qsamplecache \
+    qvideoframeconversion \
+    qvideoframetriplebuffer
+
+qtConfig(gstreamer): SUBDIRS += qgstreamerpipeline
+qtConfig(gstreamer_1_0): SUBDIRS += qvideoframe
@@ -0,0 +1,6 @@
+TARGET = tst_bench_qaudiobatchdecoder
+
+QT += multimedia testlib
+CONFIG += release
+
+SOURCES += tst_bench_qaudiobatchdecoder.cpp
@@ -0,0 +1,172 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qtemporarydir.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qmath.h>
+#include <QtMultimedia/qaudiodecoder.h>
+#include <QtMultimedia/qaudiobatchdecoder.h>
+
+QT_USE_NAMESPACE
+
+static const int FileCount = 16;
+static const int SampleRate = 44100;
+static const int ChannelCount = 2;
+static const int DurationSeconds = 10;
+
+class tst_QAudioBatchDecoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void sequential();
+    void batch_data();
+    void batch();
+
+private:
+    static bool writeWaveFile(const QString &fileName, int frequency);
+
+    QTemporaryDir m_dir;
+    QStringList m_fileNames;
+};
+
+// 16 bit PCM with a plain 44 byte RIFF header
+bool tst_QAudioBatchDecoder::writeWaveFile(const QString &fileName, int frequency)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    const quint32 frames = SampleRate * DurationSeconds;
+    const quint32 dataSize = frames * ChannelCount * 2;
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData("RIFF", 4);
+    out << quint32(36 + dataSize);
+    out.writeRawData("WAVEfmt ", 8);
+    out << quint32(16) << quint16(1) << quint16(ChannelCount) << quint32(SampleRate)
+        << quint32(SampleRate * ChannelCount * 2) << quint16(ChannelCount * 2) << quint16(16);
+    out.writeRawData("data", 4);
+    out << dataSize;
+
+    QByteArray data(dataSize, Qt::Uninitialized);
+    qint16 *samples = reinterpret_cast<qint16 *>(data.data());
+    for (quint32 i = 0; i < frames; ++i) {
+        const qint16 value = qint16(16000 * qSin(2 * M_PI * frequency * i / SampleRate));
+        for (int c = 0; c < ChannelCount; ++c)
+            *samples++ = value;
+    }
+    out.writeRawData(data.constData(), data.size());
+
+    return out.status() == QDataStream::Ok;
+}
+
+void tst_QAudioBatchDecoder::initTestCase()
+{
+    QAudioDecoder decoder;
+    if (decoder.error() == QAudioDecoder::ServiceMissingError)
+        QSKIP("There is no audio decoding support on this platform.");
+
+    QVERIFY(m_dir.isValid());
+    for (int i = 0; i < FileCount; ++i) {
+        const QString fileName = m_dir.filePath(QStringLiteral("fixture%1.wav").arg(i));
+        QVERIFY(writeWaveFile(fileName, 220 + 20 * i));
+        m_fileNames.append(fileName);
+    }
+}
+
+// Baseline: one QAudioDecoder, driven by its signals
+void tst_QAudioBatchDecoder::sequential()
+{
+    qint64 frames = 0;
+
+    QBENCHMARK {
+        frames = 0;
+        for (const QString &fileName : qAsConst(m_fileNames)) {
+            QAudioDecoder decoder;
+            QEventLoop loop;
+            connect(&decoder, &QAudioDecoder::bufferReady, [&]() {
+                frames += decoder.read().frameCount();
+            });
+            connect(&decoder, &QAudioDecoder::finished, &loop, &QEventLoop::quit);
+            connect(&decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error),
+                    &loop, &QEventLoop::quit);
+            decoder.setSourceFilename(fileName);
+            decoder.start();
+            loop.exec();
+        }
+    }
+
+    QCOMPARE(frames, qint64(FileCount) * SampleRate * DurationSeconds);
+}
+
+void tst_QAudioBatchDecoder::batch_data()
+{
+    QTest::addColumn<int>("workers");
+    QTest::addColumn<int>("framesPerBuffer");
+
+    QList<int> workerCounts = QList<int>() << 1 << 2 << 4;
+    if (!workerCounts.contains(QThread::idealThreadCount()))
+        workerCounts << QThread::idealThreadCount();
+
+    for (int workers : qAsConst(workerCounts)) {
+        QTest::newRow(qPrintable(QStringLiteral("%1 workers").arg(workers))) << workers << 0;
+        QTest::newRow(qPrintable(QStringLiteral("%1 workers, 4096 frames").arg(workers))) << workers << 4096;
+    }
+}
+
+void tst_QAudioBatchDecoder::batch()
+{
+    QFETCH(int, workers);
+    QFETCH(int, framesPerBuffer);
+
+    QAudioBatchDecoder decoder;
+    decoder.setMaximumWorkerCount(workers);
+    decoder.setFramesPerBuffer(framesPerBuffer);
+
+    QAtomicInteger<qint64> frames;
+    decoder.setBufferHandler([&frames](int, const QAudioBuffer &buffer) {
+        frames.fetchAndAddRelaxed(buffer.frameCount());
+    });
+
+    QBENCHMARK {
+        frames.store(0);
+        decoder.decode(m_fileNames);
+        QVERIFY(decoder.waitForFinished());
+    }
+
+    QCOMPARE(frames.load(), qint64(FileCount) * SampleRate * DurationSeconds);
+}
+
+QTEST_MAIN(tst_QAudioBatchDecoder)
+
+#include "tst_bench_qaudiobatchdecoder.moc"
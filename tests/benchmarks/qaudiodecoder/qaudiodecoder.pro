@@ -0,0 +1,6 @@
+TARGET = tst_bench_qaudiodecoder
+
+QT += multimedia testlib
+CONFIG += release
+
+SOURCES += tst_bench_qaudiodecoder.cpp
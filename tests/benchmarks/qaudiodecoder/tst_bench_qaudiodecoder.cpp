@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qtemporarydir.h>
+#include <QtMultimedia/qaudiodecoder.h>
+
+QT_USE_NAMESPACE
+
+// Many short files, so that the time is dominated by what it costs to get
+// from one file to the next rather than by decoding
+static const int ShortFileCount = 32;
+static const int ShortFileFrames = 4410;
+
+class tst_QAudioDecoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void decodeFiles_data();
+    void decodeFiles();
+
+private:
+    static bool writeWaveFile(const QString &fileName);
+    static qint64 decodeFile(QAudioDecoder *decoder, const QString &fileName);
+
+    QTemporaryDir m_dir;
+    QStringList m_fileNames;
+};
+
+// 100 ms of 16 bit mono PCM with a plain 44 byte RIFF header
+bool tst_QAudioDecoder::writeWaveFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    const quint32 sampleRate = 44100;
+    const quint32 dataSize = ShortFileFrames * 2;
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData("RIFF", 4);
+    out << quint32(36 + dataSize);
+    out.writeRawData("WAVEfmt ", 8);
+    out << quint32(16) << quint16(1) << quint16(1) << sampleRate
+        << quint32(sampleRate * 2) << quint16(2) << quint16(16);
+    out.writeRawData("data", 4);
+    out << dataSize;
+
+    QByteArray data(dataSize, Qt::Uninitialized);
+    qint16 *samples = reinterpret_cast<qint16 *>(data.data());
+    for (int i = 0; i < ShortFileFrames; ++i)
+        samples[i] = qint16((i % 100) * 300 - 15000);
+    out.writeRawData(data.constData(), data.size());
+
+    return out.status() == QDataStream::Ok;
+}
+
+// Decodes one file to the end and returns the number of decoded frames,
+// or -1 on failure.
+qint64 tst_QAudioDecoder::decodeFile(QAudioDecoder *decoder, const QString &fileName)
+{
+    qint64 frames = 0;
+    QEventLoop loop;
+    bool failed = false;
+
+    QMetaObject::Connection ready = connect(decoder, &QAudioDecoder::bufferReady, [&]() {
+        while (decoder->bufferAvailable())
+            frames += decoder->read().frameCount();
+    });
+    QMetaObject::Connection finished = connect(decoder, &QAudioDecoder::finished,
+                                               &loop, &QEventLoop::quit);
+    QMetaObject::Connection error = connect(decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error),
+                                            [&]() { failed = true; loop.quit(); });
+
+    decoder->setSourceFilename(fileName);
+    decoder->start();
+    loop.exec();
+
+    disconnect(ready);
+    disconnect(finished);
+    disconnect(error);
+    decoder->stop();
+
+    return failed ? -1 : frames;
+}
+
+void tst_QAudioDecoder::initTestCase()
+{
+    {
+        QAudioDecoder decoder;
+        if (decoder.error() == QAudioDecoder::ServiceMissingError)
+            QSKIP("There is no audio decoding support on this platform.");
+    }
+
+    QVERIFY(m_dir.isValid());
+    for (int i = 0; i < ShortFileCount; ++i) {
+        const QString fileName = m_dir.filePath(QStringLiteral("short%1.wav").arg(i));
+        QVERIFY(writeWaveFile(fileName));
+        m_fileNames.append(fileName);
+    }
+}
+
+void tst_QAudioDecoder::decodeFiles_data()
+{
+    QTest::addColumn<bool>("reuseDecoder");
+
+    QTest::newRow("new decoder per file") << false;
+    QTest::newRow("warm pipeline") << true;
+}
+
+// Decodes many short files back to back. Reusing the decoder keeps its
+// pipeline in READY between files and only rebuilds the source side, a
+// new decoder per file builds and tears down the whole pipeline each time.
+void tst_QAudioDecoder::decodeFiles()
+{
+    QFETCH(bool, reuseDecoder);
+
+    QBENCHMARK {
+        QScopedPointer<QAudioDecoder> decoder;
+        for (const QString &fileName : qAsConst(m_fileNames)) {
+            if (!reuseDecoder || !decoder)
+                decoder.reset(new QAudioDecoder);
+            QCOMPARE(decodeFile(decoder.data(), fileName), qint64(ShortFileFrames));
+        }
+    }
+}
+
+QTEST_MAIN(tst_QAudioDecoder)
+
+#include "tst_bench_qaudiodecoder.moc"
@@ -0,0 +1,6 @@
+TARGET = tst_bench_qaudiohelpers
+
+QT += multimedia multimedia-private testlib
+CONFIG += release
+
+SOURCES += tst_bench_qaudiohelpers.cpp
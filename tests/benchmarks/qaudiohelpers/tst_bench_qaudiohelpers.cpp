@@ -0,0 +1,154 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qmath.h>
+#include <QtMultimedia/qaudiobuffer.h>
+#include <QtMultimedia/qaudioformat.h>
+#include <QtMultimedia/private/qaudiohelpers_p.h>
+
+QT_USE_NAMESPACE
+
+static const int SampleRate = 48000;
+static const int ChannelCount = 2;
+// 20 ms, a typical device period
+static const int FrameCount = SampleRate / 50;
+
+class tst_QAudioHelpers : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void multiplySamples_data();
+    void multiplySamples();
+    void createBuffer_data();
+    void createBuffer();
+
+private:
+    static QAudioFormat format(int sampleSize, QAudioFormat::SampleType sampleType);
+    static QByteArray generate(const QAudioFormat &format, int frames);
+};
+
+QAudioFormat tst_QAudioHelpers::format(int sampleSize, QAudioFormat::SampleType sampleType)
+{
+    QAudioFormat format;
+    format.setSampleRate(SampleRate);
+    format.setChannelCount(ChannelCount);
+    format.setSampleSize(sampleSize);
+    format.setSampleType(sampleType);
+    format.setByteOrder(QAudioFormat::LittleEndian);
+    format.setCodec(QStringLiteral("audio/pcm"));
+    return format;
+}
+
+// A 440 Hz sine at half scale in the given format
+QByteArray tst_QAudioHelpers::generate(const QAudioFormat &format, int frames)
+{
+    QByteArray data(format.bytesForFrames(frames), Qt::Uninitialized);
+    char *out = data.data();
+
+    for (int i = 0; i < frames; ++i) {
+        const qreal value = 0.5 * qSin(2 * M_PI * 440 * i / format.sampleRate());
+        for (int c = 0; c < format.channelCount(); ++c) {
+            switch (format.sampleSize()) {
+            case 8:
+                *reinterpret_cast<quint8 *>(out) = quint8(128 + value * 127);
+                break;
+            case 16:
+                *reinterpret_cast<qint16 *>(out) = qint16(value * 32767);
+                break;
+            default:
+                if (format.sampleType() == QAudioFormat::Float)
+                    *reinterpret_cast<float *>(out) = float(value);
+                else
+                    *reinterpret_cast<qint32 *>(out) = qint32(value * 2147483647.0);
+                break;
+            }
+            out += format.sampleSize() / 8;
+        }
+    }
+
+    return data;
+}
+
+void tst_QAudioHelpers::multiplySamples_data()
+{
+    QTest::addColumn<QAudioFormat>("format");
+    QTest::addColumn<bool>("inPlace");
+
+    QTest::newRow("8 bit unsigned") << format(8, QAudioFormat::UnSignedInt) << false;
+    QTest::newRow("16 bit signed") << format(16, QAudioFormat::SignedInt) << false;
+    QTest::newRow("16 bit signed, in place") << format(16, QAudioFormat::SignedInt) << true;
+    QTest::newRow("32 bit signed") << format(32, QAudioFormat::SignedInt) << false;
+    QTest::newRow("32 bit float") << format(32, QAudioFormat::Float) << false;
+    QTest::newRow("32 bit float, in place") << format(32, QAudioFormat::Float) << true;
+}
+
+// Volume scaling, done on every period by the audio outputs and inputs
+void tst_QAudioHelpers::multiplySamples()
+{
+    QFETCH(QAudioFormat, format);
+    QFETCH(bool, inPlace);
+
+    const QByteArray source = generate(format, FrameCount);
+    QByteArray destination = inPlace ? source : QByteArray(source.size(), Qt::Uninitialized);
+    char *output = destination.data();
+    const void *input = inPlace ? static_cast<const void *>(output) : source.constData();
+
+    QBENCHMARK {
+        QAudioHelperInternal::qMultiplySamples(0.5, format, input, output, source.size());
+    }
+}
+
+void tst_QAudioHelpers::createBuffer_data()
+{
+    QTest::addColumn<QAudioFormat>("format");
+
+    QTest::newRow("16 bit signed") << format(16, QAudioFormat::SignedInt);
+    QTest::newRow("32 bit float") << format(32, QAudioFormat::Float);
+}
+
+// What an audio probe hands to its clients for every buffer
+void tst_QAudioHelpers::createBuffer()
+{
+    QFETCH(QAudioFormat, format);
+
+    const QByteArray data = generate(format, FrameCount);
+    qint64 startTime = 0;
+
+    QBENCHMARK {
+        QAudioBuffer buffer(data, format, startTime);
+        volatile const void *samples = buffer.constData();
+        Q_UNUSED(samples);
+        startTime += 20000;
+    }
+}
+
+QTEST_MAIN(tst_QAudioHelpers)
+
+#include "tst_bench_qaudiohelpers.moc"
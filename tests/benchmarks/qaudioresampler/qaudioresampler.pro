@@ -0,0 +1,6 @@
+TARGET = tst_bench_qaudioresampler
+
+QT += multimedia multimedia-private testlib
+CONFIG += release
+
+SOURCES += tst_bench_qaudioresampler.cpp
@@ -0,0 +1,123 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qmath.h>
+#include <private/qaudioresampler_p.h>
+
+QT_USE_NAMESPACE
+
+static const int DurationSeconds = 1;
+static const int BlockBytes = 4096;
+
+class tst_QAudioResampler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void convert_data();
+    void convert();
+
+private:
+    static QAudioFormat pcmFormat(int sampleRate, int channels,
+                                  QAudioFormat::SampleType type = QAudioFormat::SignedInt,
+                                  int sampleSize = 16);
+    static QByteArray sine(const QAudioFormat &format);
+};
+
+QAudioFormat tst_QAudioResampler::pcmFormat(int sampleRate, int channels,
+                                            QAudioFormat::SampleType type, int sampleSize)
+{
+    QAudioFormat format;
+    format.setCodec(QStringLiteral("audio/pcm"));
+    format.setByteOrder(QAudioFormat::LittleEndian);
+    format.setSampleType(type);
+    format.setSampleSize(sampleSize);
+    format.setSampleRate(sampleRate);
+    format.setChannelCount(channels);
+    return format;
+}
+
+// DurationSeconds of a 440 Hz tone, 16 bit
+QByteArray tst_QAudioResampler::sine(const QAudioFormat &format)
+{
+    const int frames = format.sampleRate() * DurationSeconds;
+    QByteArray data(frames * format.bytesPerFrame(), Qt::Uninitialized);
+    qint16 *out = reinterpret_cast<qint16 *>(data.data());
+    for (int i = 0; i < frames; ++i) {
+        const qint16 value = qint16(16000 * qSin(2 * M_PI * 440 * i / format.sampleRate()));
+        for (int ch = 0; ch < format.channelCount(); ++ch)
+            *out++ = value;
+    }
+    return data;
+}
+
+void tst_QAudioResampler::convert_data()
+{
+    QTest::addColumn<QAudioFormat>("input");
+    QTest::addColumn<QAudioFormat>("output");
+    QTest::addColumn<int>("quality");
+
+    const int fast = QAudioResampler::FastQuality;
+    const int high = QAudioResampler::HighQuality;
+
+    QTest::newRow("format only, s16 -> f32") << pcmFormat(48000, 2) << pcmFormat(48000, 2, QAudioFormat::Float, 32) << high;
+    QTest::newRow("remix only, 6 -> 2") << pcmFormat(48000, 6) << pcmFormat(48000, 2) << high;
+    QTest::newRow("44100 -> 48000 stereo, fast") << pcmFormat(44100, 2) << pcmFormat(48000, 2) << fast;
+    QTest::newRow("44100 -> 48000 stereo, high") << pcmFormat(44100, 2) << pcmFormat(48000, 2) << high;
+    QTest::newRow("48000 -> 44100 stereo, fast") << pcmFormat(48000, 2) << pcmFormat(44100, 2) << fast;
+    QTest::newRow("48000 -> 44100 stereo, high") << pcmFormat(48000, 2) << pcmFormat(44100, 2) << high;
+    QTest::newRow("22050 mono -> 48000 stereo, high") << pcmFormat(22050, 1) << pcmFormat(48000, 2) << high;
+    QTest::newRow("96000 -> 44100 stereo, high") << pcmFormat(96000, 2) << pcmFormat(44100, 2) << high;
+}
+
+void tst_QAudioResampler::convert()
+{
+    QFETCH(QAudioFormat, input);
+    QFETCH(QAudioFormat, output);
+    QFETCH(int, quality);
+
+    const QByteArray data = sine(input);
+    QByteArray converted;
+    converted.reserve(int(output.bytesForDuration(qint64(DurationSeconds) * 1000000) + BlockBytes));
+
+    // One second of input per iteration, fed in device sized blocks.
+    QAudioResampler resampler(input, output, QAudioResampler::Quality(quality));
+    QBENCHMARK {
+        converted.resize(0);
+        resampler.reset();
+        for (int offset = 0; offset < data.size(); offset += BlockBytes)
+            resampler.convert(data.constData() + offset, qMin(BlockBytes, data.size() - offset), &converted);
+    }
+
+    QVERIFY(converted.size() > 0);
+}
+
+QTEST_MAIN(tst_QAudioResampler)
+
+#include "tst_bench_qaudioresampler.moc"
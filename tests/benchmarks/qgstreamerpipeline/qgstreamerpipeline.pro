@@ -0,0 +1,8 @@
+TARGET = tst_bench_qgstreamerpipeline
+
+QT += multimedia-private multimediagsttools-private testlib
+CONFIG += release
+
+QMAKE_USE += gstreamer
+
+SOURCES += tst_bench_qgstreamerpipeline.cpp
@@ -0,0 +1,244 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtMultimedia/qabstractvideosurface.h>
+#include <QtMultimedia/qvideosurfaceformat.h>
+#include <private/qgstutils_p.h>
+#include <private/qgstreameraudioprobecontrol_p.h>
+#include <private/qgstreamervideoprobecontrol_p.h>
+#include <private/qvideosurfacegstsink_p.h>
+
+#include <gst/gst.h>
+
+QT_USE_NAMESPACE
+
+static const int VideoFrameCount = 120;
+static const int AudioBufferCount = 500;
+
+#if GST_CHECK_VERSION(1,0,0)
+static const char *VideoCaps = "video/x-raw,format=I420,width=1280,height=720,framerate=30/1";
+static const char *AudioCaps = "audio/x-raw,format=S16LE,rate=48000,channels=2";
+#else
+static const char *VideoCaps = "video/x-raw-yuv,format=(fourcc)I420,width=1280,height=720,framerate=30/1";
+static const char *AudioCaps = "audio/x-raw-int,width=16,depth=16,signed=true,endianness=1234,rate=48000,channels=2";
+#endif
+
+// Accepts system memory frames and only counts them, so the benchmark
+// measures the sink and not a renderer.
+class CountingSurface : public QAbstractVideoSurface
+{
+public:
+    QList<QVideoFrame::PixelFormat> supportedPixelFormats(
+            QAbstractVideoBuffer::HandleType handleType) const override
+    {
+        if (handleType != QAbstractVideoBuffer::NoHandle)
+            return QList<QVideoFrame::PixelFormat>();
+        return QList<QVideoFrame::PixelFormat>() << QVideoFrame::Format_YUV420P;
+    }
+
+    bool present(const QVideoFrame &frame) override
+    {
+        if (frame.isValid())
+            ++frames;
+        return true;
+    }
+
+    int frames = 0;
+};
+
+class tst_QGstreamerPipeline : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void videoSink_data();
+    void videoSink();
+    void audioProbe_data();
+    void audioProbe();
+
+private:
+    static GstElement *createElement(const char *factory);
+    static GstElement *createPipeline(const char *sourceFactory, int buffers,
+                                      const char *caps, GstElement *sink);
+    static bool run(GstElement *pipeline);
+};
+
+GstElement *tst_QGstreamerPipeline::createElement(const char *factory)
+{
+    return gst_element_factory_make(factory, nullptr);
+}
+
+// source ! capsfilter ! sink, running as fast as the sink allows
+GstElement *tst_QGstreamerPipeline::createPipeline(const char *sourceFactory, int buffers,
+                                                   const char *caps, GstElement *sink)
+{
+    GstElement *pipeline = gst_pipeline_new(nullptr);
+    GstElement *source = createElement(sourceFactory);
+    GstElement *filter = createElement("capsfilter");
+
+    g_object_set(G_OBJECT(source), "num-buffers", buffers, nullptr);
+    GstCaps *filterCaps = gst_caps_from_string(caps);
+    g_object_set(G_OBJECT(filter), "caps", filterCaps, nullptr);
+    gst_caps_unref(filterCaps);
+    g_object_set(G_OBJECT(sink), "sync", FALSE, nullptr);
+
+    gst_bin_add_many(GST_BIN(pipeline), source, filter, sink, nullptr);
+    if (!gst_element_link_many(source, filter, sink, nullptr)) {
+        gst_object_unref(GST_OBJECT(pipeline));
+        return nullptr;
+    }
+
+    return pipeline;
+}
+
+// Plays the pipeline to the end. The surface sink presents frames through
+// the event loop, so keep it spinning while waiting.
+bool tst_QGstreamerPipeline::run(GstElement *pipeline)
+{
+    if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+        return false;
+
+    GstBus *bus = gst_element_get_bus(pipeline);
+    GstMessage *message = nullptr;
+    QElapsedTimer timer;
+    timer.start();
+    while (!message && timer.elapsed() < 30000) {
+        QCoreApplication::processEvents();
+        message = gst_bus_timed_pop_filtered(
+                    bus, GST_MSECOND, GstMessageType(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+    }
+    gst_object_unref(GST_OBJECT(bus));
+
+    const bool finished = message && GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS;
+    if (message)
+        gst_message_unref(message);
+
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    QCoreApplication::processEvents();
+
+    return finished;
+}
+
+void tst_QGstreamerPipeline::initTestCase()
+{
+    QGstUtils::initializeGst();
+
+    for (const char *factory : { "videotestsrc", "audiotestsrc", "capsfilter", "fakesink" }) {
+        GstElementFactory *elementFactory = gst_element_factory_find(factory);
+        if (!elementFactory)
+            QSKIP(qPrintable(QStringLiteral("The %1 element is not available.").arg(QLatin1String(factory))));
+        gst_object_unref(GST_OBJECT(elementFactory));
+    }
+}
+
+void tst_QGstreamerPipeline::videoSink_data()
+{
+    QTest::addColumn<bool>("surface");
+    QTest::addColumn<bool>("probe");
+
+    QTest::newRow("fakesink") << false << false;
+    QTest::newRow("fakesink, video probe") << false << true;
+    QTest::newRow("surface sink") << true << false;
+    QTest::newRow("surface sink, video probe") << true << true;
+}
+
+// The hand-off of decoded frames to a QAbstractVideoSurface, with and
+// without a QVideoProbe attached to the sink pad.
+void tst_QGstreamerPipeline::videoSink()
+{
+    QFETCH(bool, surface);
+    QFETCH(bool, probe);
+
+    QBENCHMARK {
+        CountingSurface videoSurface;
+        QGstreamerVideoProbeControl probeControl(nullptr);
+
+        GstElement *sink = surface
+                ? reinterpret_cast<GstElement *>(QVideoSurfaceGstSink::createSink(&videoSurface))
+                : createElement("fakesink");
+        GstElement *pipeline = createPipeline("videotestsrc", VideoFrameCount, VideoCaps, sink);
+        QVERIFY(pipeline);
+
+        GstPad *pad = gst_element_get_static_pad(sink, "sink");
+        if (probe)
+            probeControl.addProbeToPad(pad);
+
+        const bool finished = run(pipeline);
+
+        if (probe)
+            probeControl.removeProbeFromPad(pad);
+        gst_object_unref(GST_OBJECT(pad));
+        gst_object_unref(GST_OBJECT(pipeline));
+
+        QVERIFY(finished);
+        if (surface)
+            QCOMPARE(videoSurface.frames, VideoFrameCount);
+    }
+}
+
+void tst_QGstreamerPipeline::audioProbe_data()
+{
+    QTest::addColumn<bool>("probe");
+
+    QTest::newRow("no probe") << false;
+    QTest::newRow("audio probe") << true;
+}
+
+// What a QAudioProbe adds to every audio buffer
+void tst_QGstreamerPipeline::audioProbe()
+{
+    QFETCH(bool, probe);
+
+    QBENCHMARK {
+        QGstreamerAudioProbeControl probeControl(nullptr);
+
+        GstElement *sink = createElement("fakesink");
+        GstElement *pipeline = createPipeline("audiotestsrc", AudioBufferCount, AudioCaps, sink);
+        QVERIFY(pipeline);
+
+        GstPad *pad = gst_element_get_static_pad(sink, "sink");
+        if (probe)
+            probeControl.addProbeToPad(pad);
+
+        const bool finished = run(pipeline);
+
+        if (probe)
+            probeControl.removeProbeFromPad(pad);
+        gst_object_unref(GST_OBJECT(pad));
+        gst_object_unref(GST_OBJECT(pipeline));
+
+        QVERIFY(finished);
+    }
+}
+
+QTEST_MAIN(tst_QGstreamerPipeline)
+
+#include "tst_bench_qgstreamerpipeline.moc"
@@ -0,0 +1,143 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtMultimedia/qmediatimerange.h>
+
+QT_USE_NAMESPACE
+
+class tst_QMediaTimeRange : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void addInterval_data();
+    void addInterval();
+    void mergeIntervals_data();
+    void mergeIntervals();
+    void contains_data();
+    void contains();
+    void removeInterval_data();
+    void removeInterval();
+
+private:
+    static QMediaTimeRange fragmented(int count);
+};
+
+// Disjoint one second intervals with one second gaps, like the buffered
+// ranges of a stream that was seeked around in.
+QMediaTimeRange tst_QMediaTimeRange::fragmented(int count)
+{
+    QMediaTimeRange range;
+    for (int i = 0; i < count; ++i)
+        range.addInterval(i * 2000000, i * 2000000 + 999999);
+    return range;
+}
+
+void tst_QMediaTimeRange::addInterval_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("16") << 16;
+    QTest::newRow("256") << 256;
+}
+
+void tst_QMediaTimeRange::addInterval()
+{
+    QFETCH(int, count);
+
+    QBENCHMARK {
+        QMediaTimeRange range = fragmented(count);
+        QCOMPARE(range.intervals().count(), count);
+    }
+}
+
+void tst_QMediaTimeRange::mergeIntervals_data()
+{
+    addInterval_data();
+}
+
+// Filling the gaps collapses the range back into one interval
+void tst_QMediaTimeRange::mergeIntervals()
+{
+    QFETCH(int, count);
+
+    const QMediaTimeRange source = fragmented(count);
+
+    QBENCHMARK {
+        QMediaTimeRange range = source;
+        for (int i = 0; i < count - 1; ++i)
+            range.addInterval(i * 2000000 + 1000000, i * 2000000 + 1999999);
+        QVERIFY(range.isContinuous());
+    }
+}
+
+void tst_QMediaTimeRange::contains_data()
+{
+    addInterval_data();
+}
+
+void tst_QMediaTimeRange::contains()
+{
+    QFETCH(int, count);
+
+    const QMediaTimeRange range = fragmented(count);
+    const qint64 latest = range.latestTime();
+    qint64 time = 0;
+    int hits = 0;
+
+    QBENCHMARK {
+        hits += range.contains(time) ? 1 : 0;
+        time = (time + 333333) % latest;
+    }
+
+    Q_UNUSED(hits);
+}
+
+void tst_QMediaTimeRange::removeInterval_data()
+{
+    addInterval_data();
+}
+
+void tst_QMediaTimeRange::removeInterval()
+{
+    QFETCH(int, count);
+
+    const QMediaTimeRange source = fragmented(count);
+
+    QBENCHMARK {
+        QMediaTimeRange range = source;
+        for (int i = 0; i < count; ++i)
+            range.removeInterval(i * 2000000 + 250000, i * 2000000 + 749999);
+        QCOMPARE(range.intervals().count(), count * 2);
+    }
+}
+
+QTEST_MAIN(tst_QMediaTimeRange)
+
+#include "tst_bench_qmediatimerange.moc"
@@ -0,0 +1,6 @@
+TARGET = tst_bench_qsamplecache
+
+QT += multimedia-private testlib
+CONFIG += release
+
+SOURCES += tst_bench_qsamplecache.cpp
@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qtemporarydir.h>
+#include <QtCore/qmath.h>
+#include <QtMultimedia/private/qsamplecache_p.h>
+
+QT_USE_NAMESPACE
+
+static const int SampleRate = 44100;
+static const int ChannelCount = 2;
+
+class tst_QSampleCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void load_data();
+    void load();
+    void cachedRequest();
+
+private:
+    static bool writeWaveFile(const QString &fileName, int durationMs);
+    static bool waitForSample(QSample *sample);
+
+    QTemporaryDir m_dir;
+};
+
+// 16 bit PCM with a plain 44 byte RIFF header
+bool tst_QSampleCache::writeWaveFile(const QString &fileName, int durationMs)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    const quint32 frames = SampleRate * durationMs / 1000;
+    const quint32 dataSize = frames * ChannelCount * 2;
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData("RIFF", 4);
+    out << quint32(36 + dataSize);
+    out.writeRawData("WAVEfmt ", 8);
+    out << quint32(16) << quint16(1) << quint16(ChannelCount) << quint32(SampleRate)
+        << quint32(SampleRate * ChannelCount * 2) << quint16(ChannelCount * 2) << quint16(16);
+    out.writeRawData("data", 4);
+    out << dataSize;
+
+    QByteArray data(dataSize, Qt::Uninitialized);
+    qint16 *samples = reinterpret_cast<qint16 *>(data.data());
+    for (quint32 i = 0; i < frames; ++i) {
+        const qint16 value = qint16(16000 * qSin(2 * M_PI * 440 * i / SampleRate));
+        for (int c = 0; c < ChannelCount; ++c)
+            *samples++ = value;
+    }
+    out.writeRawData(data.constData(), data.size());
+
+    return out.status() == QDataStream::Ok;
+}
+
+// Samples are decoded on the cache's loading thread
+bool tst_QSampleCache::waitForSample(QSample *sample)
+{
+    QEventLoop loop;
+    connect(sample, &QSample::ready, &loop, &QEventLoop::quit);
+    connect(sample, &QSample::error, &loop, &QEventLoop::quit);
+    QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+
+    const QSample::State state = sample->state();
+    if (state != QSample::Ready && state != QSample::Error)
+        loop.exec();
+
+    return sample->state() == QSample::Ready;
+}
+
+void tst_QSampleCache::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    QVERIFY(writeWaveFile(m_dir.filePath(QStringLiteral("click.wav")), 50));
+    QVERIFY(writeWaveFile(m_dir.filePath(QStringLiteral("effect.wav")), 1000));
+}
+
+void tst_QSampleCache::load_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("50 ms") << QStringLiteral("click.wav");
+    QTest::newRow("1 s") << QStringLiteral("effect.wav");
+}
+
+// A sound effect's first play: read and decode the whole file
+void tst_QSampleCache::load()
+{
+    QFETCH(QString, fileName);
+
+    const QUrl url = QUrl::fromLocalFile(m_dir.filePath(fileName));
+
+    QBENCHMARK {
+        QSampleCache cache;
+        QSample *sample = cache.requestSample(url);
+        QVERIFY(waitForSample(sample));
+        sample->release();
+    }
+}
+
+// Every later play of the same effect
+void tst_QSampleCache::cachedRequest()
+{
+    const QUrl url = QUrl::fromLocalFile(m_dir.filePath(QStringLiteral("effect.wav")));
+
+    QSampleCache cache;
+    cache.setCapacity(16 * 1024 * 1024);
+
+    QSample *sample = cache.requestSample(url);
+    QVERIFY(waitForSample(sample));
+    sample->release();
+    QVERIFY(cache.isCached(url));
+
+    QBENCHMARK {
+        sample = cache.requestSample(url);
+        QVERIFY(waitForSample(sample));
+        sample->release();
+    }
+}
+
+QTEST_MAIN(tst_QSampleCache)
+
+#include "tst_bench_qsamplecache.moc"
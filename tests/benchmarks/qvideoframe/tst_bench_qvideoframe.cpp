@@ -0,0 +1,264 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qatomic.h>
+#include <QtMultimedia/qvideoframe.h>
+#include <QtMultimedia/qabstractvideosurface.h>
+#include <QtMultimedia/qvideosurfaceformat.h>
+#include <private/qgstutils_p.h>
+#include <private/qgstvideobuffer_p.h>
+#include <private/qgstvideorenderersink_p.h>
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#include <cstdlib>
+#include <new>
+
+// Count every heap allocation of the process made through operator new.
+// GStreamer itself allocates through GLib, so this counts what the Qt side
+// of the frame delivery costs.
+static QBasicAtomicInt allocationCount = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+void *operator new(std::size_t size)
+{
+    allocationCount.ref();
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+QT_USE_NAMESPACE
+
+static const int Width = 1920;
+static const int Height = 1080;
+static const int FrameSize = Width * Height * 3 / 2;
+static const int PipelineFrameCount = 300;
+
+// Maps every presented frame like a painting surface would, without
+// drawing it
+class MappingSurface : public QAbstractVideoSurface
+{
+public:
+    QList<QVideoFrame::PixelFormat> supportedPixelFormats(
+            QAbstractVideoBuffer::HandleType handleType) const override
+    {
+        if (handleType != QAbstractVideoBuffer::NoHandle)
+            return QList<QVideoFrame::PixelFormat>();
+        return QList<QVideoFrame::PixelFormat>() << QVideoFrame::Format_YUV420P;
+    }
+
+    bool present(const QVideoFrame &frame) override
+    {
+        QVideoFrame presented = frame;
+        if (presented.map(QAbstractVideoBuffer::ReadOnly)) {
+            volatile uchar pixel = presented.bits(1)[0];
+            Q_UNUSED(pixel);
+            presented.unmap();
+            ++frames;
+        }
+        return true;
+    }
+
+    int frames = 0;
+};
+
+class tst_QVideoFrame : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void steadyStateAllocations();
+    void pipelineAllocations();
+    void createFrame();
+    void createAndMapFrame();
+
+private:
+    GstBuffer *wrapData(qint64 time);
+    void deliverFrame(qint64 time);
+
+    QByteArray m_data;
+    GstVideoInfo m_videoInfo;
+};
+
+void tst_QVideoFrame::initTestCase()
+{
+    QGstUtils::initializeGst();
+
+    GstElementFactory *elementFactory = gst_element_factory_find("appsrc");
+    if (!elementFactory)
+        QSKIP("The appsrc element is not available.");
+    gst_object_unref(GST_OBJECT(elementFactory));
+
+    m_data = QByteArray(FrameSize, 0x10);
+    gst_video_info_init(&m_videoInfo);
+    gst_video_info_set_format(&m_videoInfo, GST_VIDEO_FORMAT_I420, Width, Height);
+}
+
+// A new GstBuffer for every frame around the same memory, like a decoder
+// handing out buffers from its pool
+GstBuffer *tst_QVideoFrame::wrapData(qint64 time)
+{
+    GstBuffer *buffer = gst_buffer_new_wrapped_full(
+                GST_MEMORY_FLAG_READONLY, m_data.data(), FrameSize, 0, FrameSize,
+                nullptr, nullptr);
+    GST_BUFFER_PTS(buffer) = time * GST_USECOND;
+    GST_BUFFER_DURATION(buffer) = 16666 * GST_USECOND;
+    return buffer;
+}
+
+// What the GStreamer video sink and a surface do with every frame
+void tst_QVideoFrame::deliverFrame(qint64 time)
+{
+    GstBuffer *buffer = wrapData(time);
+    QVideoFrame frame(new QGstVideoBuffer(buffer, m_videoInfo),
+                      QSize(Width, Height), QVideoFrame::Format_YUV420P);
+    gst_buffer_unref(buffer);
+    frame.setStartTime(time);
+    frame.setEndTime(time + 16666);
+
+    QVideoFrame presented = frame;
+    if (presented.map(QAbstractVideoBuffer::ReadOnly)) {
+        volatile uchar pixel = presented.bits(1)[0];
+        Q_UNUSED(pixel);
+        presented.unmap();
+    }
+}
+
+void tst_QVideoFrame::steadyStateAllocations()
+{
+    // Fill the pools
+    for (int i = 0; i < 16; ++i)
+        deliverFrame(i * 16666);
+
+    const int before = allocationCount.load();
+    for (int i = 0; i < 1000; ++i)
+        deliverFrame(i * 16666);
+
+    QCOMPARE(allocationCount.load() - before, 0);
+}
+
+// Pushes frames from appsrc through QGstVideoRendererSink to a surface and
+// reports the allocations per frame. Besides the frame itself, the sink
+// posts an event to the surface's thread for every frame, so this is not
+// expected to reach zero.
+void tst_QVideoFrame::pipelineAllocations()
+{
+    MappingSurface surface;
+
+    GstElement *pipeline = gst_pipeline_new(nullptr);
+    GstElement *source = gst_element_factory_make("appsrc", nullptr);
+    GstElement *sink = reinterpret_cast<GstElement *>(QGstVideoRendererSink::createSink(&surface));
+
+    GstCaps *caps = gst_video_info_to_caps(&m_videoInfo);
+    g_object_set(G_OBJECT(source), "caps", caps, "format", GST_FORMAT_TIME, nullptr);
+    gst_caps_unref(caps);
+    g_object_set(G_OBJECT(sink), "sync", FALSE, nullptr);
+
+    gst_bin_add_many(GST_BIN(pipeline), source, sink, nullptr);
+    QVERIFY(gst_element_link(source, sink));
+    QVERIFY(gst_element_set_state(pipeline, GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+
+    GstBus *bus = gst_element_get_bus(pipeline);
+    int before = 0;
+    for (int i = 0; i < PipelineFrameCount; ++i) {
+        // Don't count setting up the pipeline and filling the pools
+        if (i == 16) {
+            QTRY_COMPARE(surface.frames, 16);
+            before = allocationCount.load();
+        }
+
+        GstFlowReturn result = GST_FLOW_OK;
+        g_signal_emit_by_name(source, "push-buffer", wrapData(i * 16666), &result);
+        QCOMPARE(result, GST_FLOW_OK);
+    }
+    GstFlowReturn result = GST_FLOW_OK;
+    g_signal_emit_by_name(source, "end-of-stream", &result);
+
+    // The sink waits for the surface to present each frame on this thread
+    GstMessage *message = nullptr;
+    QElapsedTimer timer;
+    timer.start();
+    while (!message && timer.elapsed() < 30000) {
+        QCoreApplication::processEvents();
+        message = gst_bus_timed_pop_filtered(
+                    bus, GST_MSECOND, GstMessageType(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+    }
+    const int allocations = allocationCount.load() - before;
+    const bool finished = message && GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS;
+    if (message)
+        gst_message_unref(message);
+    gst_object_unref(GST_OBJECT(bus));
+
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(GST_OBJECT(pipeline));
+
+    QVERIFY(finished);
+    QCOMPARE(surface.frames, PipelineFrameCount);
+    QTest::setBenchmarkResult(qreal(allocations) / (PipelineFrameCount - 16), QTest::Events);
+}
+
+void tst_QVideoFrame::createFrame()
+{
+    GstBuffer *buffer = wrapData(0);
+
+    QBENCHMARK {
+        QVideoFrame frame(new QGstVideoBuffer(buffer, m_videoInfo),
+                          QSize(Width, Height), QVideoFrame::Format_YUV420P);
+        frame.setStartTime(0);
+    }
+
+    gst_buffer_unref(buffer);
+}
+
+void tst_QVideoFrame::createAndMapFrame()
+{
+    qint64 time = 0;
+
+    QBENCHMARK {
+        deliverFrame(time);
+        time += 16666;
+    }
+}
+
+QTEST_MAIN(tst_QVideoFrame)
+
+#include "tst_bench_qvideoframe.moc"
@@ -0,0 +1,13 @@
+TARGET = tst_bench_qvideoframeconversion
+
+QT += multimedia multimedia-private testlib
+CONFIG += release
+
+# The scaled conversion is internal to Qt Multimedia Widgets
+INCLUDEPATH += ../../../src/multimediawidgets
+
+HEADERS += ../../../src/multimediawidgets/qvideoframescaling_p.h
+
+SOURCES += \
+    tst_bench_qvideoframeconversion.cpp \
+    ../../../src/multimediawidgets/qvideoframescaling.cpp
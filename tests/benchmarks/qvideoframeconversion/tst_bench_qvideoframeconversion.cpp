@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtGui/qimage.h>
+#include <QtMultimedia/qvideoframe.h>
+#include "qvideoframescaling_p.h"
+
+QT_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QVideoFrame::PixelFormat)
+
+static const QSize FrameSize(1280, 720);
+
+class tst_QVideoFrameConversion : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void toImage_data();
+    void toImage();
+    void scaledToARGB32_data();
+    void scaledToARGB32();
+
+private:
+    static QVideoFrame createFrame(QVideoFrame::PixelFormat format);
+};
+
+// A frame in system memory filled with a gradient, so the conversion
+// does not run on uniform data.
+QVideoFrame tst_QVideoFrameConversion::createFrame(QVideoFrame::PixelFormat format)
+{
+    int bytesPerLine = FrameSize.width();
+    int bytes = 0;
+
+    switch (format) {
+    case QVideoFrame::Format_YUV420P:
+    case QVideoFrame::Format_YV12:
+    case QVideoFrame::Format_NV12:
+    case QVideoFrame::Format_NV21:
+        bytes = FrameSize.width() * FrameSize.height() * 3 / 2;
+        break;
+    case QVideoFrame::Format_UYVY:
+    case QVideoFrame::Format_YUYV:
+    case QVideoFrame::Format_RGB565:
+        bytesPerLine *= 2;
+        bytes = bytesPerLine * FrameSize.height();
+        break;
+    case QVideoFrame::Format_RGB24:
+        bytesPerLine *= 3;
+        bytes = bytesPerLine * FrameSize.height();
+        break;
+    default:
+        bytesPerLine *= 4;
+        bytes = bytesPerLine * FrameSize.height();
+        break;
+    }
+
+    QVideoFrame frame(bytes, FrameSize, bytesPerLine, format);
+    if (frame.map(QAbstractVideoBuffer::WriteOnly)) {
+        uchar *data = frame.bits();
+        for (int i = 0; i < frame.mappedBytes(); ++i)
+            data[i] = uchar(i * 7 + i / bytesPerLine);
+        frame.unmap();
+    }
+    return frame;
+}
+
+void tst_QVideoFrameConversion::toImage_data()
+{
+    QTest::addColumn<QVideoFrame::PixelFormat>("pixelFormat");
+
+    QTest::newRow("YUV420P") << QVideoFrame::Format_YUV420P;
+    QTest::newRow("YV12") << QVideoFrame::Format_YV12;
+    QTest::newRow("NV12") << QVideoFrame::Format_NV12;
+    QTest::newRow("NV21") << QVideoFrame::Format_NV21;
+    QTest::newRow("UYVY") << QVideoFrame::Format_UYVY;
+    QTest::newRow("YUYV") << QVideoFrame::Format_YUYV;
+    QTest::newRow("BGRA32") << QVideoFrame::Format_BGRA32;
+    QTest::newRow("BGR32") << QVideoFrame::Format_BGR32;
+    QTest::newRow("RGB32") << QVideoFrame::Format_RGB32;
+    QTest::newRow("RGB565") << QVideoFrame::Format_RGB565;
+}
+
+// What QVideoFrame::image() and the painter surface pay per frame
+void tst_QVideoFrameConversion::toImage()
+{
+    QFETCH(QVideoFrame::PixelFormat, pixelFormat);
+
+    const QVideoFrame frame = createFrame(pixelFormat);
+    QVERIFY(frame.isValid());
+    QVERIFY(!frame.image().isNull());
+
+    QBENCHMARK {
+        QImage image = frame.image();
+        Q_UNUSED(image);
+    }
+}
+
+void tst_QVideoFrameConversion::scaledToARGB32_data()
+{
+    QTest::addColumn<QVideoFrame::PixelFormat>("pixelFormat");
+    QTest::addColumn<QSize>("size");
+
+    QTest::newRow("YUV420P, 1:1") << QVideoFrame::Format_YUV420P << FrameSize;
+    QTest::newRow("YUV420P, 1:4") << QVideoFrame::Format_YUV420P << FrameSize / 4;
+    QTest::newRow("NV12, 1:1") << QVideoFrame::Format_NV12 << FrameSize;
+    QTest::newRow("NV12, 1:4") << QVideoFrame::Format_NV12 << FrameSize / 4;
+    QTest::newRow("UYVY, 1:4") << QVideoFrame::Format_UYVY << FrameSize / 4;
+}
+
+// The combined convert and scale path used for downscaled presentation
+void tst_QVideoFrameConversion::scaledToARGB32()
+{
+    QFETCH(QVideoFrame::PixelFormat, pixelFormat);
+    QFETCH(QSize, size);
+
+    QVideoFrame frame = createFrame(pixelFormat);
+    QVERIFY(frame.map(QAbstractVideoBuffer::ReadOnly));
+
+    QImage image(size, QImage::Format_ARGB32);
+    const QRect source(QPoint(0, 0), FrameSize);
+    QVERIFY(qt_convert_scaled_to_ARGB32(frame, source, image.bits(), image.bytesPerLine(), size));
+
+    QBENCHMARK {
+        qt_convert_scaled_to_ARGB32(frame, source, image.bits(), image.bytesPerLine(), size);
+    }
+
+    frame.unmap();
+}
+
+QTEST_MAIN(tst_QVideoFrameConversion)
+
+#include "tst_bench_qvideoframeconversion.moc"
@@ -0,0 +1,167 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtTest/QtTest>
+#include <QtCore/qatomic.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+#include <QtMultimedia/qvideoframe.h>
+#include <QtMultimedia/private/qvideoframetriplebuffer_p.h>
+
+QT_USE_NAMESPACE
+
+// Mimics the render thread of a VideoOutput: a long render pass followed by a
+// wait for the next vsync. With the mutex hand-off the frame lock is held for
+// the whole render pass, as updatePaintNode() used to do.
+class StalledRenderer : public QThread
+{
+public:
+    enum HandOff { MutexHandOff, TripleBufferHandOff };
+
+    StalledRenderer(HandOff handOff, int renderMsecs)
+        : m_handOff(handOff)
+        , m_renderMsecs(renderMsecs)
+    {
+    }
+
+    void present(const QVideoFrame &frame)
+    {
+        if (m_handOff == MutexHandOff) {
+            QMutexLocker lock(&m_mutex);
+            m_frame = frame;
+            m_frameChanged = true;
+        } else {
+            m_frames.publish(frame);
+        }
+    }
+
+    void requestStop() { m_quit.storeRelease(1); }
+
+    int takenFrames() const { return m_taken; }
+    QVideoFrameTripleBuffer &frames() { return m_frames; }
+
+protected:
+    void run() override
+    {
+        while (!m_quit.loadAcquire()) {
+            if (m_handOff == MutexHandOff) {
+                QMutexLocker lock(&m_mutex);
+                if (m_frameChanged) {
+                    m_frameChanged = false;
+                    m_frame = QVideoFrame();
+                    ++m_taken;
+                }
+                QThread::msleep(m_renderMsecs);
+            } else {
+                QVideoFrame frame;
+                if (m_frames.take(&frame))
+                    ++m_taken;
+                QThread::msleep(m_renderMsecs);
+            }
+            QThread::msleep(m_renderMsecs);
+        }
+    }
+
+private:
+    const HandOff m_handOff;
+    const int m_renderMsecs;
+    QAtomicInt m_quit;
+
+    QMutex m_mutex;
+    QVideoFrame m_frame;
+    bool m_frameChanged = false;
+
+    QVideoFrameTripleBuffer m_frames;
+    int m_taken = 0;
+};
+
+Q_DECLARE_METATYPE(StalledRenderer::HandOff)
+
+class tst_QVideoFrameTripleBuffer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void producerLatency_data();
+    void producerLatency();
+    void counters();
+};
+
+void tst_QVideoFrameTripleBuffer::producerLatency_data()
+{
+    QTest::addColumn<StalledRenderer::HandOff>("handOff");
+
+    QTest::newRow("mutex") << StalledRenderer::MutexHandOff;
+    QTest::newRow("triple buffer") << StalledRenderer::TripleBufferHandOff;
+}
+
+// Time spent in present() on the decoder thread while the renderer is busy
+void tst_QVideoFrameTripleBuffer::producerLatency()
+{
+    QFETCH(StalledRenderer::HandOff, handOff);
+
+    const QVideoFrame frame(640 * 480 * 4, QSize(640, 480), 640 * 4, QVideoFrame::Format_RGB32);
+
+    StalledRenderer renderer(handOff, 8);
+    renderer.start();
+
+    QBENCHMARK {
+        renderer.present(frame);
+    }
+
+    renderer.requestStop();
+    renderer.wait();
+}
+
+void tst_QVideoFrameTripleBuffer::counters()
+{
+    const QVideoFrame frame(640 * 480 * 4, QSize(640, 480), 640 * 4, QVideoFrame::Format_RGB32);
+
+    StalledRenderer renderer(StalledRenderer::TripleBufferHandOff, 8);
+    renderer.start();
+
+    for (int i = 0; i < 1000; ++i) {
+        renderer.present(frame);
+        QThread::usleep(100);
+    }
+
+    renderer.requestStop();
+    renderer.wait();
+
+    // Drain the frame published after the last render pass
+    QVideoFrame last;
+    const int pending = renderer.frames().take(&last) ? 1 : 0;
+
+    QVideoFrameTripleBuffer &frames = renderer.frames();
+    QCOMPARE(frames.publishedFrames(), 1000);
+    QVERIFY(frames.droppedFrames() > 0);
+    QCOMPARE(renderer.takenFrames() + pending + frames.droppedFrames(), frames.publishedFrames());
+}
+
+QTEST_MAIN(tst_QVideoFrameTripleBuffer)
+
+#include "tst_bench_qvideoframetriplebuffer.moc"